@@ -0,0 +1,60 @@
+#!/bin/sh
+# Runs the regression scripts of this directory against ./nitcbase (or the
+# binary in $NITCBASE) and compares their output with the expected output in
+# <script>.out.
+# usage (from mynitcbase, after make): ../Files/Batch_Execution_Files/regression/run.sh [name ...]
+#
+# Every script starts on a freshly formatted disk. A script may hold several
+# sessions: each `exit` line ends one, and the next one starts a new nitcbase
+# on the same disk. The disk is restored afterwards. Times printed by the
+# commands ("123 us", "4 ms", "(1.5x)") are replaced by "_" before the comparison.
+
+NITCBASE=${NITCBASE:-./nitcbase}
+DIR=../Files/Batch_Execution_Files/regression
+DISK=../Disk/disk
+TMP=$(mktemp -d)
+
+# readline wraps the echo of a command longer than the screen width
+export COLUMNS=1000
+
+if [ -f "$DISK" ]; then
+  cp "$DISK" "$TMP/disk"
+fi
+
+if [ $# -eq 0 ]; then
+  set -- $(cd "$DIR" && ls *.txt | sed 's/\.txt$//')
+fi
+
+failed=0
+for name in "$@"; do
+  (cd ../XFS_Interface && printf 'fdisk\nexit\n' | ./xfs-interface > /dev/null)
+
+  rm -f "$TMP"/session.*
+  awk -v dir="$TMP" '{ print > (dir "/session." sprintf("%03d", n)) } /^exit;?$/ { n++ }' "$DIR/$name.txt"
+
+  : > "$TMP/$name.actual"
+  for session in "$TMP"/session.*; do
+    # a session that hangs fails the script instead of the whole run
+    timeout 120 "$NITCBASE" < "$session" 2>&1 |
+      sed -E 's/[0-9]+ (us|ms|ns)\b/_ \1/g; s/\([0-9.e+-]+x\)/(_x)/g' >> "$TMP/$name.actual"
+  done
+
+  if diff "$DIR/$name.out" "$TMP/$name.actual" > "$TMP/$name.diff"; then
+    echo "PASS $name"
+  else
+    echo "FAIL $name"
+    cat "$TMP/$name.diff"
+    failed=$((failed + 1))
+  fi
+done
+
+if [ -f "$TMP/disk" ]; then
+  cp "$TMP/disk" "$DISK"
+fi
+rm -rf "$TMP"
+
+if [ $failed -ne 0 ]; then
+  echo "$failed of $# regression scripts failed"
+  exit 1
+fi
+echo "all $# regression scripts passed"
@@ -1,26 +1,325 @@
 #include "Algebra.h"
+#include "ResultWriter.h"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include<cstdlib>
 #include<cstdio>
 
 bool isNumber(char *str);
+int strToAttribute(char strVal[ATTR_SIZE], int type, union Attribute *attrVal);
+
+int Algebra::joinMemoryBudget = JOIN_MEMORY_BUDGET;
+
+void Algebra::setJoinMemoryBudget(int numBytes)
+{
+	joinMemoryBudget = numBytes;
+}
+
+int Algebra::getJoinMemoryBudget()
+{
+	return joinMemoryBudget;
+}
 /* used to select all the records that satisfy a condition.
 the arguments of the function are
 - srcRel - the source relation we want to select from
 - targetRel - the relation we want to select into. (ignore for now)
-- attr - the attribute that the condition is checking
-- op - the operator of the condition
-- strVal - the value that we want to compare against (represented as a string)
+- where - the condition of the WHERE clause
 */
 
-int Algebra::select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], char attr[ATTR_SIZE], int op, char strVal[ATTR_SIZE])
-{	
-	int srcRelId = OpenRelTable::getRelId(srcRel);      // we'll implement this later
-	if (srcRelId == E_RELNOTOPEN)
+int Algebra::select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], Predicate *where)
+{
+	Operator *root;
+	int ret = Algebra::buildSelect(srcRel, where, &root);
+	if (ret != SUCCESS)
+		return ret;
+
+	// insert the selected records into the target relation
+	ret = Algebra::materialize(root, targetRel);
+	delete root;
+
+	return ret;
+}
+
+/* select followed by project, executed as a single pipeline: only the records
+that satisfy the condition reach the projection and only the projected
+records are written to the target relation */
+int Algebra::select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], int tar_nAttrs, char tar_Attrs[][ATTR_SIZE],
+                    Predicate *where)
+{
+	Operator *root;
+	int ret = Algebra::buildSelect(srcRel, where, tar_nAttrs, tar_Attrs, &root);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = Algebra::materialize(root, targetRel);
+	delete root;
+
+	return ret;
+}
+
+/* a range of an indexed attribute that holds every record satisfying a
+condition: the entries of the B+ tree of attr between the bounds (see
+BPlusCursor), or the records of its hash index equal to lowVal */
+struct IndexRange
+{
+	char attr[ATTR_SIZE];
+	int attrType;
+	bool hash;
+	int lowOp;
+	Attribute lowVal;
+	int highOp;
+	Attribute highVal;
+};
+
+// 0 for a single value, 1 for a range closed at both ends, 2 for an open one
+static int rangeWidth(const IndexRange &range)
+{
+	if (range.hash ||
+	    (range.lowOp == GE && range.highOp == LE && compareAttrs(range.lowVal, range.highVal, range.attrType) == 0))
+		return 0;
+	return (range.lowOp != NO_BOUND && range.highOp != NO_BOUND) ? 1 : 2;
+}
+
+/* the index ranges of a comparison, or of the comparisons of an AND (those on
+one attribute narrow a single range), narrowest kind first. NE, comparisons
+on attributes without an index and the terms of a nested OR give no range. */
+static int indexRanges(int relId, Predicate *where, std::vector<IndexRange> *ranges)
+{
+	std::vector<Predicate *> terms;
+	if (where->type == PRED_COMPARE)
+		terms.push_back(where);
+	else if (where->type == PRED_AND)
 	{
-		return E_RELNOTOPEN;
+		for (Predicate &term : where->children)
+		{
+			if (term.type == PRED_COMPARE)
+				terms.push_back(&term);
+		}
 	}
 
+	ranges->clear();
+	for (Predicate *term : terms)
+	{
+		AttrCatEntry attrCatEntry;
+		if (AttrCacheTable::getAttrCatEntry(relId, term->attr, &attrCatEntry) != SUCCESS)
+			return E_ATTRNOTEXIST;
+
+		Attribute attrVal;
+		int ret = strToAttribute(term->value, attrCatEntry.attrType, &attrVal);
+		if (ret != SUCCESS)
+			return ret;
+
+		// an equality on an attribute without a B+ tree can still use its hash index
+		HashIndexInfo hashIndex;
+		bool hash = (attrCatEntry.rootBlock == -1);
+		if (term->op == NE ||
+		    (hash && (term->op != EQ || HashIndex::find(relId, attrCatEntry.offset, &hashIndex) != SUCCESS)))
+			continue;
+
+		IndexRange *range = nullptr;
+		for (IndexRange &other : *ranges)
+		{
+			if (strcmp(other.attr, term->attr) == 0)
+				range = &other;
+		}
+		if (range == nullptr)
+		{
+			ranges->push_back(IndexRange());
+			range = &ranges->back();
+			strcpy(range->attr, term->attr);
+			range->attrType = attrCatEntry.attrType;
+			range->hash = hash;
+			range->lowOp = NO_BOUND;
+			range->highOp = NO_BOUND;
+		}
+
+		if (range->hash)
+		{
+			// a hash index looks up a single value; the filter checks the others
+			if (range->lowOp == NO_BOUND)
+			{
+				range->lowOp = EQ;
+				range->lowVal = attrVal;
+			}
+			continue;
+		}
+
+		// keep the larger lower bound and the smaller upper bound
+		if (term->op == EQ || term->op == GE || term->op == GT)
+		{
+			int lowOp = (term->op == GT) ? GT : GE;
+			int cmpVal = (range->lowOp == NO_BOUND) ? 1 : compareAttrs(attrVal, range->lowVal, range->attrType);
+			if (cmpVal > 0 || (cmpVal == 0 && lowOp == GT))
+			{
+				range->lowOp = lowOp;
+				range->lowVal = attrVal;
+			}
+		}
+		if (term->op == EQ || term->op == LE || term->op == LT)
+		{
+			int highOp = (term->op == LT) ? LT : LE;
+			int cmpVal = (range->highOp == NO_BOUND) ? -1 : compareAttrs(attrVal, range->highVal, range->attrType);
+			if (cmpVal < 0 || (cmpVal == 0 && highOp == LT))
+			{
+				range->highOp = highOp;
+				range->highVal = attrVal;
+			}
+		}
+	}
+
+	std::stable_sort(ranges->begin(), ranges->end(),
+	                 [](const IndexRange &range1, const IndexRange &range2) { return rangeWidth(range1) < rangeWidth(range2); });
+	return SUCCESS;
+}
+
+/* the RecIds of the records in an index range; FAILURE (and an incomplete
+set) as soon as there are more than maxRecIds of them (-1 for no limit) */
+static int scanRange(int relId, IndexRange *range, int maxRecIds, RecIdBitmap *recIds)
+{
+	recIds->clear();
+	if (range->hash)
+	{
+		std::vector<RecId> hashRecIds;
+		int ret = BlockAccess::findRecIds(relId, range->attr, range->lowVal, EQ, &hashRecIds);
+		if (ret != SUCCESS)
+			return ret;
+		if (maxRecIds != -1 && (int)hashRecIds.size() > maxRecIds)
+			return FAILURE;
+		for (RecId recId : hashRecIds)
+			recIds->add(recId);
+		return SUCCESS;
+	}
+
+	BPlusCursor cursor;
+	int ret = cursor.seek(relId, range->attr, range->lowOp, range->lowVal, range->highOp, range->highVal);
+	if (ret != SUCCESS)
+		return ret;
+	return BlockAccess::collectRecIds(&cursor, recIds, maxRecIds);
+}
+
+/* finds through the indexes of the relation a set of RecIds holding every
+record that satisfies where (the records still have to be filtered), or
+returns E_NOINDEX if the indexes cannot narrow the search.
+- a comparison or an AND: the RecIds of its narrowest index range, intersected
+  with those of its other ranges. Reading a range is given up once it has
+  MAX_KEYS_LEAF RecIds per candidate, since its leaves would then cost more
+  than the record blocks it can save. Without a range, a nested OR is used.
+- an OR: the union of the sets of its terms, each of which needs one. */
+static int findCandidates(int relId, Predicate *where, RecIdBitmap *recIds)
+{
+	recIds->clear();
+	if (where->type == PRED_OR)
+	{
+		for (Predicate &term : where->children)
+		{
+			RecIdBitmap termRecIds;
+			int ret = findCandidates(relId, &term, &termRecIds);
+			if (ret != SUCCESS)
+				return ret;
+			recIds->unite(termRecIds);
+		}
+		return SUCCESS;
+	}
+
+	std::vector<IndexRange> ranges;
+	int ret = indexRanges(relId, where, &ranges);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (ranges.empty())
+	{
+		for (Predicate &term : where->children)
+		{
+			if (term.type == PRED_OR && findCandidates(relId, &term, recIds) == SUCCESS)
+				return SUCCESS;
+		}
+		return E_NOINDEX;
+	}
+
+	ret = scanRange(relId, &ranges[0], -1, recIds);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (int i = 1; i < (int)ranges.size() && recIds->size() > 0; ++i)
+	{
+		RecIdBitmap rangeRecIds;
+		if (scanRange(relId, &ranges[i], recIds->size() * MAX_KEYS_LEAF, &rangeRecIds) != SUCCESS)
+			continue;
+		recIds->intersect(rangeRecIds);
+	}
+	return SUCCESS;
+}
+
+/* builds the operator tree selecting the records of srcRel that satisfy
+where. The tree is returned through `root`; the caller may put more operators
+on top of it before it is executed.
+A condition with AND and OR is answered, depending on the indexes, by
+- a single index range (the comparisons of an AND on one indexed attribute)
+  with the rest of the condition filtered,
+- the RecIds of several index ranges intersected (AND) or united (OR), whose
+  records are fetched in block order and filtered, or
+- a select on one comparison of an AND, or a scan, filtered on the rest. */
+int Algebra::buildSelect(char srcRel[ATTR_SIZE], Predicate *where, Operator **root)
+{
+	int srcRelId = OpenRelTable::getQueryRelId(srcRel);
+	if (srcRelId < 0)
+	{
+		return srcRelId;
+	}
+
+	if (where->type != PRED_COMPARE)
+	{
+		std::vector<IndexRange> ranges;
+		int ret = indexRanges(srcRelId, where, &ranges);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (ranges.size() == 1 && !ranges[0].hash)
+		{
+			IndexRange &range = ranges[0];
+			IndexScanOp *scan = new IndexScanOp(srcRelId, range.attr, range.lowOp, range.lowVal, range.highOp,
+			                                    range.highVal);
+			scan->setBitmapFetch(true);
+			*root = new FilterOp(scan, where);
+			return SUCCESS;
+		}
+
+		RecIdBitmap recIds;
+		ret = findCandidates(srcRelId, where, &recIds);
+		if (ret == SUCCESS)
+		{
+			*root = new FilterOp(new RecIdScanOp(srcRelId, recIds), where);
+			return SUCCESS;
+		}
+		if (ret != E_NOINDEX)
+			return ret;
+
+		// (the select may still skip blocks with a zone map or use a composite index)
+		Operator *scan = nullptr;
+		for (int i = 0; where->type == PRED_AND && scan == nullptr && i < (int)where->children.size(); ++i)
+		{
+			Predicate &term = where->children[i];
+			if (term.type == PRED_COMPARE && term.op != NE)
+			{
+				ret = Algebra::buildSelect(srcRel, &term, &scan);
+				if (ret != SUCCESS)
+					return ret;
+			}
+		}
+		if (scan == nullptr)
+		{
+			ret = Algebra::buildScan(srcRel, &scan);
+			if (ret != SUCCESS)
+				return ret;
+		}
+		*root = new FilterOp(scan, where);
+		return SUCCESS;
+	}
+
+	char *attr = where->attr;
+	int op = where->op;
+
 	AttrCatEntry  attrCatEntry;
 	// get the attribute catalog entry for attr, using AttrCacheTable::getAttrcatEntry()
 	//    return E_ATTRNOTEXIST if it returns the error
@@ -28,114 +327,254 @@ int Algebra::select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], char attr
 		return E_ATTRNOTEXIST;
 	
 	/*** Convert strVal (string) to an attribute of data type NUMBER or STRING ***/
-	int type = attrCatEntry.attrType;
 	Attribute attrVal;
-	if (type == NUMBER)
+	int ret = strToAttribute(where->value, attrCatEntry.attrType, &attrVal);
+	if (ret != SUCCESS)
+		return ret;
+
+	/*** Selecting records from the source relation ***/
+
+	/* A B+ tree on the attribute is scanned by an IndexScanOp (with bitmap
+	fetch, so the records come in block order unless a LIMIT above the select
+	gives it a limit hint), unless a hash index can answer
+	an equality. Otherwise the SelectScanOp reads every record
+	that satisfies the condition using BlockAccess::search(), which does a linear
+	search or uses another index of the attribute. Both keep their own search
+	position, so there is no need to reset the search indexes of the relation here. */
+	HashIndexInfo hashIndex;
+	if (attrCatEntry.rootBlock != -1 &&
+	    !(op == EQ && HashIndex::find(srcRelId, attrCatEntry.offset, &hashIndex) == SUCCESS))
 	{
-		if (isNumber(strVal))
-		{       // the isNumber() function is implemented below
-			attrVal.nVal = atof(strVal);
-		}
-		else
-		{
-			return E_ATTRTYPEMISMATCH;
-		}
+		IndexScanOp *scan = new IndexScanOp(srcRelId, attr, op, attrVal);
+		scan->setBitmapFetch(true);
+		*root = scan;
 	}
-	else if (type == STRING)
+	else
+		*root = new SelectScanOp(srcRelId, attr, op, attrVal);
+	return SUCCESS;
+}
+
+/* builds the operator tree selecting the records of srcRel that satisfy
+where and projecting tar_Attrs out of them. If the condition and the
+projection only use one attribute and it has a B+ tree, the values are read
+straight from the leaves of the index instead of from the record blocks. */
+int Algebra::buildSelect(char srcRel[ATTR_SIZE], Predicate *where, int tar_nAttrs, char tar_Attrs[][ATTR_SIZE],
+                         Operator **root)
+{
+	int ret = Algebra::buildIndexOnlyScan(srcRel, where, tar_nAttrs, tar_Attrs, root);
+	if (ret != E_NOINDEX)
+		return ret;
+
+	ret = Algebra::buildSelect(srcRel, where, root);
+	if (ret != SUCCESS)
+		return ret;
+
+	*root = new ProjectOp(*root, tar_nAttrs, tar_Attrs);
+	return SUCCESS;
+}
+
+/* builds an index-only scan of attr if where is a comparison on attr, or an
+AND of comparisons (other than NE) on attr, every attribute in usedAttrs is
+attr (or "*") and attr is indexed; returns E_NOINDEX if the query is not
+covered by the index, so that the caller can fall back to a select. */
+int Algebra::buildIndexOnlyScan(char srcRel[ATTR_SIZE], Predicate *where, int numUsedAttrs,
+                                char usedAttrs[][ATTR_SIZE], Operator **root)
+{
+	int srcRelId = OpenRelTable::getQueryRelId(srcRel);
+	if (srcRelId < 0)
+		return srcRelId;
+
+	if (where->type == PRED_OR || (where->type == PRED_AND && where->children.empty()))
+		return E_NOINDEX;
+
+	char *attr = (where->type == PRED_COMPARE) ? where->attr : where->children[0].attr;
+	for (Predicate &term : where->children)
 	{
-		strcpy(attrVal.sVal, strVal);
+		if (term.type != PRED_COMPARE || term.op == NE || strcmp(term.attr, attr) != 0)
+			return E_NOINDEX;
 	}
 
-	/*** Selecting records from the source relation ***/
+	AttrCatEntry attrCatEntry;
+	if (AttrCacheTable::getAttrCatEntry(srcRelId, attr, &attrCatEntry) == E_ATTRNOTEXIST)
+		return E_ATTRNOTEXIST;
 
-	// Before calling the search function, reset the search to start from the first hit
-	// using RelCacheTable::resetSearchIndex()
-	//RelCacheTable::resetSearchIndex(crcRelId);
-	
-	RelCatEntry relCatEntry;
-	// get relCatEntry using RelCacheTable::getRelCatEntry()
-	RelCacheTable::getRelCatEntry(srcRelId, &relCatEntry);
-	int src_nAttrs = relCatEntry.numAttrs ;
-	
-	/* let attr_names[src_nAttrs][ATTR_SIZE] be a 2D array of type char
-        (will store the attribute names of rel). */
-        char attr_names[src_nAttrs][ATTR_SIZE];
-    	// let attr_types[src_nAttrs] be an array of type int
-    	int attr_types[src_nAttrs];
-    	
-	/*iterate through 0 to src_nAttrs-1 :
-	get the i'th attribute's AttrCatEntry using AttrCacheTable::getAttrCatEntry()
-	fill the attr_names, attr_types arrays that we declared with the entries
-	of corresponding attributes
-	*/
-	for (int i = 0; i < src_nAttrs; ++i)
+	if (attrCatEntry.rootBlock == -1 || numUsedAttrs == 0)
+		return E_NOINDEX;
+
+	for (int i = 0; i < numUsedAttrs; ++i)
 	{
-		AttrCatEntry attrCatEntry;
-		// get attrCatEntry at offset i using AttrCacheTable::getAttrCatEntry()
-		AttrCacheTable::getAttrCatEntry(srcRelId, i, &attrCatEntry);
+		if (strcmp(usedAttrs[i], attr) != 0 && strcmp(usedAttrs[i], "*") != 0)
+			return E_NOINDEX;
+	}
+
+	if (where->type == PRED_AND)
+	{
+		// the comparisons narrow a single range of the index
+		std::vector<IndexRange> ranges;
+		int ret = indexRanges(srcRelId, where, &ranges);
+		if (ret != SUCCESS)
+			return ret;
 
-		strcpy(attr_names[i],attrCatEntry.attrName);
-		attr_types[i]=attrCatEntry.attrType;
+		IndexRange &range = ranges[0];
+		*root = new IndexOnlyScanOp(srcRelId, attr, range.lowOp, range.lowVal, range.highOp, range.highVal);
+		return SUCCESS;
 	}
-	
+
+	Attribute attrVal;
+	int ret = strToAttribute(where->value, attrCatEntry.attrType, &attrVal);
+	if (ret != SUCCESS)
+		return ret;
+
+	*root = new IndexOnlyScanOp(srcRelId, attr, where->op, attrVal);
+	return SUCCESS;
+}
+
+/* builds the operator tree reading all the records of srcRel */
+int Algebra::buildScan(char srcRel[ATTR_SIZE], Operator **root)
+{
+	int srcRelId = OpenRelTable::getQueryRelId(srcRel);
+
+	// if srcRel is not open in open relation table, return E_RELNOTOPEN
+	if (srcRelId < 0)
+		return srcRelId;
+
+	// the ScanOp fetches the records using BlockAccess::project()
+	*root = new ScanOp(srcRelId);
+	return SUCCESS;
+}
+
+/* Creates the relation targetRel with the output schema of the operator tree
+rooted at `root` and inserts every record produced by the tree into it.
+Only this final result of a pipeline is written to disk. */
+int Algebra::materialize(Operator *root, char targetRel[ATTR_SIZE])
+{
+	int ret = root->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	int nAttrs = root->getNumAttrs();
+
+	// get the attribute names and types of the records produced by the tree
+	char attrNames[nAttrs][ATTR_SIZE];
+	int attrTypes[nAttrs];
+	for (int i = 0; i < nAttrs; ++i)
+	{
+		root->getAttrName(i, attrNames[i]);
+		attrTypes[i] = root->getAttrType(i);
+	}
+
 	/* Create the relation for target relation by calling Schema::createRel()
 	by providing appropriate arguments */
 	// if the createRel returns an error code, then return that value.
-	int ret=Schema::createRel(targetRel, src_nAttrs, attr_names,attr_types);
-	if(ret!=SUCCESS)
+	ret = Schema::createRel(targetRel, nAttrs, attrNames, attrTypes);
+	if (ret != SUCCESS)
+	{
+		root->close();
 		return ret;
-		
+	}
+
 	/* Open the newly created target relation by calling OpenRelTable::openRel()
 	method and store the target relid */
-	int targetRelId=OpenRelTable::openRel(targetRel);
+	int targetRelId = OpenRelTable::openRel(targetRel);
 	/* If opening fails, delete the target relation by calling Schema::deleteRel()
 	and return the error value returned from openRel() */
-	if(targetRelId<0 || targetRelId>=MAX_OPEN)
+	if (targetRelId < 0)
 	{
+		root->close();
 		Schema::deleteRel(targetRel);
 		return targetRelId;
 	}
-	/*** Selecting and inserting records into the target relation ***/
-	/* Before calling the search function, reset the search to start from the
-	first using RelCacheTable::resetSearchIndex() */
-	
-	Attribute record[src_nAttrs];
-	
-	/*
-        The BlockAccess::search() function can either do a linearSearch or
-        a B+ tree search. Hence, reset the search index of the relation in the
-        relation cache using RelCacheTable::resetSearchIndex().
-        Also, reset the search index in the attribute cache for the select
-        condition attribute with name given by the argument `attr`. Use
-        AttrCacheTable::resetSearchIndex().
-        Both these calls are necessary to ensure that search begins from the
-        first record.
-	*/
-	RelCacheTable::resetSearchIndex(srcRelId);
-	AttrCacheTable::resetSearchIndex(srcRelId,attr);
 
-	// read every record that satisfies the condition by repeatedly calling
-	// BlockAccess::search() until there are no more records to be read
-	
-	while (BlockAccess::search(srcRelId, record, attr,attrVal, op)==SUCCESS)
-	{
+	Attribute record[nAttrs];
 
+	// read every record produced by the tree and insert it into the target relation
+	while (root->next(record) == SUCCESS)
+	{
 		ret = BlockAccess::insert(targetRelId, record);
 
-		if (ret!=SUCCESS)
+		if (ret != SUCCESS)
 		{
+			root->close();
 			Schema::closeRel(targetRel);
 			Schema::deleteRel(targetRel);
 			return ret;
 		}
 	}
 
+	root->close();
+
 	// Close the targetRel by calling closeRel() method of schema layer
 	Schema::closeRel(targetRel);
 
 	return SUCCESS;
 }
 
+/* Executes the operator tree rooted at `root` and writes its records as csv
+to the file fileName in the Output_Files directory, or to the console if
+fileName is nullptr. No relation is created for the result. */
+int Algebra::output(Operator *root, char fileName[])
+{
+	int ret = root->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	FILE *fp = stdout;
+	if (fileName != nullptr)
+	{
+		char filePath[strlen(OUTPUT_FILES_PATH) + strlen(fileName) + 1];
+		strcpy(filePath, OUTPUT_FILES_PATH);
+		strcat(filePath, fileName);
+
+		fp = fopen(filePath, "w");
+		if (fp == nullptr)
+		{
+			root->close();
+			return FAILURE;
+		}
+	}
+
+	ResultWriter writer(fp, root);
+	writer.writeHeader();
+
+	Attribute record[root->getNumAttrs()];
+	while (root->next(record) == SUCCESS)
+	{
+		ret = writer.writeRecord(record);
+		if (ret != SUCCESS)
+			break;
+	}
+
+	root->close();
+	if (ret == SUCCESS)
+		ret = writer.flush();
+
+	if (fileName != nullptr)
+		fclose(fp);
+
+	return ret;
+}
+
+/* converts strVal (string) to an attribute of data type NUMBER or STRING */
+int strToAttribute(char strVal[ATTR_SIZE], int type, union Attribute *attrVal)
+{
+	if (type == NUMBER)
+	{
+		if (isNumber(strVal))
+		{       // the isNumber() function is implemented below
+			attrVal->nVal = atof(strVal);
+		}
+		else
+		{
+			return E_ATTRTYPEMISMATCH;
+		}
+	}
+	else if (type == STRING)
+	{
+		strcpy(attrVal->sVal, strVal);
+	}
+	return SUCCESS;
+}
+
 // will return if a string can be parsed as a floating point number
 bool isNumber(char *str)
 {
@@ -160,10 +599,10 @@ int Algebra::insert(char relName[ATTR_SIZE], int nAttrs, char record[][ATTR_SIZE
 	if(strcmp(relName,RELCAT_RELNAME)==0 ||strcmp(relName,ATTRCAT_RELNAME)==0)
 		return E_NOTPERMITTED;
 		
-	int relId = OpenRelTable::getRelId(relName);
+	int relId = OpenRelTable::getQueryRelId(relName);
 
-	if (relId==E_RELNOTOPEN)
-		return E_RELNOTOPEN;
+	if (relId < 0)
+		return relId;
 	// get the relation catalog entry from relation cache
 	// (use RelCacheTable::getRelCatEntry() of Cache Layer)
 	RelCatEntry relcatentry;
@@ -215,195 +654,243 @@ int Algebra::insert(char relName[ATTR_SIZE], int nAttrs, char record[][ATTR_SIZE
 
 }
 
-int Algebra::project(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE])
+/* finds the records of the open relation relId satisfying where (all the
+records if where is nullptr) */
+static int findRecords(int relId, Predicate *where, std::vector<RecId> *recIds)
 {
+	if (where == nullptr)
+		return BlockAccess::findRecIds(relId, nullptr, Attribute(), EQ, recIds);
 
-	int srcRelId = OpenRelTable::getRelId(srcRel);
+	if (where->type == PRED_COMPARE)
+	{
+		AttrCatEntry attrCatEntry;
+		if (AttrCacheTable::getAttrCatEntry(relId, where->attr, &attrCatEntry) != SUCCESS)
+			return E_ATTRNOTEXIST;
 
-	// if srcRel is not open in open relation table, return E_RELNOTOPEN
-	if (srcRelId < 0 || srcRelId >= MAX_OPEN)
-		return E_RELNOTOPEN;
-		
-	RelCatEntry RelCatEntrySrcRel;
-	// get RelCatEntry of srcRel using RelCacheTable::getRelCatEntry()
-	RelCacheTable::getRelCatEntry(srcRelId,&RelCatEntrySrcRel);
-	// get the no. of attributes present in relation from the fetched RelCatEntry.
-	int numAttrs=RelCatEntrySrcRel.numAttrs;
-
-	// attrNames and attrTypes will be used to store the attribute names
-	// and types of the source relation respectively
-	char attrNames[numAttrs][ATTR_SIZE];
-	int attrTypes[numAttrs];
-
-	/*iterate through every attribute of the source relation :
-	- get the AttributeCat entry of the attribute with offset.
-	(using AttrCacheTable::getAttrCatEntry())
-	- fill the arrays `attrNames` and `attrTypes` that we declared earlier
-	with the data about each attribute
-	*/
-	
-	for(int i=0;i<numAttrs;++i)
+		Attribute attrVal;
+		int ret = strToAttribute(where->value, attrCatEntry.attrType, &attrVal);
+		if (ret != SUCCESS)
+			return ret;
+
+		return BlockAccess::findRecIds(relId, where->attr, attrVal, where->op, recIds);
+	}
+
+	// the records found through the indexes (or all of them) are filtered on the condition
+	RecIdBitmap candidates;
+	int ret = findCandidates(relId, where, &candidates);
+	if (ret == E_NOINDEX)
 	{
-		AttrCatEntry AttrCatEntrySrcRel;
-		AttrCacheTable::getAttrCatEntry(srcRelId, i, &AttrCatEntrySrcRel);
-		strcpy(attrNames[i],AttrCatEntrySrcRel.attrName);
-		attrTypes[i]=AttrCatEntrySrcRel.attrType;
+		ret = BlockAccess::findRecIds(relId, nullptr, Attribute(), EQ, recIds);
+		for (RecId recId : *recIds)
+			candidates.add(recId);
 	}
-		
-	/*** Creating and opening the target relation ***/
+	if (ret != SUCCESS)
+		return ret;
+
+	RecIdScanOp *scan = new RecIdScanOp(relId, candidates);
+	FilterOp filter(scan, where);
+	ret = filter.open();
+	if (ret != SUCCESS)
+		return ret;
+
+	recIds->clear();
+	Attribute record[filter.getNumAttrs()];
+	while (filter.next(record) == SUCCESS)
+		recIds->push_back(scan->getRecId());
+	filter.close();
+	return SUCCESS;
+}
+
+int Algebra::deleteFrom(char relName[ATTR_SIZE], Predicate *where, int *numRecords)
+{
+	if(strcmp(relName,RELCAT_RELNAME)==0 ||strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
+
+	int relId = OpenRelTable::getQueryRelId(relName);
+	if (relId < 0)
+		return relId;
 
-	// Create a relation for target relation by calling Schema::createRel()
-	int ret=Schema::createRel(targetRel, numAttrs, attrNames, attrTypes);
-	if(ret!=SUCCESS)
+	// all the matching records are found before the first one is deleted
+	std::vector<RecId> recIds;
+	int ret = findRecords(relId, where, &recIds);
+	if (ret != SUCCESS)
 		return ret;
-	// Open the newly created target relation by calling OpenRelTable::openRel()
-	// and get the target relid
-	int targetrelId=OpenRelTable::openRel(targetRel);
 
-	// If opening fails, delete the target relation by calling Schema::deleteRel() of
-	// return the error value returned from openRel().
-	if(targetrelId<0 || targetrelId>=MAX_OPEN)
+	for (RecId recId : recIds)
 	{
-		Schema::deleteRel(targetRel);
-		return targetrelId;
+		ret = BlockAccess::deleteRecord(relId, recId);
+		if (ret != SUCCESS)
+			return ret;
 	}
 
-	/*** Inserting projected records into the target relation ***/
+	*numRecords = recIds.size();
+	return SUCCESS;
+}
 
-	// Take care to reset the searchIndex before calling the project function
-	// using RelCacheTable::resetSearchIndex()
-	RelCacheTable::resetSearchIndex(srcRelId);
-	Attribute record[numAttrs];
+int Algebra::update(char relName[ATTR_SIZE], int numSetAttrs, char setAttrs[][ATTR_SIZE], char setVals[][ATTR_SIZE],
+                    Predicate *where, int *numRecords)
+{
+	if(strcmp(relName,RELCAT_RELNAME)==0 ||strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
 
+	int relId = OpenRelTable::getQueryRelId(relName);
+	if (relId < 0)
+		return relId;
 
-	while ( BlockAccess::project(srcRelId, record)==SUCCESS)
-	{
-		// record will contain the next record
+	RelCatEntry relCatEntry;
+	RelCacheTable::getRelCatEntry(relId, &relCatEntry);
 
-		ret = BlockAccess::insert(targetrelId, record);
+	// convert the new values to the types of the attributes they are assigned to
+	int setOffsets[numSetAttrs];
+	Attribute newVals[numSetAttrs];
+	for (int i = 0; i < numSetAttrs; ++i)
+	{
+		AttrCatEntry attrCatEntry;
+		if (AttrCacheTable::getAttrCatEntry(relId, setAttrs[i], &attrCatEntry) != SUCCESS)
+			return E_ATTRNOTEXIST;
 
-		if (ret!=SUCCESS)
-		{
-			// close the targetrel by calling Schema::closeRel()
-			Schema::closeRel(targetRel);
-			// delete targetrel by calling Schema::deleteRel()
-			Schema::deleteRel(targetRel);
+		int ret = strToAttribute(setVals[i], attrCatEntry.attrType, &newVals[i]);
+		if (ret != SUCCESS)
 			return ret;
-		}
+		setOffsets[i] = attrCatEntry.offset;
 	}
 
-	// Close the targetRel by calling Schema::closeRel()
-	Schema::closeRel(targetRel);
+	// the records are found first, so a record whose new value still
+	// satisfies the condition is not updated twice
+	std::vector<RecId> recIds;
+	int ret = findRecords(relId, where, &recIds);
+	if (ret != SUCCESS)
+		return ret;
 
-	return SUCCESS;
+	int flag = SUCCESS;
+	Attribute record[relCatEntry.numAttrs];
+	for (RecId recId : recIds)
+	{
+		RecBuffer recBuffer(recId.block);
+		recBuffer.getRecord(record, recId.slot);
+		for (int i = 0; i < numSetAttrs; ++i)
+			record[setOffsets[i]] = newVals[i];
+
+		ret = BlockAccess::updateRecord(relId, recId, record);
+		if (ret == E_INDEX_BLOCKS_RELEASED)
+			flag = ret;
+		else if (ret != SUCCESS)
+			return ret;
+	}
+
+	*numRecords = recIds.size();
+	return flag;
 }
 
-int Algebra::project(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], int tar_nAttrs, char tar_Attrs[][ATTR_SIZE])
+/* sorts the records of the relation on attr with a SortOp, empties the
+relation (keeping its blocks) and inserts the records again in that order, so
+that they fill consecutive blocks. The B+ trees are maintained by the inserts
+and the attribute is recorded in the PrimaryFlag of the attribute catalog. */
+int Algebra::cluster(char relName[ATTR_SIZE], char attr[ATTR_SIZE])
 {
+	if(strcmp(relName,RELCAT_RELNAME)==0 ||strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
 
-	int srcRelId = OpenRelTable::getRelId(srcRel);
+	int relId = OpenRelTable::getQueryRelId(relName);
+	if (relId < 0)
+		return relId;
 
-	// if srcRel is not open in open relation table, return E_RELNOTOPEN
-	if (srcRelId < 0 || srcRelId >= MAX_OPEN)
-		return E_RELNOTOPEN;
-
-	// get RelCatEntry of srcRel using RelCacheTable::getRelCatEntry()
-	RelCatEntry RelCatEntrySrcRel;
-	RelCacheTable::getRelCatEntry(srcRelId,&RelCatEntrySrcRel);
-
-	// get the no. of attributes present in relation from the fetched RelCatEntry.
-	int src_nAttrs= RelCatEntrySrcRel.numAttrs;
-
-	// declare attr_offset[tar_nAttrs] an array of type int.
-	// where i-th entry will store the offset in a record of srcRel for the
-	// i-th attribute in the target relation.
-	int attr_offset[tar_nAttrs];
-
-	// let attr_types[tar_nAttrs] be an array of type int.
-	// where i-th entry will store the type of the i-th attribute in the
-	// target relation.
-	int attr_types[tar_nAttrs];
-
-	/*** Checking if attributes of target are present in the source relation
-	and storing its offsets and types ***/
-
-	/*iterate through 0 to tar_nAttrs-1 :
-	- get the attribute catalog entry of the attribute with name tar_attrs[i].
-	- if the attribute is not found return E_ATTRNOTEXIST
-	- fill the attr_offset, attr_types arrays of target relation from the
-	corresponding attribute catalog entries of source relation
-	*/
-	for(int i=0; i<tar_nAttrs; ++i)
+	AttrCatEntry clusterAttr;
+	if (AttrCacheTable::getAttrCatEntry(relId, attr, &clusterAttr) != SUCCESS)
+		return E_ATTRNOTEXIST;
+
+	RelCatEntry relCatEntry;
+	RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+
+	// the sort reads every record (into memory or sorted runs) in open()
+	char keyAttrs[1][ATTR_SIZE];
+	strcpy(keyAttrs[0], attr);
+	SortOp sorted(new ScanOp(relId), 1, keyAttrs, false, false);
+	int ret = sorted.open();
+	if (ret != SUCCESS)
+		return ret;
+
+	BlockAccess::truncate(relId);
+
+	int flag = SUCCESS;
+	Attribute record[relCatEntry.numAttrs];
+	while (sorted.next(record) == SUCCESS)
 	{
-		AttrCatEntry AttrCatEntrySrcRel;
-		int ret=AttrCacheTable::getAttrCatEntry(srcRelId, tar_Attrs[i], &AttrCatEntrySrcRel);
-		if(ret== E_ATTRNOTEXIST)
+		ret = BlockAccess::insert(relId, record);
+		if (ret == E_INDEX_BLOCKS_RELEASED)
+			flag = ret;
+		else if (ret != SUCCESS)
 			return ret;
-		attr_offset[i]=AttrCatEntrySrcRel.offset;
-		attr_types[i]=AttrCatEntrySrcRel.attrType;
 	}
-	
-	/*** Creating and opening the target relation ***/
+	sorted.close();
 
-	// Create a relation for target relation by calling Schema::createRel()
-	int ret=Schema::createRel(targetRel, tar_nAttrs, tar_Attrs, attr_types);
-	if(ret!=SUCCESS)
-		return ret;
-	// Open the newly created target relation by calling OpenRelTable::openRel()
-	// and get the target relid
-	int targetRelId=OpenRelTable::openRel(targetRel);
-	if(targetRelId<0 || targetRelId>=MAX_OPEN)
+	// release the blocks that were not needed
+	int numBlocksBefore, numBlocksAfter;
+	BlockAccess::compact(relId, &numBlocksBefore, &numBlocksAfter);
+
+	for (int offset = 0; offset < relCatEntry.numAttrs; ++offset)
 	{
-		Schema::deleteRel(targetRel);
-		return targetRelId;
+		AttrCatEntry attrCatEntry;
+		AttrCacheTable::getAttrCatEntry(relId, offset, &attrCatEntry);
+		attrCatEntry.primaryFlag = (offset == clusterAttr.offset);
+		AttrCacheTable::setAttrCatEntry(relId, offset, &attrCatEntry);
 	}
 
-	/*** Inserting projected records into the target relation ***/
+	return flag;
+}
 
-	// Take care to reset the searchIndex before calling the project function
-	// using RelCacheTable::resetSearchIndex()
-	RelCacheTable::resetSearchIndex(srcRelId);
+int Algebra::project(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE])
+{
+	/*** Inserting all the records of the source relation into the target relation ***/
+	Operator *root;
+	int ret = Algebra::buildScan(srcRel, &root);
+	if (ret != SUCCESS)
+		return ret;
 
-	Attribute record[src_nAttrs];
+	ret = Algebra::materialize(root, targetRel);
+	delete root;
 
-	while (BlockAccess::project(srcRelId, record)==SUCCESS)
-	{
-		// the variable `record` will contain the next record
+	return ret;
+}
 
-		Attribute proj_record[tar_nAttrs];
+int Algebra::project(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], int tar_nAttrs, char tar_Attrs[][ATTR_SIZE])
+{
+	Operator *root;
+	int ret = Algebra::buildScan(srcRel, &root);
+	if (ret != SUCCESS)
+		return ret;
 
-		//iterate through 0 to tar_attrs-1:
-		//    proj_record[attr_iter] = record[attr_offset[attr_iter]]
-		for(int i=0; i<tar_nAttrs; ++i)
-		{
-			 proj_record[i] = record[attr_offset[i]];
-		}
-		
+	/*** Inserting projected records into the target relation ***/
 
-		ret = BlockAccess::insert(targetRelId, proj_record);
+	/* the ProjectOp looks up the offsets of the target attributes in the source
+	relation (E_ATTRNOTEXIST if any of them is missing) and copies them out of
+	every record of the scan */
+	root = new ProjectOp(root, tar_nAttrs, tar_Attrs);
 
-		if (ret!=SUCCESS)
-		{
-			// close the targetrel by calling Schema::closeRel()
-			Schema::closeRel(targetRel);
-			// delete targetrel by calling Schema::deleteRel()
-			Schema::deleteRel(targetRel);
-			return ret;
-		}
-	}
-	// Close the targetRel by calling Schema::closeRel()
-	Schema::closeRel(targetRel);
+	ret = Algebra::materialize(root, targetRel);
+	delete root;
 
-	return SUCCESS;
+	return ret;
 }
-int Algebra::join(char srcRelation1[ATTR_SIZE], char srcRelation2[ATTR_SIZE], char targetRelation[ATTR_SIZE], char attribute1[ATTR_SIZE], char attribute2[ATTR_SIZE]){
 
+/* builds the operator tree for srcRelation1 JOIN srcRelation2 on
+attribute1 = attribute2. The tree is returned through `root`; the caller may
+put more operators on top of it before it is executed. */
+int Algebra::buildJoin(char srcRelation1[ATTR_SIZE], char srcRelation2[ATTR_SIZE], char attribute1[ATTR_SIZE],
+                       char attribute2[ATTR_SIZE], Operator **root)
+{
     // get relation1's and relation2's relId
-    int relId1 = OpenRelTable::getRelId(srcRelation1);
-    int relId2 = OpenRelTable::getRelId(srcRelation2);
+    // pin the first relation so that opening the second one cannot evict it
+    int relId1 = OpenRelTable::getQueryRelId(srcRelation1);
+    if(relId1 < 0){
+        return relId1;
+    }
+    OpenRelTable::pinRel(relId1);
+    int relId2 = OpenRelTable::getQueryRelId(srcRelation2);
+    OpenRelTable::unpinRel(relId1);
 
-    if(relId1 < 0 || relId1 >= MAX_OPEN || relId2 < 0 || relId2 >= MAX_OPEN){
-        return E_RELNOTOPEN;
+    if(relId2 < 0){
+        return relId2;
     }
 
     // get attribute catalog entries for the source relations corresponding to their give attributes.
@@ -414,141 +901,630 @@ int Algebra::join(char srcRelation1[ATTR_SIZE], char srcRelation2[ATTR_SIZE], ch
     if(AttrCacheTable::getAttrCatEntry(relId2, attribute2, &attrCatEntry2) == E_ATTRNOTEXIST){
         return E_ATTRNOTEXIST;
     }
-    
+
     // if attribute1 and attribute2 are of different types, return error
     if(attrCatEntry1.attrType != attrCatEntry2.attrType){
         return E_ATTRTYPEMISMATCH;
     }
 
     /*
-        iterate through all the attributes in both the source relation and check if there are
-        any other pair of attributes other than join attributes
-
-        if yes, then return error
+        If srcRelation2 has an index on attribute2, probe it once per record
+        of srcRelation1: O(mlogn) where m = no. of records in relation_1,
+        n = no. of records in relation_2 (O(m) with a hash index, which
+        BlockAccess::search() prefers for the EQ probes).
+
+        Otherwise, without building an index as a side effect, either
+        - sort both relations on the join attributes and merge them:
+          O(mlogm + nlogn), but a sort larger than SORT_MEMORY_BUDGET writes
+          its runs out and reads them back, or
+        - read relation_1 in chunks of the join memory budget and scan
+          relation_2 once per chunk (block nested-loop): O(mn) comparisons,
+          but in a tight loop over an array, and no sorting. The rescans
+          are free while relation_2 fits in the buffer, and cost its blocks
+          once per extra chunk otherwise.
+        The block nested-loop join is used when it transfers fewer blocks
+        than the sorts spill and its comparisons, scaled down by
+        JOIN_LOOP_COMPARE_RATIO, are fewer than those of the sorts.
+
+        All the operators check that no other pair of attributes has the
+        same name (E_DUPLICATEATTR) when the tree is opened.
     */
+    HashIndexInfo hashIndex;
+    if(attrCatEntry2.rootBlock != -1 || HashIndex::find(relId2, attrCatEntry2.offset, &hashIndex) == SUCCESS){
+        *root = new JoinOp(new ScanOp(relId1), relId2, attribute1, attribute2);
+        return SUCCESS;
+    }
+
     RelCatEntry relCatEntry1, relCatEntry2;
     RelCacheTable::getRelCatEntry(relId1, &relCatEntry1);
     RelCacheTable::getRelCatEntry(relId2, &relCatEntry2);
 
-    AttrCatEntry temp1, temp2;
-    for(int j = 0; j < relCatEntry2.numAttrs; j++){
-        if(j == attrCatEntry2.offset){
-            continue;
-        }
+    long long recSize1 = (long long)relCatEntry1.numAttrs * ATTR_SIZE;
+    long long recSize2 = (long long)relCatEntry2.numAttrs * ATTR_SIZE;
+    long long numBlocks1 = (relCatEntry1.numRecs + relCatEntry1.numSlotsPerBlk - 1) / relCatEntry1.numSlotsPerBlk;
+    long long numBlocks2 = (relCatEntry2.numRecs + relCatEntry2.numSlotsPerBlk - 1) / relCatEntry2.numSlotsPerBlk;
+
+    long long sortCost = 0;
+    if(relCatEntry1.numRecs * recSize1 > SORT_MEMORY_BUDGET){
+        sortCost += 2 * numBlocks1;
+    }
+    if(relCatEntry2.numRecs * recSize2 > SORT_MEMORY_BUDGET){
+        sortCost += 2 * numBlocks2;
+    }
 
-        AttrCacheTable::getAttrCatEntry(relId2, j, &temp2);
-        
-        for(int i = 0; i < relCatEntry1.numAttrs; i++){
-            AttrCacheTable::getAttrCatEntry(relId1, i, &temp1);
+    long long chunkRecs = std::max(1LL, Algebra::getJoinMemoryBudget() / recSize1);
+    long long numChunks = (relCatEntry1.numRecs + chunkRecs - 1) / chunkRecs;
+    long long rescanCost = (numBlocks2 <= BUFFER_CAPACITY || numChunks <= 1) ? 0 : (numChunks - 1) * numBlocks2;
 
-            if(strcmp(temp2.attrName, temp1.attrName) == 0){
+    double numRecs1 = relCatEntry1.numRecs, numRecs2 = relCatEntry2.numRecs;
+    double loopCompares = numRecs1 * numRecs2 / JOIN_LOOP_COMPARE_RATIO;
+    double sortCompares = numRecs1 * std::log2(numRecs1 + 1) + numRecs2 * std::log2(numRecs2 + 1);
 
-                return E_DUPLICATEATTR;
-            }
-        }
+    if(rescanCost < sortCost && loopCompares < sortCompares){
+        *root = new BlockNestedLoopJoinOp(new ScanOp(relId1), new ScanOp(relId2), attribute1, attribute2,
+                                          Algebra::getJoinMemoryBudget());
+    }
+    else{
+        *root = new MergeJoinOp(new ScanOp(relId1), new ScanOp(relId2), attribute1, attribute2);
+    }
+    return SUCCESS;
+}
+
+int Algebra::join(char srcRelation1[ATTR_SIZE], char srcRelation2[ATTR_SIZE], char targetRelation[ATTR_SIZE], char attribute1[ATTR_SIZE], char attribute2[ATTR_SIZE]){
+
+    Operator *root;
+    int ret = Algebra::buildJoin(srcRelation1, srcRelation2, attribute1, attribute2, &root);
+    if(ret != SUCCESS){
+        return ret;
     }
 
-    int numOfAttributes1 = relCatEntry1.numAttrs;
-    int numOfAttributes2 = relCatEntry2.numAttrs;
+    // the joined records are inserted into the target relation as they are produced
+    ret = Algebra::materialize(root, targetRelation);
+    delete root;
 
-    /*
-        If srcRelation2 doesn't have an index on attribute2, create index
+    return ret;
+}
 
-        This will reduce time complexity from O(m.n) -> O(mlogn + n)
-        where m = no. of records in relation_1, n = no. of records in relation_2
-    */
-    if(attrCatEntry2.rootBlock == -1){
-        int ret = BPlusTree::bPlusCreate(relId2, attribute2);
-        if(ret != SUCCESS){
-            return E_DISKFULL;
-        }
+/* join followed by project, executed as a single pipeline without a temporary
+relation for the join result */
+int Algebra::join(char srcRelation1[ATTR_SIZE], char srcRelation2[ATTR_SIZE], char targetRelation[ATTR_SIZE],
+                  char attribute1[ATTR_SIZE], char attribute2[ATTR_SIZE], int tar_nAttrs, char tar_Attrs[][ATTR_SIZE]){
+
+    Operator *root;
+    int ret = Algebra::buildJoin(srcRelation1, srcRelation2, attribute1, attribute2, &root);
+    if(ret != SUCCESS){
+        return ret;
     }
 
-    int numOfAttributesInTarget = numOfAttributes1 + numOfAttributes2 - 1;
-    
-    // declaring the following arrays to store the details of the target relation
-    char targetRelAttrNames[numOfAttributesInTarget][ATTR_SIZE];
-    int targetRelAttrTypes[numOfAttributesInTarget];
+    root = new ProjectOp(root, tar_nAttrs, tar_Attrs);
 
-    /*
-        Iterate through all the attributes in both the source relations and update
-        targetRelAttrNames[], targetRelAttrTypes[] arrays excluding attribute2
-    */
-    for(int i = 0; i < numOfAttributes1; i++){
-        AttrCacheTable::getAttrCatEntry(relId1, i, &temp1);
-        strcpy(targetRelAttrNames[i], temp1.attrName);
-        targetRelAttrTypes[i] = temp1.attrType;
+    ret = Algebra::materialize(root, targetRelation);
+    delete root;
+
+    return ret;
+}
+
+/* builds the semi-join (anti = false) or anti-join (anti = true) of
+srcRelation1 with srcRelation2 on attribute1 = attribute2: every record of
+srcRelation1 that has (or does not have) a matching record in srcRelation2,
+once. Unlike a join followed by a projection back to srcRelation1, the records
+are never widened with the attributes of srcRelation2 and no duplicates have
+to be removed. */
+int Algebra::buildSemiJoin(char srcRelation1[ATTR_SIZE], char srcRelation2[ATTR_SIZE], char attribute1[ATTR_SIZE],
+                           char attribute2[ATTR_SIZE], bool anti, Operator **root)
+{
+    // pin the first relation so that opening the second one cannot evict it
+    int relId1 = OpenRelTable::getQueryRelId(srcRelation1);
+    if(relId1 < 0){
+        return relId1;
+    }
+    OpenRelTable::pinRel(relId1);
+    int relId2 = OpenRelTable::getQueryRelId(srcRelation2);
+    OpenRelTable::unpinRel(relId1);
+
+    if(relId2 < 0){
+        return relId2;
+    }
+
+    AttrCatEntry attrCatEntry1, attrCatEntry2;
+    if(AttrCacheTable::getAttrCatEntry(relId1, attribute1, &attrCatEntry1) == E_ATTRNOTEXIST){
+        return E_ATTRNOTEXIST;
     }
-    for(int j = 0; j < attrCatEntry2.offset; j++){
-        AttrCacheTable::getAttrCatEntry(relId2, j, &temp2);
-        strcpy(targetRelAttrNames[numOfAttributes1 + j], temp2.attrName);
-        targetRelAttrTypes[numOfAttributes1 + j] = temp2.attrType;
+    if(AttrCacheTable::getAttrCatEntry(relId2, attribute2, &attrCatEntry2) == E_ATTRNOTEXIST){
+        return E_ATTRNOTEXIST;
     }
-    for(int j = attrCatEntry2.offset + 1; j < numOfAttributes2; j++){
-        AttrCacheTable::getAttrCatEntry(relId2, j, &temp2);
-        strcpy(targetRelAttrNames[numOfAttributes1 + j - 1], temp2.attrName);
-        targetRelAttrTypes[numOfAttributes1 + j - 1] = temp2.attrType;
+    if(attrCatEntry1.attrType != attrCatEntry2.attrType){
+        return E_ATTRTYPEMISMATCH;
     }
 
-    // create the target relation
-    int ret = Schema::createRel(targetRelation, numOfAttributesInTarget, targetRelAttrNames, targetRelAttrTypes);
+    /*
+        Probing an index of srcRelation2 costs about one leaf block per record
+        of srcRelation1 (the upper levels stay in the buffer), while hashing the
+        keys of srcRelation2 reads each of its blocks once. So the index is only
+        probed for fewer outer records than there are inner blocks.
+    */
+    RelCatEntry relCatEntry1, relCatEntry2;
+    RelCacheTable::getRelCatEntry(relId1, &relCatEntry1);
+    RelCacheTable::getRelCatEntry(relId2, &relCatEntry2);
+    int numBlocks2 = (relCatEntry2.numRecs + relCatEntry2.numSlotsPerBlk - 1) / relCatEntry2.numSlotsPerBlk;
+    bool probeIndex = relCatEntry1.numRecs < numBlocks2;
+
+    *root = new SemiJoinOp(new ScanOp(relId1), relId2, attribute1, attribute2, anti, probeIndex);
+    return SUCCESS;
+}
+
+int Algebra::semiJoin(char srcRelation1[ATTR_SIZE], char srcRelation2[ATTR_SIZE], char targetRelation[ATTR_SIZE],
+                      char attribute1[ATTR_SIZE], char attribute2[ATTR_SIZE], bool anti, int tar_nAttrs,
+                      char tar_Attrs[][ATTR_SIZE]){
+
+    Operator *root;
+    int ret = Algebra::buildSemiJoin(srcRelation1, srcRelation2, attribute1, attribute2, anti, &root);
     if(ret != SUCCESS){
         return ret;
     }
 
-    // open and get targetRelation id
-    int targetRelId = OpenRelTable::openRel(targetRelation);
-    if(targetRelId < 0 || targetRelId >= MAX_OPEN){
-        // delete the relation
-        Schema::deleteRel(targetRelation);
-        return targetRelId;
+    if(tar_nAttrs > 0){
+        root = new ProjectOp(root, tar_nAttrs, tar_Attrs);
+    }
+
+    ret = Algebra::materialize(root, targetRelation);
+    delete root;
+
+    return ret;
+}
+
+/* estimated number of distinct values of an attribute of an open relation
+with numRecs records: numRecs, or for a NUMBER attribute holding integers the
+width of its range when the B+ tree or the zone map of the relation knows it */
+static double distinctValues(int relId, AttrCatEntry *attrCatEntry, double numRecs)
+{
+    double numValues = std::max(numRecs, 1.0);
+    if(attrCatEntry->attrType != NUMBER){
+        return numValues;
+    }
+
+    Attribute min, max;
+    bool found = false;
+    if(attrCatEntry->rootBlock != -1){
+        found = BPlusTree::bPlusMin(relId, attrCatEntry->attrName, &min) == SUCCESS &&
+                BPlusTree::bPlusMax(relId, attrCatEntry->attrName, &max) == SUCCESS;
+    }
+    ZoneMap *zoneMap = ZoneMap::get(attrCatEntry->relName);
+    if(!found && zoneMap != nullptr){
+        found = zoneMap->getRange(attrCatEntry->offset, &min, &max) == SUCCESS;
+    }
+
+    if(found && min.nVal == std::floor(min.nVal) && max.nVal == std::floor(max.nVal)){
+        numValues = std::min(numValues, max.nVal - min.nVal + 1);
+    }
+    return numValues;
+}
+
+// a relation of a multi-way join
+struct JoinRelation {
+    int relId;
+    double numRecs;
+    double numBlocks;
+    int numAttrs;
+};
+
+// the condition rel1.attr1 = rel2.attr2 of a multi-way join
+struct JoinEdge {
+    int rel1;
+    int rel2;
+    AttrCatEntry attr1;
+    AttrCatEntry attr2;
+    double distinct1;
+    double distinct2;
+};
+
+enum JoinMethod { JOIN_SCAN, JOIN_HASH, JOIN_INDEX, JOIN_MERGE };
+
+// the cheapest left-deep plan found for a set of relations
+struct JoinPlan {
+    double cost;  // estimated block transfers, -1 if the set has no plan yet
+    double numRecs;  // estimated records in the result
+    int numAttrs;
+    int prevSet;  // the set this plan extends by joining rel (-1 if rel is scanned alone)
+    int rel;
+    int edge;
+    int method;
+};
+
+// blocks taken by numRecs records of numAttrs attributes
+static double recordBlocks(double numRecs, int numAttrs)
+{
+    return std::ceil(numRecs * numAttrs * ATTR_SIZE / BLOCK_SIZE);
+}
+
+// blocks a sort writes out and reads back when its input exceeds SORT_MEMORY_BUDGET
+static double sortSpill(double numRecs, int numAttrs)
+{
+    if(numRecs * numAttrs * ATTR_SIZE <= SORT_MEMORY_BUDGET){
+        return 0;
+    }
+    return 2 * recordBlocks(numRecs, numAttrs);
+}
+
+/* extends the plan for a set of relations by joining the relation rel on edge,
+choosing the join method; returns the new plan */
+static JoinPlan extendPlan(JoinPlan &plan, int set, JoinRelation &rel, int relIndex, JoinEdge &edge, int edgeIndex)
+{
+    bool relIsFirst = (edge.rel1 == relIndex);
+    AttrCatEntry &innerAttr = relIsFirst ? edge.attr1 : edge.attr2;
+    double innerDistinct = relIsFirst ? edge.distinct1 : edge.distinct2;
+    double outerDistinct = std::min(relIsFirst ? edge.distinct2 : edge.distinct1, std::max(plan.numRecs, 1.0));
+
+    JoinPlan next;
+    next.prevSet = set;
+    next.rel = relIndex;
+    next.edge = edgeIndex;
+    next.numAttrs = plan.numAttrs + rel.numAttrs - 1;
+    next.numRecs = plan.numRecs * rel.numRecs / std::max(innerDistinct, outerDistinct);
+
+    // hash join: the relation is read once per chunk of the join memory
+    // budget, and the plan so far is run again for every chunk after the first
+    double chunkRecs = std::max(1, Algebra::getJoinMemoryBudget() / (rel.numAttrs * ATTR_SIZE));
+    double numChunks = std::max(1.0, std::ceil(rel.numRecs / chunkRecs));
+    next.method = JOIN_HASH;
+    next.cost = numChunks * plan.cost + rel.numBlocks;
+
+    // index join: a leaf (or bucket) and the matching record blocks per
+    // outer record, unless the relation stays in the buffer
+    HashIndexInfo hashIndex;
+    if(innerAttr.rootBlock != -1 || HashIndex::find(rel.relId, innerAttr.offset, &hashIndex) == SUCCESS){
+        double probeBlocks = 1 + rel.numRecs / innerDistinct;
+        double indexCost = plan.cost;
+        indexCost += (rel.numBlocks <= BUFFER_CAPACITY) ? rel.numBlocks : plan.numRecs * probeBlocks;
+        if(indexCost < next.cost){
+            next.method = JOIN_INDEX;
+            next.cost = indexCost;
+        }
     }
 
-    Attribute record1[numOfAttributes1];
-    Attribute record2[numOfAttributes2];
-    Attribute targetRecord[numOfAttributesInTarget];
+    // merge join: both inputs are sorted
+    double mergeCost = plan.cost + rel.numBlocks + sortSpill(plan.numRecs, plan.numAttrs) +
+                       sortSpill(rel.numRecs, rel.numAttrs);
+    if(mergeCost < next.cost){
+        next.method = JOIN_MERGE;
+        next.cost = mergeCost;
+    }
 
-    RelCacheTable::resetSearchIndex(relId1);
+    // the records of the result pass up the pipeline
+    next.cost += recordBlocks(next.numRecs, next.numAttrs);
+    return next;
+}
 
-    // outer while loop to get all the records from srcRelation1 one by one
-    while(BlockAccess::project(relId1, record1) == SUCCESS){
+/* builds the operator tree of a multi-way join: relNames[0] joined with
+relNames[1] ... relNames[numRels - 1], where relNames[k + 1] is joined on
+leftRels[k].leftAttrs[k] = relNames[k + 1].rightAttrs[k] and leftRels[k] is one
+of the relations before it. The result has the attributes of the relations in
+the order of relNames, without each rightAttrs[k] (as in a binary join).
+
+With reorder set, the relations are joined in the left-deep order of least
+estimated cost, found by dynamic programming over the sets of relations; only
+orders that join along a condition are considered (no cross products). The
+size of a join is estimated from #Records and the number of distinct values
+of the join attributes (see distinctValues()), and every join uses the
+cheapest of a hash join, an index join (JoinOp, if the relation added has a
+B+ tree or a hash index on its attribute) and a merge join. The joins are
+pipelined, so no intermediate result is stored in a relation. If plan is not
+nullptr, the chosen plan is described in it. */
+int Algebra::buildMultiJoin(int numRels, char relNames[][ATTR_SIZE], char leftRels[][ATTR_SIZE],
+                            char leftAttrs[][ATTR_SIZE], char rightAttrs[][ATTR_SIZE], bool reorder,
+                            Operator **root, std::string *plan)
+{
+    if(numRels < 2){
+        return E_INVALID;
+    }
+    if(numRels > MAX_OPEN){
+        return E_CACHEFULL;
+    }
+
+    // open every relation, pinning each one so that opening the next cannot evict it
+    std::vector<JoinRelation> rels(numRels);
+    int ret = SUCCESS;
+    int numPinned = 0;
+    for(int i = 0; i < numRels; ++i){
+        int relId = OpenRelTable::getQueryRelId(relNames[i]);
+        if(relId < 0){
+            ret = relId;
+            break;
+        }
+        OpenRelTable::pinRel(relId);
+        numPinned++;
+
+        RelCatEntry relCatEntry;
+        RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+        rels[i].relId = relId;
+        rels[i].numRecs = relCatEntry.numRecs;
+        rels[i].numBlocks = std::ceil((double)relCatEntry.numRecs / relCatEntry.numSlotsPerBlk);
+        rels[i].numAttrs = relCatEntry.numAttrs;
+    }
 
-        // reset search index for srcRelation2, cause for every record in srcRelation1, we start from beginning
-        RelCacheTable::resetSearchIndex(relId2);
+    // the conditions: condition k joins relNames[k + 1] with a relation before it
+    std::vector<JoinEdge> edges(numRels - 1);
+    for(int k = 0; k + 1 < numRels && ret == SUCCESS; ++k){
+        JoinEdge &edge = edges[k];
+        edge.rel1 = -1;
+        for(int i = 0; i <= k; ++i){
+            if(strcmp(relNames[i], leftRels[k]) == 0){
+                edge.rel1 = i;
+            }
+        }
+        edge.rel2 = k + 1;
+        if(edge.rel1 == -1){
+            ret = E_RELNOTEXIST;
+            break;
+        }
+
+        if(AttrCacheTable::getAttrCatEntry(rels[edge.rel1].relId, leftAttrs[k], &edge.attr1) != SUCCESS ||
+           AttrCacheTable::getAttrCatEntry(rels[edge.rel2].relId, rightAttrs[k], &edge.attr2) != SUCCESS){
+            ret = E_ATTRNOTEXIST;
+            break;
+        }
+        if(edge.attr1.attrType != edge.attr2.attrType){
+            ret = E_ATTRTYPEMISMATCH;
+            break;
+        }
+        edge.distinct1 = distinctValues(rels[edge.rel1].relId, &edge.attr1, rels[edge.rel1].numRecs);
+        edge.distinct2 = distinctValues(rels[edge.rel2].relId, &edge.attr2, rels[edge.rel2].numRecs);
+    }
+
+    // the attributes of the result, which must all have different names
+    std::vector<std::string> outputNames;
+    for(int i = 0; i < numRels && ret == SUCCESS; ++i){
+        for(int offset = 0; offset < rels[i].numAttrs; ++offset){
+            AttrCatEntry attrCatEntry;
+            AttrCacheTable::getAttrCatEntry(rels[i].relId, offset, &attrCatEntry);
+            if(i > 0 && strcmp(attrCatEntry.attrName, rightAttrs[i - 1]) == 0){
+                continue;
+            }
+
+            std::string name = attrCatEntry.attrName;
+            if(std::find(outputNames.begin(), outputNames.end(), name) != outputNames.end()){
+                ret = E_DUPLICATEATTR;
+                break;
+            }
+            outputNames.push_back(name);
+        }
+    }
+
+    if(ret != SUCCESS){
+        for(int i = 0; i < numPinned; ++i){
+            OpenRelTable::unpinRel(rels[i].relId);
+        }
+        return ret;
+    }
 
-        // reset search index for attribute2, cause we want record with whose attribute2 matches with attribute1
-        AttrCacheTable::resetSearchIndex(relId2, attribute2);
+    // best[set] is the cheapest plan joining the relations in the bit set
+    int fullSet = (1 << numRels) - 1;
+    std::vector<JoinPlan> best(fullSet + 1);
+    for(int set = 0; set <= fullSet; ++set){
+        best[set].cost = -1;
+    }
+    for(int i = 0; i < numRels; ++i){
+        if(!reorder && i > 0){
+            break;
+        }
+        JoinPlan &single = best[1 << i];
+        single.cost = rels[i].numBlocks;
+        single.numRecs = rels[i].numRecs;
+        single.numAttrs = rels[i].numAttrs;
+        single.prevSet = -1;
+        single.rel = i;
+        single.edge = -1;
+        single.method = JOIN_SCAN;
+    }
 
-        /*
-            inner loop will get every record of srcRelation2 which satisfy the following condition:
-            record1.attribute1 = record2.attribute2
-        */
-        while(BlockAccess::search(relId2, record2, attribute2, record1[attrCatEntry1.offset], EQ) == SUCCESS){
-            /*
-                copy srcRelation1's anf srcRelation2's attribute values (except for attribute2 in rel2) from record1
-                and record2 to targetRecord
-            */
-            for(int i = 0; i < numOfAttributes1; i++){
-                targetRecord[i] = record1[i];
+    // a set is always smaller than the sets extending it
+    for(int set = 1; set < fullSet; ++set){
+        if(best[set].cost < 0){
+            continue;
+        }
+        for(int r = 0; r < numRels; ++r){
+            if((set & (1 << r)) || (!reorder && set != (1 << r) - 1)){
+                continue;
             }
-            for(int i = 0; i < attrCatEntry2.offset; i++){
-                targetRecord[numOfAttributes1 + i] = record2[i];
+
+            // the conditions form a tree, so at most one of them joins r with the set
+            int e = 0;
+            while(e < numRels - 1 && !((edges[e].rel1 == r && (set & (1 << edges[e].rel2))) ||
+                                       (edges[e].rel2 == r && (set & (1 << edges[e].rel1))))){
+                e++;
             }
-            for(int i = attrCatEntry2.offset + 1; i < numOfAttributes2; i++){
-                targetRecord[numOfAttributes1 + i - 1] = record2[i];
+            if(e == numRels - 1){
+                continue;
             }
 
-            // insert the currnt record into the target relation
-            ret = BlockAccess::insert(targetRelId, targetRecord);
-            if(ret != SUCCESS){
-                OpenRelTable::closeRel(targetRelId);
-                Schema::deleteRel(targetRelation);
-                return E_DISKFULL;
+            JoinPlan next = extendPlan(best[set], set, rels[r], r, edges[e], e);
+            JoinPlan &current = best[set | (1 << r)];
+            if(current.cost < 0 || next.cost < current.cost){
+                current = next;
             }
         }
     }
 
-    OpenRelTable::closeRel(targetRelId);
+    // the joins of the plan, first to last
+    std::vector<int> sets;
+    for(int set = fullSet; set != -1; set = best[set].prevSet){
+        sets.insert(sets.begin(), set);
+    }
+
+    /*
+        A join drops the attribute of the relation it adds, and keeps the
+        equal one of the records joined so far; dropped[] maps the name of
+        every dropped attribute to the one kept, so that later conditions and
+        the result can still refer to it.
+    */
+    std::unordered_map<std::string, std::string> dropped;
+    auto keptName = [&dropped](std::string name){
+        auto it = dropped.find(name);
+        while(it != dropped.end()){
+            name = it->second;
+            it = dropped.find(name);
+        }
+        return name;
+    };
+
+    const char *methodNames[] = {"scan", "hash join", "index join", "merge join"};
+    JoinPlan &first = best[sets[0]];
+    Operator *op = new ScanOp(rels[first.rel].relId);
+    if(plan != nullptr){
+        *plan = relNames[first.rel];
+    }
+    for(int s = 1; s < (int)sets.size(); ++s){
+        JoinPlan &step = best[sets[s]];
+        JoinEdge &edge = edges[step.edge];
+        AttrCatEntry &innerAttr = (edge.rel1 == step.rel) ? edge.attr1 : edge.attr2;
+        AttrCatEntry &outerAttr = (edge.rel1 == step.rel) ? edge.attr2 : edge.attr1;
+        int innerRelId = rels[step.rel].relId;
+
+        char outerName[ATTR_SIZE];
+        strcpy(outerName, keptName(outerAttr.attrName).c_str());
+        if(step.method == JOIN_INDEX){
+            op = new JoinOp(op, innerRelId, outerName, innerAttr.attrName);
+        }
+        else if(step.method == JOIN_HASH){
+            op = new HashJoinOp(op, new ScanOp(innerRelId), outerName, innerAttr.attrName,
+                                Algebra::getJoinMemoryBudget());
+        }
+        else{
+            op = new MergeJoinOp(op, new ScanOp(innerRelId), outerName, innerAttr.attrName);
+        }
+        if(strcmp(outerName, innerAttr.attrName) != 0){
+            dropped[innerAttr.attrName] = outerName;
+        }
+
+        if(plan != nullptr){
+            *plan += std::string(", ") + relNames[step.rel] + " (" + methodNames[step.method] + " on " +
+                     outerName + " = " + innerAttr.attrName + ")";
+        }
+    }
+
+    // restore the attributes of the result to the order of relNames, under their own names
+    int numOutputAttrs = outputNames.size();
+    char keptNames[numOutputAttrs][ATTR_SIZE];
+    char names[numOutputAttrs][ATTR_SIZE];
+    for(int i = 0; i < numOutputAttrs; ++i){
+        strcpy(names[i], outputNames[i].c_str());
+        strcpy(keptNames[i], keptName(outputNames[i]).c_str());
+    }
+    *root = new ProjectOp(op, numOutputAttrs, keptNames, names);
+
+    // the operators hold their own pins
+    for(int i = 0; i < numRels; ++i){
+        OpenRelTable::unpinRel(rels[i].relId);
+    }
     return SUCCESS;
 }
 
+int Algebra::multiJoin(int numRels, char relNames[][ATTR_SIZE], char leftRels[][ATTR_SIZE],
+                       char leftAttrs[][ATTR_SIZE], char rightAttrs[][ATTR_SIZE], char targetRelation[ATTR_SIZE],
+                       int tar_nAttrs, char tar_Attrs[][ATTR_SIZE]){
+
+    Operator *root;
+    int ret = Algebra::buildMultiJoin(numRels, relNames, leftRels, leftAttrs, rightAttrs, true, &root);
+    if(ret != SUCCESS){
+        return ret;
+    }
+
+    if(tar_nAttrs > 0){
+        root = new ProjectOp(root, tar_nAttrs, tar_Attrs);
+    }
+
+    ret = Algebra::materialize(root, targetRelation);
+    delete root;
+
+    return ret;
+}
+
+/* builds the operator tree computing aggregates over srcRel (optionally
+restricted by the condition where, nullptr when there is none)
+grouped by groupAttrs. The select list has numItems entries: an aggregate
+function (AGG_COUNT ... AGG_MAX) over itemAttrs[i] ("*" for COUNT), or a plain
+group attribute when itemFuncs[i] is -1. The output follows the select list. */
+int Algebra::buildAggregate(char srcRel[ATTR_SIZE], Predicate *where, int numGroupAttrs, char groupAttrs[][ATTR_SIZE],
+                            int numItems, int itemFuncs[], char itemAttrs[][ATTR_SIZE], Operator **root)
+{
+	int srcRelId = OpenRelTable::getQueryRelId(srcRel);
+	if (srcRelId < 0)
+		return srcRelId;
+
+	// split the select list into the aggregates and the plain attributes
+	int numAggs = 0;
+	int aggFuncs[numItems];
+	char aggAttrs[numItems][ATTR_SIZE];
+	char outAttrs[numItems][ATTR_SIZE];
+	bool indexOnly = (where == nullptr && numGroupAttrs == 0);
+
+	for (int i = 0; i < numItems; ++i)
+	{
+		if (itemFuncs[i] < 0)
+		{
+			// a plain attribute in the select list must be one of the group attributes
+			bool grouped = false;
+			for (int j = 0; j < numGroupAttrs; ++j)
+				grouped = grouped || strcmp(itemAttrs[i], groupAttrs[j]) == 0;
+			if (!grouped)
+				return E_INVALID;
+
+			strcpy(outAttrs[i], itemAttrs[i]);
+			continue;
+		}
+
+		aggFuncs[numAggs] = itemFuncs[i];
+		strcpy(aggAttrs[numAggs], itemAttrs[i]);
+		aggregateName(itemFuncs[i], itemAttrs[i], outAttrs[i]);
+		numAggs++;
+
+		/* COUNT, and MIN / MAX of an indexed attribute, over a whole relation
+		can be read from the catalog and the B+ trees without a scan */
+		if (itemFuncs[i] == AGG_MIN || itemFuncs[i] == AGG_MAX)
+		{
+			AttrCatEntry attrCatEntry;
+			if (AttrCacheTable::getAttrCatEntry(srcRelId, itemAttrs[i], &attrCatEntry) != SUCCESS ||
+			    attrCatEntry.rootBlock == -1)
+				indexOnly = false;
+		}
+		else if (itemFuncs[i] != AGG_COUNT)
+		{
+			indexOnly = false;
+		}
+	}
+
+	if (indexOnly)
+	{
+		*root = new IndexAggregateOp(srcRelId, numAggs, aggFuncs, aggAttrs);
+	}
+	else
+	{
+		/* if the condition, the groups and the aggregates only use the
+		attribute of the condition, the records are not needed: the values
+		come from the index of that attribute */
+		int numUsedAttrs = numGroupAttrs + numAggs;
+		char usedAttrs[numUsedAttrs][ATTR_SIZE];
+		for (int i = 0; i < numGroupAttrs; ++i)
+			strcpy(usedAttrs[i], groupAttrs[i]);
+		for (int i = 0; i < numAggs; ++i)
+			strcpy(usedAttrs[numGroupAttrs + i], aggAttrs[i]);
+
+		int ret;
+		if (where == nullptr)
+			ret = Algebra::buildScan(srcRel, root);
+		else
+		{
+			ret = Algebra::buildIndexOnlyScan(srcRel, where, numUsedAttrs, usedAttrs, root);
+			if (ret == E_NOINDEX)
+				ret = Algebra::buildSelect(srcRel, where, root);
+		}
+		if (ret != SUCCESS)
+			return ret;
+
+		*root = new AggregateOp(*root, numGroupAttrs, groupAttrs, numAggs, aggFuncs, aggAttrs);
+	}
+
+	// order the output like the select list
+	*root = new ProjectOp(*root, numItems, outAttrs);
+	return SUCCESS;
+}
@@ -3,6 +3,7 @@
 
 #include "../Cache/OpenRelTable.h"
 #include "../Schema/Schema.h"
+#include "Operator.h"
 #include "../define/constants.h"
 
 class Algebra {
@@ -10,8 +11,20 @@ class Algebra {
   // Insert
   static int insert(char relName[ATTR_SIZE], int numberOfAttributes, char record[][ATTR_SIZE]);
 
+  // Delete / Update (where = nullptr affects every record); the number of records changed is returned in *numRecords
+  static int deleteFrom(char relName[ATTR_SIZE], Predicate *where, int *numRecords);
+  static int update(char relName[ATTR_SIZE], int numSetAttrs, char setAttrs[][ATTR_SIZE], char setVals[][ATTR_SIZE],
+                    Predicate *where, int *numRecords);
+
+  // Cluster: rewrite the records of the relation in the order of attr
+  static int cluster(char relName[ATTR_SIZE], char attr[ATTR_SIZE]);
+
   // Select
-  static int select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], char attr[ATTR_SIZE], int op, char strVal[ATTR_SIZE]);
+  static int select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], Predicate *where);
+
+  // Select + Project (pipelined)
+  static int select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], int tar_nAttrs, char tar_Attrs[][ATTR_SIZE],
+                    Predicate *where);
 
   // Project all (Copy)
   static int project(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE]);
@@ -22,6 +35,52 @@ class Algebra {
   // Join
   static int join(char srcRelOne[ATTR_SIZE], char srcRelTwo[ATTR_SIZE], char targetRel[ATTR_SIZE],
                   char attrOne[ATTR_SIZE], char attrTwo[ATTR_SIZE]);
+
+  // Join + Project (pipelined)
+  static int join(char srcRelOne[ATTR_SIZE], char srcRelTwo[ATTR_SIZE], char targetRel[ATTR_SIZE],
+                  char attrOne[ATTR_SIZE], char attrTwo[ATTR_SIZE], int tar_nAttrs, char tar_Attrs[][ATTR_SIZE]);
+
+  // Semi-join / anti-join: the records of srcRelOne with (anti: without) a match in srcRelTwo;
+  // tar_nAttrs = 0 keeps all the attributes
+  static int semiJoin(char srcRelOne[ATTR_SIZE], char srcRelTwo[ATTR_SIZE], char targetRel[ATTR_SIZE],
+                      char attrOne[ATTR_SIZE], char attrTwo[ATTR_SIZE], bool anti, int tar_nAttrs,
+                      char tar_Attrs[][ATTR_SIZE]);
+
+  // Multi-way join: relNames[k + 1] is joined on leftRels[k].leftAttrs[k] = relNames[k + 1].rightAttrs[k],
+  // in the order of least estimated cost; tar_nAttrs = 0 keeps all the attributes
+  static int multiJoin(int numRels, char relNames[][ATTR_SIZE], char leftRels[][ATTR_SIZE],
+                       char leftAttrs[][ATTR_SIZE], char rightAttrs[][ATTR_SIZE], char targetRel[ATTR_SIZE],
+                       int tar_nAttrs, char tar_Attrs[][ATTR_SIZE]);
+
+  // Build operator trees (the caller executes and deletes them)
+  static int buildScan(char srcRel[ATTR_SIZE], Operator **root);
+  static int buildSelect(char srcRel[ATTR_SIZE], Predicate *where, Operator **root);
+  static int buildSelect(char srcRel[ATTR_SIZE], Predicate *where, int tar_nAttrs, char tar_Attrs[][ATTR_SIZE],
+                         Operator **root);
+  static int buildIndexOnlyScan(char srcRel[ATTR_SIZE], Predicate *where, int numUsedAttrs,
+                                char usedAttrs[][ATTR_SIZE], Operator **root);
+  static int buildJoin(char srcRelOne[ATTR_SIZE], char srcRelTwo[ATTR_SIZE], char attrOne[ATTR_SIZE],
+                       char attrTwo[ATTR_SIZE], Operator **root);
+  static int buildSemiJoin(char srcRelOne[ATTR_SIZE], char srcRelTwo[ATTR_SIZE], char attrOne[ATTR_SIZE],
+                           char attrTwo[ATTR_SIZE], bool anti, Operator **root);
+  static int buildMultiJoin(int numRels, char relNames[][ATTR_SIZE], char leftRels[][ATTR_SIZE],
+                            char leftAttrs[][ATTR_SIZE], char rightAttrs[][ATTR_SIZE], bool reorder,
+                            Operator **root, std::string *plan = nullptr);
+  static int buildAggregate(char srcRel[ATTR_SIZE], Predicate *where, int numGroupAttrs, char groupAttrs[][ATTR_SIZE],
+                            int numItems, int itemFuncs[], char itemAttrs[][ATTR_SIZE], Operator **root);
+
+  // Execute an operator tree and store its result in a new relation
+  static int materialize(Operator *root, char targetRel[ATTR_SIZE]);
+
+  // Execute an operator tree and write its result to a csv file (or the console if fileName is nullptr)
+  static int output(Operator *root, char fileName[]);
+
+  // Bytes of records a join holds in memory (JOIN_MEMORY_BUDGET until SET JOIN MEMORY changes it)
+  static void setJoinMemoryBudget(int numBytes);
+  static int getJoinMemoryBudget();
+
+ private:
+  static int joinMemoryBudget;
 };
 
 #endif  // NITCBASE_ALGEBRA_H
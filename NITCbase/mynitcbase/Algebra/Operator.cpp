@@ -0,0 +1,2107 @@
+#include "Operator.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+int strToAttribute(char strVal[ATTR_SIZE], int type, union Attribute *attrVal);
+
+// returns true if a comparison result `cmpVal` satisfies the operator `op`
+int satisfiesOp(int cmpVal, int op)
+{
+	return (op == NE && cmpVal != 0) ||
+	       (op == LT && cmpVal < 0) ||
+	       (op == LE && cmpVal <= 0) ||
+	       (op == EQ && cmpVal == 0) ||
+	       (op == GT && cmpVal > 0) ||
+	       (op == GE && cmpVal >= 0);
+}
+
+// the condition `attrName op value`
+Predicate comparison(char attrName[ATTR_SIZE], int op, char value[ATTR_SIZE])
+{
+	Predicate pred;
+	pred.type = PRED_COMPARE;
+	strcpy(pred.attr, attrName);
+	pred.op = op;
+	strcpy(pred.value, value);
+	return pred;
+}
+
+/************ Operator ************/
+
+int Operator::getNumAttrs()
+{
+	return schema.size();
+}
+
+int Operator::getAttrType(int attrOffset)
+{
+	if (attrOffset < 0 || attrOffset >= (int)schema.size())
+		return E_OUTOFBOUND;
+	return schema[attrOffset].attrType;
+}
+
+int Operator::getAttrName(int attrOffset, char attrName[ATTR_SIZE])
+{
+	if (attrOffset < 0 || attrOffset >= (int)schema.size())
+		return E_OUTOFBOUND;
+	strcpy(attrName, schema[attrOffset].attrName);
+	return SUCCESS;
+}
+
+// returns the offset of attrName in the output of the operator or E_ATTRNOTEXIST
+int Operator::getAttrOffset(char attrName[ATTR_SIZE])
+{
+	for (int i = 0; i < (int)schema.size(); ++i)
+	{
+		if (strcmp(schema[i].attrName, attrName) == 0)
+			return i;
+	}
+	return E_ATTRNOTEXIST;
+}
+
+// fills the output schema with the attributes of an open relation (in offset order)
+int Operator::loadSchema(int relId)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	schema.resize(relCatEntry.numAttrs);
+	for (int i = 0; i < relCatEntry.numAttrs; ++i)
+		AttrCacheTable::getAttrCatEntry(relId, i, &schema[i]);
+
+	return SUCCESS;
+}
+
+/* fills the output schema of a join: the outer attributes followed by the
+inner attributes except the one at innerOffset. Any other pair of attributes
+with the same name is an error (E_DUPLICATEATTR). */
+int Operator::loadJoinSchema(Operator *outer, Operator *inner, int innerOffset)
+{
+	int numOuterAttrs = outer->getNumAttrs();
+	int numInnerAttrs = inner->getNumAttrs();
+	schema.resize(numOuterAttrs + numInnerAttrs - 1);
+
+	for (int i = 0; i < numOuterAttrs; ++i)
+	{
+		outer->getAttrName(i, schema[i].attrName);
+		schema[i].attrType = outer->getAttrType(i);
+	}
+	for (int j = 0, k = numOuterAttrs; j < numInnerAttrs; ++j)
+	{
+		if (j == innerOffset)
+			continue;
+
+		inner->getAttrName(j, schema[k].attrName);
+		schema[k].attrType = inner->getAttrType(j);
+
+		if (outer->getAttrOffset(schema[k].attrName) >= 0)
+			return E_DUPLICATEATTR;
+		k++;
+	}
+	for (int i = 0; i < (int)schema.size(); ++i)
+		schema[i].offset = i;
+
+	return SUCCESS;
+}
+
+/************ ScanOp ************/
+
+ScanOp::ScanOp(int relId)
+{
+	this->relId = relId;
+	this->cursor = RecId{-1, -1};
+	OpenRelTable::pinRel(relId);
+}
+
+ScanOp::~ScanOp()
+{
+	OpenRelTable::unpinRel(relId);
+}
+
+int ScanOp::open()
+{
+	cursor = RecId{-1, -1};
+	return loadSchema(relId);
+}
+
+int ScanOp::next(union Attribute *record)
+{
+	/* BlockAccess::project() resumes from the search index in the relation
+	cache. The scan keeps its own position and installs it before each call, so
+	that several scans over the same relation do not disturb each other. */
+	RelCacheTable::setSearchIndex(relId, &cursor);
+	int ret = BlockAccess::project(relId, record);
+	RelCacheTable::getSearchIndex(relId, &cursor);
+	return ret;
+}
+
+int ScanOp::close()
+{
+	return SUCCESS;
+}
+
+/************ SelectScanOp ************/
+
+SelectScanOp::SelectScanOp(int relId, char attrName[ATTR_SIZE], int op, union Attribute attrVal)
+{
+	this->relId = relId;
+	strcpy(this->attrName, attrName);
+	this->op = op;
+	this->attrVal = attrVal;
+	this->recCursor = RecId{-1, -1};
+	this->indexCursor = IndexId{-1, -1, -1, -1};
+	OpenRelTable::pinRel(relId);
+}
+
+SelectScanOp::~SelectScanOp()
+{
+	OpenRelTable::unpinRel(relId);
+}
+
+int SelectScanOp::open()
+{
+	AttrCatEntry attrCatEntry;
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	recCursor = RecId{-1, -1};
+	indexCursor = IndexId{-1, -1, -1, -1};
+	return loadSchema(relId);
+}
+
+void SelectScanOp::rescan(union Attribute attrVal)
+{
+	this->attrVal = attrVal;
+	recCursor = RecId{-1, -1};
+	indexCursor = IndexId{-1, -1, -1, -1};
+}
+
+int SelectScanOp::next(union Attribute *record)
+{
+	/* BlockAccess::search() resumes from the search index of the relation
+	(linear search) or of the attribute (B+ tree search). Install this
+	operator's position in both before searching and save them back after. */
+	RelCacheTable::setSearchIndex(relId, &recCursor);
+	AttrCacheTable::setSearchIndex(relId, attrName, &indexCursor);
+
+	int ret = BlockAccess::search(relId, record, attrName, attrVal, op);
+
+	RelCacheTable::getSearchIndex(relId, &recCursor);
+	AttrCacheTable::getSearchIndex(relId, attrName, &indexCursor);
+	return ret;
+}
+
+int SelectScanOp::close()
+{
+	return SUCCESS;
+}
+
+/************ IndexScanOp ************/
+
+IndexScanOp::IndexScanOp(int relId, char attrName[ATTR_SIZE], int op, union Attribute attrVal)
+{
+	this->relId = relId;
+	strcpy(this->attrName, attrName);
+	this->op = op;
+	this->attrVal = attrVal;
+	this->lowOp = NO_BOUND;
+	this->highOp = NO_BOUND;
+	this->bitmapFetch = false;
+	this->limitHint = -1;
+	OpenRelTable::pinRel(relId);
+}
+
+IndexScanOp::IndexScanOp(int relId, char attrName[ATTR_SIZE], int lowOp, union Attribute lowVal, int highOp,
+                         union Attribute highVal)
+{
+	this->relId = relId;
+	strcpy(this->attrName, attrName);
+	this->op = NO_BOUND;
+	this->lowOp = lowOp;
+	this->lowVal = lowVal;
+	this->highOp = highOp;
+	this->highVal = highVal;
+	this->bitmapFetch = false;
+	this->limitHint = -1;
+	OpenRelTable::pinRel(relId);
+}
+
+IndexScanOp::~IndexScanOp()
+{
+	OpenRelTable::unpinRel(relId);
+}
+
+void IndexScanOp::setBitmapFetch(bool bitmapFetch)
+{
+	this->bitmapFetch = bitmapFetch;
+}
+
+void IndexScanOp::setLimitHint(int numRecords)
+{
+	this->limitHint = numRecords;
+}
+
+int IndexScanOp::open()
+{
+	int ret;
+	if (op != NO_BOUND)
+		ret = cursor.seek(relId, attrName, op, attrVal);
+	else
+		ret = cursor.seek(relId, attrName, lowOp, lowVal, highOp, highVal);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (bitmapFetch && limitHint == -1)
+	{
+		bitmap.clear();
+		BlockAccess::collectRecIds(&cursor, &bitmap, -1);
+		recCursor = RecId{-1, -1};
+	}
+
+	return loadSchema(relId);
+}
+
+int IndexScanOp::next(union Attribute *record)
+{
+	if (bitmapFetch && limitHint == -1)
+	{
+		recCursor = bitmap.next(recCursor);
+		if (recCursor.block == -1)
+			return E_NOTFOUND;
+
+		RecBuffer recBuffer(recCursor.block);
+		return recBuffer.getRecord(record, recCursor.slot);
+	}
+
+	Index leafEntry;
+	int ret = cursor.next(&leafEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	RecBuffer recBuffer(leafEntry.block);
+	return recBuffer.getRecord(record, leafEntry.slot);
+}
+
+int IndexScanOp::close()
+{
+	return SUCCESS;
+}
+
+/************ RecIdScanOp ************/
+
+RecIdScanOp::RecIdScanOp(int relId, RecIdBitmap &recIds)
+{
+	this->relId = relId;
+	this->recIds = recIds;
+	this->recCursor = RecId{-1, -1};
+	OpenRelTable::pinRel(relId);
+}
+
+RecIdScanOp::~RecIdScanOp()
+{
+	OpenRelTable::unpinRel(relId);
+}
+
+int RecIdScanOp::open()
+{
+	recCursor = RecId{-1, -1};
+	return loadSchema(relId);
+}
+
+int RecIdScanOp::next(union Attribute *record)
+{
+	recCursor = recIds.next(recCursor);
+	if (recCursor.block == -1)
+		return E_NOTFOUND;
+
+	RecBuffer recBuffer(recCursor.block);
+	return recBuffer.getRecord(record, recCursor.slot);
+}
+
+int RecIdScanOp::close()
+{
+	return SUCCESS;
+}
+
+RecId RecIdScanOp::getRecId()
+{
+	return recCursor;
+}
+
+/************ IndexOnlyScanOp ************/
+
+IndexOnlyScanOp::IndexOnlyScanOp(int relId, char attrName[ATTR_SIZE], int op, union Attribute attrVal)
+{
+	this->relId = relId;
+	strcpy(this->attrName, attrName);
+	this->op = op;
+	this->attrVal = attrVal;
+	this->lowOp = NO_BOUND;
+	this->highOp = NO_BOUND;
+	OpenRelTable::pinRel(relId);
+}
+
+IndexOnlyScanOp::IndexOnlyScanOp(int relId, char attrName[ATTR_SIZE], int lowOp, union Attribute lowVal, int highOp,
+                                 union Attribute highVal)
+{
+	this->relId = relId;
+	strcpy(this->attrName, attrName);
+	this->op = NO_BOUND;
+	this->lowOp = lowOp;
+	this->lowVal = lowVal;
+	this->highOp = highOp;
+	this->highVal = highVal;
+	OpenRelTable::pinRel(relId);
+}
+
+IndexOnlyScanOp::~IndexOnlyScanOp()
+{
+	OpenRelTable::unpinRel(relId);
+}
+
+int IndexOnlyScanOp::open()
+{
+	schema.resize(1);
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &schema[0]);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (schema[0].rootBlock == -1)
+		return E_NOINDEX;
+
+	schema[0].offset = 0;
+	if (op != NO_BOUND)
+		return cursor.seek(relId, attrName, op, attrVal);
+	return cursor.seek(relId, attrName, lowOp, lowVal, highOp, highVal);
+}
+
+int IndexOnlyScanOp::next(union Attribute *record)
+{
+	Index leafEntry;
+	int ret = cursor.next(&leafEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	record[0] = leafEntry.attrVal;
+	return SUCCESS;
+}
+
+int IndexOnlyScanOp::close()
+{
+	return SUCCESS;
+}
+
+/************ FilterOp ************/
+
+FilterOp::FilterOp(Operator *child, Predicate *where)
+{
+	this->child = child;
+	this->where = *where;
+}
+
+FilterOp::~FilterOp()
+{
+	delete child;
+}
+
+// the filter pulls more records than it returns, but still stops early
+void FilterOp::setLimitHint(int numRecords)
+{
+	child->setLimitHint(numRecords);
+}
+
+// resolves the comparisons of pred against the schema of the child
+int FilterOp::resolve(Predicate *pred)
+{
+	if (pred->type != PRED_COMPARE)
+	{
+		for (Predicate &term : pred->children)
+		{
+			int ret = resolve(&term);
+			if (ret != SUCCESS)
+				return ret;
+		}
+		return SUCCESS;
+	}
+
+	int offset = child->getAttrOffset(pred->attr);
+	if (offset < 0)
+		return E_ATTRNOTEXIST;
+
+	Attribute value;
+	int ret = strToAttribute(pred->value, child->getAttrType(offset), &value);
+	if (ret != SUCCESS)
+		return ret;
+
+	offsets.push_back(offset);
+	values.push_back(value);
+	return SUCCESS;
+}
+
+int FilterOp::open()
+{
+	int ret = child->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	offsets.clear();
+	values.clear();
+	ret = resolve(&where);
+	if (ret != SUCCESS)
+	{
+		child->close();
+		return ret;
+	}
+
+	schema.resize(child->getNumAttrs());
+	for (int i = 0; i < child->getNumAttrs(); ++i)
+	{
+		child->getAttrName(i, schema[i].attrName);
+		schema[i].attrType = child->getAttrType(i);
+		schema[i].offset = i;
+	}
+	return SUCCESS;
+}
+
+/* evaluates pred on record; *comparison is the number of the first comparison
+of pred (in depth-first order) and is moved past the last one */
+bool FilterOp::satisfies(Predicate *pred, union Attribute *record, int *comparison)
+{
+	if (pred->type == PRED_COMPARE)
+	{
+		int i = (*comparison)++;
+		return satisfiesOp(compareAttrs(record[offsets[i]], values[i], schema[offsets[i]].attrType), pred->op);
+	}
+
+	// every child is evaluated, so that the numbering stays in step
+	bool result = (pred->type == PRED_AND);
+	for (Predicate &term : pred->children)
+	{
+		bool holds = satisfies(&term, record, comparison);
+		result = (pred->type == PRED_AND) ? (result && holds) : (result || holds);
+	}
+	return result;
+}
+
+int FilterOp::next(union Attribute *record)
+{
+	while (child->next(record) == SUCCESS)
+	{
+		int comparison = 0;
+		if (satisfies(&where, record, &comparison))
+			return SUCCESS;
+	}
+	return E_NOTFOUND;
+}
+
+int FilterOp::close()
+{
+	return child->close();
+}
+
+/************ ProjectOp ************/
+
+ProjectOp::ProjectOp(Operator *child, int numAttrs, char attrNames[][ATTR_SIZE])
+{
+	this->child = child;
+	targetAttrs.resize(numAttrs);
+	for (int i = 0; i < numAttrs; ++i)
+		strcpy(targetAttrs[i].attrName, attrNames[i]);
+}
+
+ProjectOp::ProjectOp(Operator *child, int numAttrs, char attrNames[][ATTR_SIZE], char outputNames[][ATTR_SIZE])
+	: ProjectOp(child, numAttrs, attrNames)
+{
+	outputAttrs.resize(numAttrs);
+	for (int i = 0; i < numAttrs; ++i)
+		strcpy(outputAttrs[i].attrName, outputNames[i]);
+}
+
+ProjectOp::~ProjectOp()
+{
+	delete child;
+}
+
+void ProjectOp::setLimitHint(int numRecords)
+{
+	child->setLimitHint(numRecords);
+}
+
+int ProjectOp::open()
+{
+	int ret = child->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	// find the offset of each target attribute in the records of the child
+	schema = targetAttrs;
+	attrOffsets.resize(targetAttrs.size());
+	for (int i = 0; i < (int)targetAttrs.size(); ++i)
+	{
+		int offset = child->getAttrOffset(targetAttrs[i].attrName);
+		if (offset < 0)
+		{
+			child->close();
+			return E_ATTRNOTEXIST;
+		}
+		attrOffsets[i] = offset;
+		schema[i].attrType = child->getAttrType(offset);
+		schema[i].offset = i;
+		if (!outputAttrs.empty())
+			strcpy(schema[i].attrName, outputAttrs[i].attrName);
+	}
+
+	childRecord.resize(child->getNumAttrs());
+	return SUCCESS;
+}
+
+int ProjectOp::next(union Attribute *record)
+{
+	int ret = child->next(childRecord.data());
+	if (ret != SUCCESS)
+		return ret;
+
+	for (int i = 0; i < (int)attrOffsets.size(); ++i)
+		record[i] = childRecord[attrOffsets[i]];
+
+	return SUCCESS;
+}
+
+int ProjectOp::close()
+{
+	return child->close();
+}
+
+/************ JoinOp ************/
+
+JoinOp::JoinOp(Operator *outer, int innerRelId, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE])
+{
+	this->outer = outer;
+	this->innerRelId = innerRelId;
+	strcpy(this->outerAttr, outerAttr);
+	strcpy(this->innerAttr, innerAttr);
+	this->inner = nullptr;
+	this->outerValid = false;
+	OpenRelTable::pinRel(innerRelId);
+}
+
+JoinOp::~JoinOp()
+{
+	delete outer;
+	delete inner;
+	OpenRelTable::unpinRel(innerRelId);
+}
+
+int JoinOp::open()
+{
+	int ret = outer->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	// the inner relation is probed with EQ on innerAttr for each outer record
+	union Attribute dummy;
+	dummy.nVal = 0;
+	delete inner;
+	inner = new SelectScanOp(innerRelId, innerAttr, EQ, dummy);
+	ret = inner->open();
+	if (ret != SUCCESS)
+	{
+		outer->close();
+		return ret;
+	}
+
+	outerOffset = outer->getAttrOffset(outerAttr);
+	innerOffset = inner->getAttrOffset(innerAttr);
+	if (outerOffset < 0)
+	{
+		close();
+		return E_ATTRNOTEXIST;
+	}
+
+	// if the join attributes are of different types, return error
+	if (outer->getAttrType(outerOffset) != inner->getAttrType(innerOffset))
+	{
+		close();
+		return E_ATTRTYPEMISMATCH;
+	}
+
+	ret = loadJoinSchema(outer, inner, innerOffset);
+	if (ret != SUCCESS)
+	{
+		close();
+		return ret;
+	}
+
+	outerRecord.resize(outer->getNumAttrs());
+	innerRecord.resize(inner->getNumAttrs());
+	outerValid = false;
+	return SUCCESS;
+}
+
+int JoinOp::next(union Attribute *record)
+{
+	int numOuterAttrs = outerRecord.size();
+	int numInnerAttrs = innerRecord.size();
+
+	while (true)
+	{
+		if (!outerValid)
+		{
+			// fetch the next outer record and restart the inner search with its key
+			if (outer->next(outerRecord.data()) != SUCCESS)
+				return E_NOTFOUND;
+
+			inner->rescan(outerRecord[outerOffset]);
+			outerValid = true;
+		}
+
+		if (inner->next(innerRecord.data()) == SUCCESS)
+		{
+			for (int i = 0; i < numOuterAttrs; ++i)
+				record[i] = outerRecord[i];
+			for (int j = 0, k = numOuterAttrs; j < numInnerAttrs; ++j)
+			{
+				if (j != innerOffset)
+					record[k++] = innerRecord[j];
+			}
+			return SUCCESS;
+		}
+
+		outerValid = false;
+	}
+}
+
+int JoinOp::close()
+{
+	if (inner != nullptr)
+		inner->close();
+	return outer->close();
+}
+
+/************ SemiJoinOp ************/
+
+// hash key of a join attribute; only the meaningful bytes of a string are used
+static std::string joinKey(union Attribute attr, int type)
+{
+	if (type == NUMBER)
+		return std::string((char *)&attr.nVal, sizeof(attr.nVal));
+	return std::string(attr.sVal, strnlen(attr.sVal, ATTR_SIZE));
+}
+
+SemiJoinOp::SemiJoinOp(Operator *outer, int innerRelId, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE],
+                       bool anti, bool probeIndex)
+{
+	this->outer = outer;
+	this->innerRelId = innerRelId;
+	strcpy(this->outerAttr, outerAttr);
+	strcpy(this->innerAttr, innerAttr);
+	this->anti = anti;
+	this->probeIndex = probeIndex;
+	this->hashProbe = false;
+	this->treeProbe = false;
+	OpenRelTable::pinRel(innerRelId);
+}
+
+SemiJoinOp::~SemiJoinOp()
+{
+	delete outer;
+	OpenRelTable::unpinRel(innerRelId);
+}
+
+int SemiJoinOp::open()
+{
+	AttrCatEntry innerAttrCat;
+	int ret = AttrCacheTable::getAttrCatEntry(innerRelId, innerAttr, &innerAttrCat);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = outer->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	outerOffset = outer->getAttrOffset(outerAttr);
+	if (outerOffset < 0)
+	{
+		outer->close();
+		return E_ATTRNOTEXIST;
+	}
+	type = outer->getAttrType(outerOffset);
+	if (type != innerAttrCat.attrType)
+	{
+		outer->close();
+		return E_ATTRTYPEMISMATCH;
+	}
+
+	// a hash index answers the equality probes best, as in BlockAccess::search()
+	innerKeys.clear();
+	hashProbe = probeIndex && HashIndex::find(innerRelId, innerAttrCat.offset, &hashIndex) == SUCCESS;
+	treeProbe = probeIndex && !hashProbe && innerAttrCat.rootBlock != -1;
+	if (!hashProbe && !treeProbe)
+	{
+		ret = loadInnerKeys(innerAttrCat.offset);
+		if (ret != SUCCESS)
+		{
+			outer->close();
+			return ret;
+		}
+	}
+
+	schema.resize(outer->getNumAttrs());
+	for (int i = 0; i < outer->getNumAttrs(); ++i)
+	{
+		outer->getAttrName(i, schema[i].attrName);
+		schema[i].attrType = outer->getAttrType(i);
+		schema[i].offset = i;
+	}
+	return SUCCESS;
+}
+
+// reads the innerAttr value of every record of the inner relation into innerKeys
+int SemiJoinOp::loadInnerKeys(int innerOffset)
+{
+	ScanOp scan(innerRelId);
+	int ret = scan.open();
+	if (ret != SUCCESS)
+		return ret;
+
+	Attribute innerRecord[scan.getNumAttrs()];
+	while (scan.next(innerRecord) == SUCCESS)
+		innerKeys.insert(joinKey(innerRecord[innerOffset], type));
+	return scan.close();
+}
+
+// the first index entry with the key is enough; its record is not read
+bool SemiJoinOp::hasMatch(union Attribute key)
+{
+	if (hashProbe)
+	{
+		IndexId cursor = {-1, -1, -1, -1};
+		RecId recId;
+		return HashIndex::search(&hashIndex, key, &cursor, &recId) == SUCCESS;
+	}
+	if (treeProbe)
+	{
+		BPlusCursor cursor;
+		Index entry;
+		return cursor.seek(innerRelId, innerAttr, EQ, key) == SUCCESS && cursor.next(&entry) == SUCCESS;
+	}
+	return innerKeys.count(joinKey(key, type)) > 0;
+}
+
+int SemiJoinOp::next(union Attribute *record)
+{
+	while (outer->next(record) == SUCCESS)
+	{
+		if (hasMatch(record[outerOffset]) != anti)
+			return SUCCESS;
+	}
+	return E_NOTFOUND;
+}
+
+int SemiJoinOp::close()
+{
+	innerKeys.clear();
+	return outer->close();
+}
+
+bool SemiJoinOp::usesIndex()
+{
+	return hashProbe || treeProbe;
+}
+
+/************ SortOp ************/
+
+SortOp::SortOp(Operator *child, int numKeys, char keyAttrs[][ATTR_SIZE], bool descending, bool distinct)
+{
+	this->child = child;
+	this->keyAttrs.resize(numKeys);
+	for (int i = 0; i < numKeys; ++i)
+		strcpy(this->keyAttrs[i].attrName, keyAttrs[i]);
+	this->descending = descending;
+	this->distinct = distinct;
+	this->limit = -1;
+	this->numRuns = 0;
+	this->numPasses = 0;
+}
+
+SortOp::~SortOp()
+{
+	close();
+	delete child;
+}
+
+void SortOp::setLimit(int limit)
+{
+	this->limit = limit;
+}
+
+int SortOp::getNumRuns()
+{
+	return numRuns;
+}
+
+int SortOp::getNumPasses()
+{
+	return numPasses;
+}
+
+int SortOp::open()
+{
+	int ret = child->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	numAttrs = child->getNumAttrs();
+	schema.resize(numAttrs);
+	for (int i = 0; i < numAttrs; ++i)
+	{
+		child->getAttrName(i, schema[i].attrName);
+		schema[i].attrType = child->getAttrType(i);
+		schema[i].offset = i;
+	}
+
+	keyOffsets.clear();
+	for (int i = 0; i < (int)keyAttrs.size(); ++i)
+	{
+		int offset = child->getAttrOffset(keyAttrs[i].attrName);
+		if (offset < 0)
+		{
+			child->close();
+			return E_ATTRNOTEXIST;
+		}
+		keyOffsets.push_back(offset);
+	}
+
+	// duplicates are only adjacent if every attribute takes part in the order
+	if (distinct)
+	{
+		for (int i = 0; i < numAttrs; ++i)
+		{
+			if (std::find(keyOffsets.begin(), keyOffsets.end(), i) == keyOffsets.end())
+				keyOffsets.push_back(i);
+		}
+	}
+
+	maxRecords = SORT_MEMORY_BUDGET / (numAttrs * sizeof(Attribute) + sizeof(int));
+	if (maxRecords < 1)
+		maxRecords = 1;
+	arena.resize(maxRecords * numAttrs);
+	numRecords = 0;
+	numRuns = 0;
+	numPasses = 0;
+	hasLast = false;
+	lastRecord.resize(numAttrs);
+
+	// duplicates have to be seen to be removed, so DISTINCT always sorts everything
+	if (limit >= 0 && limit < maxRecords && !distinct)
+	{
+		ret = readTopN();
+		child->close();
+		arenaPos = 0;
+		return ret;
+	}
+
+	// run generation: every time the arena is full it is sorted and spilled
+	while (child->next(&arena[numRecords * numAttrs]) == SUCCESS)
+	{
+		numRecords++;
+		if (numRecords == maxRecords)
+		{
+			ret = writeRun();
+			if (ret != SUCCESS)
+			{
+				child->close();
+				close();
+				return ret;
+			}
+		}
+	}
+	child->close();
+
+	if (runs.empty())
+	{
+		// everything fit in memory
+		sortArena();
+		arenaPos = 0;
+		return SUCCESS;
+	}
+
+	if (numRecords > 0)
+	{
+		ret = writeRun();
+		if (ret != SUCCESS)
+		{
+			close();
+			return ret;
+		}
+	}
+	arena.clear();
+	arena.shrink_to_fit();
+
+	// merge passes until the remaining runs can be merged at once
+	std::vector<Attribute> record(numAttrs);
+	while ((int)runs.size() > SORT_MERGE_FANIN)
+	{
+		std::vector<FILE *> merged;
+		for (int i = 0; i < (int)runs.size(); i += SORT_MERGE_FANIN)
+		{
+			int end = std::min((int)runs.size(), i + SORT_MERGE_FANIN);
+			std::vector<FILE *> inputs(runs.begin() + i, runs.begin() + end);
+			if (inputs.size() == 1)
+			{
+				merged.push_back(inputs[0]);
+				continue;
+			}
+
+			FILE *output = tmpfile();
+			if (output == nullptr)
+			{
+				runs.erase(runs.begin(), runs.begin() + i);
+				runs.insert(runs.end(), merged.begin(), merged.end());
+				close();
+				return E_DISKFULL;
+			}
+
+			startMerge(inputs);
+			while (mergeNext(record.data()) == SUCCESS)
+				fwrite(record.data(), sizeof(Attribute), numAttrs, output);
+			endMerge();
+			merged.push_back(output);
+		}
+		runs = merged;
+		numPasses++;
+	}
+
+	startMerge(runs);
+	runs.clear();
+	numPasses++;
+
+	return SUCCESS;
+}
+
+/* reads the child stream keeping only the first `limit` records of the order
+in a max-heap over the arena (slot `limit` receives each incoming record).
+Ties are broken by arrival, so the result is the prefix of a stable sort. */
+int SortOp::readTopN()
+{
+	std::vector<int> heap;
+	std::vector<long long> seq(limit + 1);
+	long long numRead = 0;
+	int scratch = limit;
+
+	auto less = [this, &seq](int a, int b) {
+		int cmpVal = compare(&arena[a * numAttrs], &arena[b * numAttrs]);
+		return cmpVal < 0 || (cmpVal == 0 && seq[a] < seq[b]);
+	};
+
+	while (true)
+	{
+		int slot = ((int)heap.size() < limit) ? heap.size() : scratch;
+		if (child->next(&arena[slot * numAttrs]) != SUCCESS)
+			break;
+		seq[slot] = numRead++;
+
+		if (slot != scratch)
+		{
+			heap.push_back(slot);
+			std::push_heap(heap.begin(), heap.end(), less);
+			continue;
+		}
+
+		// the new record replaces the largest kept record if it comes before it
+		if (!heap.empty() && less(scratch, heap.front()))
+		{
+			std::pop_heap(heap.begin(), heap.end(), less);
+			int top = heap.back();
+			memcpy(&arena[top * numAttrs], &arena[scratch * numAttrs], numAttrs * sizeof(Attribute));
+			seq[top] = seq[scratch];
+			std::push_heap(heap.begin(), heap.end(), less);
+		}
+	}
+
+	std::sort(heap.begin(), heap.end(), less);
+	order = heap;
+	numRecords = order.size();
+	return SUCCESS;
+}
+
+// compares two records on the sort keys, in the requested direction
+int SortOp::compare(union Attribute *rec1, union Attribute *rec2)
+{
+	for (int i = 0; i < (int)keyOffsets.size(); ++i)
+	{
+		int offset = keyOffsets[i];
+		int cmpVal = compareAttrs(rec1[offset], rec2[offset], schema[offset].attrType);
+		if (cmpVal != 0)
+			return descending ? -cmpVal : cmpVal;
+	}
+	return 0;
+}
+
+// sorts the records in the arena (stably, so equal keys keep the input order)
+void SortOp::sortArena()
+{
+	order.resize(numRecords);
+	for (int i = 0; i < numRecords; ++i)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+		return compare(&arena[a * numAttrs], &arena[b * numAttrs]) < 0;
+	});
+}
+
+// sorts the arena and writes it to a new temporary file as a run
+int SortOp::writeRun()
+{
+	sortArena();
+
+	FILE *run = tmpfile();
+	if (run == nullptr)
+		return E_DISKFULL;
+
+	Attribute *prev = nullptr;
+	for (int i = 0; i < numRecords; ++i)
+	{
+		Attribute *rec = &arena[order[i] * numAttrs];
+		if (distinct && prev != nullptr && compare(prev, rec) == 0)
+			continue;
+
+		if ((int)fwrite(rec, sizeof(Attribute), numAttrs, run) != numAttrs)
+		{
+			fclose(run);
+			return E_DISKFULL;
+		}
+		prev = rec;
+	}
+
+	runs.push_back(run);
+	numRuns++;
+	numRecords = 0;
+	return SUCCESS;
+}
+
+void SortOp::readHead(int run)
+{
+	Attribute *head = &heads[run * numAttrs];
+	if ((int)fread(head, sizeof(Attribute), numAttrs, mergeInputs[run]) != numAttrs)
+		exhausted[run] = true;
+}
+
+/* returns true if run1 wins against run2. Run k (one past the last run) only
+exists while the tree is built and wins against every run; an exhausted run
+loses against every other run. Ties go to the earlier run, which keeps the
+sort stable. */
+bool SortOp::beats(int run1, int run2)
+{
+	int k = mergeInputs.size();
+	if (run1 == k)
+		return true;
+	if (run2 == k)
+		return false;
+	if (exhausted[run1])
+		return false;
+	if (exhausted[run2])
+		return true;
+
+	int cmpVal = compare(&heads[run1 * numAttrs], &heads[run2 * numAttrs]);
+	return cmpVal < 0 || (cmpVal == 0 && run1 < run2);
+}
+
+/* replays the matches on the path from the leaf of `run` to the root after its
+current record has changed: at each node the loser stays and the winner
+moves up, and the overall winner is stored in tree[0] */
+void SortOp::adjust(int run)
+{
+	int k = mergeInputs.size();
+	for (int node = (run + k) / 2; node > 0; node /= 2)
+	{
+		if (beats(tree[node], run))
+			std::swap(run, tree[node]);
+	}
+	tree[0] = run;
+}
+
+void SortOp::startMerge(std::vector<FILE *> &inputs)
+{
+	int k = inputs.size();
+	mergeInputs = inputs;
+	heads.resize(k * numAttrs);
+	exhausted.assign(k, false);
+
+	for (int i = 0; i < k; ++i)
+	{
+		rewind(mergeInputs[i]);
+		readHead(i);
+	}
+
+	tree.assign(k, k);
+	for (int i = k - 1; i >= 0; --i)
+		adjust(i);
+}
+
+int SortOp::mergeNext(union Attribute *record)
+{
+	if (mergeInputs.empty() || exhausted[tree[0]])
+		return E_NOTFOUND;
+
+	int winner = tree[0];
+	memcpy(record, &heads[winner * numAttrs], numAttrs * sizeof(Attribute));
+	readHead(winner);
+	adjust(winner);
+	return SUCCESS;
+}
+
+void SortOp::endMerge()
+{
+	for (FILE *input : mergeInputs)
+		fclose(input);
+	mergeInputs.clear();
+}
+
+int SortOp::next(union Attribute *record)
+{
+	while (true)
+	{
+		if (mergeInputs.empty())
+		{
+			if (arenaPos >= numRecords)
+				return E_NOTFOUND;
+			memcpy(record, &arena[order[arenaPos++] * numAttrs], numAttrs * sizeof(Attribute));
+		}
+		else if (mergeNext(record) != SUCCESS)
+		{
+			return E_NOTFOUND;
+		}
+
+		if (distinct && hasLast && compare(lastRecord.data(), record) == 0)
+			continue;
+
+		if (distinct)
+		{
+			memcpy(lastRecord.data(), record, numAttrs * sizeof(Attribute));
+			hasLast = true;
+		}
+		return SUCCESS;
+	}
+}
+
+int SortOp::close()
+{
+	// the child was closed once the input had been read
+	for (FILE *run : runs)
+		fclose(run);
+	runs.clear();
+	endMerge();
+	numRecords = 0;
+	arenaPos = 0;
+	return SUCCESS;
+}
+
+/************ LimitOp ************/
+
+LimitOp::LimitOp(Operator *child, int limit, int offset)
+{
+	this->child = child;
+	this->limit = limit;
+	this->offset = offset;
+	this->numSkipped = 0;
+	this->numReturned = 0;
+	if (limit != INT_MAX)
+		child->setLimitHint(offset + limit);
+}
+
+LimitOp::~LimitOp()
+{
+	delete child;
+}
+
+void LimitOp::setLimitHint(int numRecords)
+{
+	if (numRecords < limit)
+		child->setLimitHint(offset + numRecords);
+}
+
+int LimitOp::open()
+{
+	int ret = child->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	schema.resize(child->getNumAttrs());
+	for (int i = 0; i < child->getNumAttrs(); ++i)
+	{
+		child->getAttrName(i, schema[i].attrName);
+		schema[i].attrType = child->getAttrType(i);
+		schema[i].offset = i;
+	}
+
+	numSkipped = 0;
+	numReturned = 0;
+	return SUCCESS;
+}
+
+int LimitOp::next(union Attribute *record)
+{
+	if (numReturned >= limit)
+		return E_NOTFOUND;
+
+	// the first `offset` records are read and dropped
+	while (numSkipped < offset)
+	{
+		if (child->next(record) != SUCCESS)
+			return E_NOTFOUND;
+		numSkipped++;
+	}
+
+	int ret = child->next(record);
+	if (ret == SUCCESS)
+		numReturned++;
+	return ret;
+}
+
+int LimitOp::close()
+{
+	return child->close();
+}
+
+/************ MergeJoinOp ************/
+
+MergeJoinOp::MergeJoinOp(Operator *outer, Operator *inner, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE])
+{
+	strcpy(this->outerAttr, outerAttr);
+	strcpy(this->innerAttr, innerAttr);
+
+	char outerKey[1][ATTR_SIZE];
+	char innerKey[1][ATTR_SIZE];
+	strcpy(outerKey[0], outerAttr);
+	strcpy(innerKey[0], innerAttr);
+	this->outer = new SortOp(outer, 1, outerKey, false, false);
+	this->inner = new SortOp(inner, 1, innerKey, false, false);
+}
+
+MergeJoinOp::~MergeJoinOp()
+{
+	delete outer;
+	delete inner;
+}
+
+int MergeJoinOp::open()
+{
+	int ret = outer->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = inner->open();
+	if (ret != SUCCESS)
+	{
+		outer->close();
+		return ret;
+	}
+
+	outerOffset = outer->getAttrOffset(outerAttr);
+	innerOffset = inner->getAttrOffset(innerAttr);
+
+	// if the join attributes are of different types, return error
+	type = outer->getAttrType(outerOffset);
+	if (type != inner->getAttrType(innerOffset))
+	{
+		close();
+		return E_ATTRTYPEMISMATCH;
+	}
+
+	ret = loadJoinSchema(outer, inner, innerOffset);
+	if (ret != SUCCESS)
+	{
+		close();
+		return ret;
+	}
+
+	outerRecord.resize(outer->getNumAttrs());
+	innerRecord.resize(inner->getNumAttrs());
+	innerValid = (inner->next(innerRecord.data()) == SUCCESS);
+	group.clear();
+
+	// no outer record is current until next() fetches one
+	groupPos = -1;
+	return SUCCESS;
+}
+
+int MergeJoinOp::next(union Attribute *record)
+{
+	int numOuterAttrs = outerRecord.size();
+	int numInnerAttrs = innerRecord.size();
+	int groupSize = group.size() / numInnerAttrs;
+
+	while (true)
+	{
+		if (groupPos >= 0 && groupPos < groupSize)
+		{
+			Attribute *innerRec = &group[groupPos * numInnerAttrs];
+			for (int i = 0; i < numOuterAttrs; ++i)
+				record[i] = outerRecord[i];
+			for (int j = 0, k = numOuterAttrs; j < numInnerAttrs; ++j)
+			{
+				if (j != innerOffset)
+					record[k++] = innerRec[j];
+			}
+			groupPos++;
+			return SUCCESS;
+		}
+
+		// move to the next outer record
+		if (outer->next(outerRecord.data()) != SUCCESS)
+			return E_NOTFOUND;
+
+		Attribute key = outerRecord[outerOffset];
+		if (groupSize > 0 && compareAttrs(key, groupKey, type) == 0)
+		{
+			// same key as the previous outer record: join with the same group again
+			groupPos = 0;
+			continue;
+		}
+
+		// skip the inner records with smaller keys and collect the ones equal to key
+		while (innerValid && compareAttrs(innerRecord[innerOffset], key, type) < 0)
+			innerValid = (inner->next(innerRecord.data()) == SUCCESS);
+
+		group.clear();
+		groupKey = key;
+		while (innerValid && compareAttrs(innerRecord[innerOffset], key, type) == 0)
+		{
+			group.insert(group.end(), innerRecord.begin(), innerRecord.end());
+			innerValid = (inner->next(innerRecord.data()) == SUCCESS);
+		}
+		groupSize = group.size() / numInnerAttrs;
+		groupPos = 0;
+
+		// no inner record can match this or any later outer record
+		if (groupSize == 0 && !innerValid)
+			return E_NOTFOUND;
+	}
+}
+
+int MergeJoinOp::close()
+{
+	inner->close();
+	return outer->close();
+}
+
+/************ BlockNestedLoopJoinOp ************/
+
+BlockNestedLoopJoinOp::BlockNestedLoopJoinOp(Operator *outer, Operator *inner, char outerAttr[ATTR_SIZE],
+                                             char innerAttr[ATTR_SIZE], int memoryBudget)
+{
+	this->outer = outer;
+	this->inner = inner;
+	strcpy(this->outerAttr, outerAttr);
+	strcpy(this->innerAttr, innerAttr);
+	this->memoryBudget = memoryBudget;
+	this->numInnerPasses = 0;
+}
+
+BlockNestedLoopJoinOp::~BlockNestedLoopJoinOp()
+{
+	delete outer;
+	delete inner;
+}
+
+// read the next chunk of outer records; returns the number of records read
+int BlockNestedLoopJoinOp::loadChunk()
+{
+	int numOuterAttrs = outer->getNumAttrs();
+
+	// the chunk always holds at least one record
+	int maxRecords = memoryBudget / (numOuterAttrs * (int)sizeof(Attribute));
+	if (maxRecords < 1)
+		maxRecords = 1;
+
+	chunk.resize((size_t)maxRecords * numOuterAttrs);
+	chunkKeys.clear();
+	while (!outerDone && (int)chunkKeys.size() < maxRecords)
+	{
+		Attribute *rec = &chunk[chunkKeys.size() * numOuterAttrs];
+		if (outer->next(rec) != SUCCESS)
+		{
+			outerDone = true;
+			break;
+		}
+		chunkKeys.push_back(rec[outerOffset]);
+	}
+	chunk.resize(chunkKeys.size() * numOuterAttrs);
+
+	return chunkKeys.size();
+}
+
+int BlockNestedLoopJoinOp::open()
+{
+	int ret = outer->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = inner->open();
+	if (ret != SUCCESS)
+	{
+		outer->close();
+		return ret;
+	}
+
+	outerOffset = outer->getAttrOffset(outerAttr);
+	innerOffset = inner->getAttrOffset(innerAttr);
+
+	// if the join attributes are of different types, return error
+	type = outer->getAttrType(outerOffset);
+	if (type != inner->getAttrType(innerOffset))
+	{
+		close();
+		return E_ATTRTYPEMISMATCH;
+	}
+
+	ret = loadJoinSchema(outer, inner, innerOffset);
+	if (ret != SUCCESS)
+	{
+		close();
+		return ret;
+	}
+
+	innerRecord.resize(inner->getNumAttrs());
+	innerValid = false;
+	outerDone = false;
+	numInnerPasses = 1;
+	loadChunk();
+	return SUCCESS;
+}
+
+int BlockNestedLoopJoinOp::next(union Attribute *record)
+{
+	int numOuterAttrs = outer->getNumAttrs();
+	int numInnerAttrs = innerRecord.size();
+
+	while (true)
+	{
+		if (chunkKeys.empty())
+			return E_NOTFOUND;
+
+		if (!innerValid)
+		{
+			if (inner->next(innerRecord.data()) != SUCCESS)
+			{
+				// the inner stream is done with this chunk: move to the next one
+				if (outerDone || loadChunk() == 0)
+					return E_NOTFOUND;
+
+				inner->close();
+				int ret = inner->open();
+				if (ret != SUCCESS)
+					return ret;
+				numInnerPasses++;
+				continue;
+			}
+			innerValid = true;
+			chunkPos = 0;
+		}
+
+		// find the next outer record of the chunk with the key of the inner record
+		Attribute key = innerRecord[innerOffset];
+		int numKeys = chunkKeys.size();
+		int i = chunkPos;
+		if (type == NUMBER)
+		{
+			while (i < numKeys && chunkKeys[i].nVal != key.nVal)
+				i++;
+		}
+		else
+		{
+			while (i < numKeys && strcmp(chunkKeys[i].sVal, key.sVal) != 0)
+				i++;
+		}
+
+		if (i == numKeys)
+		{
+			innerValid = false;
+			continue;
+		}
+		chunkPos = i + 1;
+
+		Attribute *outerRec = &chunk[(size_t)i * numOuterAttrs];
+		for (int j = 0; j < numOuterAttrs; ++j)
+			record[j] = outerRec[j];
+		for (int j = 0, k = numOuterAttrs; j < numInnerAttrs; ++j)
+		{
+			if (j != innerOffset)
+				record[k++] = innerRecord[j];
+		}
+		return SUCCESS;
+	}
+}
+
+int BlockNestedLoopJoinOp::close()
+{
+	chunk.clear();
+	chunkKeys.clear();
+	inner->close();
+	return outer->close();
+}
+
+int BlockNestedLoopJoinOp::getNumInnerPasses()
+{
+	return numInnerPasses;
+}
+
+/************ HashJoinOp ************/
+
+HashJoinOp::HashJoinOp(Operator *outer, Operator *inner, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE],
+                       int memoryBudget)
+{
+	this->outer = outer;
+	this->inner = inner;
+	strcpy(this->outerAttr, outerAttr);
+	strcpy(this->innerAttr, innerAttr);
+	this->memoryBudget = memoryBudget;
+	this->numOuterPasses = 0;
+}
+
+HashJoinOp::~HashJoinOp()
+{
+	delete outer;
+	delete inner;
+}
+
+// read the next chunk of inner records into the hash table; returns the number of records read
+int HashJoinOp::loadChunk()
+{
+	int numInnerAttrs = inner->getNumAttrs();
+
+	// the chunk always holds at least one record
+	int maxRecords = memoryBudget / (numInnerAttrs * (int)sizeof(Attribute));
+	if (maxRecords < 1)
+		maxRecords = 1;
+
+	chunk.resize((size_t)maxRecords * numInnerAttrs);
+	table.clear();
+	int numRecords = 0;
+	while (!innerDone && numRecords < maxRecords)
+	{
+		Attribute *rec = &chunk[(size_t)numRecords * numInnerAttrs];
+		if (inner->next(rec) != SUCCESS)
+		{
+			innerDone = true;
+			break;
+		}
+		table.emplace(joinKey(rec[innerOffset], type), numRecords);
+		numRecords++;
+	}
+	chunk.resize((size_t)numRecords * numInnerAttrs);
+
+	return numRecords;
+}
+
+int HashJoinOp::open()
+{
+	int ret = outer->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = inner->open();
+	if (ret != SUCCESS)
+	{
+		outer->close();
+		return ret;
+	}
+
+	outerOffset = outer->getAttrOffset(outerAttr);
+	innerOffset = inner->getAttrOffset(innerAttr);
+
+	// if the join attributes are of different types, return error
+	type = outer->getAttrType(outerOffset);
+	if (type != inner->getAttrType(innerOffset))
+	{
+		close();
+		return E_ATTRTYPEMISMATCH;
+	}
+
+	ret = loadJoinSchema(outer, inner, innerOffset);
+	if (ret != SUCCESS)
+	{
+		close();
+		return ret;
+	}
+
+	outerRecord.resize(outer->getNumAttrs());
+	outerValid = false;
+	innerDone = false;
+	numOuterPasses = 1;
+	loadChunk();
+	return SUCCESS;
+}
+
+int HashJoinOp::next(union Attribute *record)
+{
+	int numOuterAttrs = outerRecord.size();
+	int numInnerAttrs = inner->getNumAttrs();
+
+	while (true)
+	{
+		if (table.empty())
+			return E_NOTFOUND;
+
+		if (outerValid && match != matchEnd)
+		{
+			Attribute *innerRec = &chunk[(size_t)match->second * numInnerAttrs];
+			for (int i = 0; i < numOuterAttrs; ++i)
+				record[i] = outerRecord[i];
+			for (int j = 0, k = numOuterAttrs; j < numInnerAttrs; ++j)
+			{
+				if (j != innerOffset)
+					record[k++] = innerRec[j];
+			}
+			++match;
+			return SUCCESS;
+		}
+
+		if (outer->next(outerRecord.data()) != SUCCESS)
+		{
+			// the outer stream is done with this chunk: move to the next one
+			outerValid = false;
+			if (innerDone || loadChunk() == 0)
+				return E_NOTFOUND;
+
+			outer->close();
+			int ret = outer->open();
+			if (ret != SUCCESS)
+				return ret;
+			numOuterPasses++;
+			continue;
+		}
+
+		auto range = table.equal_range(joinKey(outerRecord[outerOffset], type));
+		match = range.first;
+		matchEnd = range.second;
+		outerValid = true;
+	}
+}
+
+int HashJoinOp::close()
+{
+	chunk.clear();
+	table.clear();
+	inner->close();
+	return outer->close();
+}
+
+int HashJoinOp::getNumOuterPasses()
+{
+	return numOuterPasses;
+}
+
+/************ AggregateOp ************/
+
+// output name of an aggregate: COUNT for COUNT(*), otherwise FUNC_attr (truncated to fit)
+void aggregateName(int aggFunc, char attrName[ATTR_SIZE], char name[ATTR_SIZE])
+{
+	const char *funcNames[] = {"COUNT", "SUM", "AVG", "MIN", "MAX"};
+
+	if (strcmp(attrName, "*") == 0)
+		snprintf(name, ATTR_SIZE, "%s", funcNames[aggFunc]);
+	else
+		snprintf(name, ATTR_SIZE, "%s_%s", funcNames[aggFunc], attrName);
+}
+
+AggregateOp::AggregateOp(Operator *child, int numGroupAttrs, char groupAttrs[][ATTR_SIZE],
+                         int numAggs, int aggFuncs[], char aggAttrs[][ATTR_SIZE])
+{
+	this->child = child;
+	this->groupAttrs.resize(numGroupAttrs);
+	for (int i = 0; i < numGroupAttrs; ++i)
+		strcpy(this->groupAttrs[i].attrName, groupAttrs[i]);
+
+	this->aggAttrs.resize(numAggs);
+	this->aggFuncs.resize(numAggs);
+	for (int i = 0; i < numAggs; ++i)
+	{
+		strcpy(this->aggAttrs[i].attrName, aggAttrs[i]);
+		this->aggFuncs[i] = aggFuncs[i];
+	}
+
+	this->maxGroups = 0;
+	this->nextGroup = 0;
+}
+
+AggregateOp::~AggregateOp()
+{
+	for (auto &partition : pending)
+		fclose(partition.first);
+	delete child;
+}
+
+int AggregateOp::open()
+{
+	int ret = child->open();
+	if (ret != SUCCESS)
+		return ret;
+
+	int numGroupAttrs = groupAttrs.size();
+	int numAggs = aggFuncs.size();
+	schema.resize(numGroupAttrs + numAggs);
+
+	groupOffsets.resize(numGroupAttrs);
+	for (int i = 0; i < numGroupAttrs; ++i)
+	{
+		groupOffsets[i] = child->getAttrOffset(groupAttrs[i].attrName);
+		if (groupOffsets[i] < 0)
+		{
+			child->close();
+			return E_ATTRNOTEXIST;
+		}
+		groupAttrs[i].attrType = child->getAttrType(groupOffsets[i]);
+		schema[i] = groupAttrs[i];
+	}
+
+	aggOffsets.resize(numAggs);
+	for (int i = 0; i < numAggs; ++i)
+	{
+		AttrCatEntry &outAttr = schema[numGroupAttrs + i];
+		aggregateName(aggFuncs[i], aggAttrs[i].attrName, outAttr.attrName);
+		outAttr.attrType = NUMBER;
+
+		if (strcmp(aggAttrs[i].attrName, "*") == 0)
+		{
+			// only COUNT can be computed over whole records
+			if (aggFuncs[i] != AGG_COUNT)
+			{
+				child->close();
+				return E_ATTRNOTEXIST;
+			}
+			aggOffsets[i] = -1;
+			continue;
+		}
+
+		aggOffsets[i] = child->getAttrOffset(aggAttrs[i].attrName);
+		if (aggOffsets[i] < 0)
+		{
+			child->close();
+			return E_ATTRNOTEXIST;
+		}
+		aggAttrs[i].attrType = child->getAttrType(aggOffsets[i]);
+
+		// SUM and AVG are only defined on numbers; MIN and MAX keep the type
+		if ((aggFuncs[i] == AGG_SUM || aggFuncs[i] == AGG_AVG) && aggAttrs[i].attrType != NUMBER)
+		{
+			child->close();
+			return E_ATTRTYPEMISMATCH;
+		}
+		if (aggFuncs[i] == AGG_MIN || aggFuncs[i] == AGG_MAX)
+			outAttr.attrType = aggAttrs[i].attrType;
+	}
+	for (int i = 0; i < (int)schema.size(); ++i)
+		schema[i].offset = i;
+
+	int groupSize = numGroupAttrs * sizeof(Attribute) + numAggs * sizeof(AggregateState) + 2 * ATTR_SIZE;
+	maxGroups = AGGREGATE_MEMORY_BUDGET / groupSize;
+
+	// first pass: aggregate the child stream, spilling what does not fit
+	childRecord.resize(child->getNumAttrs());
+	clearGroups();
+
+	FILE *partitions[AGGREGATE_SPILL_PARTITIONS] = {nullptr};
+	while (child->next(childRecord.data()) == SUCCESS)
+	{
+		ret = addRecord(childRecord.data(), 0, partitions);
+		if (ret != SUCCESS)
+		{
+			queuePartitions(partitions, 1);
+			close();
+			return ret;
+		}
+	}
+	queuePartitions(partitions, 1);
+
+	/* without GROUP BY the aggregates of an empty input are still a record:
+	COUNT is 0 and the others are NULL (NaN for a NUMBER, the empty string for
+	a STRING) */
+	if (numGroupAttrs == 0 && groupStates.empty())
+	{
+		groupStates.resize(numAggs);
+		for (int i = 0; i < numAggs; ++i)
+		{
+			AggregateState &state = groupStates[i];
+			state.count = state.sum = 0;
+			memset(&state.min, 0, sizeof(Attribute));
+			memset(&state.max, 0, sizeof(Attribute));
+			if (aggOffsets[i] != -1 && aggAttrs[i].attrType == NUMBER)
+				state.min.nVal = state.max.nVal = NAN;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/* builds the hash key of the group of a record. Only the meaningful bytes of
+each attribute are used, so equal strings always produce equal keys. */
+std::string AggregateOp::groupKey(union Attribute *record)
+{
+	std::string key;
+	for (int i = 0; i < (int)groupOffsets.size(); ++i)
+	{
+		Attribute &attr = record[groupOffsets[i]];
+		if (groupAttrs[i].attrType == NUMBER)
+			key.append((char *)&attr.nVal, sizeof(attr.nVal));
+		else
+			key.append(attr.sVal, strnlen(attr.sVal, ATTR_SIZE)).push_back('\0');
+	}
+	return key;
+}
+
+/* adds a record to its group in the hash table. If the group is not in the
+table and the table is full, the record is written to a spill partition
+chosen by hashing the key together with the level of the pass. */
+int AggregateOp::addRecord(union Attribute *record, int level, FILE *partitions[])
+{
+	int numGroupAttrs = groupOffsets.size();
+	int numAggs = aggFuncs.size();
+	std::string key = groupKey(record);
+
+	auto it = groupIndex.find(key);
+	int group;
+	if (it != groupIndex.end())
+	{
+		group = it->second;
+	}
+	else if ((int)groupIndex.size() < maxGroups || level >= AGGREGATE_SPILL_PARTITIONS)
+	{
+		/* new group (partitioning is abandoned after a few levels, so that keys
+		which keep hashing together cannot recurse forever) */
+		group = groupIndex.size();
+		groupIndex[key] = group;
+
+		for (int i = 0; i < numGroupAttrs; ++i)
+			groupKeys.push_back(record[groupOffsets[i]]);
+
+		for (int i = 0; i < numAggs; ++i)
+		{
+			AggregateState state;
+			state.count = 0;
+			state.sum = 0;
+			if (aggOffsets[i] >= 0)
+				state.min = state.max = record[aggOffsets[i]];
+			groupStates.push_back(state);
+		}
+	}
+	else
+	{
+		std::string seed = key + (char)level;
+		int partition = std::hash<std::string>()(seed) % AGGREGATE_SPILL_PARTITIONS;
+		if (partitions[partition] == nullptr)
+		{
+			partitions[partition] = tmpfile();
+			if (partitions[partition] == nullptr)
+				return E_DISKFULL;
+		}
+
+		int numAttrs = childRecord.size();
+		if ((int)fwrite(record, sizeof(Attribute), numAttrs, partitions[partition]) != numAttrs)
+			return E_DISKFULL;
+		return SUCCESS;
+	}
+
+	for (int i = 0; i < numAggs; ++i)
+	{
+		AggregateState &state = groupStates[group * numAggs + i];
+		state.count += 1;
+		if (aggOffsets[i] < 0)
+			continue;
+
+		Attribute &attr = record[aggOffsets[i]];
+		int type = aggAttrs[i].attrType;
+		if (type == NUMBER)
+			state.sum += attr.nVal;
+		if (compareAttrs(attr, state.min, type) < 0)
+			state.min = attr;
+		if (compareAttrs(attr, state.max, type) > 0)
+			state.max = attr;
+	}
+	return SUCCESS;
+}
+
+// queues the spill partitions that were written in a pass for later passes
+void AggregateOp::queuePartitions(FILE *partitions[], int level)
+{
+	for (int i = 0; i < AGGREGATE_SPILL_PARTITIONS; ++i)
+	{
+		if (partitions[i] != nullptr)
+			pending.push_back({partitions[i], level});
+	}
+}
+
+void AggregateOp::clearGroups()
+{
+	groupIndex.clear();
+	groupKeys.clear();
+	groupStates.clear();
+	nextGroup = 0;
+}
+
+int AggregateOp::next(union Attribute *record)
+{
+	int numGroupAttrs = groupOffsets.size();
+	int numAggs = aggFuncs.size();
+
+	while (true)
+	{
+		int numGroups = numAggs > 0 ? groupStates.size() / numAggs : groupIndex.size();
+		if (nextGroup < numGroups)
+		{
+			for (int i = 0; i < numGroupAttrs; ++i)
+				record[i] = groupKeys[nextGroup * numGroupAttrs + i];
+
+			for (int i = 0; i < numAggs; ++i)
+			{
+				AggregateState &state = groupStates[nextGroup * numAggs + i];
+				Attribute &out = record[numGroupAttrs + i];
+				switch (aggFuncs[i])
+				{
+					case AGG_COUNT:
+						out.nVal = state.count;
+						break;
+					case AGG_SUM:
+						out.nVal = state.count > 0 ? state.sum : NAN;
+						break;
+					case AGG_AVG:
+						out.nVal = state.count > 0 ? state.sum / state.count : NAN;
+						break;
+					case AGG_MIN:
+						out = state.min;
+						break;
+					case AGG_MAX:
+						out = state.max;
+						break;
+				}
+			}
+			nextGroup++;
+			return SUCCESS;
+		}
+
+		if (pending.empty())
+			return E_NOTFOUND;
+
+		// aggregate the next spilled partition on its own
+		FILE *input = pending.back().first;
+		int level = pending.back().second;
+		pending.pop_back();
+		clearGroups();
+		rewind(input);
+
+		int numAttrs = childRecord.size();
+		FILE *partitions[AGGREGATE_SPILL_PARTITIONS] = {nullptr};
+		int ret = SUCCESS;
+		while (ret == SUCCESS &&
+		       (int)fread(childRecord.data(), sizeof(Attribute), numAttrs, input) == numAttrs)
+		{
+			ret = addRecord(childRecord.data(), level, partitions);
+		}
+		fclose(input);
+		queuePartitions(partitions, level + 1);
+
+		if (ret != SUCCESS)
+			return ret;
+	}
+}
+
+int AggregateOp::close()
+{
+	for (auto &partition : pending)
+		fclose(partition.first);
+	pending.clear();
+	clearGroups();
+	return child->close();
+}
+
+/************ IndexAggregateOp ************/
+
+IndexAggregateOp::IndexAggregateOp(int relId, int numAggs, int aggFuncs[], char aggAttrs[][ATTR_SIZE])
+{
+	this->relId = relId;
+	this->aggFuncs.assign(aggFuncs, aggFuncs + numAggs);
+	this->aggAttrs.resize(numAggs);
+	for (int i = 0; i < numAggs; ++i)
+		strcpy(this->aggAttrs[i].attrName, aggAttrs[i]);
+	this->done = false;
+	OpenRelTable::pinRel(relId);
+}
+
+IndexAggregateOp::~IndexAggregateOp()
+{
+	OpenRelTable::unpinRel(relId);
+}
+
+int IndexAggregateOp::open()
+{
+	int numAggs = aggFuncs.size();
+	schema.resize(numAggs);
+
+	for (int i = 0; i < numAggs; ++i)
+	{
+		aggregateName(aggFuncs[i], aggAttrs[i].attrName, schema[i].attrName);
+		schema[i].attrType = NUMBER;
+		schema[i].offset = i;
+
+		if (aggFuncs[i] == AGG_COUNT && strcmp(aggAttrs[i].attrName, "*") == 0)
+			continue;
+
+		int ret = AttrCacheTable::getAttrCatEntry(relId, aggAttrs[i].attrName, &aggAttrs[i]);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (aggFuncs[i] == AGG_COUNT)
+			continue;
+
+		// any other aggregate needs a scan
+		if ((aggFuncs[i] != AGG_MIN && aggFuncs[i] != AGG_MAX) || aggAttrs[i].rootBlock == -1)
+			return E_NOINDEX;
+
+		schema[i].attrType = aggAttrs[i].attrType;
+	}
+
+	done = false;
+	return SUCCESS;
+}
+
+int IndexAggregateOp::next(union Attribute *record)
+{
+	if (done)
+		return E_NOTFOUND;
+
+	RelCatEntry relCatEntry;
+	RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+
+	for (int i = 0; i < (int)aggFuncs.size(); ++i)
+	{
+		memset(&record[i], 0, sizeof(Attribute));
+
+		int ret = SUCCESS;
+		if (aggFuncs[i] == AGG_COUNT)
+			record[i].nVal = relCatEntry.numRecs;
+		else if (aggFuncs[i] == AGG_MIN)
+			ret = BPlusTree::bPlusMin(relId, aggAttrs[i].attrName, &record[i]);
+		else
+			ret = BPlusTree::bPlusMax(relId, aggAttrs[i].attrName, &record[i]);
+
+		// an empty index gives NULL, like the aggregate of an empty scan
+		if (ret == E_NOTFOUND && schema[i].attrType == NUMBER)
+			record[i].nVal = NAN;
+		else if (ret != SUCCESS && ret != E_NOTFOUND)
+			return ret;
+	}
+
+	done = true;
+	return SUCCESS;
+}
+
+int IndexAggregateOp::close()
+{
+	return SUCCESS;
+}
@@ -0,0 +1,585 @@
+#ifndef NITCBASE_OPERATOR_H
+#define NITCBASE_OPERATOR_H
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../BlockAccess/BlockAccess.h"
+#include "../Cache/OpenRelTable.h"
+#include "../define/constants.h"
+
+/*
+ * condition of a WHERE clause: the comparison `attr op value` (value as
+ * written in the query; it is converted to the type of attr where it is
+ * used), or the AND / OR of the conditions in children.
+ */
+struct Predicate {
+  int type;  // PRED_COMPARE, PRED_AND or PRED_OR
+  char attr[ATTR_SIZE];
+  int op;
+  char value[ATTR_SIZE];
+  std::vector<Predicate> children;
+};
+
+/*
+ * Iterator interface of the query pipeline. A query is a tree of operators;
+ * the root is drained with open() / next() / close() and every operator pulls
+ * records from its children one at a time, so no intermediate relation is
+ * materialized on disk.
+ * next() returns SUCCESS and fills `record` (numAttrs attributes, allocated by
+ * the caller) or E_NOTFOUND once the stream is exhausted.
+ */
+class Operator {
+ public:
+  virtual ~Operator() {}
+  virtual int open() = 0;
+  virtual int next(union Attribute *record) = 0;
+  virtual int close() = 0;
+
+  /* the consumer stops after about numRecords records (a LIMIT above the
+     operator), so an operator that reads its whole input in open() should
+     stream it instead when it can. The stream itself is not cut short. */
+  virtual void setLimitHint(int /* numRecords */) {}
+
+  int getNumAttrs();
+  int getAttrType(int attrOffset);
+  int getAttrName(int attrOffset, char attrName[ATTR_SIZE]);
+  int getAttrOffset(char attrName[ATTR_SIZE]);
+
+ protected:
+  // output schema of the operator (filled in by open())
+  std::vector<AttrCatEntry> schema;
+
+  int loadSchema(int relId);
+  int loadJoinSchema(Operator *outer, Operator *inner, int innerOffset);
+};
+
+/* sequential scan over all the records of an open relation. Operators that
+   read a relation pin it in the open relation table for their lifetime. */
+class ScanOp : public Operator {
+ public:
+  ScanOp(int relId);
+  ~ScanOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  int relId;
+  RecId cursor;
+};
+
+/* records of an open relation satisfying `attr op value` (linear or B+ tree search) */
+class SelectScanOp : public Operator {
+ public:
+  SelectScanOp(int relId, char attrName[ATTR_SIZE], int op, union Attribute attrVal);
+  ~SelectScanOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+  // restart the search with a new value (used as the inner side of a join)
+  void rescan(union Attribute attrVal);
+
+ private:
+  int relId;
+  char attrName[ATTR_SIZE];
+  int op;
+  union Attribute attrVal;
+  RecId recCursor;
+  IndexId indexCursor;
+};
+
+/*
+ * records of an open relation whose attribute attrName satisfies `attr op
+ * value`, or lies between a lower and an upper bound (see BPlusCursor), found
+ * by a single scan of the B+ tree of the attribute. The scan keeps its own
+ * position, so the search index of the attribute is left alone.
+ * The records come in key order, unless bitmap fetch is set: then open()
+ * collects the RecIds of the whole range in a RecIdBitmap and the records are
+ * read in block order, each record block once. Under a limit hint the range is
+ * streamed in key order, since collecting it would read every leaf of the
+ * range for the few records returned.
+ */
+class IndexScanOp : public Operator {
+ public:
+  IndexScanOp(int relId, char attrName[ATTR_SIZE], int op, union Attribute attrVal);
+  IndexScanOp(int relId, char attrName[ATTR_SIZE], int lowOp, union Attribute lowVal, int highOp,
+              union Attribute highVal);
+  ~IndexScanOp();
+  void setBitmapFetch(bool bitmapFetch);
+  void setLimitHint(int numRecords);
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  int relId;
+  char attrName[ATTR_SIZE];
+  int op;  // NO_BOUND if the scan is given by the bounds
+  union Attribute attrVal;
+  int lowOp;
+  union Attribute lowVal;
+  int highOp;
+  union Attribute highVal;
+  BPlusCursor cursor;
+
+  bool bitmapFetch;
+  int limitHint;  // -1 if no limit hint was given
+  RecIdBitmap bitmap;
+  RecId recCursor;  // RecId returned last from the bitmap
+};
+
+/*
+ * the records of an open relation at a set of RecIds (found through its
+ * indexes), fetched in the order of their blocks so that every record block is
+ * read once
+ */
+class RecIdScanOp : public Operator {
+ public:
+  RecIdScanOp(int relId, RecIdBitmap &recIds);
+  ~RecIdScanOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+  // the RecId of the record returned last
+  RecId getRecId();
+
+ private:
+  int relId;
+  RecIdBitmap recIds;
+  RecId recCursor;
+};
+
+/*
+ * index-only scan: the values of an indexed attribute satisfying
+ * `attr op value` (or lying between two bounds), read from the leaves of its
+ * B+ tree. The output has the single attribute attrName and no record block
+ * is fetched, so it replaces a SelectScanOp when the query projects (or
+ * aggregates) only the key.
+ */
+class IndexOnlyScanOp : public Operator {
+ public:
+  IndexOnlyScanOp(int relId, char attrName[ATTR_SIZE], int op, union Attribute attrVal);
+  IndexOnlyScanOp(int relId, char attrName[ATTR_SIZE], int lowOp, union Attribute lowVal, int highOp,
+                  union Attribute highVal);
+  ~IndexOnlyScanOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  int relId;
+  char attrName[ATTR_SIZE];
+  int op;  // NO_BOUND if the scan is given by the bounds
+  union Attribute attrVal;
+  int lowOp;
+  union Attribute lowVal;
+  int highOp;
+  union Attribute highVal;
+  BPlusCursor cursor;
+};
+
+/* records of the child stream satisfying a WHERE condition */
+class FilterOp : public Operator {
+ public:
+  FilterOp(Operator *child, Predicate *where);
+  ~FilterOp();
+  void setLimitHint(int numRecords);
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  Operator *child;
+  Predicate where;
+
+  // the comparisons of `where` in depth-first order, resolved by open(): the
+  // offset of the attribute in the child's records and the value in its type
+  std::vector<int> offsets;
+  std::vector<Attribute> values;
+
+  int resolve(Predicate *pred);
+  bool satisfies(Predicate *pred, union Attribute *record, int *comparison);
+};
+
+/* the listed attributes of every record of the child stream, optionally
+   renamed to outputNames in the output schema */
+class ProjectOp : public Operator {
+ public:
+  ProjectOp(Operator *child, int numAttrs, char attrNames[][ATTR_SIZE]);
+  ProjectOp(Operator *child, int numAttrs, char attrNames[][ATTR_SIZE], char outputNames[][ATTR_SIZE]);
+  ~ProjectOp();
+  void setLimitHint(int numRecords);
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  Operator *child;
+  std::vector<AttrCatEntry> targetAttrs;
+  std::vector<AttrCatEntry> outputAttrs;
+  std::vector<int> attrOffsets;
+  std::vector<Attribute> childRecord;
+};
+
+/*
+ * equi-join of the child stream (outer) with an open relation (inner) on
+ * outer.outerAttr = inner.innerAttr. The inner relation is probed with
+ * BlockAccess::search() once per outer record. The output contains all the
+ * outer attributes followed by the inner attributes except innerAttr.
+ */
+class JoinOp : public Operator {
+ public:
+  JoinOp(Operator *outer, int innerRelId, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE]);
+  ~JoinOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  Operator *outer;
+  SelectScanOp *inner;
+  int innerRelId;
+  char outerAttr[ATTR_SIZE];
+  char innerAttr[ATTR_SIZE];
+  int outerOffset;
+  int innerOffset;
+  bool outerValid;
+  std::vector<Attribute> outerRecord;
+  std::vector<Attribute> innerRecord;
+};
+
+/*
+ * semi-join (anti = false) or anti-join (anti = true) of the child stream
+ * (outer) with an open relation (inner) on outer.outerAttr = inner.innerAttr:
+ * the outer records that have (or do not have) a matching inner record, each
+ * returned once and with the outer schema only. With probeIndex set and a
+ * hash index or a B+ tree on innerAttr, the index is probed once per outer
+ * record and a match is found without reading the inner record; otherwise the
+ * keys of the inner relation are read once into an in-memory hash set.
+ */
+class SemiJoinOp : public Operator {
+ public:
+  SemiJoinOp(Operator *outer, int innerRelId, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE], bool anti,
+             bool probeIndex);
+  ~SemiJoinOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+  // whether the last open() chose to probe an index of the inner relation
+  bool usesIndex();
+
+ private:
+  Operator *outer;
+  int innerRelId;
+  char outerAttr[ATTR_SIZE];
+  char innerAttr[ATTR_SIZE];
+  bool anti;
+  bool probeIndex;
+  int outerOffset;
+  int type;
+
+  bool hashProbe;
+  HashIndexInfo hashIndex;
+  bool treeProbe;
+  std::unordered_set<std::string> innerKeys;  // used without either index
+
+  int loadInnerKeys(int innerOffset);
+  bool hasMatch(union Attribute key);
+};
+
+/*
+ * external merge sort of the child stream on keyAttrs (all ascending, or all
+ * descending). Records are collected in an arena of SORT_MEMORY_BUDGET bytes;
+ * if the input does not fit, every full arena is sorted and written to a
+ * temporary file as a run, and the runs are merged SORT_MERGE_FANIN at a time
+ * with a loser tree until a single merge produces the output.
+ * With distinct set, records equal on every attribute are returned only once
+ * (the attributes that are not keys are used as further sort keys).
+ */
+class SortOp : public Operator {
+ public:
+  SortOp(Operator *child, int numKeys, char keyAttrs[][ATTR_SIZE], bool descending, bool distinct);
+  ~SortOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+  /* only the first `limit` records of the order are needed (ORDER BY ...
+     LIMIT): if they fit in the arena, a heap of the smallest `limit` records
+     replaces the sort */
+  void setLimit(int limit);
+
+  // statistics of the last open()
+  int getNumRuns();
+  int getNumPasses();
+
+ private:
+  Operator *child;
+  std::vector<AttrCatEntry> keyAttrs;
+  std::vector<int> keyOffsets;
+  bool descending;
+  bool distinct;
+  int numAttrs;
+  int limit;
+
+  // records held in memory and the sorted order of the ones in use
+  std::vector<Attribute> arena;
+  std::vector<int> order;
+  int maxRecords;
+  int numRecords;
+  int arenaPos;
+
+  // runs written to temporary files
+  std::vector<FILE *> runs;
+  int numRuns;
+  int numPasses;
+
+  // loser tree over the runs being merged: tree[0] is the run with the
+  // smallest current record, tree[1..k-1] hold the losers of each match
+  std::vector<FILE *> mergeInputs;
+  std::vector<Attribute> heads;
+  std::vector<bool> exhausted;
+  std::vector<int> tree;
+
+  std::vector<Attribute> lastRecord;
+  bool hasLast;
+
+  int compare(union Attribute *rec1, union Attribute *rec2);
+  int readTopN();
+  int writeRun();
+  void sortArena();
+  void readHead(int run);
+  bool beats(int run1, int run2);
+  void adjust(int run);
+  void startMerge(std::vector<FILE *> &inputs);
+  int mergeNext(union Attribute *record);
+  void endMerge();
+};
+
+/*
+ * the records of the child stream after skipping the first `offset`, up to
+ * `limit` of them. No record is pulled from the child once the limit is
+ * reached, so scans and index searches below it stop early; the child is
+ * given a limit hint of offset + limit.
+ */
+class LimitOp : public Operator {
+ public:
+  LimitOp(Operator *child, int limit, int offset);
+  ~LimitOp();
+  void setLimitHint(int numRecords);
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  Operator *child;
+  int limit;
+  int offset;
+  int numSkipped;
+  int numReturned;
+};
+
+/*
+ * sort-merge equi-join of two child streams on outer.outerAttr =
+ * inner.innerAttr. Both inputs are sorted on the join attribute by a SortOp,
+ * and the inner records with the current key are kept in memory so that they
+ * can be joined with every outer record having that key. The output has the
+ * same schema as JoinOp.
+ */
+class MergeJoinOp : public Operator {
+ public:
+  MergeJoinOp(Operator *outer, Operator *inner, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE]);
+  ~MergeJoinOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  SortOp *outer;
+  SortOp *inner;
+  char outerAttr[ATTR_SIZE];
+  char innerAttr[ATTR_SIZE];
+  int outerOffset;
+  int innerOffset;
+  int type;
+
+  std::vector<Attribute> outerRecord;
+  std::vector<Attribute> innerRecord;
+  bool innerValid;
+
+  // inner records having the key of the current group
+  std::vector<Attribute> group;
+  union Attribute groupKey;
+  int groupPos;
+};
+
+/*
+ * block nested-loop equi-join of two child streams on outer.outerAttr =
+ * inner.innerAttr, for joins without an index on the inner side. The outer
+ * records are read in chunks of at most memoryBudget bytes, and the inner
+ * stream is reopened and read once per chunk, comparing each inner key with
+ * the keys of the chunk held in an array. The output has the same schema as
+ * JoinOp, in the order of the inner records within each chunk.
+ */
+class BlockNestedLoopJoinOp : public Operator {
+ public:
+  BlockNestedLoopJoinOp(Operator *outer, Operator *inner, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE],
+                        int memoryBudget);
+  ~BlockNestedLoopJoinOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+  // number of times the inner stream has been read since open()
+  int getNumInnerPasses();
+
+ private:
+  int loadChunk();
+
+  Operator *outer;
+  Operator *inner;
+  char outerAttr[ATTR_SIZE];
+  char innerAttr[ATTR_SIZE];
+  int outerOffset;
+  int innerOffset;
+  int type;
+  int memoryBudget;
+
+  // outer records of the current chunk and their join keys
+  std::vector<Attribute> chunk;
+  std::vector<Attribute> chunkKeys;
+  bool outerDone;
+
+  std::vector<Attribute> innerRecord;
+  bool innerValid;
+  int chunkPos;
+  int numInnerPasses;
+};
+
+/*
+ * hash equi-join of two child streams on outer.outerAttr = inner.innerAttr.
+ * The inner records are read into an in-memory hash table on the join key,
+ * at most memoryBudget bytes at a time, and the outer stream is probed
+ * against it; if the inner stream does not fit, the outer stream is reopened
+ * and read once per chunk of the inner. The output has the same schema as
+ * JoinOp.
+ */
+class HashJoinOp : public Operator {
+ public:
+  HashJoinOp(Operator *outer, Operator *inner, char outerAttr[ATTR_SIZE], char innerAttr[ATTR_SIZE],
+             int memoryBudget);
+  ~HashJoinOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+  // number of times the outer stream has been read since open()
+  int getNumOuterPasses();
+
+ private:
+  int loadChunk();
+
+  Operator *outer;
+  Operator *inner;
+  char outerAttr[ATTR_SIZE];
+  char innerAttr[ATTR_SIZE];
+  int outerOffset;
+  int innerOffset;
+  int type;
+  int memoryBudget;
+
+  // inner records of the current chunk, and their positions by join key
+  std::vector<Attribute> chunk;
+  std::unordered_multimap<std::string, int> table;
+  bool innerDone;
+
+  std::vector<Attribute> outerRecord;
+  std::unordered_multimap<std::string, int>::iterator match, matchEnd;
+  bool outerValid;
+  int numOuterPasses;
+};
+
+/* running state of one aggregate function within one group */
+struct AggregateState {
+  double count;
+  double sum;
+  union Attribute min;
+  union Attribute max;
+};
+
+/*
+ * hash aggregation: groups the records of the child stream by groupAttrs and
+ * computes aggFuncs (AGG_COUNT ... AGG_MAX) over aggAttrs in each group ("*"
+ * is allowed for AGG_COUNT). The output has the group attributes followed by
+ * one attribute per aggregate, named by aggregateName().
+ * The hash table holds at most AGGREGATE_MEMORY_BUDGET bytes of groups; once
+ * it is full, records of groups that are not in the table are spilled to one
+ * of AGGREGATE_SPILL_PARTITIONS temporary files, and every partition is
+ * aggregated on its own after the groups in memory have been emitted.
+ */
+class AggregateOp : public Operator {
+ public:
+  AggregateOp(Operator *child, int numGroupAttrs, char groupAttrs[][ATTR_SIZE],
+              int numAggs, int aggFuncs[], char aggAttrs[][ATTR_SIZE]);
+  ~AggregateOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  Operator *child;
+  std::vector<AttrCatEntry> groupAttrs;
+  std::vector<AttrCatEntry> aggAttrs;
+  std::vector<int> aggFuncs;
+  std::vector<int> groupOffsets;
+  std::vector<int> aggOffsets;  // -1 for COUNT(*)
+  std::vector<Attribute> childRecord;
+
+  // hash table of groups: normalized key -> group number
+  std::unordered_map<std::string, int> groupIndex;
+  std::vector<Attribute> groupKeys;         // numGroupAttrs per group
+  std::vector<AggregateState> groupStates;  // numAggs per group
+  int maxGroups;
+  int nextGroup;
+
+  // partitions spilled to temporary files and the level they were spilled at
+  std::vector<std::pair<FILE *, int>> pending;
+
+  std::string groupKey(union Attribute *record);
+  int addRecord(union Attribute *record, int level, FILE *partitions[]);
+  void queuePartitions(FILE *partitions[], int level);
+  void clearGroups();
+};
+
+/*
+ * aggregates over a whole relation that can be answered without a scan:
+ * COUNT from #Records in the relation catalog, and MIN / MAX of an indexed
+ * attribute from the first / last entry of its B+ tree. Emits a single record.
+ */
+class IndexAggregateOp : public Operator {
+ public:
+  IndexAggregateOp(int relId, int numAggs, int aggFuncs[], char aggAttrs[][ATTR_SIZE]);
+  ~IndexAggregateOp();
+  int open();
+  int next(union Attribute *record);
+  int close();
+
+ private:
+  int relId;
+  std::vector<int> aggFuncs;
+  std::vector<AttrCatEntry> aggAttrs;
+  bool done;
+};
+
+int satisfiesOp(int cmpVal, int op);
+Predicate comparison(char attrName[ATTR_SIZE], int op, char value[ATTR_SIZE]);
+void aggregateName(int aggFunc, char attrName[ATTR_SIZE], char name[ATTR_SIZE]);
+
+#endif  // NITCBASE_OPERATOR_H
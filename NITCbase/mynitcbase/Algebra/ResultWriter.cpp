@@ -0,0 +1,78 @@
+#include "ResultWriter.h"
+#include <cmath>
+#include <cstring>
+
+ResultWriter::ResultWriter(FILE *fp, Operator *root)
+{
+	this->fp = fp;
+	this->root = root;
+	this->used = 0;
+	this->numRecords = 0;
+}
+
+// copies `len` bytes to the buffer, writing the buffer out first if they do not fit
+int ResultWriter::append(const char *str, int len)
+{
+	if (used + len > BLOCK_SIZE)
+	{
+		int ret = flush();
+		if (ret != SUCCESS)
+			return ret;
+	}
+	memcpy(buffer + used, str, len);
+	used += len;
+	return SUCCESS;
+}
+
+// writes the attribute names of the records as the first line
+int ResultWriter::writeHeader()
+{
+	int numAttrs = root->getNumAttrs();
+	for (int i = 0; i < numAttrs; ++i)
+	{
+		char attrName[ATTR_SIZE];
+		root->getAttrName(i, attrName);
+		append(attrName, strlen(attrName));
+		append(i == numAttrs - 1 ? "\n" : ",", 1);
+	}
+	return SUCCESS;
+}
+
+int ResultWriter::writeRecord(union Attribute *record)
+{
+	int numAttrs = root->getNumAttrs();
+	for (int i = 0; i < numAttrs; ++i)
+	{
+		// a NUMBER is printed with "%f" (NULL if it is NaN, the result of an
+		// aggregate over no records) and a STRING as it is
+		char field[2 * ATTR_SIZE];
+		int len;
+		if (root->getAttrType(i) == NUMBER && std::isnan(record[i].nVal))
+			len = snprintf(field, sizeof(field), "NULL");
+		else if (root->getAttrType(i) == NUMBER)
+			len = snprintf(field, sizeof(field), "%f", record[i].nVal);
+		else
+			len = strnlen(record[i].sVal, ATTR_SIZE);
+
+		int ret = append(root->getAttrType(i) == NUMBER ? field : record[i].sVal, len);
+		if (ret != SUCCESS)
+			return ret;
+		append(i == numAttrs - 1 ? "\n" : ",", 1);
+	}
+	numRecords++;
+	return SUCCESS;
+}
+
+int ResultWriter::flush()
+{
+	if (used > 0 && fwrite(buffer, 1, used, fp) != (size_t)used)
+		return FAILURE;
+	used = 0;
+	fflush(fp);
+	return SUCCESS;
+}
+
+int ResultWriter::getNumRecords()
+{
+	return numRecords;
+}
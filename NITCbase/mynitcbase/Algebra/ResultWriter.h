@@ -0,0 +1,34 @@
+#ifndef NITCBASE_RESULTWRITER_H
+#define NITCBASE_RESULTWRITER_H
+
+#include <cstdio>
+
+#include "../define/constants.h"
+#include "Operator.h"
+
+/*
+ * Writes the records produced by an operator tree as csv lines (the format of
+ * the XFS export command). Lines are collected in an in-memory buffer which is
+ * written out with a single fwrite() whenever it fills up, so streaming a query
+ * result does not allocate any disk blocks of the database. The caller must
+ * flush() the writer before closing the file.
+ */
+class ResultWriter {
+ public:
+  ResultWriter(FILE *fp, Operator *root);
+  int writeHeader();
+  int writeRecord(union Attribute *record);
+  int flush();
+  int getNumRecords();
+
+ private:
+  FILE *fp;
+  Operator *root;
+  char buffer[BLOCK_SIZE];
+  int used;
+  int numRecords;
+
+  int append(const char *str, int len);
+};
+
+#endif  // NITCBASE_RESULTWRITER_H
@@ -1,9 +1,297 @@
 #include "BPlusTree.h"
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <vector>
+
+/************ posting lists ************/
+
+/* The records of a key with POSTING_THRESHOLD or more records are kept in a
+posting list instead of one leaf entry each: the key then has a single leaf
+entry, whose block is the first block of the list and whose slot is
+POSTING_LIST_SLOT. A posting block (IND_POSTING) holds numEntries RecIds and
+is linked to the next block of the list by rblock. A record is added at the
+end of the list and a removed one is replaced by the last record, so only
+the last block may be partly filled. A list is never turned back into leaf
+entries; it is released with the last record of its key. */
+
+static int postingCapacity()
+{
+	return (BLOCK_SIZE - HEADER_SIZE) / (2 * sizeof(int32_t));
+}
+
+static bool isPostingEntry(Index *entry)
+{
+	return entry->slot == POSTING_LIST_SLOT;
+}
+
+static RecId getPosting(IndNode &postingBlk, int index)
+{
+	int32_t recId[2];
+	postingBlk.getBytes((unsigned char *)recId, index * sizeof(recId), sizeof(recId));
+	return RecId{recId[0], recId[1]};
+}
+
+static void setPosting(IndNode &postingBlk, int index, RecId recId)
+{
+	int32_t entry[2] = {recId.block, recId.slot};
+	postingBlk.setBytes((unsigned char *)entry, index * sizeof(entry), sizeof(entry));
+}
+
+// releases every block of the posting list starting at block
+static void destroyPostingList(int block)
+{
+	while (block != -1)
+	{
+		IndNode postingBlk(block);
+		HeadInfo head;
+		postingBlk.getHeader(&head);
+		postingBlk.releaseBlock();
+		block = head.rblock;
+	}
+}
+
+/* creates a posting list holding recIds; returns its first block, or
+E_DISKFULL (nothing is left allocated) */
+static int newPostingList(std::vector<RecId> &recIds)
+{
+	int firstBlock = -1;
+	HeadInfo prevHead;
+	int prevBlock = -1;
+
+	for (int i = 0; i < (int)recIds.size(); i += postingCapacity())
+	{
+		IndNode postingBlk('P');
+		int block = postingBlk.getBlockNum();
+		if (block < 0 || block >= DISK_BLOCKS)
+		{
+			destroyPostingList(firstBlock);
+			return E_DISKFULL;
+		}
+
+		HeadInfo head;
+		postingBlk.getHeader(&head);
+		head.lblock = prevBlock;
+		head.numEntries = std::min(postingCapacity(), (int)recIds.size() - i);
+		for (int j = 0; j < head.numEntries; ++j)
+			setPosting(postingBlk, j, recIds[i + j]);
+		postingBlk.setHeader(&head);
+
+		if (prevBlock == -1)
+		{
+			firstBlock = block;
+		}
+		else
+		{
+			IndNode prevBlk(prevBlock);
+			prevBlk.getHeader(&prevHead);
+			prevHead.rblock = block;
+			prevBlk.setHeader(&prevHead);
+		}
+		prevBlock = block;
+	}
+
+	return firstBlock;
+}
+
+// adds recId at the end of the posting list starting at block
+static int appendPosting(int block, RecId recId)
+{
+	IndNode postingBlk(block);
+	HeadInfo head;
+	postingBlk.getHeader(&head);
+	while (head.rblock != -1)
+	{
+		block = head.rblock;
+		postingBlk = IndNode(block);
+		postingBlk.getHeader(&head);
+	}
+
+	if (head.numEntries < postingCapacity())
+	{
+		setPosting(postingBlk, head.numEntries, recId);
+		head.numEntries++;
+		postingBlk.setHeader(&head);
+		return SUCCESS;
+	}
+
+	// the last block is full: the record starts a new one
+	std::vector<RecId> recIds = {recId};
+	int newBlock = newPostingList(recIds);
+	if (newBlock < 0)
+		return E_DISKFULL;
+
+	IndNode newBlk(newBlock);
+	HeadInfo newHead;
+	newBlk.getHeader(&newHead);
+	newHead.lblock = block;
+	newBlk.setHeader(&newHead);
+	head.rblock = newBlock;
+	postingBlk.setHeader(&head);
+	return SUCCESS;
+}
+
+/* removes recId from the posting list starting at firstBlock (E_NOTFOUND if
+it is not there). *empty tells whether that was the last record of the list,
+whose block has then been released. */
+static int removePosting(int firstBlock, RecId recId, bool *empty)
+{
+	*empty = false;
+
+	// find the record, and the last block of the list
+	int foundBlock = -1, foundIndex = -1;
+	int block = firstBlock, lastBlock = -1;
+	HeadInfo head;
+	while (block != -1)
+	{
+		IndNode postingBlk(block);
+		postingBlk.getHeader(&head);
+		for (int i = 0; foundBlock == -1 && i < head.numEntries; ++i)
+		{
+			RecId posting = getPosting(postingBlk, i);
+			if (posting.block == recId.block && posting.slot == recId.slot)
+			{
+				foundBlock = block;
+				foundIndex = i;
+			}
+		}
+		lastBlock = block;
+		block = head.rblock;
+	}
+	if (foundBlock == -1)
+		return E_NOTFOUND;
+
+	// the last record of the list takes the place of the removed one
+	IndNode lastBlk(lastBlock);
+	lastBlk.getHeader(&head);
+	RecId last = getPosting(lastBlk, head.numEntries - 1);
+	IndNode foundBlk(foundBlock);
+	setPosting(foundBlk, foundIndex, last);
+	head.numEntries--;
+	lastBlk.setHeader(&head);
+
+	if (head.numEntries == 0)
+	{
+		if (head.lblock == -1)
+		{
+			*empty = true;
+		}
+		else
+		{
+			IndNode prevBlk(head.lblock);
+			HeadInfo prevHead;
+			prevBlk.getHeader(&prevHead);
+			prevHead.rblock = -1;
+			prevBlk.setHeader(&prevHead);
+		}
+		lastBlk.releaseBlock();
+	}
+	return SUCCESS;
+}
+
+/* moves cursor to the record of the posting list after the one at
+(cursor->postingBlock, cursor->postingIndex), returned in *recId; returns
+E_NOTFOUND at the end of the list */
+static int nextPosting(IndexId *cursor, RecId *recId)
+{
+	int block = cursor->postingBlock;
+	int index = cursor->postingIndex + 1;
+	while (block != -1)
+	{
+		IndNode postingBlk(block);
+		HeadInfo head;
+		postingBlk.getHeader(&head);
+		if (index < head.numEntries)
+		{
+			cursor->postingBlock = block;
+			cursor->postingIndex = index;
+			*recId = getPosting(postingBlk, index);
+			return SUCCESS;
+		}
+		block = head.rblock;
+		index = 0;
+	}
+	return E_NOTFOUND;
+}
+
+// the leftmost leaf that can hold attrVal: the left child of the first key >= attrVal on every level
+static int leftmostLeaf(int block, Attribute attrVal, int attrType)
+{
+	while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL)
+	{
+		IndInternal internalBlk(block);
+		HeadInfo intHead;
+		internalBlk.getHeader(&intHead);
+
+		InternalEntry intEntry;
+		bool found = false;
+		for (int index = 0; index < intHead.numEntries; ++index)
+		{
+			internalBlk.getEntry(&intEntry, index);
+			if (compareAttrs(intEntry.attrVal, attrVal, attrType) >= 0)
+			{
+				found = true;
+				break;
+			}
+		}
+		block = found ? intEntry.lChild : intEntry.rChild;
+	}
+	return block;
+}
+
+/* finds the leaf entries of attrVal in the tree rooted at rootBlock. Returns
+the first block of the posting list of the key if it has one; otherwise -1,
+and the records of its leaf entries (up to POSTING_THRESHOLD of them) are
+added to recIds, unless it is nullptr. */
+static int keyEntries(int rootBlock, Attribute attrVal, int attrType, std::vector<RecId> *recIds)
+{
+	int block = leftmostLeaf(rootBlock, attrVal, attrType);
+	int numFound = 0;
+	while (block != -1)
+	{
+		IndLeaf leafBlk(block);
+		HeadInfo leafHead;
+		leafBlk.getHeader(&leafHead);
+
+		for (int index = 0; index < leafHead.numEntries; ++index)
+		{
+			Index leafEntry;
+			leafBlk.getEntry(&leafEntry, index);
+			int cmpVal = compareAttrs(leafEntry.attrVal, attrVal, attrType);
+			if (cmpVal > 0)
+				return -1;
+			if (cmpVal < 0)
+				continue;
+
+			if (isPostingEntry(&leafEntry))
+				return leafEntry.block;
+			if (recIds != nullptr)
+				recIds->push_back(RecId{leafEntry.block, leafEntry.slot});
+			if (++numFound >= POSTING_THRESHOLD)
+				return -1;
+		}
+		block = leafHead.rblock;
+	}
+	return -1;
+}
 
 
 RecId BPlusTree::bPlusSearch(int relId, char attrName[ATTR_SIZE], Attribute attrVal, int op)
+{
+	Index leafEntry;
+	if (BPlusTree::bPlusSearchEntry(relId, attrName, attrVal, op, &leafEntry) != SUCCESS)
+		return RecId{-1, -1};
+
+	// return the recId {leafEntry.block, leafEntry.slot}.
+	return RecId{leafEntry.block, leafEntry.slot};
+}
+
+/* Same search as bPlusSearch(), but the whole leaf entry that satisfies the
+condition is returned in *entry (SUCCESS), or E_NOTFOUND once there are no
+more entries. The key is read from the leaf, so an index-only scan never has
+to fetch the record. An entry with a posting list is returned once for every
+record of the list, with the block and slot of that record. */
+int BPlusTree::bPlusSearchEntry(int relId, char attrName[ATTR_SIZE], Attribute attrVal, int op, Index *entry)
 {
 	// declare searchIndex which will be used to store search index for attrName.
 	IndexId searchIndex;
@@ -31,7 +319,7 @@ RecId BPlusTree::bPlusSearch(int relId, char attrName[ATTR_SIZE], Attribute attr
 
 		if (block==-1)
 		{
-			return RecId{-1, -1};
+			return E_NOTFOUND;
 		}
 
 	}
@@ -52,6 +340,22 @@ RecId BPlusTree::bPlusSearch(int relId, char attrName[ATTR_SIZE], Attribute attr
 		// load header into leafHead using BlockBuffer::getHeader().
 		leaf.getHeader(&leafHead);
 
+		// the rest of the posting list of the previous entry comes first
+		Index leafEntry;
+		if (searchIndex.index < leafHead.numEntries && leaf.getEntry(&leafEntry, searchIndex.index) == SUCCESS &&
+		    isPostingEntry(&leafEntry))
+		{
+			RecId recId;
+			if (nextPosting(&searchIndex, &recId) == SUCCESS)
+			{
+				AttrCacheTable::setSearchIndex(relId, attrName, &searchIndex);
+				leafEntry.block = recId.block;
+				leafEntry.slot = recId.slot;
+				*entry = leafEntry;
+				return SUCCESS;
+			}
+		}
+
 		if (index >= leafHead.numEntries)
 		{
 		 	/* (all the entries in the block has been searched; search from the
@@ -64,7 +368,7 @@ RecId BPlusTree::bPlusSearch(int relId, char attrName[ATTR_SIZE], Attribute attr
 			if (block == -1)
 			{
 				// (end of linked list reached - the search is done.)
-				return RecId{-1, -1};
+				return E_NOTFOUND;
 			}
 		}
 	}
@@ -203,18 +507,23 @@ RecId BPlusTree::bPlusSearch(int relId, char attrName[ATTR_SIZE], Attribute attr
 				// set search index to {block, index}
 				searchIndex.block=block;
 				searchIndex.index=index;
+
+				// (the first record of a posting list stands for the entry)
+				if (isPostingEntry(&leafEntry))
+				{
+					RecId recId;
+					searchIndex.postingBlock = leafEntry.block;
+					searchIndex.postingIndex = -1;
+					nextPosting(&searchIndex, &recId);
+					leafEntry.block = recId.block;
+					leafEntry.slot = recId.slot;
+				}
 				//printf("setting search index to %d %d \n",block,index);
 				AttrCacheTable:: setSearchIndex(relId, attrName, &searchIndex);
 
-				// return the recId {leafEntry.block, leafEntry.slot}.
-				//printf("returning %d %d ",leafEntry.block,leafEntry.slot);
-//				printf("searchIndex.block=%d searchIndex.index=index=%d\n",searchIndex.block,searchIndex.index=index);
-//				printf("leafEntry.block=%d leafEntry.slot=%d\n",leafEntry.block,leafEntry.slot);
-
-				return RecId{leafEntry.block, leafEntry.slot};
-				
-				
-				
+				// return the entry (its key and the recId {block, slot})
+				*entry = leafEntry;
+				return SUCCESS;
 
 			} 
 			else if((op == EQ || op == LE || op == LT) && cmpVal > 0)
@@ -222,20 +531,17 @@ RecId BPlusTree::bPlusSearch(int relId, char attrName[ATTR_SIZE], Attribute attr
 				/*future entries will not satisfy EQ, LE, LT since the values
 				are arranged in ascending order in the leaves */
 
-				return RecId{-1, -1};
+				return E_NOTFOUND;
 			}
 
 			// search next index.
 			++index;
 		}
 
-		/*only for NE operation do we have to check the entire linked list;
-		for all the other op it is guaranteed that the block being searched
-		will have an entry, if it exists, satisying that op. */
-		if (op != NE)
-		{
-		    break;
-		}
+		/* the search continues in the next leaf: NE has to check the entire
+		linked list, and once entries have been deleted the first matching
+		entry need not be in the leaf reached from the root (EQ, LT and LE
+		still stop at the first entry greater than attrVal) */
 
 		// block = next block in the linked list, i.e., the rblock in leafHead.
 		block=leafHead.rblock;
@@ -243,10 +549,159 @@ RecId BPlusTree::bPlusSearch(int relId, char attrName[ATTR_SIZE], Attribute attr
 		index=0;
 	}
 	//printf("not found\n");
-	// no entry satisying the op was found; return the recId {-1,-1}
-	return RecId{-1,-1};
+	// no entry satisying the op was found
+	return E_NOTFOUND;
 }
 
+/************ BPlusCursor ************/
+
+BPlusCursor::BPlusCursor()
+{
+	this->attrType = NUMBER;
+	this->lowOp = NO_BOUND;
+	this->highOp = NO_BOUND;
+	this->excludeLow = false;
+	this->position = IndexId{-1, -1, -1, -1};
+}
+
+int BPlusCursor::seek(int relId, char attrName[ATTR_SIZE], int lowOp, Attribute lowVal, int highOp, Attribute highVal)
+{
+	position = IndexId{-1, -1, -1, -1};
+
+	AttrCatEntry attrCatEntry;
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+	if (attrCatEntry.rootBlock == -1)
+		return E_NOINDEX;
+
+	this->attrType = attrCatEntry.attrType;
+	this->lowOp = lowOp;
+	this->lowVal = lowVal;
+	this->highOp = highOp;
+	this->highVal = highVal;
+	this->excludeLow = false;
+
+	/* the only descent of the scan: on every level, move to the left child of
+	the first key that is >= (GE) or > (GT) the lower bound, or to the
+	leftmost child if the range has no lower bound */
+	int block = attrCatEntry.rootBlock;
+	while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL)
+	{
+		IndInternal internalBlk(block);
+		HeadInfo intHead;
+		internalBlk.getHeader(&intHead);
+
+		InternalEntry intEntry;
+		bool found = false;
+		for (int index = 0; index < intHead.numEntries; ++index)
+		{
+			internalBlk.getEntry(&intEntry, index);
+			int cmpVal = compareAttrs(intEntry.attrVal, lowVal, attrType);
+			if (lowOp == NO_BOUND || (lowOp == GE && cmpVal >= 0) || (lowOp == GT && cmpVal > 0))
+			{
+				found = true;
+				break;
+			}
+		}
+		block = found ? intEntry.lChild : intEntry.rChild;
+	}
+
+	// next() starts at the first entry of this leaf
+	position.block = block;
+	return SUCCESS;
+}
+
+int BPlusCursor::seek(int relId, char attrName[ATTR_SIZE], int op, Attribute attrVal)
+{
+	int ret;
+	switch (op)
+	{
+	case EQ:
+		return seek(relId, attrName, GE, attrVal, LE, attrVal);
+	case LE:
+	case LT:
+		return seek(relId, attrName, NO_BOUND, attrVal, op, attrVal);
+	case GE:
+	case GT:
+		return seek(relId, attrName, op, attrVal, NO_BOUND, attrVal);
+	case NE:
+		ret = seek(relId, attrName, NO_BOUND, attrVal, NO_BOUND, attrVal);
+		lowVal = attrVal;
+		excludeLow = true;
+		return ret;
+	default:
+		return E_INVALID;
+	}
+}
+
+int BPlusCursor::next(Index *entry)
+{
+	if (position.block == -1)
+		return E_NOTFOUND;
+
+	// the rest of the posting list of the last entry comes first
+	RecId recId;
+	if (position.postingBlock != -1)
+	{
+		if (nextPosting(&position, &recId) == SUCCESS)
+		{
+			entry->attrVal = postingKey;
+			entry->block = recId.block;
+			entry->slot = recId.slot;
+			return SUCCESS;
+		}
+		position.postingBlock = -1;
+	}
+
+	int block = position.block;
+	int index = position.index + 1;
+	while (block != -1)
+	{
+		IndLeaf leafBlk(block);
+		HeadInfo leafHead;
+		leafBlk.getHeader(&leafHead);
+
+		Index leafEntry;
+		for (; index < leafHead.numEntries; ++index)
+		{
+			leafBlk.getEntry(&leafEntry, index);
+
+			// entries below the lower bound can only be at the start of the walk
+			int cmpLow = compareAttrs(leafEntry.attrVal, lowVal, attrType);
+			if ((lowOp == GE && cmpLow < 0) || (lowOp == GT && cmpLow <= 0) || (excludeLow && cmpLow == 0))
+				continue;
+
+			// the first entry past the upper bound ends the scan
+			int cmpHigh = compareAttrs(leafEntry.attrVal, highVal, attrType);
+			if ((highOp == LE && cmpHigh > 0) || (highOp == LT && cmpHigh >= 0))
+			{
+				position.block = -1;
+				return E_NOTFOUND;
+			}
+
+			position.block = block;
+			position.index = index;
+			if (isPostingEntry(&leafEntry))
+			{
+				position.postingBlock = leafEntry.block;
+				position.postingIndex = -1;
+				postingKey = leafEntry.attrVal;
+				nextPosting(&position, &recId);
+				leafEntry.block = recId.block;
+				leafEntry.slot = recId.slot;
+			}
+			*entry = leafEntry;
+			return SUCCESS;
+		}
+
+		block = leafHead.rblock;
+		index = 0;
+	}
+
+	position.block = -1;
+	return E_NOTFOUND;
+}
 
 int BPlusTree::bPlusCreate(int relId, char attrName[ATTR_SIZE])
 {
@@ -357,6 +812,17 @@ int BPlusTree::bPlusDestroy(int rootBlockNum)
 		// constructor
 		IndLeaf Leaf(rootBlockNum);
 
+		// (the posting lists of the leaf go with it)
+		HeadInfo Head;
+		Leaf.getHeader(&Head);
+		for (int slot = 0; slot < Head.numEntries; ++slot)
+		{
+			Index leafEntry;
+			Leaf.getEntry(&leafEntry, slot);
+			if (isPostingEntry(&leafEntry))
+				destroyPostingList(leafEntry.block);
+		}
+
 		Leaf.releaseBlock();
 		return SUCCESS;
 
@@ -416,24 +882,58 @@ int BPlusTree::bPlusInsert(int relId, char attrName[ATTR_SIZE], Attribute attrVa
         	return E_NOINDEX;
 	}
 
-	// find the leaf block to which insertion is to be done using the
-	// findLeafToInsert() function
-	int leafBlkNum=findLeafToInsert(blockNum, attrVal, attrCatEntry.attrType); 
-
-	// insert the attrVal and recId to the leaf block at blockNum using the
-	// insertIntoLeaf() function.
 	Index indexEntry;
 	indexEntry.attrVal=attrVal;
 	indexEntry.block=recId.block;
 	indexEntry.slot=recId.slot;
-	ret=insertIntoLeaf(relId, attrName, leafBlkNum, indexEntry);
-	
+
+	/* a key with a posting list gets the record added to the list, and the
+	POSTING_THRESHOLD-th record of a key moves the leaf entries of the key to
+	a new posting list, which then has a leaf entry of its own */
+	std::vector<RecId> keyRecIds;
+	int postingBlock = keyEntries(blockNum, attrVal, attrCatEntry.attrType, &keyRecIds);
+	bool newEntry = true;
+	if (postingBlock != -1)
+	{
+		// (the leaves do not change)
+		ret = appendPosting(postingBlock, recId);
+		newEntry = false;
+	}
+	else if ((int)keyRecIds.size() + 1 >= POSTING_THRESHOLD)
+	{
+		keyRecIds.push_back(recId);
+		postingBlock = newPostingList(keyRecIds);
+		ret = postingBlock < 0 ? E_DISKFULL : SUCCESS;
+		for (int i = 0; ret == SUCCESS && i + 1 < (int)keyRecIds.size(); ++i)
+			deleteLeafEntry(relId, attrName, attrVal, keyRecIds[i]);
+
+		indexEntry.block = postingBlock;
+		indexEntry.slot = POSTING_LIST_SLOT;
+	}
+
+	if (ret == SUCCESS && newEntry)
+	{
+		// (the deletions may have changed the root)
+		AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+
+		// find the leaf block to which insertion is to be done using the
+		// findLeafToInsert() function
+		int leafBlkNum=findLeafToInsert(attrCatEntry.rootBlock, attrVal, attrCatEntry.attrType);
+
+		// insert the attrVal and recId to the leaf block at blockNum using the
+		// insertIntoLeaf() function.
+		ret=insertIntoLeaf(relId, attrName, leafBlkNum, indexEntry);
+	}
+
 	// NOTE: the insertIntoLeaf() function will propagate the insertion to the
 	//       required internal nodes by calling the required helper functions
 	//       like insertIntoInternal() or createNewRoot()
 
 	if ( ret==E_DISKFULL )
 	{
+		AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+		blockNum = attrCatEntry.rootBlock;
+
 		// destroy the existing B+ tree by passing the rootBlock to bPlusDestroy()
 		bPlusDestroy(blockNum);
 
@@ -446,6 +946,335 @@ int BPlusTree::bPlusInsert(int relId, char attrName[ATTR_SIZE], Attribute attrVa
 	return SUCCESS;
 }
 
+/* removes the entry (attrVal, recId) from the B+ tree of attrName. A leaf or
+internal node left with fewer than the minimum number of keys takes entries
+from a sibling, or is merged with it, and the root shrinks when it is left
+with a single child. Returns E_NOINDEX if the attribute is not indexed and
+E_NOTFOUND if there is no such entry. */
+int BPlusTree::bPlusDelete(int relId, char attrName[ATTR_SIZE], Attribute attrVal, RecId recId)
+{
+	AttrCatEntry attrCatEntry;
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (attrCatEntry.rootBlock == -1)
+		return E_NOINDEX;
+
+	/* a record of a key with a posting list is removed from the list; the
+	leaf entry of the list goes when its last record does */
+	int postingBlock = keyEntries(attrCatEntry.rootBlock, attrVal, attrCatEntry.attrType, nullptr);
+	if (postingBlock != -1)
+	{
+		bool empty;
+		ret = removePosting(postingBlock, recId, &empty);
+		if (ret != SUCCESS || !empty)
+			return ret;
+		recId = RecId{postingBlock, POSTING_LIST_SLOT};
+	}
+
+	return deleteLeafEntry(relId, attrName, attrVal, recId);
+}
+
+// removes the leaf entry (attrVal, recId) and fixes the underflow of its leaf
+int BPlusTree::deleteLeafEntry(int relId, char attrName[ATTR_SIZE], Attribute attrVal, RecId recId)
+{
+	AttrCatEntry attrCatEntry;
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	// move to the leftmost leaf that can hold attrVal (as for an EQ search)
+	int block = leftmostLeaf(attrCatEntry.rootBlock, attrVal, attrCatEntry.attrType);
+
+	// entries equal to attrVal may continue into the leaves on the right
+	while (block != -1)
+	{
+		IndLeaf leafBlk(block);
+		HeadInfo leafHead;
+		leafBlk.getHeader(&leafHead);
+
+		for (int index = 0; index < leafHead.numEntries; ++index)
+		{
+			Index leafEntry;
+			leafBlk.getEntry(&leafEntry, index);
+
+			int cmpVal = compareAttrs(leafEntry.attrVal, attrVal, attrCatEntry.attrType);
+			if (cmpVal > 0)
+				return E_NOTFOUND;
+
+			if (cmpVal == 0 && leafEntry.block == recId.block && leafEntry.slot == recId.slot)
+			{
+				// shift the following entries of the leaf one position left
+				for (int next = index + 1; next < leafHead.numEntries; ++next)
+				{
+					leafBlk.getEntry(&leafEntry, next);
+					leafBlk.setEntry(&leafEntry, next - 1);
+				}
+				leafHead.numEntries--;
+				leafBlk.setHeader(&leafHead);
+
+				return fixLeafUnderflow(relId, attrName, block);
+			}
+		}
+
+		block = leafHead.rblock;
+	}
+
+	return E_NOTFOUND;
+}
+
+/* loads the keys of an internal index block into keys[0..n-1] and its children
+into children[0..n] (children[i] and children[i+1] are the lChild and rChild
+of keys[i]) and returns n */
+static int getInternalNode(int blockNum, Attribute keys[], int children[])
+{
+	IndInternal internalBlk(blockNum);
+	HeadInfo intHead;
+	internalBlk.getHeader(&intHead);
+
+	InternalEntry intEntry;
+	internalBlk.getEntry(&intEntry, 0);
+	children[0] = intEntry.lChild;
+	for (int i = 0; i < intHead.numEntries; ++i)
+	{
+		internalBlk.getEntry(&intEntry, i);
+		keys[i] = intEntry.attrVal;
+		children[i + 1] = intEntry.rChild;
+	}
+
+	return intHead.numEntries;
+}
+
+/* stores n keys and n+1 children in an internal index block (a block without
+keys keeps its only child as the lChild of entry 0) */
+static void setInternalNode(int blockNum, int numKeys, Attribute keys[], int children[])
+{
+	IndInternal internalBlk(blockNum);
+	HeadInfo intHead;
+	internalBlk.getHeader(&intHead);
+	intHead.numEntries = numKeys;
+	internalBlk.setHeader(&intHead);
+
+	InternalEntry intEntry;
+	intEntry.lChild = children[0];
+	intEntry.rChild = -1;
+	internalBlk.setEntry(&intEntry, 0);
+	for (int i = 0; i < numKeys; ++i)
+	{
+		intEntry.lChild = children[i];
+		intEntry.attrVal = keys[i];
+		intEntry.rChild = children[i + 1];
+		internalBlk.setEntry(&intEntry, i);
+	}
+}
+
+static void setParent(int blockNum, int parentBlockNum)
+{
+	BlockBuffer blockBuf(blockNum);
+	HeadInfo head;
+	blockBuf.getHeader(&head);
+	head.pblock = parentBlockNum;
+	blockBuf.setHeader(&head);
+}
+
+// removes an index block from the list of blocks of its level
+static void unlinkBlock(int blockNum)
+{
+	BlockBuffer blockBuf(blockNum);
+	HeadInfo head;
+	blockBuf.getHeader(&head);
+
+	if (head.lblock != -1)
+	{
+		BlockBuffer leftBuf(head.lblock);
+		HeadInfo leftHead;
+		leftBuf.getHeader(&leftHead);
+		leftHead.rblock = head.rblock;
+		leftBuf.setHeader(&leftHead);
+	}
+	if (head.rblock != -1)
+	{
+		BlockBuffer rightBuf(head.rblock);
+		HeadInfo rightHead;
+		rightBuf.getHeader(&rightHead);
+		rightHead.lblock = head.lblock;
+		rightBuf.setHeader(&rightHead);
+	}
+}
+
+// returns the position of childBlockNum among the numKeys+1 children
+static int childIndex(int children[], int numKeys, int childBlockNum)
+{
+	for (int i = 0; i <= numKeys; ++i)
+	{
+		if (children[i] == childBlockNum)
+			return i;
+	}
+	return -1;
+}
+
+/* restores the minimum number of entries of a leaf after a deletion: the leaf
+is paired with its left sibling (or its right sibling if it is the first
+child of its parent); if the entries of both fit in one leaf, the right leaf
+is merged into the left one, otherwise the entries are divided evenly */
+int BPlusTree::fixLeafUnderflow(int relId, char attrName[ATTR_SIZE], int leafBlockNum)
+{
+	IndLeaf leafBlk(leafBlockNum);
+	HeadInfo leafHead;
+	leafBlk.getHeader(&leafHead);
+
+	// a root leaf may hold any number of entries
+	if (leafHead.pblock == -1 || leafHead.numEntries >= MIN_KEYS_LEAF)
+		return SUCCESS;
+
+	int parentBlockNum = leafHead.pblock;
+	Attribute keys[MAX_KEYS_INTERNAL];
+	int children[MAX_KEYS_INTERNAL + 1];
+	int numKeys = getInternalNode(parentBlockNum, keys, children);
+
+	int index = childIndex(children, numKeys, leafBlockNum);
+	int sepIndex = index > 0 ? index - 1 : 0;
+	int leftBlockNum = children[sepIndex];
+	int rightBlockNum = children[sepIndex + 1];
+
+	IndLeaf leftBlk(leftBlockNum);
+	IndLeaf rightBlk(rightBlockNum);
+	HeadInfo leftHead, rightHead;
+	leftBlk.getHeader(&leftHead);
+	rightBlk.getHeader(&rightHead);
+
+	int total = leftHead.numEntries + rightHead.numEntries;
+	Index entries[total];
+	for (int i = 0; i < leftHead.numEntries; ++i)
+		leftBlk.getEntry(&entries[i], i);
+	for (int i = 0; i < rightHead.numEntries; ++i)
+		rightBlk.getEntry(&entries[leftHead.numEntries + i], i);
+
+	if (total <= MAX_KEYS_LEAF)
+	{
+		// merge the right leaf into the left one and unlink it from the leaf list
+		for (int i = 0; i < total; ++i)
+			leftBlk.setEntry(&entries[i], i);
+		leftHead.numEntries = total;
+		leftBlk.setHeader(&leftHead);
+
+		unlinkBlock(rightBlockNum);
+		rightBlk.releaseBlock();
+
+		// remove the separator and the right leaf from the parent
+		for (int i = sepIndex; i < numKeys - 1; ++i)
+			keys[i] = keys[i + 1];
+		for (int i = sepIndex + 1; i < numKeys; ++i)
+			children[i] = children[i + 1];
+		setInternalNode(parentBlockNum, numKeys - 1, keys, children);
+
+		return fixInternalUnderflow(relId, attrName, parentBlockNum);
+	}
+
+	// redistribute: the separator becomes the last value of the left leaf
+	int numLeft = total / 2;
+	for (int i = 0; i < numLeft; ++i)
+		leftBlk.setEntry(&entries[i], i);
+	for (int i = numLeft; i < total; ++i)
+		rightBlk.setEntry(&entries[i], i - numLeft);
+	leftHead.numEntries = numLeft;
+	rightHead.numEntries = total - numLeft;
+	leftBlk.setHeader(&leftHead);
+	rightBlk.setHeader(&rightHead);
+
+	keys[sepIndex] = entries[numLeft - 1].attrVal;
+	setInternalNode(parentBlockNum, numKeys, keys, children);
+
+	return SUCCESS;
+}
+
+/* restores the minimum number of keys of an internal node after one of its
+children was merged away, in the same way as fixLeafUnderflow() (the
+separator in the parent moves down into the merged or divided keys). An
+internal root left without keys is replaced by its only child. */
+int BPlusTree::fixInternalUnderflow(int relId, char attrName[ATTR_SIZE], int intBlockNum)
+{
+	IndInternal intBlk(intBlockNum);
+	HeadInfo intHead;
+	intBlk.getHeader(&intHead);
+
+	if (intHead.pblock == -1)
+	{
+		if (intHead.numEntries > 0)
+			return SUCCESS;
+
+		// the only child becomes the root
+		InternalEntry intEntry;
+		intBlk.getEntry(&intEntry, 0);
+		setParent(intEntry.lChild, -1);
+		intBlk.releaseBlock();
+
+		AttrCatEntry attrCatEntry;
+		AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+		attrCatEntry.rootBlock = intEntry.lChild;
+		AttrCacheTable::setAttrCatEntry(relId, attrName, &attrCatEntry);
+		return SUCCESS;
+	}
+
+	if (intHead.numEntries >= MIN_KEYS_INTERNAL)
+		return SUCCESS;
+
+	int parentBlockNum = intHead.pblock;
+	Attribute keys[MAX_KEYS_INTERNAL];
+	int children[MAX_KEYS_INTERNAL + 1];
+	int numKeys = getInternalNode(parentBlockNum, keys, children);
+
+	int index = childIndex(children, numKeys, intBlockNum);
+	int sepIndex = index > 0 ? index - 1 : 0;
+	int leftBlockNum = children[sepIndex];
+	int rightBlockNum = children[sepIndex + 1];
+
+	// the keys of both nodes with the separator between them
+	Attribute allKeys[2 * MAX_KEYS_INTERNAL + 1];
+	int allChildren[2 * MAX_KEYS_INTERNAL + 2];
+	int numLeftKeys = getInternalNode(leftBlockNum, allKeys, allChildren);
+	allKeys[numLeftKeys] = keys[sepIndex];
+	int numRightKeys = getInternalNode(rightBlockNum, allKeys + numLeftKeys + 1, allChildren + numLeftKeys + 1);
+	int total = numLeftKeys + 1 + numRightKeys;
+
+	if (total <= MAX_KEYS_INTERNAL)
+	{
+		// merge the right node into the left one
+		setInternalNode(leftBlockNum, total, allKeys, allChildren);
+		for (int i = numLeftKeys + 1; i <= total; ++i)
+			setParent(allChildren[i], leftBlockNum);
+
+		unlinkBlock(rightBlockNum);
+		IndInternal rightBlk(rightBlockNum);
+		rightBlk.releaseBlock();
+
+		for (int i = sepIndex; i < numKeys - 1; ++i)
+			keys[i] = keys[i + 1];
+		for (int i = sepIndex + 1; i < numKeys; ++i)
+			children[i] = children[i + 1];
+		setInternalNode(parentBlockNum, numKeys - 1, keys, children);
+
+		return fixInternalUnderflow(relId, attrName, parentBlockNum);
+	}
+
+	// redistribute: allKeys[numLeft] moves up to the parent
+	int numLeft = total / 2;
+	setInternalNode(leftBlockNum, numLeft, allKeys, allChildren);
+	setInternalNode(rightBlockNum, total - numLeft - 1, allKeys + numLeft + 1, allChildren + numLeft + 1);
+
+	// children that changed sides get a new parent
+	for (int i = numLeftKeys + 1; i <= numLeft; ++i)
+		setParent(allChildren[i], leftBlockNum);
+	for (int i = numLeft + 1; i <= numLeftKeys; ++i)
+		setParent(allChildren[i], rightBlockNum);
+
+	keys[sepIndex] = allKeys[numLeft];
+	setInternalNode(parentBlockNum, numKeys, keys, children);
+
+	return SUCCESS;
+}
+
 int BPlusTree::findLeafToInsert(int rootBlock, Attribute attrVal, int attrType)
 {
 	int blockNum = rootBlock;
@@ -645,6 +1474,16 @@ int BPlusTree::splitLeaf(int leafBlockNum, Index indices[])
 	rightBlkHeader.rblock=leftBlkHeader.rblock;
 	rightBlk.setHeader(&rightBlkHeader);
 
+	// the block that followed leftBlk now follows rightBlk
+	if (leftBlkHeader.rblock != -1)
+	{
+		IndLeaf nextBlk(leftBlkHeader.rblock);
+		HeadInfo nextBlkHeader;
+		nextBlk.getHeader(&nextBlkHeader);
+		nextBlkHeader.lblock = rightBlkNum;
+		nextBlk.setHeader(&nextBlkHeader);
+	}
+
 	// set leftBlkHeader with the following values
 	// - number of entries = (MAX_KEYS_LEAF+1)/2 = 32
 	// - rblock = rightBlkNum
@@ -689,7 +1528,7 @@ int BPlusTree::insertIntoInternal(int relId, char attrName[ATTR_SIZE], int intBl
 	`internalEntries`. Insert `indexEntry` at appropriate position in the
 	array maintaining the ascending order.
         - use IndInternal::getEntry() to get the entry
-        - use compareAttrs() to compare two structs of type Attribute
+        - the position is that of the entry whose lChild is intEntry.lChild
 
 	Update the lChild of the internalEntry immediately following the newly added
 	entry to the rChild of the newly added entry.
@@ -701,7 +1540,10 @@ int BPlusTree::insertIntoInternal(int relId, char attrName[ATTR_SIZE], int intBl
 		InternalEntry internalBlockEntry;
 		intBlk.getEntry(&internalBlockEntry, entry);
 
-		if (compareAttrs(internalBlockEntry.attrVal, intEntry.attrVal, attrCatEntry.attrType)<=0)
+		/* the new entry goes right before the entry whose left child was split
+		(comparing attribute values is not enough: with duplicate values
+		several entries may hold the value of the new entry) */
+		if (internalBlockEntry.lChild != intEntry.lChild)
 		{
 			internalEntries[entry] = internalBlockEntry;
 		}
@@ -845,10 +1687,22 @@ int BPlusTree::splitInternal(int intBlockNum, InternalEntry internalEntries[])
 	// - number of entries = (MAX_KEYS_INTERNAL)/2 = 50
 	// - pblock = pblock of leftBlk
 	// and update the header of rightBlk using BlockBuffer::setHeader()
+	// - lblock = leftBlkNum, rblock = rblock of leftBlk
 	rightBlkHeader.numEntries=50;
 	rightBlkHeader.pblock=leftBlkHeader.pblock;
 	rightBlkHeader.lblock=leftBlkNum;
+	rightBlkHeader.rblock=leftBlkHeader.rblock;
 	rightBlk.setHeader(&rightBlkHeader);
+
+	// internal blocks of a level are linked like the leaves
+	if (leftBlkHeader.rblock != -1)
+	{
+		IndInternal nextBlk(leftBlkHeader.rblock);
+		HeadInfo nextBlkHeader;
+		nextBlk.getHeader(&nextBlkHeader);
+		nextBlkHeader.lblock = rightBlkNum;
+		nextBlk.setHeader(&nextBlkHeader);
+	}
 	
 	// set leftBlkHeader with the following values
 	// - number of entries = (MAX_KEYS_INTERNAL)/2 = 50
@@ -958,3 +1812,299 @@ int BPlusTree::createNewRoot(int relId, char attrName[ATTR_SIZE], Attribute attr
 
 	return SUCCESS;
 }
+
+/* Stores the smallest value of attribute attrName in attrVal by reading the
+first entry of the leftmost leaf of its B+ tree. Returns E_NOINDEX if the
+attribute is not indexed and E_NOTFOUND if the tree is empty. */
+int BPlusTree::bPlusMin(int relId, char attrName[ATTR_SIZE], Attribute *attrVal)
+{
+	AttrCatEntry attrCatEntry;
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	int block = attrCatEntry.rootBlock;
+	if (block == -1)
+		return E_NOINDEX;
+
+	// always move to the left child of the first entry
+	while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL)
+	{
+		IndInternal internalBlk(block);
+		InternalEntry intEntry;
+		internalBlk.getEntry(&intEntry, 0);
+		block = intEntry.lChild;
+	}
+
+	// skip any leaf that has no entries (moving right)
+	while (block != -1)
+	{
+		IndLeaf leafBlk(block);
+		HeadInfo leafHead;
+		leafBlk.getHeader(&leafHead);
+
+		if (leafHead.numEntries > 0)
+		{
+			Index leafEntry;
+			leafBlk.getEntry(&leafEntry, 0);
+			*attrVal = leafEntry.attrVal;
+			return SUCCESS;
+		}
+		block = leafHead.rblock;
+	}
+
+	return E_NOTFOUND;
+}
+
+/* Stores the largest value of attribute attrName in attrVal by reading the
+last entry of the rightmost leaf of its B+ tree. */
+int BPlusTree::bPlusMax(int relId, char attrName[ATTR_SIZE], Attribute *attrVal)
+{
+	AttrCatEntry attrCatEntry;
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	int block = attrCatEntry.rootBlock;
+	if (block == -1)
+		return E_NOINDEX;
+
+	// always move to the right child of the last entry
+	while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL)
+	{
+		IndInternal internalBlk(block);
+		HeadInfo intHead;
+		internalBlk.getHeader(&intHead);
+
+		InternalEntry intEntry;
+		internalBlk.getEntry(&intEntry, intHead.numEntries - 1);
+		block = intEntry.rChild;
+	}
+
+	// skip any leaf that has no entries (moving left)
+	while (block != -1)
+	{
+		IndLeaf leafBlk(block);
+		HeadInfo leafHead;
+		leafBlk.getHeader(&leafHead);
+
+		if (leafHead.numEntries > 0)
+		{
+			Index leafEntry;
+			leafBlk.getEntry(&leafEntry, leafHead.numEntries - 1);
+			*attrVal = leafEntry.attrVal;
+			return SUCCESS;
+		}
+		block = leafHead.lblock;
+	}
+
+	return E_NOTFOUND;
+}
+
+/* state shared by the recursive calls of checkNode() */
+struct TreeCheck {
+	AttrCatEntry attrCatEntry;
+	int leafLevel;
+	int numEntries;  // records of the leaf entries and of the posting lists
+	int numPostingBlocks;
+	// the blocks of every level of the tree, from left to right
+	std::vector<std::vector<int>> levels;
+};
+
+// checks that recId refers to an occupied slot holding attrVal
+static bool checkRecord(TreeCheck *check, RecId recId, Attribute attrVal)
+{
+	if (StaticBuffer::getStaticBlockType(recId.block) != REC)
+		return false;
+
+	RecBuffer recBuffer(recId.block);
+	HeadInfo recHead;
+	recBuffer.getHeader(&recHead);
+	if (recId.slot < 0 || recId.slot >= recHead.numSlots)
+		return false;
+
+	unsigned char slotMap[recHead.numSlots];
+	recBuffer.getSlotMap(slotMap);
+	Attribute record[recHead.numAttrs];
+	recBuffer.getRecord(record, recId.slot);
+	return slotMap[recId.slot] == SLOT_OCCUPIED &&
+	       compareAttrs(record[check->attrCatEntry.offset], attrVal, check->attrCatEntry.attrType) == 0;
+}
+
+/* checks the posting list starting at block: every block but the last is
+full, the blocks are linked both ways and every record holds attrVal */
+static bool checkPostingList(TreeCheck *check, int block, Attribute attrVal)
+{
+	int prevBlock = -1;
+	while (block != -1)
+	{
+		if (StaticBuffer::getStaticBlockType(block) != IND_POSTING)
+			return false;
+
+		IndNode postingBlk(block);
+		HeadInfo head;
+		postingBlk.getHeader(&head);
+		if (head.lblock != prevBlock || head.numEntries < 1 ||
+		    (head.rblock != -1 && head.numEntries != postingCapacity()))
+			return false;
+
+		for (int i = 0; i < head.numEntries; ++i)
+		{
+			if (!checkRecord(check, getPosting(postingBlk, i), attrVal))
+				return false;
+		}
+		check->numEntries += head.numEntries;
+		check->numPostingBlocks++;
+
+		prevBlock = block;
+		block = head.rblock;
+	}
+	return true;
+}
+
+/* checks the subtree rooted at blockNum, whose values must lie in [low, high]
+(nullptr for no bound) */
+static int checkNode(TreeCheck *check, int blockNum, int parentBlockNum, int level, Attribute *low, Attribute *high)
+{
+	int type = StaticBuffer::getStaticBlockType(blockNum);
+	if (type != IND_LEAF && type != IND_INTERNAL)
+		return E_INDEXCORRUPT;
+
+	BlockBuffer blockBuf(blockNum);
+	HeadInfo head;
+	blockBuf.getHeader(&head);
+	if (head.pblock != parentBlockNum)
+		return E_INDEXCORRUPT;
+
+	if ((int)check->levels.size() <= level)
+		check->levels.resize(level + 1);
+	check->levels[level].push_back(blockNum);
+
+	int attrType = check->attrCatEntry.attrType;
+
+	if (type == IND_LEAF)
+	{
+		// all the leaves are at the same depth and only the root may hold fewer
+		// than MIN_KEYS_LEAF entries
+		if (check->leafLevel == -1)
+			check->leafLevel = level;
+		if (level != check->leafLevel || head.numEntries > MAX_KEYS_LEAF ||
+		    (parentBlockNum != -1 && head.numEntries < MIN_KEYS_LEAF))
+			return E_INDEXCORRUPT;
+
+		IndLeaf leafBlk(blockNum);
+		Index entry, prevEntry = {};
+		for (int i = 0; i < head.numEntries; ++i)
+		{
+			leafBlk.getEntry(&entry, i);
+			int cmpPrev = i > 0 ? compareAttrs(prevEntry.attrVal, entry.attrVal, attrType) : -1;
+			if (cmpPrev > 0 ||
+			    (low != nullptr && compareAttrs(entry.attrVal, *low, attrType) < 0) ||
+			    (high != nullptr && compareAttrs(entry.attrVal, *high, attrType) > 0))
+				return E_INDEXCORRUPT;
+
+			// a key with a posting list has no other leaf entry
+			if (cmpPrev == 0 && (isPostingEntry(&entry) || isPostingEntry(&prevEntry)))
+				return E_INDEXCORRUPT;
+			prevEntry = entry;
+
+			// the entry refers to an occupied slot holding the same value
+			if (isPostingEntry(&entry))
+			{
+				if (!checkPostingList(check, entry.block, entry.attrVal))
+					return E_INDEXCORRUPT;
+				continue;
+			}
+			if (!checkRecord(check, RecId{entry.block, entry.slot}, entry.attrVal))
+				return E_INDEXCORRUPT;
+			check->numEntries++;
+		}
+
+		return SUCCESS;
+	}
+
+	if (head.numEntries > MAX_KEYS_INTERNAL ||
+	    head.numEntries < (parentBlockNum == -1 ? 1 : MIN_KEYS_INTERNAL))
+		return E_INDEXCORRUPT;
+
+	// consecutive entries share a child and the keys are in ascending order
+	IndInternal internalBlk(blockNum);
+	InternalEntry intEntry, prevEntry;
+	for (int i = 0; i < head.numEntries; ++i)
+	{
+		internalBlk.getEntry(&intEntry, i);
+		if (i > 0 && (prevEntry.rChild != intEntry.lChild ||
+		              compareAttrs(prevEntry.attrVal, intEntry.attrVal, attrType) > 0))
+			return E_INDEXCORRUPT;
+		prevEntry = intEntry;
+	}
+
+	Attribute keys[MAX_KEYS_INTERNAL];
+	int children[MAX_KEYS_INTERNAL + 1];
+	int numKeys = getInternalNode(blockNum, keys, children);
+	if ((low != nullptr && compareAttrs(keys[0], *low, attrType) < 0) ||
+	    (high != nullptr && compareAttrs(keys[numKeys - 1], *high, attrType) > 0))
+		return E_INDEXCORRUPT;
+
+	// the values of children[i] lie between keys[i-1] and keys[i]
+	for (int i = 0; i <= numKeys; ++i)
+	{
+		int ret = checkNode(check, children[i], blockNum, level + 1,
+		                    i > 0 ? &keys[i - 1] : low, i < numKeys ? &keys[i] : high);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/* verifies the structure of the B+ tree of attrName: key order and bounds,
+node occupancy, parent pointers, the lblock / rblock links of every level,
+the posting lists, and that the tree holds exactly one entry per record of
+the relation. The number of records indexed, of blocks of the tree and of
+posting blocks among them are returned. Returns E_INDEXCORRUPT at the first
+violation found. */
+int BPlusTree::bPlusCheck(int relId, char attrName[ATTR_SIZE], int *numEntries, int *numBlocks,
+                          int *numPostingBlocks)
+{
+	TreeCheck check;
+	int ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &check.attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (check.attrCatEntry.rootBlock == -1)
+		return E_NOINDEX;
+
+	check.leafLevel = -1;
+	check.numEntries = 0;
+	check.numPostingBlocks = 0;
+	ret = checkNode(&check, check.attrCatEntry.rootBlock, -1, 0, nullptr, nullptr);
+	if (ret != SUCCESS)
+		return ret;
+
+	// the blocks of each level are linked from left to right
+	for (std::vector<int> &blocks : check.levels)
+	{
+		for (int i = 0; i < (int)blocks.size(); ++i)
+		{
+			BlockBuffer blockBuf(blocks[i]);
+			HeadInfo head;
+			blockBuf.getHeader(&head);
+			if (head.lblock != (i > 0 ? blocks[i - 1] : -1) ||
+			    head.rblock != (i + 1 < (int)blocks.size() ? blocks[i + 1] : -1))
+				return E_INDEXCORRUPT;
+		}
+	}
+
+	RelCatEntry relCatEntry;
+	RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (check.numEntries != relCatEntry.numRecs)
+		return E_INDEXCORRUPT;
+
+	*numEntries = check.numEntries;
+	*numPostingBlocks = check.numPostingBlocks;
+	*numBlocks = check.numPostingBlocks;
+	for (std::vector<int> &blocks : check.levels)
+		*numBlocks += blocks.size();
+	return SUCCESS;
+}
@@ -15,12 +15,53 @@ class BPlusTree {
   static int insertIntoInternal(int relId, char attrName[ATTR_SIZE], int intBlockNum, InternalEntry entry);
   static int splitInternal(int intBlockNum, InternalEntry internalEntries[]);
   static int createNewRoot(int relId, char attrName[ATTR_SIZE], Attribute attrVal, int lChild, int rChild);
+  static int deleteLeafEntry(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, RecId recId);
+  static int fixLeafUnderflow(int relId, char attrName[ATTR_SIZE], int leafBlockNum);
+  static int fixInternalUnderflow(int relId, char attrName[ATTR_SIZE], int intBlockNum);
 
  public:
   static int bPlusCreate(int relId, char attrName[ATTR_SIZE]);
   static int bPlusInsert(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, RecId recordId);
+  static int bPlusDelete(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, RecId recordId);
   static RecId bPlusSearch(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, int op);
+  static int bPlusSearchEntry(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, int op, Index *entry);
   static int bPlusDestroy(int rootBlockNum);
+  static int bPlusMin(int relId, char attrName[ATTR_SIZE], union Attribute *attrVal);
+  static int bPlusMax(int relId, char attrName[ATTR_SIZE], union Attribute *attrVal);
+  static int bPlusCheck(int relId, char attrName[ATTR_SIZE], int *numEntries, int *numBlocks, int *numPostingBlocks);
+};
+
+/*
+ * range scan over the B+ tree of an attribute. seek() descends the tree once,
+ * to the leaf of the lower bound, and next() walks the leaves through rblock
+ * until the first entry past the upper bound. The position is kept in the
+ * cursor instead of the search index of the attribute, so any number of scans
+ * of the same tree can be interleaved.
+ * The lower bound is GE or GT a value and the upper bound LE or LT a value;
+ * NO_BOUND leaves that end of the range open.
+ */
+class BPlusCursor {
+ public:
+  BPlusCursor();
+  int seek(int relId, char attrName[ATTR_SIZE], int lowOp, union Attribute lowVal, int highOp,
+           union Attribute highVal);
+  // the range of `attr op attrVal` (NE: every entry but attrVal)
+  int seek(int relId, char attrName[ATTR_SIZE], int op, union Attribute attrVal);
+  // the next entry in the range, with the RecId of its record (E_NOTFOUND at the end)
+  int next(Index *entry);
+
+ private:
+  int attrType;
+  int lowOp;
+  union Attribute lowVal;
+  int highOp;
+  union Attribute highVal;
+  bool excludeLow;  // NE: entries equal to lowVal are skipped
+
+  // leaf entry returned last (block -1 once the scan is over), and the
+  // position in its posting list (postingBlock -1 if it has none)
+  IndexId position;
+  union Attribute postingKey;
 };
 
 #endif  // NITCBASE_BPLUSTREE_H
@@ -0,0 +1,978 @@
+#include "CompositeIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* in-memory copy of a block of a composite B+ tree, used when a block is
+modified (the searches read single entries from the buffer instead) */
+struct CompositeNode {
+	HeadInfo head;
+	std::vector<Attribute> keys;  // numKeys attributes per entry
+	std::vector<int> children;    // internal block: numEntries + 1 children
+	std::vector<RecId> recIds;    // leaf block: the record of every entry
+};
+
+/* a leaf entry is the key followed by the block and slot of the record;
+an internal block starts with a child and every key is followed by the
+child on its right */
+static int keySize(int numKeys)
+{
+	return numKeys * ATTR_SIZE;
+}
+
+static int leafEntrySize(int numKeys)
+{
+	return keySize(numKeys) + 2 * sizeof(int32_t);
+}
+
+static int internalEntrySize(int numKeys)
+{
+	return keySize(numKeys) + sizeof(int32_t);
+}
+
+/* a block of a compressed index (a single string key) starts with the length
+of the prefix shared by all the keys of the block and the width of the rest
+of a key, followed by the prefix. The entries then hold only the rest of
+their key, padded with zeros to the width, in place of the ATTR_SIZE bytes
+of the key. */
+#define PREFIX_META_SIZE 2
+#define MAX_KEY_LENGTH (ATTR_SIZE - 1)
+
+struct PrefixLayout {
+	int prefixLen;
+	int width;
+	char prefix[ATTR_SIZE];
+};
+
+static int keyLength(Attribute *key)
+{
+	return strnlen(key->sVal, MAX_KEY_LENGTH);
+}
+
+// the prefix shared by numEntries keys and the width of the longest rest of a key
+static void prefixLayout(Attribute *keys, int numEntries, PrefixLayout *layout)
+{
+	layout->prefixLen = numEntries > 0 ? keyLength(&keys[0]) : 0;
+	for (int i = 1; i < numEntries; ++i)
+	{
+		int len = 0;
+		while (len < layout->prefixLen && keys[i].sVal[len] == keys[0].sVal[len])
+			len++;
+		layout->prefixLen = len;
+	}
+
+	layout->width = 0;
+	for (int i = 0; i < numEntries; ++i)
+		layout->width = std::max(layout->width, keyLength(&keys[i]) - layout->prefixLen);
+
+	memset(layout->prefix, 0, ATTR_SIZE);
+	if (numEntries > 0)
+		memcpy(layout->prefix, keys[0].sVal, layout->prefixLen);
+}
+
+static void readPrefixLayout(IndNode &node, PrefixLayout *layout)
+{
+	unsigned char meta[PREFIX_META_SIZE];
+	node.getBytes(meta, 0, PREFIX_META_SIZE);
+	layout->prefixLen = meta[0];
+	layout->width = meta[1];
+	memset(layout->prefix, 0, ATTR_SIZE);
+	node.getBytes((unsigned char *)layout->prefix, PREFIX_META_SIZE, layout->prefixLen);
+}
+
+// the key whose rest (layout->width bytes) is at `rest`
+static void expandKey(PrefixLayout *layout, unsigned char *rest, Attribute *key)
+{
+	memset(key->sVal, 0, ATTR_SIZE);
+	memcpy(key->sVal, layout->prefix, layout->prefixLen);
+	memcpy(key->sVal + layout->prefixLen, rest, layout->width);
+}
+
+static int prefixLeafEntrySize(PrefixLayout *layout)
+{
+	return layout->width + 2 * sizeof(int32_t);
+}
+
+static int prefixInternalEntrySize(PrefixLayout *layout)
+{
+	return layout->width + sizeof(int32_t);
+}
+
+// offset of the first entry (leaf) or of the first child (internal block)
+static int prefixDataOffset(PrefixLayout *layout)
+{
+	return PREFIX_META_SIZE + layout->prefixLen;
+}
+
+/* a compressed block holds as many entries as fit, but at most twice the
+number that fit when the keys share no prefix and have the full length
+(less one): a block split in two then always leaves both halves fitting */
+int CompositeIndex::leafCapacity(int numKeys, bool compressed)
+{
+	if (compressed)
+		return 2 * ((BLOCK_SIZE - HEADER_SIZE - PREFIX_META_SIZE) / (MAX_KEY_LENGTH + 2 * (int)sizeof(int32_t))) - 1;
+	return (BLOCK_SIZE - HEADER_SIZE) / leafEntrySize(numKeys);
+}
+
+int CompositeIndex::internalCapacity(int numKeys, bool compressed)
+{
+	if (compressed)
+		return 2 * ((BLOCK_SIZE - HEADER_SIZE - PREFIX_META_SIZE - (int)sizeof(int32_t)) /
+		            (MAX_KEY_LENGTH + (int)sizeof(int32_t))) - 1;
+	return (BLOCK_SIZE - HEADER_SIZE - sizeof(int32_t)) / internalEntrySize(numKeys);
+}
+
+// whether the entries of node fit in a block
+static bool nodeFits(CompositeNode *node, int numKeys, bool compressed)
+{
+	int numEntries = node->keys.size() / numKeys;
+	bool leaf = node->head.blockType == IND_LEAF;
+	if (numEntries > (leaf ? CompositeIndex::leafCapacity(numKeys, compressed)
+	                       : CompositeIndex::internalCapacity(numKeys, compressed)))
+		return false;
+	if (!compressed)
+		return true;
+
+	PrefixLayout layout;
+	prefixLayout(node->keys.data(), numEntries, &layout);
+	int numBytes = leaf ? numEntries * prefixLeafEntrySize(&layout)
+	                    : numEntries * prefixInternalEntrySize(&layout) + sizeof(int32_t);
+	return prefixDataOffset(&layout) + numBytes <= BLOCK_SIZE - HEADER_SIZE;
+}
+
+/* the shortest prefix of the key `right` that is greater than the key `left`
+(`right` itself if they are equal). It separates two leaves as well as the
+last key of the left one does, since it is > every key on the left and <=
+every key on the right, and it compresses better. */
+static void shortSeparator(Attribute *left, Attribute *right, Attribute *sep)
+{
+	int len = 0;
+	while (len < MAX_KEY_LENGTH && left->sVal[len] != '\0' && left->sVal[len] == right->sVal[len])
+		len++;
+
+	memset(sep->sVal, 0, ATTR_SIZE);
+	if (right->sVal[len] == '\0')
+		memcpy(sep->sVal, right->sVal, len);
+	else
+		memcpy(sep->sVal, right->sVal, len + 1);
+}
+
+// lexicographic comparison of the first numKeys attributes of two keys
+static int compareKeys(Attribute *key1, Attribute *key2, int keyTypes[], int numKeys)
+{
+	for (int i = 0; i < numKeys; ++i)
+	{
+		int cmpVal = compareAttrs(key1[i], key2[i], keyTypes[i]);
+		if (cmpVal != 0)
+			return cmpVal;
+	}
+	return 0;
+}
+
+static bool satisfies(int cmpVal, int op)
+{
+	return (op == EQ && cmpVal == 0) || (op == LE && cmpVal <= 0) || (op == LT && cmpVal < 0) ||
+	       (op == GT && cmpVal > 0) || (op == GE && cmpVal >= 0) || (op == NE && cmpVal != 0);
+}
+
+static void readLeafEntry(IndNode &leaf, int numKeys, bool compressed, int index, Attribute *key, RecId *recId)
+{
+	int32_t block, slot;
+	if (compressed)
+	{
+		PrefixLayout layout;
+		readPrefixLayout(leaf, &layout);
+		unsigned char entry[prefixLeafEntrySize(&layout)];
+		leaf.getBytes(entry, prefixDataOffset(&layout) + index * prefixLeafEntrySize(&layout),
+		              prefixLeafEntrySize(&layout));
+
+		expandKey(&layout, entry, key);
+		memcpy(&block, entry + layout.width, sizeof(int32_t));
+		memcpy(&slot, entry + layout.width + sizeof(int32_t), sizeof(int32_t));
+		*recId = RecId{block, slot};
+		return;
+	}
+
+	unsigned char entry[leafEntrySize(numKeys)];
+	leaf.getBytes(entry, index * leafEntrySize(numKeys), leafEntrySize(numKeys));
+
+	memcpy(key, entry, keySize(numKeys));
+	memcpy(&block, entry + keySize(numKeys), sizeof(int32_t));
+	memcpy(&slot, entry + keySize(numKeys) + sizeof(int32_t), sizeof(int32_t));
+	*recId = RecId{block, slot};
+}
+
+static void readInternalKey(IndNode &internal, int numKeys, bool compressed, int index, Attribute *key)
+{
+	if (compressed)
+	{
+		PrefixLayout layout;
+		readPrefixLayout(internal, &layout);
+		unsigned char rest[ATTR_SIZE];
+		internal.getBytes(rest, prefixDataOffset(&layout) + sizeof(int32_t) + index * prefixInternalEntrySize(&layout),
+		                  layout.width);
+		expandKey(&layout, rest, key);
+		return;
+	}
+
+	internal.getBytes((unsigned char *)key, index * internalEntrySize(numKeys) + sizeof(int32_t), keySize(numKeys));
+}
+
+static int readChild(IndNode &internal, int numKeys, bool compressed, int index)
+{
+	int32_t child;
+	if (compressed)
+	{
+		PrefixLayout layout;
+		readPrefixLayout(internal, &layout);
+		internal.getBytes((unsigned char *)&child, prefixDataOffset(&layout) + index * prefixInternalEntrySize(&layout),
+		                  sizeof(int32_t));
+		return child;
+	}
+
+	internal.getBytes((unsigned char *)&child, index * internalEntrySize(numKeys), sizeof(int32_t));
+	return child;
+}
+
+static void readNode(int block, int numKeys, bool compressed, CompositeNode *node)
+{
+	IndNode buffer(block);
+	buffer.getHeader(&node->head);
+
+	int numEntries = node->head.numEntries;
+	unsigned char data[BLOCK_SIZE - HEADER_SIZE];
+	buffer.getBytes(data, 0, BLOCK_SIZE - HEADER_SIZE);
+
+	/* the entries of a compressed block are read like the others, with the
+	rest of the key in place of the key */
+	PrefixLayout layout;
+	int dataOffset = 0, restSize = keySize(numKeys);
+	int leafSize = leafEntrySize(numKeys), internalSize = internalEntrySize(numKeys);
+	if (compressed)
+	{
+		readPrefixLayout(buffer, &layout);
+		dataOffset = prefixDataOffset(&layout);
+		restSize = layout.width;
+		leafSize = prefixLeafEntrySize(&layout);
+		internalSize = prefixInternalEntrySize(&layout);
+	}
+
+	node->keys.resize(numEntries * numKeys);
+	node->children.clear();
+	node->recIds.clear();
+	if (node->head.blockType == IND_LEAF)
+	{
+		node->recIds.resize(numEntries);
+		for (int i = 0; i < numEntries; ++i)
+		{
+			unsigned char *entry = data + dataOffset + i * leafSize;
+			int32_t recBlock, recSlot;
+			if (compressed)
+				expandKey(&layout, entry, &node->keys[i]);
+			else
+				memcpy(&node->keys[i * numKeys], entry, keySize(numKeys));
+			memcpy(&recBlock, entry + restSize, sizeof(int32_t));
+			memcpy(&recSlot, entry + restSize + sizeof(int32_t), sizeof(int32_t));
+			node->recIds[i] = RecId{recBlock, recSlot};
+		}
+	}
+	else
+	{
+		node->children.resize(numEntries + 1);
+		for (int i = 0; i <= numEntries; ++i)
+		{
+			unsigned char *entry = data + dataOffset + i * internalSize;
+			int32_t child;
+			memcpy(&child, entry, sizeof(int32_t));
+			node->children[i] = child;
+			if (i < numEntries && compressed)
+				expandKey(&layout, entry + sizeof(int32_t), &node->keys[i]);
+			else if (i < numEntries)
+				memcpy(&node->keys[i * numKeys], entry + sizeof(int32_t), keySize(numKeys));
+		}
+	}
+}
+
+static void writeNode(int block, int numKeys, bool compressed, CompositeNode *node)
+{
+	int numEntries = node->keys.size() / numKeys;
+	unsigned char data[BLOCK_SIZE - HEADER_SIZE];
+	int numBytes;
+
+	PrefixLayout layout;
+	int dataOffset = 0, restSize = keySize(numKeys);
+	int leafSize = leafEntrySize(numKeys), internalSize = internalEntrySize(numKeys);
+	if (compressed)
+	{
+		prefixLayout(node->keys.data(), numEntries, &layout);
+		data[0] = layout.prefixLen;
+		data[1] = layout.width;
+		memcpy(data + PREFIX_META_SIZE, layout.prefix, layout.prefixLen);
+		dataOffset = prefixDataOffset(&layout);
+		restSize = layout.width;
+		leafSize = prefixLeafEntrySize(&layout);
+		internalSize = prefixInternalEntrySize(&layout);
+	}
+
+	// the key (or the rest of it after the prefix of the block) at `dest`
+	auto putKey = [&](unsigned char *dest, int i) {
+		if (compressed)
+			memcpy(dest, node->keys[i].sVal + layout.prefixLen, layout.width);
+		else
+			memcpy(dest, &node->keys[i * numKeys], keySize(numKeys));
+	};
+
+	if (node->head.blockType == IND_LEAF)
+	{
+		for (int i = 0; i < numEntries; ++i)
+		{
+			unsigned char *entry = data + dataOffset + i * leafSize;
+			int32_t recBlock = node->recIds[i].block, recSlot = node->recIds[i].slot;
+			putKey(entry, i);
+			memcpy(entry + restSize, &recBlock, sizeof(int32_t));
+			memcpy(entry + restSize + sizeof(int32_t), &recSlot, sizeof(int32_t));
+		}
+		numBytes = dataOffset + numEntries * leafSize;
+	}
+	else
+	{
+		for (int i = 0; i <= numEntries; ++i)
+		{
+			unsigned char *entry = data + dataOffset + i * internalSize;
+			int32_t child = node->children[i];
+			memcpy(entry, &child, sizeof(int32_t));
+			if (i < numEntries)
+				putKey(entry + sizeof(int32_t), i);
+		}
+		numBytes = dataOffset + numEntries * internalSize + sizeof(int32_t);
+	}
+
+	IndNode buffer(block);
+	node->head.numEntries = numEntries;
+	buffer.setHeader(&node->head);
+	buffer.setBytes(data, 0, numBytes);
+}
+
+// allocates a leaf ('L') or internal ('I') block; returns E_DISKFULL if there is no free block
+static int newNode(char blockType)
+{
+	IndNode buffer(blockType);
+	int block = buffer.getBlockNum();
+	if (block < 0 || block >= DISK_BLOCKS)
+		return E_DISKFULL;
+	return block;
+}
+
+// puts `block` between `leftBlock` and the block that was on its right
+static void linkAfter(int leftBlock, CompositeNode *left, int block, CompositeNode *node)
+{
+	node->head.lblock = leftBlock;
+	node->head.rblock = left->head.rblock;
+	left->head.rblock = block;
+
+	if (node->head.rblock != -1)
+	{
+		IndNode next(node->head.rblock);
+		HeadInfo nextHead;
+		next.getHeader(&nextHead);
+		nextHead.lblock = block;
+		next.setHeader(&nextHead);
+	}
+}
+
+/************ catalog ************/
+
+void CompositeIndex::keyName(int numKeys, int keyOffsets[], char name[ATTR_SIZE])
+{
+	name[0] = '\0';
+	for (int i = 0; i < numKeys; ++i)
+	{
+		int len = strlen(name);
+		snprintf(name + len, ATTR_SIZE - len, i == 0 ? "%d" : "_%d", keyOffsets[i]);
+	}
+}
+
+// returns the number of key attributes listed in name (0 if it is not a key list)
+int CompositeIndex::parseKeyName(char name[ATTR_SIZE], int keyOffsets[])
+{
+	int numKeys = 0;
+	char *pos = name;
+	while (*pos != '\0' && numKeys < MAX_COMPOSITE_KEYS)
+	{
+		char *end;
+		keyOffsets[numKeys++] = strtol(pos, &end, 10);
+		if (end == pos)
+			return 0;
+		pos = (*end == '_') ? end + 1 : end;
+	}
+	return numKeys;
+}
+
+int CompositeIndex::getIndexes(int relId, std::vector<CompositeIndexInfo> *indexes)
+{
+	indexes->clear();
+
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	std::vector<RecId> indexRecIds;
+	if (CatalogDirectory::getIndexRecIds(relCatEntry.relName, &indexRecIds) != SUCCESS)
+		return SUCCESS;
+
+	for (RecId indexRecId : indexRecIds)
+	{
+		RecBuffer catBuffer(indexRecId.block);
+		Attribute record[ATTRCAT_NO_ATTRS];
+		catBuffer.getRecord(record, indexRecId.slot);
+		int offset = (int)record[ATTRCAT_OFFSET_INDEX].nVal;
+		if (offset != COMPOSITE_INDEX_OFFSET && offset != COMPRESSED_INDEX_OFFSET)
+			continue;
+
+		CompositeIndexInfo index;
+		index.catRecId = indexRecId;
+		index.compressed = offset == COMPRESSED_INDEX_OFFSET;
+		index.rootBlock = (int)record[ATTRCAT_ROOT_BLOCK_INDEX].nVal;
+		index.numKeys = parseKeyName(record[ATTRCAT_ATTR_NAME_INDEX].sVal, index.keyOffsets);
+
+		for (int i = 0; i < index.numKeys; ++i)
+		{
+			AttrCatEntry attrCatEntry;
+			AttrCacheTable::getAttrCatEntry(relId, index.keyOffsets[i], &attrCatEntry);
+			index.keyTypes[i] = attrCatEntry.attrType;
+		}
+		indexes->push_back(index);
+	}
+
+	return SUCCESS;
+}
+
+// finds the index on exactly the attributes keyOffsets (in that order)
+int CompositeIndex::find(int relId, int numKeys, int keyOffsets[], CompositeIndexInfo *index)
+{
+	std::vector<CompositeIndexInfo> indexes;
+	int ret = getIndexes(relId, &indexes);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (CompositeIndexInfo &candidate : indexes)
+	{
+		if (candidate.numKeys == numKeys &&
+		    memcmp(candidate.keyOffsets, keyOffsets, numKeys * sizeof(int)) == 0)
+		{
+			*index = candidate;
+			return SUCCESS;
+		}
+	}
+	return E_NOINDEX;
+}
+
+// finds an index whose first key attribute is attrOffset
+int CompositeIndex::findLeading(int relId, int attrOffset, CompositeIndexInfo *index)
+{
+	std::vector<CompositeIndexInfo> indexes;
+	int ret = getIndexes(relId, &indexes);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (CompositeIndexInfo &candidate : indexes)
+	{
+		if (candidate.keyOffsets[0] == attrOffset)
+		{
+			*index = candidate;
+			return SUCCESS;
+		}
+	}
+	return E_NOINDEX;
+}
+
+int CompositeIndex::setRoot(CompositeIndexInfo *index, int rootBlock)
+{
+	index->rootBlock = rootBlock;
+
+	RecBuffer catBuffer(index->catRecId.block);
+	Attribute record[ATTRCAT_NO_ATTRS];
+	catBuffer.getRecord(record, index->catRecId.slot);
+	record[ATTRCAT_ROOT_BLOCK_INDEX].nVal = rootBlock;
+	return catBuffer.setRecord(record, index->catRecId.slot);
+}
+
+/************ tree operations ************/
+
+/* inserts an entry for every record of the relation. On E_DISKFULL the tree
+is destroyed and left empty. */
+int CompositeIndex::build(int relId, CompositeIndexInfo *index)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	int block = relCatEntry.firstBlk;
+	while (block != -1)
+	{
+		RecBuffer recBuffer(block);
+		HeadInfo head;
+		recBuffer.getHeader(&head);
+		unsigned char slotMap[head.numSlots];
+		recBuffer.getSlotMap(slotMap);
+
+		for (int slot = 0; slot < head.numSlots; ++slot)
+		{
+			if (slotMap[slot] == SLOT_UNOCCUPIED)
+				continue;
+
+			Attribute record[head.numAttrs];
+			recBuffer.getRecord(record, slot);
+			if (insert(index, record, RecId{block, slot}) != SUCCESS)
+			{
+				destroy(index->rootBlock, index->numKeys, index->compressed);
+				setRoot(index, -1);
+				return E_DISKFULL;
+			}
+		}
+		block = head.rblock;
+	}
+
+	return SUCCESS;
+}
+
+/* inserts the entry of `record` at recId. Entries with an equal key are kept
+in the order they were inserted. Returns E_DISKFULL if a block could not be
+allocated (the caller has to destroy the tree, which may be half split). */
+int CompositeIndex::insert(CompositeIndexInfo *index, union Attribute *record, RecId recId)
+{
+	int numKeys = index->numKeys;
+	Attribute key[numKeys];
+	for (int i = 0; i < numKeys; ++i)
+		key[i] = record[index->keyOffsets[i]];
+
+	if (index->rootBlock == -1)
+	{
+		// the first entry of the index: the root is a leaf
+		int leafBlock = newNode('L');
+		if (leafBlock < 0)
+			return E_DISKFULL;
+
+		CompositeNode leaf;
+		readNode(leafBlock, numKeys, index->compressed, &leaf);
+		leaf.keys.assign(key, key + numKeys);
+		leaf.recIds.push_back(recId);
+		writeNode(leafBlock, numKeys, index->compressed, &leaf);
+		return setRoot(index, leafBlock);
+	}
+
+	/* walk down to the leaf, remembering the internal blocks on the way and
+	which child was taken in each: the child left of the first key greater
+	than the new key (so that equal keys go to the right) */
+	std::vector<int> path, pathChild;
+	int block = index->rootBlock;
+	while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL)
+	{
+		IndNode internal(block);
+		HeadInfo head;
+		internal.getHeader(&head);
+
+		int child = 0;
+		Attribute sepKey[numKeys];
+		while (child < head.numEntries)
+		{
+			readInternalKey(internal, numKeys, index->compressed, child, sepKey);
+			if (compareKeys(sepKey, key, index->keyTypes, numKeys) > 0)
+				break;
+			child++;
+		}
+
+		path.push_back(block);
+		pathChild.push_back(child);
+		block = readChild(internal, numKeys, index->compressed, child);
+	}
+
+	CompositeNode leaf;
+	readNode(block, numKeys, index->compressed, &leaf);
+	int numEntries = leaf.recIds.size();
+	int pos = 0;
+	while (pos < numEntries && compareKeys(&leaf.keys[pos * numKeys], key, index->keyTypes, numKeys) <= 0)
+		pos++;
+	leaf.keys.insert(leaf.keys.begin() + pos * numKeys, key, key + numKeys);
+	leaf.recIds.insert(leaf.recIds.begin() + pos, recId);
+
+	if (nodeFits(&leaf, numKeys, index->compressed))
+	{
+		writeNode(block, numKeys, index->compressed, &leaf);
+		return SUCCESS;
+	}
+
+	// split the leaf: the upper half of the entries moves to a new leaf on its right
+	int rightBlock = newNode('L');
+	if (rightBlock < 0)
+		return E_DISKFULL;
+
+	CompositeNode right;
+	readNode(rightBlock, numKeys, index->compressed, &right);
+	int numLeft = (numEntries + 2) / 2;
+	right.keys.assign(leaf.keys.begin() + numLeft * numKeys, leaf.keys.end());
+	right.recIds.assign(leaf.recIds.begin() + numLeft, leaf.recIds.end());
+	leaf.keys.resize(numLeft * numKeys);
+	leaf.recIds.resize(numLeft);
+	linkAfter(block, &leaf, rightBlock, &right);
+	writeNode(block, numKeys, index->compressed, &leaf);
+	writeNode(rightBlock, numKeys, index->compressed, &right);
+
+	/* the last key of the left leaf separates the two leaves in the parent
+	(a compressed index keeps only as much of the first key on the right as
+	tells it apart). Every split of an internal block moves its middle key up
+	one more level. */
+	std::vector<Attribute> sepKey(leaf.keys.end() - numKeys, leaf.keys.end());
+	if (index->compressed)
+		shortSeparator(&leaf.keys.back(), &right.keys.front(), &sepKey[0]);
+	int newChild = rightBlock;
+	while (!path.empty())
+	{
+		int parentBlock = path.back();
+		int child = pathChild.back();
+		path.pop_back();
+		pathChild.pop_back();
+
+		CompositeNode parent;
+		readNode(parentBlock, numKeys, index->compressed, &parent);
+		parent.keys.insert(parent.keys.begin() + child * numKeys, sepKey.begin(), sepKey.end());
+		parent.children.insert(parent.children.begin() + child + 1, newChild);
+
+		int numParentEntries = parent.children.size() - 1;
+		if (nodeFits(&parent, numKeys, index->compressed))
+		{
+			writeNode(parentBlock, numKeys, index->compressed, &parent);
+			return SUCCESS;
+		}
+
+		int newBlock = newNode('I');
+		if (newBlock < 0)
+			return E_DISKFULL;
+
+		CompositeNode newInternal;
+		readNode(newBlock, numKeys, index->compressed, &newInternal);
+		int mid = numParentEntries / 2;
+		newInternal.keys.assign(parent.keys.begin() + (mid + 1) * numKeys, parent.keys.end());
+		newInternal.children.assign(parent.children.begin() + mid + 1, parent.children.end());
+		sepKey.assign(parent.keys.begin() + mid * numKeys, parent.keys.begin() + (mid + 1) * numKeys);
+		parent.keys.resize(mid * numKeys);
+		parent.children.resize(mid + 1);
+		linkAfter(parentBlock, &parent, newBlock, &newInternal);
+		writeNode(parentBlock, numKeys, index->compressed, &parent);
+		writeNode(newBlock, numKeys, index->compressed, &newInternal);
+
+		newChild = newBlock;
+	}
+
+	// the root was split: a new root has the two halves as its children
+	int rootBlock = newNode('I');
+	if (rootBlock < 0)
+		return E_DISKFULL;
+
+	CompositeNode root;
+	readNode(rootBlock, numKeys, index->compressed, &root);
+	root.keys = sepKey;
+	root.children = {index->rootBlock, newChild};
+	writeNode(rootBlock, numKeys, index->compressed, &root);
+	return setRoot(index, rootBlock);
+}
+
+// removes the entry of `record` at recId (E_NOTFOUND if there is none)
+int CompositeIndex::remove(CompositeIndexInfo *index, union Attribute *record, RecId recId)
+{
+	int numKeys = index->numKeys;
+	Attribute key[numKeys];
+	for (int i = 0; i < numKeys; ++i)
+		key[i] = record[index->keyOffsets[i]];
+
+	int block = index->rootBlock;
+	if (block == -1)
+		return E_NOTFOUND;
+
+	// the first entry with the key is under the child left of the first key >= it
+	while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL)
+	{
+		IndNode internal(block);
+		HeadInfo head;
+		internal.getHeader(&head);
+
+		int child = 0;
+		Attribute sepKey[numKeys];
+		while (child < head.numEntries)
+		{
+			readInternalKey(internal, numKeys, index->compressed, child, sepKey);
+			if (compareKeys(sepKey, key, index->keyTypes, numKeys) >= 0)
+				break;
+			child++;
+		}
+		block = readChild(internal, numKeys, index->compressed, child);
+	}
+
+	// the entries with the key may continue over the next leaves
+	while (block != -1)
+	{
+		CompositeNode leaf;
+		readNode(block, numKeys, index->compressed, &leaf);
+
+		for (int i = 0; i < (int)leaf.recIds.size(); ++i)
+		{
+			int cmpVal = compareKeys(&leaf.keys[i * numKeys], key, index->keyTypes, numKeys);
+			if (cmpVal > 0)
+				return E_NOTFOUND;
+
+			if (cmpVal == 0 && leaf.recIds[i].block == recId.block && leaf.recIds[i].slot == recId.slot)
+			{
+				leaf.keys.erase(leaf.keys.begin() + i * numKeys, leaf.keys.begin() + (i + 1) * numKeys);
+				leaf.recIds.erase(leaf.recIds.begin() + i);
+				writeNode(block, numKeys, index->compressed, &leaf);
+				return SUCCESS;
+			}
+		}
+		block = leaf.head.rblock;
+	}
+
+	return E_NOTFOUND;
+}
+
+/* returns in *recId the next record whose first numSearchKeys key attributes
+compare with searchKey as `op` says (lexicographically), or E_NOTFOUND.
+cursor is the position of the previous entry found ({-1, -1} to start a new
+search) and is advanced like the search index of BPlusTree::bPlusSearch(). */
+int CompositeIndex::search(CompositeIndexInfo *index, int numSearchKeys, union Attribute searchKey[], int op,
+                           IndexId *cursor, RecId *recId)
+{
+	int numKeys = index->numKeys;
+	int block, entryIndex;
+
+	if (cursor->block == -1 && cursor->index == -1)
+	{
+		block = index->rootBlock;
+		if (block == -1)
+			return E_NOTFOUND;
+
+		/* NE, LT and LE start from the leftmost leaf; EQ, GE and GT move to the
+		left child of the first key that can start the result */
+		while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL)
+		{
+			IndNode internal(block);
+			HeadInfo head;
+			internal.getHeader(&head);
+
+			int child = 0;
+			if (op != NE && op != LT && op != LE)
+			{
+				Attribute sepKey[numKeys];
+				while (child < head.numEntries)
+				{
+					readInternalKey(internal, numKeys, index->compressed, child, sepKey);
+					int cmpVal = compareKeys(sepKey, searchKey, index->keyTypes, numSearchKeys);
+					if ((op == GT && cmpVal > 0) || (op != GT && cmpVal >= 0))
+						break;
+					child++;
+				}
+			}
+			block = readChild(internal, numKeys, index->compressed, child);
+		}
+		entryIndex = 0;
+	}
+	else
+	{
+		// resume from the entry after the previous one
+		block = cursor->block;
+		entryIndex = cursor->index + 1;
+	}
+
+	Attribute entryKey[numKeys];
+	RecId entryRecId;
+	while (block != -1)
+	{
+		IndNode leaf(block);
+		HeadInfo head;
+		leaf.getHeader(&head);
+
+		for (; entryIndex < head.numEntries; ++entryIndex)
+		{
+			readLeafEntry(leaf, numKeys, index->compressed, entryIndex, entryKey, &entryRecId);
+			int cmpVal = compareKeys(entryKey, searchKey, index->keyTypes, numSearchKeys);
+
+			if (satisfies(cmpVal, op))
+			{
+				*cursor = IndexId{block, entryIndex, -1, -1};
+				*recId = entryRecId;
+				return SUCCESS;
+			}
+			// the following entries are greater still
+			if ((op == EQ || op == LE || op == LT) && cmpVal > 0)
+				return E_NOTFOUND;
+		}
+
+		block = head.rblock;
+		entryIndex = 0;
+	}
+
+	return E_NOTFOUND;
+}
+
+// releases every block of the tree rooted at rootBlock
+void CompositeIndex::destroy(int rootBlock, int numKeys, bool compressed)
+{
+	if (rootBlock < 0 || rootBlock >= DISK_BLOCKS)
+		return;
+
+	int type = StaticBuffer::getStaticBlockType(rootBlock);
+	if (type == IND_INTERNAL)
+	{
+		IndNode internal(rootBlock);
+		HeadInfo head;
+		internal.getHeader(&head);
+
+		std::vector<int> children;
+		for (int i = 0; i <= head.numEntries; ++i)
+			children.push_back(readChild(internal, numKeys, compressed, i));
+		for (int child : children)
+			destroy(child, numKeys, compressed);
+	}
+	else if (type != IND_LEAF)
+	{
+		return;
+	}
+
+	IndNode buffer(rootBlock);
+	buffer.releaseBlock();
+}
+
+/************ invariant check ************/
+
+struct CompositeCheck {
+	int numKeys;
+	bool compressed;
+	int *keyTypes;
+	int *keyOffsets;
+	int relNumAttrs;
+	int leafDepth;
+	int numEntries;
+	int numBlocks;
+	std::vector<int> leaves;  // in key order
+};
+
+// key of the entry at index in keys (numKeys attributes per entry)
+static Attribute *entryKey(std::vector<Attribute> &keys, int numKeys, int index)
+{
+	return &keys[index * numKeys];
+}
+
+/* checks the subtree at block: its keys are sorted and lie within [lo, hi]
+(nullptr for no bound), the blocks are not overfull, every leaf is at the
+same depth and every leaf entry matches the key of its record */
+static int checkNode(CompositeCheck *check, int block, Attribute *lo, Attribute *hi, int depth)
+{
+	int numKeys = check->numKeys;
+	int type = StaticBuffer::getStaticBlockType(block);
+	if (type != IND_LEAF && type != IND_INTERNAL)
+		return E_INDEXCORRUPT;
+
+	CompositeNode node;
+	readNode(block, numKeys, check->compressed, &node);
+	int numEntries = node.keys.size() / numKeys;
+	if (!nodeFits(&node, numKeys, check->compressed))
+		return E_INDEXCORRUPT;
+	check->numBlocks++;
+
+	for (int i = 0; i < numEntries; ++i)
+	{
+		Attribute *key = entryKey(node.keys, numKeys, i);
+		if ((lo != nullptr && compareKeys(key, lo, check->keyTypes, numKeys) < 0) ||
+		    (hi != nullptr && compareKeys(key, hi, check->keyTypes, numKeys) > 0) ||
+		    (i > 0 && compareKeys(entryKey(node.keys, numKeys, i - 1), key, check->keyTypes, numKeys) > 0))
+			return E_INDEXCORRUPT;
+	}
+
+	if (type == IND_LEAF)
+	{
+		if (check->leafDepth == -1)
+			check->leafDepth = depth;
+		if (check->leafDepth != depth)
+			return E_INDEXCORRUPT;
+
+		for (int i = 0; i < numEntries; ++i)
+		{
+			RecBuffer recBuffer(node.recIds[i].block);
+			Attribute record[check->relNumAttrs];
+			if (recBuffer.getRecord(record, node.recIds[i].slot) != SUCCESS)
+				return E_INDEXCORRUPT;
+			for (int k = 0; k < numKeys; ++k)
+			{
+				if (compareAttrs(record[check->keyOffsets[k]], node.keys[i * numKeys + k], check->keyTypes[k]) != 0)
+					return E_INDEXCORRUPT;
+			}
+		}
+
+		check->numEntries += numEntries;
+		check->leaves.push_back(block);
+		return SUCCESS;
+	}
+
+	if (numEntries < 1)
+		return E_INDEXCORRUPT;
+
+	for (int i = 0; i <= numEntries; ++i)
+	{
+		Attribute *childLo = i > 0 ? entryKey(node.keys, numKeys, i - 1) : lo;
+		Attribute *childHi = i < numEntries ? entryKey(node.keys, numKeys, i) : hi;
+		int ret = checkNode(check, node.children[i], childLo, childHi, depth + 1);
+		if (ret != SUCCESS)
+			return ret;
+	}
+	return SUCCESS;
+}
+
+/* checks the invariants of the tree and that it has exactly one entry per
+record of the relation; the number of entries, the number of blocks of the
+tree and its height (blocks from the root to a leaf) are returned */
+int CompositeIndex::check(int relId, CompositeIndexInfo *index, int *numEntries, int *numBlocks, int *height)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	CompositeCheck check;
+	check.numKeys = index->numKeys;
+	check.compressed = index->compressed;
+	check.keyTypes = index->keyTypes;
+	check.keyOffsets = index->keyOffsets;
+	check.relNumAttrs = relCatEntry.numAttrs;
+	check.leafDepth = -1;
+	check.numEntries = 0;
+	check.numBlocks = 0;
+
+	if (index->rootBlock != -1)
+	{
+		ret = checkNode(&check, index->rootBlock, nullptr, nullptr, 0);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	// the leaves are linked in key order
+	for (int i = 0; i < (int)check.leaves.size(); ++i)
+	{
+		IndNode leaf(check.leaves[i]);
+		HeadInfo head;
+		leaf.getHeader(&head);
+		int expectedLeft = i > 0 ? check.leaves[i - 1] : -1;
+		int expectedRight = i + 1 < (int)check.leaves.size() ? check.leaves[i + 1] : -1;
+		if (head.lblock != expectedLeft || head.rblock != expectedRight)
+			return E_INDEXCORRUPT;
+	}
+
+	*numEntries = check.numEntries;
+	*numBlocks = check.numBlocks;
+	*height = check.leafDepth + 1;
+	if (check.numEntries != relCatEntry.numRecs)
+		return E_INDEXCORRUPT;
+	return SUCCESS;
+}
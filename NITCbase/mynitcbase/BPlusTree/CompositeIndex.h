@@ -0,0 +1,75 @@
+#ifndef NITCBASE_COMPOSITEINDEX_H
+#define NITCBASE_COMPOSITEINDEX_H
+
+#include <vector>
+
+#include "../Buffer/BlockBuffer.h"
+#include "../Buffer/StaticBuffer.h"
+#include "../Cache/AttrCacheTable.h"
+#include "../Cache/CatalogDirectory.h"
+#include "../Cache/RelCacheTable.h"
+#include "../define/constants.h"
+#include "../define/id.h"
+
+typedef struct CompositeIndexInfo {
+  RecId catRecId;  // Attribute Catalog record of the index
+  int numKeys;
+  bool compressed;  // a single string key with prefix-compressed blocks
+  int keyOffsets[MAX_COMPOSITE_KEYS];
+  int keyTypes[MAX_COMPOSITE_KEYS];
+  int rootBlock;  // -1 while the index is empty
+
+} CompositeIndexInfo;
+
+/*
+ * B+ tree over several attributes of a relation (CREATE INDEX ON rel.(a, b)),
+ * ordered lexicographically on the attributes in the order they were listed.
+ * A leaf entry holds numKeys attribute values followed by the block and slot
+ * of the record; an internal block holds numKeys + 1 children with a key of
+ * numKeys values between every two of them, so the fanout of a block depends
+ * on numKeys (see leafCapacity() and internalCapacity()).
+ *
+ * An index is stored as a record of the Attribute Catalog with Offset -1,
+ * whose AttributeName lists the offsets of the key attributes ("0_2") and
+ * whose RootBlock is the root of the tree. The root is written back to that
+ * record whenever it changes.
+ *
+ * A search compares the first numSearchKeys attributes of the entries, so it
+ * answers prefix searches on the leading attributes as well as searches on
+ * the full key. Deleting an entry never merges blocks: the leaves may become
+ * sparse (searches skip empty leaves) until the index is rebuilt by VACUUM.
+ * The trees are always walked down from the root, so pblock is not kept.
+ *
+ * A compressed index (CREATE COMPRESSED INDEX ON rel.attr) is a tree of this
+ * kind on a single string attribute, recorded with Offset -3, whose blocks
+ * store the prefix shared by their keys once and only the rest of every key.
+ * The keys of its internal blocks are cut to the shortest prefix that still
+ * separates two leaves, so a block holds as many entries as fit in it (up to
+ * leafCapacity() or internalCapacity()) instead of a fixed number.
+ */
+class CompositeIndex {
+ public:
+  // the composite indexes of an open relation
+  static int getIndexes(int relId, std::vector<CompositeIndexInfo> *indexes);
+  static int find(int relId, int numKeys, int keyOffsets[], CompositeIndexInfo *index);
+  static int findLeading(int relId, int attrOffset, CompositeIndexInfo *index);
+
+  // catalog record of an index
+  static void keyName(int numKeys, int keyOffsets[], char name[ATTR_SIZE]);
+  static int parseKeyName(char name[ATTR_SIZE], int keyOffsets[]);
+  static int setRoot(CompositeIndexInfo *index, int rootBlock);
+
+  // tree operations
+  static int build(int relId, CompositeIndexInfo *index);
+  static int insert(CompositeIndexInfo *index, union Attribute *record, RecId recId);
+  static int remove(CompositeIndexInfo *index, union Attribute *record, RecId recId);
+  static int search(CompositeIndexInfo *index, int numSearchKeys, union Attribute searchKey[], int op,
+                    IndexId *cursor, RecId *recId);
+  static void destroy(int rootBlock, int numKeys, bool compressed);
+  static int check(int relId, CompositeIndexInfo *index, int *numEntries, int *numBlocks, int *height);
+
+  static int leafCapacity(int numKeys, bool compressed);
+  static int internalCapacity(int numKeys, bool compressed);
+};
+
+#endif  // NITCBASE_COMPOSITEINDEX_H
@@ -0,0 +1,656 @@
+#include "HashIndex.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* the level, split pointer and counts at the start of every directory block
+(only those of the first directory block are used) */
+struct HashMeta {
+	int32_t level;
+	int32_t next;
+	int32_t numBuckets;
+	int32_t numEntries;
+};
+
+// a bucket entry is the attribute value followed by the block and slot of the record
+static const int ENTRY_SIZE = ATTR_SIZE + 2 * sizeof(int32_t);
+
+int HashIndex::bucketCapacity()
+{
+	return (BLOCK_SIZE - HEADER_SIZE) / ENTRY_SIZE;
+}
+
+// number of buckets listed in one directory block
+static int directoryCapacity()
+{
+	return (BLOCK_SIZE - HEADER_SIZE - sizeof(HashMeta)) / sizeof(int32_t);
+}
+
+/* hash of an attribute value: the bits of a number (0 and -0 are equal) are
+mixed with the splitmix64 finalizer, a string is hashed with FNV-1a */
+static unsigned int hashValue(Attribute attrVal, int attrType)
+{
+	uint64_t h;
+	if (attrType == NUMBER)
+	{
+		double val = attrVal.nVal == 0 ? 0.0 : attrVal.nVal;
+		memcpy(&h, &val, sizeof(h));
+		h ^= h >> 30;
+		h *= 0xbf58476d1ce4e5b9ULL;
+		h ^= h >> 27;
+		h *= 0x94d049bb133111ebULL;
+		h ^= h >> 31;
+	}
+	else
+	{
+		h = 1469598103934665603ULL;
+		for (int i = 0; i < ATTR_SIZE && attrVal.sVal[i] != '\0'; ++i)
+		{
+			h ^= (unsigned char)attrVal.sVal[i];
+			h *= 1099511628211ULL;
+		}
+	}
+	return (unsigned int)(h ^ (h >> 32));
+}
+
+/* the bucket of a hash: the buckets before the split pointer have already
+been split at this level, so they are addressed with twice as many buckets */
+static int bucketOf(HashMeta *meta, unsigned int hash)
+{
+	unsigned int numBuckets = HASH_INITIAL_BUCKETS << meta->level;
+	unsigned int bucket = hash % numBuckets;
+	if (bucket < (unsigned int)meta->next)
+		bucket = hash % (2 * numBuckets);
+	return bucket;
+}
+
+static void readMeta(int rootBlock, HashMeta *meta)
+{
+	IndNode directory(rootBlock);
+	directory.getBytes((unsigned char *)meta, 0, sizeof(HashMeta));
+}
+
+static void writeMeta(int rootBlock, HashMeta *meta)
+{
+	IndNode directory(rootBlock);
+	directory.setBytes((unsigned char *)meta, 0, sizeof(HashMeta));
+}
+
+// first block of a bucket
+static int getBucket(int rootBlock, int bucket)
+{
+	int block = rootBlock;
+	for (int i = 0; i < bucket / directoryCapacity(); ++i)
+	{
+		IndNode directory(block);
+		HeadInfo head;
+		directory.getHeader(&head);
+		block = head.rblock;
+	}
+
+	IndNode directory(block);
+	int32_t bucketBlock;
+	directory.getBytes((unsigned char *)&bucketBlock,
+	                   sizeof(HashMeta) + (bucket % directoryCapacity()) * sizeof(int32_t), sizeof(int32_t));
+	return bucketBlock;
+}
+
+// allocates a directory ('D') or bucket ('H') block; returns E_DISKFULL if there is no free block
+static int newBlock(char blockType)
+{
+	IndNode buffer(blockType);
+	int block = buffer.getBlockNum();
+	if (block < 0 || block >= DISK_BLOCKS)
+		return E_DISKFULL;
+	return block;
+}
+
+/* records bucketBlock as the first block of a bucket, adding a directory
+block at the end of the directory if the bucket does not fit in it */
+static int setBucket(int rootBlock, int bucket, int bucketBlock)
+{
+	int block = rootBlock;
+	for (int i = 0; i < bucket / directoryCapacity(); ++i)
+	{
+		IndNode directory(block);
+		HeadInfo head;
+		directory.getHeader(&head);
+		if (head.rblock == -1)
+		{
+			head.rblock = newBlock('D');
+			if (head.rblock == E_DISKFULL)
+				return E_DISKFULL;
+			directory.setHeader(&head);
+
+			IndNode next(head.rblock);
+			HeadInfo nextHead;
+			next.getHeader(&nextHead);
+			nextHead.lblock = block;
+			next.setHeader(&nextHead);
+		}
+		block = head.rblock;
+	}
+
+	IndNode directory(block);
+	int32_t value = bucketBlock;
+	return directory.setBytes((unsigned char *)&value,
+	                          sizeof(HashMeta) + (bucket % directoryCapacity()) * sizeof(int32_t), sizeof(int32_t));
+}
+
+static void readEntry(unsigned char *entry, Attribute *attrVal, RecId *recId)
+{
+	int32_t block, slot;
+	memcpy(attrVal, entry, ATTR_SIZE);
+	memcpy(&block, entry + ATTR_SIZE, sizeof(int32_t));
+	memcpy(&slot, entry + ATTR_SIZE + sizeof(int32_t), sizeof(int32_t));
+	*recId = RecId{block, slot};
+}
+
+static void writeEntry(unsigned char *entry, Attribute attrVal, RecId recId)
+{
+	int32_t block = recId.block, slot = recId.slot;
+	memcpy(entry, &attrVal, ATTR_SIZE);
+	memcpy(entry + ATTR_SIZE, &block, sizeof(int32_t));
+	memcpy(entry + ATTR_SIZE + sizeof(int32_t), &slot, sizeof(int32_t));
+}
+
+/* appends an entry to the last block of the bucket starting at block, adding
+an overflow block if that one is full */
+static int appendEntry(int block, Attribute attrVal, RecId recId)
+{
+	IndNode bucket(block);
+	HeadInfo head;
+	bucket.getHeader(&head);
+	while (head.rblock != -1)
+	{
+		block = head.rblock;
+		bucket = IndNode(block);
+		bucket.getHeader(&head);
+	}
+
+	if (head.numEntries == HashIndex::bucketCapacity())
+	{
+		int overflow = newBlock('H');
+		if (overflow == E_DISKFULL)
+			return E_DISKFULL;
+		head.rblock = overflow;
+		bucket.setHeader(&head);
+
+		bucket = IndNode(overflow);
+		bucket.getHeader(&head);
+		head.lblock = block;
+		block = overflow;
+	}
+
+	unsigned char entry[ENTRY_SIZE];
+	writeEntry(entry, attrVal, recId);
+	bucket.setBytes(entry, head.numEntries * ENTRY_SIZE, ENTRY_SIZE);
+	head.numEntries++;
+	return bucket.setHeader(&head);
+}
+
+/************ catalog ************/
+
+int HashIndex::getIndexes(int relId, std::vector<HashIndexInfo> *indexes)
+{
+	indexes->clear();
+
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	std::vector<RecId> indexRecIds;
+	if (CatalogDirectory::getIndexRecIds(relCatEntry.relName, &indexRecIds) != SUCCESS)
+		return SUCCESS;
+
+	for (RecId indexRecId : indexRecIds)
+	{
+		RecBuffer catBuffer(indexRecId.block);
+		Attribute record[ATTRCAT_NO_ATTRS];
+		catBuffer.getRecord(record, indexRecId.slot);
+		if ((int)record[ATTRCAT_OFFSET_INDEX].nVal != HASH_INDEX_OFFSET)
+			continue;
+
+		HashIndexInfo index;
+		index.catRecId = indexRecId;
+		index.rootBlock = (int)record[ATTRCAT_ROOT_BLOCK_INDEX].nVal;
+		index.attrOffset = atoi(record[ATTRCAT_ATTR_NAME_INDEX].sVal);
+
+		AttrCatEntry attrCatEntry;
+		if (AttrCacheTable::getAttrCatEntry(relId, index.attrOffset, &attrCatEntry) != SUCCESS)
+			continue;
+		index.attrType = attrCatEntry.attrType;
+		indexes->push_back(index);
+	}
+
+	return SUCCESS;
+}
+
+// finds the hash index on the attribute at attrOffset
+int HashIndex::find(int relId, int attrOffset, HashIndexInfo *index)
+{
+	std::vector<HashIndexInfo> indexes;
+	int ret = getIndexes(relId, &indexes);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (HashIndexInfo &candidate : indexes)
+	{
+		if (candidate.attrOffset == attrOffset)
+		{
+			*index = candidate;
+			return SUCCESS;
+		}
+	}
+	return E_NOINDEX;
+}
+
+int HashIndex::setRoot(HashIndexInfo *index, int rootBlock)
+{
+	index->rootBlock = rootBlock;
+
+	RecBuffer catBuffer(index->catRecId.block);
+	Attribute record[ATTRCAT_NO_ATTRS];
+	catBuffer.getRecord(record, index->catRecId.slot);
+	record[ATTRCAT_ROOT_BLOCK_INDEX].nVal = rootBlock;
+	return catBuffer.setRecord(record, index->catRecId.slot);
+}
+
+/************ table operations ************/
+
+// allocates the directory and the first HASH_INITIAL_BUCKETS buckets of an empty index
+static int createTable(HashIndexInfo *index)
+{
+	int rootBlock = newBlock('D');
+	if (rootBlock == E_DISKFULL)
+		return E_DISKFULL;
+
+	HashMeta meta = {0, 0, 0, 0};
+	writeMeta(rootBlock, &meta);
+	for (int bucket = 0; bucket < HASH_INITIAL_BUCKETS; ++bucket)
+	{
+		int block = newBlock('H');
+		if (block == E_DISKFULL)
+		{
+			HashIndex::destroy(rootBlock);
+			return E_DISKFULL;
+		}
+		setBucket(rootBlock, bucket, block);
+		meta.numBuckets++;
+		writeMeta(rootBlock, &meta);
+	}
+
+	return HashIndex::setRoot(index, rootBlock);
+}
+
+/* splits the bucket at the split pointer: its entries are shared between it
+and a new bucket at the end of the table using the hash on twice as many
+buckets, and the split pointer moves to the next bucket (back to the first
+one, at the next level, once every bucket of the level has been split) */
+static int splitBucket(int rootBlock, int attrType)
+{
+	HashMeta meta;
+	readMeta(rootBlock, &meta);
+
+	int bucket = meta.next;
+	int newBucket = meta.numBuckets;
+	int block = newBlock('H');
+	if (block == E_DISKFULL)
+		return E_DISKFULL;
+	if (setBucket(rootBlock, newBucket, block) != SUCCESS)
+	{
+		IndNode(block).releaseBlock();
+		return E_DISKFULL;
+	}
+
+	// take the entries out of the bucket, keeping only its first block
+	std::vector<Attribute> attrVals;
+	std::vector<RecId> recIds;
+	int first = getBucket(rootBlock, bucket);
+	for (int current = first; current != -1;)
+	{
+		IndNode buffer(current);
+		HeadInfo head;
+		buffer.getHeader(&head);
+
+		unsigned char data[BLOCK_SIZE - HEADER_SIZE];
+		buffer.getBytes(data, 0, head.numEntries * ENTRY_SIZE);
+		for (int i = 0; i < head.numEntries; ++i)
+		{
+			Attribute attrVal;
+			RecId recId;
+			readEntry(data + i * ENTRY_SIZE, &attrVal, &recId);
+			attrVals.push_back(attrVal);
+			recIds.push_back(recId);
+		}
+
+		int next = head.rblock;
+		if (current == first)
+		{
+			head.numEntries = 0;
+			head.rblock = -1;
+			buffer.setHeader(&head);
+		}
+		else
+		{
+			buffer.releaseBlock();
+		}
+		current = next;
+	}
+
+	meta.numBuckets++;
+	meta.next++;
+	if (meta.next == (HASH_INITIAL_BUCKETS << meta.level))
+	{
+		meta.level++;
+		meta.next = 0;
+	}
+	writeMeta(rootBlock, &meta);
+
+	for (int i = 0; i < (int)attrVals.size(); ++i)
+	{
+		int target = bucketOf(&meta, hashValue(attrVals[i], attrType));
+		int ret = appendEntry(getBucket(rootBlock, target), attrVals[i], recIds[i]);
+		if (ret != SUCCESS)
+			return ret;
+	}
+	return SUCCESS;
+}
+
+/* inserts an entry for every record of the relation. On E_DISKFULL the
+index is destroyed and left empty. */
+int HashIndex::build(int relId, HashIndexInfo *index)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	int block = relCatEntry.firstBlk;
+	while (block != -1)
+	{
+		RecBuffer recBuffer(block);
+		HeadInfo head;
+		recBuffer.getHeader(&head);
+		unsigned char slotMap[head.numSlots];
+		recBuffer.getSlotMap(slotMap);
+
+		for (int slot = 0; slot < head.numSlots; ++slot)
+		{
+			if (slotMap[slot] == SLOT_UNOCCUPIED)
+				continue;
+
+			Attribute record[head.numAttrs];
+			recBuffer.getRecord(record, slot);
+			if (insert(index, record, RecId{block, slot}) != SUCCESS)
+			{
+				destroy(index->rootBlock);
+				setRoot(index, -1);
+				return E_DISKFULL;
+			}
+		}
+		block = head.rblock;
+	}
+
+	return SUCCESS;
+}
+
+/* inserts the entry of the record at recId (the directory is created by the
+first insertion) and splits a bucket if the index got too full */
+int HashIndex::insert(HashIndexInfo *index, union Attribute *record, RecId recId)
+{
+	if (index->rootBlock == -1)
+	{
+		int ret = createTable(index);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	HashMeta meta;
+	readMeta(index->rootBlock, &meta);
+
+	Attribute attrVal = record[index->attrOffset];
+	int bucket = bucketOf(&meta, hashValue(attrVal, index->attrType));
+	int ret = appendEntry(getBucket(index->rootBlock, bucket), attrVal, recId);
+	if (ret != SUCCESS)
+		return ret;
+
+	meta.numEntries++;
+	writeMeta(index->rootBlock, &meta);
+
+	if (meta.numEntries * 100 > meta.numBuckets * bucketCapacity() * HASH_SPLIT_LOAD)
+		return splitBucket(index->rootBlock, index->attrType);
+	return SUCCESS;
+}
+
+/* removes the entry of the record at recId. The last entry of the bucket
+takes its place, so the blocks of a bucket stay full but for the last one,
+which is released (unless it is the first) when it becomes empty. */
+int HashIndex::remove(HashIndexInfo *index, union Attribute *record, RecId recId)
+{
+	if (index->rootBlock == -1)
+		return E_NOTFOUND;
+
+	HashMeta meta;
+	readMeta(index->rootBlock, &meta);
+
+	Attribute attrVal = record[index->attrOffset];
+	int bucket = bucketOf(&meta, hashValue(attrVal, index->attrType));
+
+	std::vector<int> chain;
+	int foundBlock = -1, foundEntry = -1;
+	for (int block = getBucket(index->rootBlock, bucket); block != -1;)
+	{
+		chain.push_back(block);
+		IndNode buffer(block);
+		HeadInfo head;
+		buffer.getHeader(&head);
+
+		unsigned char data[BLOCK_SIZE - HEADER_SIZE];
+		buffer.getBytes(data, 0, head.numEntries * ENTRY_SIZE);
+		for (int i = 0; i < head.numEntries && foundBlock == -1; ++i)
+		{
+			Attribute entryVal;
+			RecId entryRecId;
+			readEntry(data + i * ENTRY_SIZE, &entryVal, &entryRecId);
+			if (entryRecId.block == recId.block && entryRecId.slot == recId.slot &&
+			    compareAttrs(entryVal, attrVal, index->attrType) == 0)
+			{
+				foundBlock = block;
+				foundEntry = i;
+			}
+		}
+		block = head.rblock;
+	}
+	if (foundBlock == -1)
+		return E_NOTFOUND;
+
+	// move the last entry of the bucket into the place of the removed one
+	int lastBlock = chain.back();
+	IndNode last(lastBlock);
+	HeadInfo lastHead;
+	last.getHeader(&lastHead);
+
+	unsigned char entry[ENTRY_SIZE];
+	last.getBytes(entry, (lastHead.numEntries - 1) * ENTRY_SIZE, ENTRY_SIZE);
+	IndNode(foundBlock).setBytes(entry, foundEntry * ENTRY_SIZE, ENTRY_SIZE);
+	lastHead.numEntries--;
+	last.setHeader(&lastHead);
+
+	if (lastHead.numEntries == 0 && chain.size() > 1)
+	{
+		last.releaseBlock();
+		IndNode previous(chain[chain.size() - 2]);
+		HeadInfo previousHead;
+		previous.getHeader(&previousHead);
+		previousHead.rblock = -1;
+		previous.setHeader(&previousHead);
+	}
+
+	meta.numEntries--;
+	writeMeta(index->rootBlock, &meta);
+	return SUCCESS;
+}
+
+/* finds the next entry equal to attrVal after *cursor ({-1, -1} to start with
+the first entry of its bucket), returning the record in *recId and moving
+*cursor past the entry. Returns E_NOTFOUND when the bucket has no more. */
+int HashIndex::search(HashIndexInfo *index, union Attribute attrVal, IndexId *cursor, RecId *recId)
+{
+	if (index->rootBlock == -1)
+		return E_NOTFOUND;
+
+	int block, entryIndex;
+	if (cursor->block == -1)
+	{
+		HashMeta meta;
+		readMeta(index->rootBlock, &meta);
+		block = getBucket(index->rootBlock, bucketOf(&meta, hashValue(attrVal, index->attrType)));
+		entryIndex = 0;
+	}
+	else
+	{
+		block = cursor->block;
+		entryIndex = cursor->index;
+	}
+
+	while (block != -1)
+	{
+		IndNode bucket(block);
+		HeadInfo head;
+		bucket.getHeader(&head);
+
+		unsigned char data[BLOCK_SIZE - HEADER_SIZE];
+		if (entryIndex < head.numEntries)
+			bucket.getBytes(data, entryIndex * ENTRY_SIZE, (head.numEntries - entryIndex) * ENTRY_SIZE);
+		for (int i = entryIndex; i < head.numEntries; ++i)
+		{
+			Attribute entryVal;
+			RecId entryRecId;
+			readEntry(data + (i - entryIndex) * ENTRY_SIZE, &entryVal, &entryRecId);
+			if (compareAttrs(entryVal, attrVal, index->attrType) == 0)
+			{
+				*cursor = IndexId{block, i + 1, -1, -1};
+				*recId = entryRecId;
+				return SUCCESS;
+			}
+		}
+
+		block = head.rblock;
+		entryIndex = 0;
+	}
+
+	return E_NOTFOUND;
+}
+
+// releases every bucket and directory block of the index at rootBlock
+void HashIndex::destroy(int rootBlock)
+{
+	if (rootBlock < 0 || rootBlock >= DISK_BLOCKS || StaticBuffer::getStaticBlockType(rootBlock) != HASH_DIR)
+		return;
+
+	HashMeta meta;
+	readMeta(rootBlock, &meta);
+	for (int bucket = 0; bucket < meta.numBuckets; ++bucket)
+	{
+		int block = getBucket(rootBlock, bucket);
+		while (block >= 0 && block < DISK_BLOCKS && StaticBuffer::getStaticBlockType(block) == HASH_BUCKET)
+		{
+			IndNode buffer(block);
+			HeadInfo head;
+			buffer.getHeader(&head);
+			buffer.releaseBlock();
+			block = head.rblock;
+		}
+	}
+
+	int block = rootBlock;
+	while (block != -1)
+	{
+		IndNode directory(block);
+		HeadInfo head;
+		directory.getHeader(&head);
+		directory.releaseBlock();
+		block = head.rblock;
+	}
+}
+
+/************ invariant check ************/
+
+/* checks that every entry is in the bucket its hash addresses and matches
+its record, that the counts of the directory are right and that the index has
+exactly one entry per record of the relation. The number of entries, buckets
+and bucket blocks are returned in *numEntries, *numBuckets and *numBlocks. */
+int HashIndex::check(int relId, HashIndexInfo *index, int *numEntries, int *numBuckets, int *numBlocks)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	*numEntries = 0;
+	*numBuckets = 0;
+	*numBlocks = 0;
+	if (index->rootBlock == -1)
+		return relCatEntry.numRecs == 0 ? SUCCESS : E_INDEXCORRUPT;
+
+	for (int block = index->rootBlock; block != -1;)
+	{
+		if (StaticBuffer::getStaticBlockType(block) != HASH_DIR)
+			return E_INDEXCORRUPT;
+		IndNode directory(block);
+		HeadInfo head;
+		directory.getHeader(&head);
+		block = head.rblock;
+	}
+
+	HashMeta meta;
+	readMeta(index->rootBlock, &meta);
+	if (meta.next < 0 || meta.next >= (HASH_INITIAL_BUCKETS << meta.level) ||
+	    meta.numBuckets != (HASH_INITIAL_BUCKETS << meta.level) + meta.next)
+		return E_INDEXCORRUPT;
+
+	for (int bucket = 0; bucket < meta.numBuckets; ++bucket)
+	{
+		for (int block = getBucket(index->rootBlock, bucket); block != -1;)
+		{
+			if (StaticBuffer::getStaticBlockType(block) != HASH_BUCKET)
+				return E_INDEXCORRUPT;
+
+			IndNode buffer(block);
+			HeadInfo head;
+			buffer.getHeader(&head);
+			if (head.numEntries < 0 || head.numEntries > bucketCapacity())
+				return E_INDEXCORRUPT;
+
+			unsigned char data[BLOCK_SIZE - HEADER_SIZE];
+			buffer.getBytes(data, 0, head.numEntries * ENTRY_SIZE);
+			for (int i = 0; i < head.numEntries; ++i)
+			{
+				Attribute entryVal;
+				RecId entryRecId;
+				readEntry(data + i * ENTRY_SIZE, &entryVal, &entryRecId);
+				if (bucketOf(&meta, hashValue(entryVal, index->attrType)) != bucket)
+					return E_INDEXCORRUPT;
+
+				RecBuffer recBuffer(entryRecId.block);
+				Attribute record[relCatEntry.numAttrs];
+				if (recBuffer.getRecord(record, entryRecId.slot) != SUCCESS ||
+				    compareAttrs(record[index->attrOffset], entryVal, index->attrType) != 0)
+					return E_INDEXCORRUPT;
+			}
+
+			*numEntries += head.numEntries;
+			*numBlocks += 1;
+			block = head.rblock;
+		}
+	}
+	*numBuckets = meta.numBuckets;
+
+	if (*numEntries != meta.numEntries || *numEntries != relCatEntry.numRecs)
+		return E_INDEXCORRUPT;
+	return SUCCESS;
+}
@@ -0,0 +1,61 @@
+#ifndef NITCBASE_HASHINDEX_H
+#define NITCBASE_HASHINDEX_H
+
+#include <vector>
+
+#include "../Buffer/BlockBuffer.h"
+#include "../Buffer/StaticBuffer.h"
+#include "../Cache/AttrCacheTable.h"
+#include "../Cache/CatalogDirectory.h"
+#include "../Cache/RelCacheTable.h"
+#include "../define/constants.h"
+#include "../define/id.h"
+
+typedef struct HashIndexInfo {
+  RecId catRecId;  // Attribute Catalog record of the index
+  int attrOffset;
+  int attrType;
+  int rootBlock;  // first directory block, -1 while the index is empty
+
+} HashIndexInfo;
+
+/*
+ * Linear hashing index on one attribute of a relation (CREATE HASH INDEX ON
+ * rel.attr), used by equality searches. An entry (attribute value, block and
+ * slot of the record) lives in the bucket chosen by the hash of its value; a
+ * bucket is a chain of HASH_BUCKET blocks linked by rblock. A HASH_DIR block
+ * starts with the level, the split pointer and the number of buckets and
+ * entries of the index (read from the first directory block only), followed
+ * by the first block of every bucket; more directory blocks are linked by
+ * rblock when the buckets outgrow one.
+ *
+ * The table starts with HASH_INITIAL_BUCKETS buckets. Whenever an insertion
+ * fills the buckets beyond HASH_SPLIT_LOAD percent, the bucket at the split
+ * pointer is split in two and the pointer moves on, so the table grows one
+ * bucket at a time and a search reads the directory block and (usually) a
+ * single bucket block. Deletions never merge buckets; an overflow block left
+ * empty is released.
+ *
+ * An index is stored as a record of the Attribute Catalog with Offset -2,
+ * whose AttributeName is the offset of the attribute and whose RootBlock is
+ * the first directory block.
+ */
+class HashIndex {
+ public:
+  // the hash indexes of an open relation
+  static int getIndexes(int relId, std::vector<HashIndexInfo> *indexes);
+  static int find(int relId, int attrOffset, HashIndexInfo *index);
+  static int setRoot(HashIndexInfo *index, int rootBlock);
+
+  // table operations
+  static int build(int relId, HashIndexInfo *index);
+  static int insert(HashIndexInfo *index, union Attribute *record, RecId recId);
+  static int remove(HashIndexInfo *index, union Attribute *record, RecId recId);
+  static int search(HashIndexInfo *index, union Attribute attrVal, IndexId *cursor, RecId *recId);
+  static void destroy(int rootBlock);
+  static int check(int relId, HashIndexInfo *index, int *numEntries, int *numBuckets, int *numBlocks);
+
+  static int bucketCapacity();
+};
+
+#endif  // NITCBASE_HASHINDEX_H
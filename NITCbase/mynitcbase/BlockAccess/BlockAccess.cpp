@@ -1,9 +1,23 @@
 #include "BlockAccess.h"
+#include <algorithm>
 #include <cstring>
 #include<cstdlib>
 #include<cstdio>
 
 
+/* returns the first slot at or after `slot` that is marked SLOT_OCCUPIED in
+the slot map, or numSlots if there is none */
+static int nextOccupiedSlot(unsigned char *slotMap, int slot, int numSlots)
+{
+	if (slot >= numSlots)
+		return numSlots;
+
+	void *found = memchr(slotMap + slot, SLOT_OCCUPIED, numSlots - slot);
+	if (found == nullptr)
+		return numSlots;
+	return (unsigned char *)found - slotMap;
+}
+
 RecId BlockAccess::linearSearch(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, int op)
 {
 	// get the previous search index of the relation relId from the relation cache
@@ -36,85 +50,88 @@ RecId BlockAccess::linearSearch(int relId, char attrName[ATTR_SIZE], union Attri
 		slot = prevRecId.slot + 1;
 	}
 
+	/* resolve the attribute once for the whole search:
+	get the attribute offset and type for the attrName attribute
+	from the attribute cache entry of the relation using
+	AttrCacheTable::getAttrCatEntry()
+	*/
+	AttrCatEntry attrcatentry;
+	if (AttrCacheTable::getAttrCatEntry(relId, attrName, &attrcatentry) != SUCCESS)
+		return RecId{-1, -1};
+
+	int attrType = attrcatentry.attrType;
+	int attrOffset = attrcatentry.offset * ATTR_SIZE;
+
+	// blocks whose range in the zone map of the relation (if it has one)
+	// cannot satisfy the condition are skipped without being loaded
+	RelCatEntry relcatentry;
+	RelCacheTable::getRelCatEntry(relId, &relcatentry);
+	ZoneMap *zoneMap = ZoneMap::get(relcatentry.relName);
+
 	/* The following code searches for the next record in the relation
 	that satisfies the given condition
 	We start from the record id (block, slot) and iterate over the remaining
-	records of the relation
+	records of the relation, loading every block only once
 	*/
 	while (block != -1)
 	{
-		/* create a RecBuffer object for block (use RecBuffer Constructor for
-		existing block) */
-		RecBuffer recbuffer(block);
-		
-		// get header of the block using RecBuffer::getHeader() function
-		struct HeadInfo head;
-		recbuffer.getHeader(&head);
-		// get slot map of the block using RecBuffer::getSlotMap() function		
-		unsigned char slotmap[head.numSlots];
-		recbuffer.getSlotMap(slotmap);
-		
-		// get the record with id (block, slot) using RecBuffer::getRecord()
-		union Attribute record[head.numAttrs];
-		recbuffer.getRecord(record, slot);
-		
-
-		if ( slot >= head.numSlots)
+		if (zoneMap != nullptr && !zoneMap->mayContain(block, attrcatentry.offset, attrVal, op))
 		{
-			block = head.rblock;
+			block = zoneMap->getNextBlock(block);
 			slot = 0;
-			continue;  // continue to the beginning of this while loop
-		}
-
-		// if slot is free skip the loop
-		// (i.e. check if slot'th entry in slot map of block contains SLOT_UNOCCUPIED)
-		if (slotmap[slot]==SLOT_UNOCCUPIED)
-		{
-			slot++;
 			continue;
 		}
 
-		// compare record's attribute value to the the given attrVal as below:
-		/*
-		firstly get the attribute offset for the attrName attribute
-		from the attribute cache entry of the relation using
-		AttrCacheTable::getAttrCatEntry()
-		*/
-		AttrCatEntry attrcatentry;
-		AttrCacheTable::getAttrCatEntry(relId, attrName,&attrcatentry);
-		/* use the attribute offset to get the value of the attribute from
-		current record */
-
-		int cmpVal;  // will store the difference between the attributes
-		// set cmpVal using compareAttrs()
-		cmpVal=compareAttrs(record[attrcatentry.offset], attrVal, attrcatentry.attrType);
-
-		/* Next task is to check whether this record satisfies the given condition.
-		It is determined based on the output of previous comparison and
-		the op value received.
-		The following code sets the cond variable if the condition is satisfied.
-		*/
-		if (
-		(op == NE && cmpVal != 0) ||    // if op is "not equal to"
-		(op == LT && cmpVal < 0) ||     // if op is "less than"
-		(op == LE && cmpVal <= 0) ||    // if op is "less than or equal to"
-		(op == EQ && cmpVal == 0) ||    // if op is "equal to"
-		(op == GT && cmpVal > 0) ||     // if op is "greater than"
-		(op == GE && cmpVal >= 0)       // if op is "greater than or equal to"
-		)
+		/* create a RecBuffer object for block (use RecBuffer Constructor for
+		existing block) and get its header, slotmap and records in place */
+		RecBuffer recbuffer(block);
+		struct HeadInfo head;
+		unsigned char *slotmap, *records;
+		recbuffer.getBlockContents(&head, &slotmap, &records);
+		int recordSize = head.numAttrs * ATTR_SIZE;
+
+		// skip the free slots (i.e. entries in the slot map containing SLOT_UNOCCUPIED)
+		for (slot = nextOccupiedSlot(slotmap, slot, head.numSlots); slot < head.numSlots;
+		     slot = nextOccupiedSlot(slotmap, slot + 1, head.numSlots))
 		{
-			/*
-			set the search index in the relation cache as
-			the record id of the record that satisfies the given condition
-			(use RelCacheTable::setSearchIndex function)
+			// get the value of the attribute from the current record
+			// (records are not aligned in the block, so it is copied out)
+			union Attribute value;
+			memcpy(&value, records + slot * recordSize + attrOffset, ATTR_SIZE);
+
+			int cmpVal;  // will store the difference between the attributes
+			// set cmpVal using compareAttrs()
+			cmpVal=compareAttrs(value, attrVal, attrType);
+
+			/* Next task is to check whether this record satisfies the given condition.
+			It is determined based on the output of previous comparison and
+			the op value received.
+			The following code sets the cond variable if the condition is satisfied.
 			*/
-			
-			RecId recid{block,slot};
-			RelCacheTable::setSearchIndex(relId,&recid);
-			return RecId{block, slot};
+			if (
+			(op == NE && cmpVal != 0) ||    // if op is "not equal to"
+			(op == LT && cmpVal < 0) ||     // if op is "less than"
+			(op == LE && cmpVal <= 0) ||    // if op is "less than or equal to"
+			(op == EQ && cmpVal == 0) ||    // if op is "equal to"
+			(op == GT && cmpVal > 0) ||     // if op is "greater than"
+			(op == GE && cmpVal >= 0)       // if op is "greater than or equal to"
+			)
+			{
+				/*
+				set the search index in the relation cache as
+				the record id of the record that satisfies the given condition
+				(use RelCacheTable::setSearchIndex function)
+				*/
+				
+				RecId recid{block,slot};
+				RelCacheTable::setSearchIndex(relId,&recid);
+				return RecId{block, slot};
+			}
 		}
 
-		slot++;
+		// (no more slots in this block)
+		block = head.rblock;
+		slot = 0;
 	}
 
 	// no record in the relation with Id relid satisfies the given condition
@@ -123,41 +140,19 @@ RecId BlockAccess::linearSearch(int relId, char attrName[ATTR_SIZE], union Attri
 
 int BlockAccess::renameRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE])
 {
-	/* reset the searchIndex of the relation catalog using
-	RelCacheTable::resetSearchIndex() */
-	
-	RelCacheTable::resetSearchIndex(RELCAT_RELID);
-	
-	Attribute newRelationName;    // set newRelationName with newName
-	strcpy(newRelationName.sVal,newName);
-
-	// search the relation catalog for an entry with "RelName" = newRelationName
-	char RelName[ATTR_SIZE];
-	strcpy(RelName,"RelName");
-	RecId searchResult = linearSearch(RELCAT_RELID, RelName, newRelationName, EQ);
-	
-	// If relation with name newName already exists (result of linearSearch
-	//                                               is not {-1, -1})
+	// If relation with name newName already exists (found in the catalog directory)
 	//    return E_RELEXIST;
-	if (searchResult.block!=-1 && searchResult.slot!=-1)
+	RecId searchResult;
+	if (CatalogDirectory::getRelCatRecId(newName, &searchResult) == SUCCESS)
 		return E_RELEXIST;
 
-	/* reset the searchIndex of the relation catalog using
-	RelCacheTable::resetSearchIndex() */
-	RelCacheTable::resetSearchIndex(RELCAT_RELID);
-	
-	Attribute oldRelationName;    // set oldRelationName with oldName
-	strcpy(oldRelationName.sVal, oldName);  // Set oldRelationName with oldName
-	searchResult = linearSearch(RELCAT_RELID, RelName, oldRelationName, EQ);
-
-	// search the relation catalog for an entry with "RelName" = oldRelationName
-
-	// If relation with name oldName does not exist (result of linearSearch is {-1, -1})
+	// If relation with name oldName does not exist
 	//    return E_RELNOTEXIST;
-	
-	if (searchResult.block==-1 && searchResult.slot==-1)
+	if (CatalogDirectory::getRelCatRecId(oldName, &searchResult) != SUCCESS)
 		return E_RELNOTEXIST;
 
+	std::vector<RecId> attrCatRecIds;
+	CatalogDirectory::getAttrCatRecIds(oldName, &attrCatRecIds);
 
 	/* get the relation catalog record of the relation to rename using a RecBuffer
 	on the relation catalog [RELCAT_BLOCK] and RecBuffer.getRecord function
@@ -171,103 +166,63 @@ int BlockAccess::renameRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE]
 	strcpy(attribute[RELCAT_REL_NAME_INDEX].sVal,newName);
 	recbuffer.setRecord(attribute, searchResult.slot);
 	// set back the record value using RecBuffer.setRecord
-	
-	
 
 	/*
 	update all the attribute catalog entries in the attribute catalog corresponding
 	to the relation with relation name oldName to the relation name newName
 	*/
+	// (the records of the composite and hash indexes of the relation are renamed too)
+	std::vector<RecId> indexRecIds;
+	CatalogDirectory::getIndexRecIds(oldName, &indexRecIds);
+	attrCatRecIds.insert(attrCatRecIds.end(), indexRecIds.begin(), indexRecIds.end());
 
-	/* reset the searchIndex of the attribute catalog using
-	RelCacheTable::resetSearchIndex() */
-	RelCacheTable::resetSearchIndex(ATTRCAT_RELID);
-
-	while(true)
+	for (RecId attrSearchResult : attrCatRecIds)
 	{
-		RecId attrSearchResult=linearSearch(ATTRCAT_RELID, RelName,oldRelationName,EQ);
-		if (attrSearchResult.block==-1 && attrSearchResult.slot==-1)
-			break;
-
 		RecBuffer attrrecbuffer(attrSearchResult.block);
 		Attribute attrib[ATTRCAT_NO_ATTRS];
 		attrrecbuffer.getRecord(attrib,attrSearchResult.slot);
 
 		strcpy(attrib[ATTRCAT_REL_NAME_INDEX].sVal,newName);
-		attrrecbuffer.setRecord(attrib, attrSearchResult.slot);		
+		attrrecbuffer.setRecord(attrib, attrSearchResult.slot);
 	}
-	//for i = 0 to numberOfAttributes :
-	//    linearSearch on the attribute catalog for relName = oldRelationName
-	//    get the record using RecBuffer.getRecord
-	//
-	//    update the relName field in the record to newName
-	//    set back the record using RecBuffer.setRecord
+
+	CatalogDirectory::renameRelation(oldName, newName);
+	ZoneMap::renameRelation(oldName, newName);
 
 	return SUCCESS;
 }
 
 int BlockAccess::renameAttribute(char relName[ATTR_SIZE], char oldName[ATTR_SIZE], char newName[ATTR_SIZE])
 {
-
-	/* reset the searchIndex of the relation catalog using
-	RelCacheTable::resetSearchIndex() */
-	RelCacheTable::resetSearchIndex(RELCAT_RELID);
-
-	Attribute relNameAttr;    // set relNameAttr to relName
-	strcpy(relNameAttr.sVal,relName);
-	
-	// Search for the relation with name relName in relation catalog using linearSearch()
-	// If relation with name relName does not exist (search returns {-1,-1})
+	// If relation with name relName does not exist (not in the catalog directory)
 	//    return E_RELNOTEXIST;
-	char RelName[ATTR_SIZE];
-	strcpy(RelName,"RelName");
-	RecId relsearch=linearSearch(RELCAT_RELID,RelName,relNameAttr,EQ);
-	if (relsearch.block==-1 && relsearch.slot==-1)
+	std::vector<RecId> attrCatRecIds;
+	if (CatalogDirectory::getAttrCatRecIds(relName, &attrCatRecIds) != SUCCESS)
 		return E_RELNOTEXIST;
 
-	/* reset the searchIndex of the attribute catalog using
-	RelCacheTable::resetSearchIndex() */
-	RelCacheTable::resetSearchIndex(ATTRCAT_RELID);
-
 	/* declare variable attrToRenameRecId used to store the attr-cat recId
 	of the attribute to rename */
-	RecId attrToRenameRecId;
+	RecId attrToRenameRecId = {-1, -1};
 	Attribute attrCatEntryRecord[ATTRCAT_NO_ATTRS];
 
 	/* iterate over all Attribute Catalog Entry record corresponding to the
 	relation to find the required attribute */
-	while (true)
+	for (RecId attrCatRecId : attrCatRecIds)
 	{
-		// linear search on the attribute catalog for RelName = relNameAttr
-		attrToRenameRecId=linearSearch(ATTRCAT_RELID,RelName,relNameAttr,EQ);
-		
-		// if there are no more attributes left to check (linearSearch returned {-1,-1})
-		//     break;
-		if (attrToRenameRecId.block==-1 && attrToRenameRecId.slot==-1)
-			break;
-
 		/* Get the record from the attribute catalog using RecBuffer.getRecord
 		into attrCatEntryRecord */
-		
-		RecBuffer recbuffer(attrToRenameRecId.block);
-		recbuffer.getRecord(attrCatEntryRecord,attrToRenameRecId.slot);
+		RecBuffer recbuffer(attrCatRecId.block);
+		recbuffer.getRecord(attrCatEntryRecord,attrCatRecId.slot);
 
-		// if attrCatEntryRecord.attrName = oldName
-		//     attrToRenameRecId = block and slot of this record
+		// if attrCatEntryRecord.attrName = newName
+		//     return E_ATTREXIST;
 		if (strcmp(attrCatEntryRecord[ATTRCAT_ATTR_NAME_INDEX].sVal,newName)==0)
 			return E_ATTREXIST;
-			
-		if (strcmp(attrCatEntryRecord[ATTRCAT_ATTR_NAME_INDEX].sVal,oldName)==0)
-		{
-			RecBuffer attrcatrecbuffer(attrToRenameRecId.block);
-			attrcatrecbuffer.getRecord(attrCatEntryRecord,attrToRenameRecId.slot);
-			strcpy(attrCatEntryRecord[ATTRCAT_ATTR_NAME_INDEX].sVal,newName);
-			attrcatrecbuffer.setRecord(attrCatEntryRecord,attrToRenameRecId.slot);
-			break;
-		}
 
-		// if attrCatEntryRecord.attrName = newName
-		//     return E_ATTREXIST;
+		// if attrCatEntryRecord.attrName = oldName
+		//     attrToRenameRecId = block and slot of this record
+		if (strcmp(attrCatEntryRecord[ATTRCAT_ATTR_NAME_INDEX].sVal,oldName)==0)
+			attrToRenameRecId = attrCatRecId;
 	}
 
 	if (attrToRenameRecId.block==-1 && attrToRenameRecId.slot==-1)
@@ -278,9 +233,10 @@ int BlockAccess::renameAttribute(char relName[ATTR_SIZE], char oldName[ATTR_SIZE
 	attrToRenameRecId.slot */
 	//   update the AttrName of the record with newName
 	//   set back the record with RecBuffer.setRecord
-	
-	
-	
+	RecBuffer attrcatrecbuffer(attrToRenameRecId.block);
+	attrcatrecbuffer.getRecord(attrCatEntryRecord,attrToRenameRecId.slot);
+	strcpy(attrCatEntryRecord[ATTRCAT_ATTR_NAME_INDEX].sVal,newName);
+	attrcatrecbuffer.setRecord(attrCatEntryRecord,attrToRenameRecId.slot);
 
 	return SUCCESS;
 }
@@ -290,7 +246,11 @@ int BlockAccess::insert(int relId, Attribute *record)
 	RelCatEntry relcatentry;
 	RelCacheTable::getRelCatEntry(relId,&relcatentry);
 
-	int blockNum = relcatentry.firstBlk;
+	// the blocks before the free block hint of the relation are full
+	int blockNum;
+	RelCacheTable::getFreeBlock(relId, &blockNum);
+	if (blockNum == -1)
+		blockNum = relcatentry.firstBlk;
 
 	// rec_id will be used to store where the new record will be inserted
 	RecId rec_id = {-1, -1};
@@ -308,26 +268,23 @@ int BlockAccess::insert(int relId, Attribute *record)
 	while (blockNum != -1)
 	{
 		// create a RecBuffer object for blockNum (using appropriate constructor!)
+		// and get its header and slot map in place
 		RecBuffer recbuffer(blockNum);
-		// get header of block(blockNum) using RecBuffer::getHeader() function
 		struct HeadInfo Head;
-		recbuffer.getHeader(&Head);
-		// get slot map of block(blockNum) using RecBuffer::getSlotMap() function
-		unsigned char *slotMap=(unsigned char *)malloc(sizeof(unsigned char)*numOfSlots);
-		recbuffer.getSlotMap(slotMap); 
+		unsigned char *slotMap, *records;
+		recbuffer.getBlockContents(&Head, &slotMap, &records);
 
 		// search for free slot in the block 'blockNum' and store it's rec-id in rec_id
-		// (Free slot can be found by iterating over the slot map of the block)
 		/* slot map stores SLOT_UNOCCUPIED if slot is free and
-		SLOT_OCCUPIED if slot is occupied) */
-		int slot;
-		for(slot=0;slot<numOfSlots;++slot)
+		SLOT_OCCUPIED if slot is occupied); a full block is skipped
+		without looking at the slot map */
+		if (Head.numEntries < numOfSlots)
 		{
-			if(slotMap[slot]==SLOT_UNOCCUPIED)
+			void *freeSlot = memchr(slotMap, SLOT_UNOCCUPIED, numOfSlots);
+			if (freeSlot != nullptr)
 			{
 				rec_id.block=blockNum;
-				rec_id.slot=slot;
-				break;
+				rec_id.slot=(unsigned char *)freeSlot - slotMap;
 			}
 		}
 		if(rec_id.block!=-1 && rec_id.slot!=-1)
@@ -382,9 +339,8 @@ int BlockAccess::insert(int relId, Attribute *record)
 		(i.e. store SLOT_UNOCCUPIED for all the entries)
 		(use RecBuffer::setSlotMap() function)
 		*/
-		unsigned char *newblkslotMap= (unsigned char *)malloc(sizeof(unsigned char)*relcatentry.numSlotsPerBlk);
-		for(int i=0;i<relcatentry.numSlotsPerBlk;++i)
-			newblkslotMap[i]=SLOT_UNOCCUPIED;
+		unsigned char newblkslotMap[relcatentry.numSlotsPerBlk];
+		memset(newblkslotMap, SLOT_UNOCCUPIED, relcatentry.numSlotsPerBlk);
 		newblk.setSlotMap(newblkslotMap);
 
 	
@@ -408,15 +364,21 @@ int BlockAccess::insert(int relId, Attribute *record)
 		// new block (using RelCacheTable::setRelCatEntry() function)
 		relcatentry.lastBlk=rec_id.block;
 		RelCacheTable::setRelCatEntry(relId, &relcatentry);
-		
+
+		// link the block into the zone map of the relation (if it has one)
+		ZoneMap *zoneMap = ZoneMap::get(relcatentry.relName);
+		if (zoneMap != nullptr)
+			zoneMap->addBlock(prevBlockNum, rec_id.block);
 	}
 
+	RelCacheTable::setFreeBlock(relId, rec_id.block);
+
 	// create a RecBuffer object for rec_id.block
 	// insert the record into rec_id'th slot using RecBuffer.setRecord())
 	RecBuffer newblk(rec_id.block);
 	newblk.setRecord(record, rec_id.slot);
 	
-	unsigned char *newslotmap=(unsigned char *)malloc(sizeof(unsigned char )*numOfSlots);
+	unsigned char newslotmap[numOfSlots];
 	newblk.getSlotMap(newslotmap);
 	newslotmap[rec_id.slot]=SLOT_OCCUPIED;
 	newblk.setSlotMap(newslotmap);
@@ -431,7 +393,19 @@ int BlockAccess::insert(int relId, Attribute *record)
 	// the relation. (use RelCacheTable::setRelCatEntry function)
 	relcatentry.numRecs=(relcatentry.numRecs)+1;
 	RelCacheTable::setRelCatEntry(relId, &relcatentry);
+
+	// widen the zone map range of the block to include the record
+	ZoneMap *zoneMap = ZoneMap::get(relcatentry.relName);
+	if (zoneMap != nullptr)
+		zoneMap->addRecord(rec_id.block, record);
 	
+	// keep the catalog directory in step with the catalog relations
+	if (relId == RELCAT_RELID)
+		CatalogDirectory::addRelation(record[RELCAT_REL_NAME_INDEX].sVal, rec_id);
+	else if (relId == ATTRCAT_RELID)
+		CatalogDirectory::addAttribute(record[ATTRCAT_REL_NAME_INDEX].sVal,
+		                               (int)record[ATTRCAT_OFFSET_INDEX].nVal, rec_id);
+
 	/* B+ Tree Insertions */
 	// (the following section is only relevant once indexing has been implemented)
 
@@ -460,10 +434,64 @@ int BlockAccess::insert(int relId, Attribute *record)
 		}
 	}
 
+	// insert the record into the composite indexes of the relation
+	std::vector<CompositeIndexInfo> compositeIndexes;
+	CompositeIndex::getIndexes(relId, &compositeIndexes);
+	for (CompositeIndexInfo &index : compositeIndexes)
+	{
+		if (CompositeIndex::insert(&index, record, rec_id) != SUCCESS)
+		{
+			BlockAccess::dropCompositeIndex(relId, &index);
+			flag = E_INDEX_BLOCKS_RELEASED;
+		}
+	}
+
+	// and into its hash indexes
+	std::vector<HashIndexInfo> hashIndexes;
+	HashIndex::getIndexes(relId, &hashIndexes);
+	for (HashIndexInfo &index : hashIndexes)
+	{
+		if (HashIndex::insert(&index, record, rec_id) != SUCCESS)
+		{
+			BlockAccess::dropHashIndex(relId, &index);
+			flag = E_INDEX_BLOCKS_RELEASED;
+		}
+	}
+
 	return flag;
 
 }
 
+/* prefix search of a composite index on its first attribute (attrName),
+resuming from the search index of attrName like BPlusTree::bPlusSearch() */
+static RecId compositeSearch(int relId, char attrName[ATTR_SIZE], CompositeIndexInfo *index, Attribute attrVal, int op)
+{
+	IndexId cursor;
+	AttrCacheTable::getSearchIndex(relId, attrName, &cursor);
+
+	RecId recId;
+	if (CompositeIndex::search(index, 1, &attrVal, op, &cursor, &recId) != SUCCESS)
+		return RecId{-1, -1};
+
+	AttrCacheTable::setSearchIndex(relId, attrName, &cursor);
+	return recId;
+}
+
+/* equality search of a hash index on attrName, resuming from the search
+index of attrName (the bucket block and the entry after the last match) */
+static RecId hashSearch(int relId, char attrName[ATTR_SIZE], HashIndexInfo *index, Attribute attrVal)
+{
+	IndexId cursor;
+	AttrCacheTable::getSearchIndex(relId, attrName, &cursor);
+
+	RecId recId;
+	if (HashIndex::search(index, attrVal, &cursor, &recId) != SUCCESS)
+		return RecId{-1, -1};
+
+	AttrCacheTable::setSearchIndex(relId, attrName, &cursor);
+	return recId;
+}
+
 /*
 NOTE: This function will copy the result of the search to the `record` argument.
       The caller should ensure that space is allocated for `record` array
@@ -481,11 +509,22 @@ int BlockAccess::search(int relId, Attribute *record, char attrName[ATTR_SIZE],
 	if(ret!=SUCCESS)
 		return ret;
 
+	// an equality search goes to the hash index of the attribute if it has one
+	HashIndexInfo hashIndex;
+	if(op==EQ && HashIndex::find(relId, attrCatBuf.offset, &hashIndex)==SUCCESS)
+	{
+		recId=hashSearch(relId, attrName, &hashIndex, attrVal);
+	}
+
 	// get rootBlock from the attribute catalog entry
-	if(attrCatBuf.rootBlock==-1)
+	else if(attrCatBuf.rootBlock==-1)
 	{
-		
-		recId=BlockAccess::linearSearch(relId, attrName, attrVal, op);
+		// a composite index that starts with the attribute can answer the search
+		CompositeIndexInfo index;
+		if (CompositeIndex::findLeading(relId, attrCatBuf.offset, &index) == SUCCESS)
+			recId=compositeSearch(relId, attrName, &index, attrVal, op);
+		else
+			recId=BlockAccess::linearSearch(relId, attrName, attrVal, op);
 	}
 
 	else
@@ -501,8 +540,6 @@ int BlockAccess::search(int relId, Attribute *record, char attrName[ATTR_SIZE],
 
 	RecBuffer recbuffer(recId.block);
 	recbuffer.getRecord(record, recId.slot);
-//	if (record->nVal==0)
-//		printf("%d %d\n",recId.block,recId.slot);
 	return SUCCESS;
 }
 
@@ -511,19 +548,17 @@ int BlockAccess::deleteRelation(char relName[ATTR_SIZE])
 	if(strcmp(relName,RELCAT_RELNAME)==0 || strcmp(relName,ATTRCAT_RELNAME)==0)
 		return E_NOTPERMITTED;
 
-	/* reset the searchIndex of the relation catalog using
-	RelCacheTable::resetSearchIndex() */
-	RelCacheTable::resetSearchIndex(RELCAT_RELID);
-
-	Attribute relNameAttr; // (stores relName as type union Attribute)
-	strcpy(relNameAttr.sVal, relName);
-	//  linearSearch on the relation catalog for RelName = relNameAttr
-	char RelName[8];
-	strcpy( RelName,"RelName");
-	RecId relid=linearSearch(RELCAT_RELID,RelName , relNameAttr, EQ);
-
-	if(relid.block==-1 && relid.slot==-1)
+	// get the rec-ids of the catalog records of the relation from the catalog directory
+	RecId relid;
+	std::vector<RecId> attrCatRecIds;
+	if (CatalogDirectory::getRelCatRecId(relName, &relid) != SUCCESS)
 		return E_RELNOTEXIST;
+	CatalogDirectory::getAttrCatRecIds(relName, &attrCatRecIds);
+
+	// the records of the composite and hash indexes of the relation are deleted with its attributes
+	std::vector<RecId> indexRecIds;
+	CatalogDirectory::getIndexRecIds(relName, &indexRecIds);
+	attrCatRecIds.insert(attrCatRecIds.end(), indexRecIds.begin(), indexRecIds.end());
 
 	Attribute relCatEntryRecord[RELCAT_NO_ATTRS];
 	/* store the relation catalog record corresponding to the relation in
@@ -561,20 +596,10 @@ int BlockAccess::deleteRelation(char relName[ATTR_SIZE])
 	blocks corresponding to the relation with relName on its attributes
 	***/
 
-	// reset the searchIndex of the attribute catalog
-	RelCacheTable::resetSearchIndex(ATTRCAT_RELID);
-
 	int numberOfAttributesDeleted = 0;
 
- 	while(true)
- 	{
-		RecId attrCatRecId;
-		char AttrRelName[8];
-		strcpy(AttrRelName,ATTRCAT_ATTR_RELNAME);
-		attrCatRecId = linearSearch(ATTRCAT_RELID, AttrRelName, relNameAttr, EQ);
-		if(attrCatRecId.block==-1 && attrCatRecId.slot==-1)
-			break;
-
+	for (RecId attrCatRecId : attrCatRecIds)
+	{
 		numberOfAttributesDeleted++;
 
 		// create a RecBuffer for attrCatRecId.block
@@ -590,10 +615,15 @@ int BlockAccess::deleteRelation(char relName[ATTR_SIZE])
 		// block field from the attribute catalog record.
 		int rootBlock = attribute[ATTRCAT_ROOT_BLOCK_INDEX].nVal;
 		// (This will be used later to delete any indexes if it exists)
+		int indexOffset = attribute[ATTRCAT_OFFSET_INDEX].nVal;
+		int compositeKeys[MAX_COMPOSITE_KEYS];
+		int numCompositeKeys = 0;
+		if (indexOffset == COMPOSITE_INDEX_OFFSET || indexOffset == COMPRESSED_INDEX_OFFSET)
+			numCompositeKeys = CompositeIndex::parseKeyName(attribute[ATTRCAT_ATTR_NAME_INDEX].sVal, compositeKeys);
 
 		// Update the Slotmap for the block by setting the slot as SLOT_UNOCCUPIED
 		// Hint: use RecBuffer.getSlotMap and RecBuffer.setSlotMap
-		unsigned char* slotmap=(unsigned char*)malloc(sizeof(unsigned char)*head.numSlots);
+		unsigned char slotmap[head.numSlots];
 		recbuff.getSlotMap(slotmap);
 		slotmap[attrCatRecId.slot]=SLOT_UNOCCUPIED;
 		recbuff.setSlotMap(slotmap);
@@ -650,7 +680,16 @@ int BlockAccess::deleteRelation(char relName[ATTR_SIZE])
 
 // (the following part is only relevant once indexing has been implemented)
 		// if index exists for the attribute (rootBlock != -1), call bplus destroy
-		if (rootBlock != -1)
+		if (rootBlock != -1 && indexOffset == HASH_INDEX_OFFSET)
+		{
+			HashIndex::destroy(rootBlock);
+		}
+		else if (rootBlock != -1 && numCompositeKeys > 0)
+		{
+			// (the tree of a composite index has wider entries)
+			CompositeIndex::destroy(rootBlock, numCompositeKeys, indexOffset == COMPRESSED_INDEX_OFFSET);
+		}
+		else if (rootBlock != -1)
 		{
 			// delete the bplus tree rooted at rootBlock using BPlusTree::bPlusDestroy()
 			BPlusTree::bPlusDestroy(rootBlock);
@@ -669,7 +708,7 @@ int BlockAccess::deleteRelation(char relName[ATTR_SIZE])
 
 	/* Get the slotmap in relation catalog, update it by marking the slot as
 	free(SLOT_UNOCCUPIED) and set it back. */
-	unsigned char* slotMap=(unsigned char*)malloc(sizeof(unsigned char)*relcatheader.numSlots);
+	unsigned char slotMap[relcatheader.numSlots];
 	relcatbuffer.getSlotMap(slotMap);
 	slotMap[relid.slot]=SLOT_UNOCCUPIED;
 	relcatbuffer.setSlotMap(slotMap);	
@@ -692,6 +731,13 @@ int BlockAccess::deleteRelation(char relName[ATTR_SIZE])
 	RelCacheTable::getRelCatEntry(ATTRCAT_RELID, &attrCatBuf);
 	attrCatBuf.numRecs=attrCatBuf.numRecs- numberOfAttributesDeleted;
 	RelCacheTable::setRelCatEntry(ATTRCAT_RELID, &attrCatBuf);
+
+	// slots (and possibly whole blocks) of the catalogs were freed
+	RelCacheTable::setFreeBlock(RELCAT_RELID, -1);
+	RelCacheTable::setFreeBlock(ATTRCAT_RELID, -1);
+
+	CatalogDirectory::removeRelation(relName);
+	ZoneMap::removeRelation(relName);
 	
 	// Get the entry corresponding to attribute catalog from the relation
 	// cache and update the number of records and set it back
@@ -753,33 +799,26 @@ int BlockAccess::project(int relId, Attribute *record)
 	while (block != -1)
 	{
 		// create a RecBuffer object for block (using appropriate constructor!)
+		// and get its header and slot map in place
 		RecBuffer recbuffer(block);
-		// get header of the block using RecBuffer::getHeader() function
-		// get slot map of the block using RecBuffer::getSlotMap() function
 		HeadInfo head;
-		recbuffer.getHeader(&head);
-		unsigned char * slotmap=(unsigned char*)malloc(sizeof(unsigned char)*head.numSlots);
-		recbuffer.getSlotMap(slotmap);
+		unsigned char *slotmap, *records;
+		recbuffer.getBlockContents(&head, &slotmap, &records);
 
-		if(slot>=head.numSlots)
-		{
-			// (no more slots in this block)
-			// update block = right block of block
-			// update slot = 0
-			block=head.rblock;
-			slot=0;
-		}
-		else if (slotmap[slot]==SLOT_UNOCCUPIED)
-		{	
-			 // (i.e slot-th entry in slotMap contains SLOT_UNOCCUPIED)
-			// increment slot
-			slot++;
-		}
-		else 
+		// find the next occupied slot of the block
+		slot = nextOccupiedSlot(slotmap, slot, head.numSlots);
+		if (slot < head.numSlots)
 		{
 			// (the next occupied slot / record has been found)
+			memcpy(record, records + slot * head.numAttrs * ATTR_SIZE, head.numAttrs * ATTR_SIZE);
 			break;
 		}
+
+		// (no more slots in this block)
+		// update block = right block of block
+		// update slot = 0
+		block=head.rblock;
+		slot=0;
 	}
 
 	if (block == -1)
@@ -793,12 +832,526 @@ int BlockAccess::project(int relId, Attribute *record)
 	// set the search index to nextRecId using RelCacheTable::setSearchIndex
 	RelCacheTable::setSearchIndex(relId, &nextRecId);
 
-	/* Copy the record with record id (nextRecId) to the record buffer (record)
-	For this Instantiate a RecBuffer class object by passing the recId and
-	call the appropriate method to fetch the record
-	*/
-	RecBuffer recbuff(nextRecId.block);
-	recbuff.getRecord(record, nextRecId.slot);
+	// (the record was already copied to `record` from the block)
+	return SUCCESS;
+}
+
+/* collects the rec-ids of all the records of the relation satisfying
+`attrName op attrVal` (of all the records if attrName is nullptr), using the
+hash index or B+ tree of the attribute if it has one. The rec-ids are collected before
+anything is modified, so that deleting or updating the records cannot affect
+the search that found them. */
+int BlockAccess::findRecIds(int relId, char attrName[ATTR_SIZE], Attribute attrVal, int op, std::vector<RecId> *recIds)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	recIds->clear();
+
+	if (attrName == nullptr)
+	{
+		// every occupied slot of every record block of the relation
+		int blockNum = relCatEntry.firstBlk;
+		while (blockNum != -1)
+		{
+			RecBuffer recBuffer(blockNum);
+			HeadInfo head;
+			unsigned char *slotMap, *records;
+			recBuffer.getBlockContents(&head, &slotMap, &records);
+
+			for (int slot = nextOccupiedSlot(slotMap, 0, head.numSlots); slot < head.numSlots;
+			     slot = nextOccupiedSlot(slotMap, slot + 1, head.numSlots))
+				recIds->push_back(RecId{blockNum, slot});
+
+			blockNum = head.rblock;
+		}
+		return SUCCESS;
+	}
+
+	AttrCatEntry attrCatEntry;
+	ret = AttrCacheTable::getAttrCatEntry(relId, attrName, &attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	RecId recId;
+	CompositeIndexInfo index;
+	HashIndexInfo hashIndex;
+	if (op == EQ && HashIndex::find(relId, attrCatEntry.offset, &hashIndex) == SUCCESS)
+	{
+		AttrCacheTable::resetSearchIndex(relId, attrName);
+		while ((recId = hashSearch(relId, attrName, &hashIndex, attrVal)).block != -1)
+			recIds->push_back(recId);
+	}
+	else if (attrCatEntry.rootBlock == -1 && CompositeIndex::findLeading(relId, attrCatEntry.offset, &index) == SUCCESS)
+	{
+		AttrCacheTable::resetSearchIndex(relId, attrName);
+		while ((recId = compositeSearch(relId, attrName, &index, attrVal, op)).block != -1)
+			recIds->push_back(recId);
+	}
+	else if (attrCatEntry.rootBlock == -1)
+	{
+		RelCacheTable::resetSearchIndex(relId);
+		while ((recId = linearSearch(relId, attrName, attrVal, op)).block != -1)
+			recIds->push_back(recId);
+	}
+	else
+	{
+		// the entries come in key order; the RecIds are returned in block order
+		BPlusCursor cursor;
+		RecIdBitmap bitmap;
+		ret = cursor.seek(relId, attrName, op, attrVal);
+		if (ret != SUCCESS)
+			return ret;
+		collectRecIds(&cursor, &bitmap, -1);
+
+		for (recId = bitmap.next(RecId{-1, -1}); recId.block != -1; recId = bitmap.next(recId))
+			recIds->push_back(recId);
+	}
+
+	return SUCCESS;
+}
+
+/* adds the RecIds of the entries left in a B+ tree scan to bitmap. The leaf
+entries are in key order, which is random block order, so reading each record
+as it is found loads the same block again and again once the buffer evicts it;
+walking the bitmap instead reads every record block once, in ascending order.
+Returns FAILURE (with an incomplete bitmap) as soon as there are more than
+maxRecIds of them (-1 for no limit). */
+int BlockAccess::collectRecIds(BPlusCursor *cursor, RecIdBitmap *bitmap, int maxRecIds)
+{
+	Index leafEntry;
+	while (cursor->next(&leafEntry) == SUCCESS)
+	{
+		if (maxRecIds != -1 && bitmap->size() >= maxRecIds)
+			return FAILURE;
+		bitmap->add(RecId{leafEntry.block, leafEntry.slot});
+	}
+	return SUCCESS;
+}
+
+/* deletes the record at recId: its entries are removed from every B+ tree of
+the relation and its slot is freed in place. A block left empty stays in the
+block list of the relation (its slots are reused by insert()). The zone map
+range of the block is not narrowed, which keeps it correct. */
+int BlockAccess::deleteRecord(int relId, RecId recId)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	RecBuffer recBuffer(recId.block);
+	HeadInfo head;
+	recBuffer.getHeader(&head);
+	if (recId.slot < 0 || recId.slot >= head.numSlots)
+		return E_OUTOFBOUND;
+
+	unsigned char slotMap[head.numSlots];
+	recBuffer.getSlotMap(slotMap);
+	if (slotMap[recId.slot] == SLOT_UNOCCUPIED)
+		return E_NOTFOUND;
+
+	Attribute record[relCatEntry.numAttrs];
+	recBuffer.getRecord(record, recId.slot);
+
+	// remove the entry of the record from the B+ tree of every indexed attribute
+	for (int attrOffset = 0; attrOffset < relCatEntry.numAttrs; attrOffset++)
+	{
+		AttrCatEntry attrCatEntry;
+		AttrCacheTable::getAttrCatEntry(relId, attrOffset, &attrCatEntry);
+		if (attrCatEntry.rootBlock != -1)
+			BPlusTree::bPlusDelete(relId, attrCatEntry.attrName, record[attrOffset], recId);
+	}
+
+	std::vector<CompositeIndexInfo> compositeIndexes;
+	CompositeIndex::getIndexes(relId, &compositeIndexes);
+	for (CompositeIndexInfo &index : compositeIndexes)
+		CompositeIndex::remove(&index, record, recId);
+
+	std::vector<HashIndexInfo> hashIndexes;
+	HashIndex::getIndexes(relId, &hashIndexes);
+	for (HashIndexInfo &index : hashIndexes)
+		HashIndex::remove(&index, record, recId);
+
+	// free the slot and update the counts in the block header and relation catalog
+	slotMap[recId.slot] = SLOT_UNOCCUPIED;
+	recBuffer.setSlotMap(slotMap);
+	head.numEntries = head.numEntries - 1;
+	recBuffer.setHeader(&head);
+
+	relCatEntry.numRecs = relCatEntry.numRecs - 1;
+	RelCacheTable::setRelCatEntry(relId, &relCatEntry);
+
+	// the freed slot may lie before the free block hint of the relation
+	RelCacheTable::setFreeBlock(relId, -1);
+
+	return SUCCESS;
+}
+
+/* replaces the record at recId with `record`. The B+ tree entries of the
+indexed attributes whose value changed are moved to the new value. Returns
+E_INDEX_BLOCKS_RELEASED if an index had to be destroyed for lack of space
+(as insert() does). */
+int BlockAccess::updateRecord(int relId, RecId recId, union Attribute *record)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	RecBuffer recBuffer(recId.block);
+	HeadInfo head;
+	recBuffer.getHeader(&head);
+	if (recId.slot < 0 || recId.slot >= head.numSlots)
+		return E_OUTOFBOUND;
+
+	unsigned char slotMap[head.numSlots];
+	recBuffer.getSlotMap(slotMap);
+	if (slotMap[recId.slot] == SLOT_UNOCCUPIED)
+		return E_NOTFOUND;
+
+	Attribute oldRecord[relCatEntry.numAttrs];
+	recBuffer.getRecord(oldRecord, recId.slot);
+
+	int flag = SUCCESS;
+	for (int attrOffset = 0; attrOffset < relCatEntry.numAttrs; attrOffset++)
+	{
+		AttrCatEntry attrCatEntry;
+		AttrCacheTable::getAttrCatEntry(relId, attrOffset, &attrCatEntry);
+		if (attrCatEntry.rootBlock == -1 ||
+		    compareAttrs(oldRecord[attrOffset], record[attrOffset], attrCatEntry.attrType) == 0)
+			continue;
+
+		BPlusTree::bPlusDelete(relId, attrCatEntry.attrName, oldRecord[attrOffset], recId);
+		if (BPlusTree::bPlusInsert(relId, attrCatEntry.attrName, record[attrOffset], recId) == E_DISKFULL)
+			flag = E_INDEX_BLOCKS_RELEASED;
+	}
+
+	// the entry of a composite index moves if any of its key attributes changed
+	std::vector<CompositeIndexInfo> compositeIndexes;
+	CompositeIndex::getIndexes(relId, &compositeIndexes);
+	for (CompositeIndexInfo &index : compositeIndexes)
+	{
+		bool changed = false;
+		for (int i = 0; i < index.numKeys; ++i)
+		{
+			int attrOffset = index.keyOffsets[i];
+			changed = changed || compareAttrs(oldRecord[attrOffset], record[attrOffset], index.keyTypes[i]) != 0;
+		}
+		if (!changed)
+			continue;
+
+		CompositeIndex::remove(&index, oldRecord, recId);
+		if (CompositeIndex::insert(&index, record, recId) != SUCCESS)
+		{
+			BlockAccess::dropCompositeIndex(relId, &index);
+			flag = E_INDEX_BLOCKS_RELEASED;
+		}
+	}
+
+	std::vector<HashIndexInfo> hashIndexes;
+	HashIndex::getIndexes(relId, &hashIndexes);
+	for (HashIndexInfo &index : hashIndexes)
+	{
+		int attrOffset = index.attrOffset;
+		if (compareAttrs(oldRecord[attrOffset], record[attrOffset], index.attrType) == 0)
+			continue;
+
+		HashIndex::remove(&index, oldRecord, recId);
+		if (HashIndex::insert(&index, record, recId) != SUCCESS)
+		{
+			BlockAccess::dropHashIndex(relId, &index);
+			flag = E_INDEX_BLOCKS_RELEASED;
+		}
+	}
+
+	recBuffer.setRecord(record, recId.slot);
+
+	// widen the zone map range of the block to include the new values
+	ZoneMap *zoneMap = ZoneMap::get(relCatEntry.relName);
+	if (zoneMap != nullptr)
+		zoneMap->addRecord(recId.block, record);
+
+	return flag;
+}
+
+/* moves the records of the last record blocks of the relation into the free
+slots of the first ones, so that every block but the last one is full, and
+releases the blocks left empty. The records that moved change rec-ids, so the
+B+ trees of the relation are rebuilt if any record moved. The zone map is rebuilt
+if any record moved or any block was released. Returns E_INDEX_BLOCKS_RELEASED
+if an index could not be rebuilt for lack of space. */
+int BlockAccess::compact(int relId, int *numBlocksBefore, int *numBlocksAfter)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	int numSlots = relCatEntry.numSlotsPerBlk;
+
+	// the record blocks of the relation in list order
+	std::vector<int> blocks;
+	for (int block = relCatEntry.firstBlk; block != -1;)
+	{
+		RecBuffer recBuffer(block);
+		HeadInfo head;
+		recBuffer.getHeader(&head);
+		blocks.push_back(block);
+		block = head.rblock;
+	}
+	*numBlocksBefore = blocks.size();
+
+	/* fill the first block that has a free slot (dst) from the last block
+	that has a record (src) until the two meet. Every pass of the loop fills
+	dst or empties src. */
+	int dst = 0, src = (int)blocks.size() - 1;
+	int numMoved = 0;
+	Attribute record[relCatEntry.numAttrs];
+	while (dst < src)
+	{
+		RecBuffer dstBuffer(blocks[dst]);
+		RecBuffer srcBuffer(blocks[src]);
+		HeadInfo dstHead, srcHead;
+		dstBuffer.getHeader(&dstHead);
+		srcBuffer.getHeader(&srcHead);
+
+		if (dstHead.numEntries == numSlots)
+		{
+			dst++;
+			continue;
+		}
+		if (srcHead.numEntries == 0)
+		{
+			src--;
+			continue;
+		}
+
+		unsigned char dstSlotMap[numSlots], srcSlotMap[numSlots];
+		dstBuffer.getSlotMap(dstSlotMap);
+		srcBuffer.getSlotMap(srcSlotMap);
+
+		int dstSlot = 0, srcSlot = numSlots - 1;
+		while (true)
+		{
+			while (dstSlot < numSlots && dstSlotMap[dstSlot] == SLOT_OCCUPIED)
+				dstSlot++;
+			while (srcSlot >= 0 && srcSlotMap[srcSlot] == SLOT_UNOCCUPIED)
+				srcSlot--;
+			if (dstSlot == numSlots || srcSlot < 0)
+				break;
+
+			srcBuffer.getRecord(record, srcSlot);
+			dstBuffer.setRecord(record, dstSlot);
+			dstSlotMap[dstSlot] = SLOT_OCCUPIED;
+			srcSlotMap[srcSlot] = SLOT_UNOCCUPIED;
+			dstHead.numEntries++;
+			srcHead.numEntries--;
+			numMoved++;
+		}
+
+		dstBuffer.setSlotMap(dstSlotMap);
+		srcBuffer.setSlotMap(srcSlotMap);
+		dstBuffer.setHeader(&dstHead);
+		srcBuffer.setHeader(&srcHead);
+	}
+
+	/* release the empty blocks and link the remaining ones again (after the
+	moves only the blocks after the meeting point can be empty) */
+	std::vector<int> kept;
+	for (int block : blocks)
+	{
+		RecBuffer recBuffer(block);
+		HeadInfo head;
+		recBuffer.getHeader(&head);
+		if (head.numEntries == 0)
+			recBuffer.releaseBlock();
+		else
+			kept.push_back(block);
+	}
+
+	for (int i = 0; i < (int)kept.size(); ++i)
+	{
+		RecBuffer recBuffer(kept[i]);
+		HeadInfo head;
+		recBuffer.getHeader(&head);
+		head.lblock = i > 0 ? kept[i - 1] : -1;
+		head.rblock = i + 1 < (int)kept.size() ? kept[i + 1] : -1;
+		recBuffer.setHeader(&head);
+	}
+
+	relCatEntry.firstBlk = kept.empty() ? -1 : kept.front();
+	relCatEntry.lastBlk = kept.empty() ? -1 : kept.back();
+	RelCacheTable::setRelCatEntry(relId, &relCatEntry);
+	RelCacheTable::setFreeBlock(relId, relCatEntry.lastBlk);
+	RelCacheTable::resetSearchIndex(relId);
+	*numBlocksAfter = kept.size();
+
+	// the zone map keeps the rblock of every block, which is stale once a block is released
+	if ((numMoved > 0 || kept.size() < blocks.size()) && ZoneMap::get(relCatEntry.relName) != nullptr)
+		ZoneMap::create(relId);
+
+	// rebuild the B+ trees on the new rec-ids
+	if (numMoved == 0)
+		return SUCCESS;
+
+	int flag = SUCCESS;
+	for (int attrOffset = 0; attrOffset < relCatEntry.numAttrs; attrOffset++)
+	{
+		AttrCatEntry attrCatEntry;
+		AttrCacheTable::getAttrCatEntry(relId, attrOffset, &attrCatEntry);
+		if (attrCatEntry.rootBlock == -1)
+			continue;
+
+		BPlusTree::bPlusDestroy(attrCatEntry.rootBlock);
+		attrCatEntry.rootBlock = -1;
+		AttrCacheTable::setAttrCatEntry(relId, attrOffset, &attrCatEntry);
+		AttrCacheTable::resetSearchIndex(relId, attrOffset);
+
+		if (BPlusTree::bPlusCreate(relId, attrCatEntry.attrName) != SUCCESS)
+			flag = E_INDEX_BLOCKS_RELEASED;
+	}
+
+	std::vector<CompositeIndexInfo> compositeIndexes;
+	CompositeIndex::getIndexes(relId, &compositeIndexes);
+	for (CompositeIndexInfo &index : compositeIndexes)
+	{
+		CompositeIndex::destroy(index.rootBlock, index.numKeys, index.compressed);
+		CompositeIndex::setRoot(&index, -1);
+		if (CompositeIndex::build(relId, &index) != SUCCESS)
+		{
+			BlockAccess::dropCompositeIndex(relId, &index);
+			flag = E_INDEX_BLOCKS_RELEASED;
+		}
+	}
+
+	std::vector<HashIndexInfo> hashIndexes;
+	HashIndex::getIndexes(relId, &hashIndexes);
+	for (HashIndexInfo &index : hashIndexes)
+	{
+		HashIndex::destroy(index.rootBlock);
+		HashIndex::setRoot(&index, -1);
+		if (HashIndex::build(relId, &index) != SUCCESS)
+		{
+			BlockAccess::dropHashIndex(relId, &index);
+			flag = E_INDEX_BLOCKS_RELEASED;
+		}
+	}
+
+	return flag;
+}
+
+/* removes every record of the relation but keeps its record blocks, linked
+again in ascending order of block number, so that the records inserted next
+fill them one after the other from the lowest block on. The B+ trees of the
+relation are replaced by empty ones and its zone map is cleared. */
+int BlockAccess::truncate(int relId)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	std::vector<int> blocks;
+	for (int block = relCatEntry.firstBlk; block != -1;)
+	{
+		RecBuffer recBuffer(block);
+		HeadInfo head;
+		recBuffer.getHeader(&head);
+		blocks.push_back(block);
+		block = head.rblock;
+	}
+	std::sort(blocks.begin(), blocks.end());
+
+	unsigned char slotMap[relCatEntry.numSlotsPerBlk];
+	memset(slotMap, SLOT_UNOCCUPIED, relCatEntry.numSlotsPerBlk);
+	for (int i = 0; i < (int)blocks.size(); ++i)
+	{
+		RecBuffer recBuffer(blocks[i]);
+		HeadInfo head;
+		recBuffer.getHeader(&head);
+		head.numEntries = 0;
+		head.lblock = i > 0 ? blocks[i - 1] : -1;
+		head.rblock = i + 1 < (int)blocks.size() ? blocks[i + 1] : -1;
+		recBuffer.setHeader(&head);
+		recBuffer.setSlotMap(slotMap);
+	}
+
+	relCatEntry.numRecs = 0;
+	relCatEntry.firstBlk = blocks.empty() ? -1 : blocks.front();
+	relCatEntry.lastBlk = blocks.empty() ? -1 : blocks.back();
+	RelCacheTable::setRelCatEntry(relId, &relCatEntry);
+	RelCacheTable::setFreeBlock(relId, -1);
+	RelCacheTable::resetSearchIndex(relId);
+
+	for (int attrOffset = 0; attrOffset < relCatEntry.numAttrs; attrOffset++)
+	{
+		AttrCatEntry attrCatEntry;
+		AttrCacheTable::getAttrCatEntry(relId, attrOffset, &attrCatEntry);
+		if (attrCatEntry.rootBlock == -1)
+			continue;
+
+		BPlusTree::bPlusDestroy(attrCatEntry.rootBlock);
+		attrCatEntry.rootBlock = -1;
+		AttrCacheTable::setAttrCatEntry(relId, attrOffset, &attrCatEntry);
+		AttrCacheTable::resetSearchIndex(relId, attrOffset);
+		BPlusTree::bPlusCreate(relId, attrCatEntry.attrName);
+	}
+
+	std::vector<CompositeIndexInfo> compositeIndexes;
+	CompositeIndex::getIndexes(relId, &compositeIndexes);
+	for (CompositeIndexInfo &index : compositeIndexes)
+	{
+		CompositeIndex::destroy(index.rootBlock, index.numKeys, index.compressed);
+		CompositeIndex::setRoot(&index, -1);
+	}
+
+	std::vector<HashIndexInfo> hashIndexes;
+	HashIndex::getIndexes(relId, &hashIndexes);
+	for (HashIndexInfo &index : hashIndexes)
+	{
+		HashIndex::destroy(index.rootBlock);
+		HashIndex::setRoot(&index, -1);
+	}
+
+	if (ZoneMap::get(relCatEntry.relName) != nullptr)
+		ZoneMap::create(relId);
+
+	return SUCCESS;
+}
+
+int BlockAccess::dropCompositeIndex(int relId, CompositeIndexInfo *index)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	CompositeIndex::destroy(index->rootBlock, index->numKeys, index->compressed);
+
+	ret = BlockAccess::deleteRecord(ATTRCAT_RELID, index->catRecId);
+	if (ret != SUCCESS)
+		return ret;
+
+	CatalogDirectory::removeIndex(relCatEntry.relName, index->catRecId);
+	return SUCCESS;
+}
+
+int BlockAccess::dropHashIndex(int relId, HashIndexInfo *index)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	HashIndex::destroy(index->rootBlock);
+
+	ret = BlockAccess::deleteRecord(ATTRCAT_RELID, index->catRecId);
+	if (ret != SUCCESS)
+		return ret;
 
+	CatalogDirectory::removeIndex(relCatEntry.relName, index->catRecId);
 	return SUCCESS;
 }
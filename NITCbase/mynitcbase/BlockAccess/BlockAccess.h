@@ -1,13 +1,22 @@
 #ifndef NITCBASE_BLOCKACCESS_H
 #define NITCBASE_BLOCKACCESS_H
 
+#include <vector>
+
 #include "../BPlusTree/BPlusTree.h"
+#include "../BPlusTree/CompositeIndex.h"
+#include "../BPlusTree/HashIndex.h"
 #include "../Buffer/BlockBuffer.h"
 #include "../Cache/AttrCacheTable.h"
+#include "../Cache/CatalogDirectory.h"
 #include "../Cache/RelCacheTable.h"
+#include "../Cache/ZoneMap.h"
+#include "RecIdBitmap.h"
 #include "../define/constants.h"
 #include "../define/id.h"
 
+class BPlusCursor;
+
 class BlockAccess {
  public:
   static int search(int relId, Attribute *record, char *attrName, Attribute attrVal, int op);
@@ -23,6 +32,28 @@ class BlockAccess {
   static RecId linearSearch(int relId, char *attrName, Attribute attrVal, int op);
 
   static int project(int relId, Attribute *record);
+
+  // record-level modification (DELETE / UPDATE)
+  static int findRecIds(int relId, char *attrName, Attribute attrVal, int op, std::vector<RecId> *recIds);
+
+  // bitmap heap fetch: the RecIds of the rest of a B+ tree scan, to be read in block order
+  static int collectRecIds(BPlusCursor *cursor, RecIdBitmap *bitmap, int maxRecIds);
+
+  static int deleteRecord(int relId, RecId recId);
+
+  static int updateRecord(int relId, RecId recId, union Attribute *record);
+
+  // VACUUM
+  static int compact(int relId, int *numBlocksBefore, int *numBlocksAfter);
+
+  // CLUSTER
+  static int truncate(int relId);
+
+  // composite indexes: removes the index from the catalog and releases its blocks
+  static int dropCompositeIndex(int relId, CompositeIndexInfo *index);
+
+  // hash indexes: removes the index from the catalog and releases its blocks
+  static int dropHashIndex(int relId, HashIndexInfo *index);
 };
 
 #endif  // NITCBASE_BLOCKACCESS_H
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "RecIdBitmap.h"
+
+static int popCount(std::vector<uint64_t> &words)
+{
+	int count = 0;
+	for (uint64_t word : words)
+		count += __builtin_popcountll(word);
+	return count;
+}
+
+RecIdBitmap::RecIdBitmap()
+{
+	count = 0;
+}
+
+void RecIdBitmap::add(RecId recId)
+{
+	std::vector<uint64_t> &words = blocks[recId.block];
+	int word = recId.slot / 64;
+	if (word >= (int)words.size())
+		words.resize(word + 1, 0);
+
+	uint64_t bit = (uint64_t)1 << (recId.slot % 64);
+	if ((words[word] & bit) == 0)
+	{
+		words[word] |= bit;
+		count++;
+	}
+}
+
+bool RecIdBitmap::contains(RecId recId)
+{
+	auto it = blocks.find(recId.block);
+	if (it == blocks.end() || recId.slot / 64 >= (int)it->second.size())
+		return false;
+	return (it->second[recId.slot / 64] >> (recId.slot % 64)) & 1;
+}
+
+// keeps the RecIds that are also in other; blocks left without one are dropped
+void RecIdBitmap::intersect(RecIdBitmap &other)
+{
+	count = 0;
+	for (auto it = blocks.begin(); it != blocks.end();)
+	{
+		auto otherIt = other.blocks.find(it->first);
+		if (otherIt == other.blocks.end())
+		{
+			it = blocks.erase(it);
+			continue;
+		}
+
+		std::vector<uint64_t> &words = it->second;
+		std::vector<uint64_t> &otherWords = otherIt->second;
+		if (words.size() > otherWords.size())
+			words.resize(otherWords.size());
+		for (int i = 0; i < (int)words.size(); ++i)
+			words[i] &= otherWords[i];
+
+		int blockCount = popCount(words);
+		if (blockCount == 0)
+		{
+			it = blocks.erase(it);
+			continue;
+		}
+		count += blockCount;
+		++it;
+	}
+}
+
+void RecIdBitmap::unite(RecIdBitmap &other)
+{
+	for (auto &otherBlock : other.blocks)
+	{
+		std::vector<uint64_t> &words = blocks[otherBlock.first];
+		std::vector<uint64_t> &otherWords = otherBlock.second;
+		count -= popCount(words);
+		if (words.size() < otherWords.size())
+			words.resize(otherWords.size(), 0);
+		for (int i = 0; i < (int)otherWords.size(); ++i)
+			words[i] |= otherWords[i];
+		count += popCount(words);
+	}
+}
+
+void RecIdBitmap::clear()
+{
+	blocks.clear();
+	count = 0;
+}
+
+int RecIdBitmap::size()
+{
+	return count;
+}
+
+int RecIdBitmap::getNumBlocks()
+{
+	return blocks.size();
+}
+
+RecId RecIdBitmap::next(RecId recId)
+{
+	// the slots after recId in its own block, then the blocks after it
+	auto it = blocks.lower_bound(recId.block);
+	int slot = recId.slot + 1;
+	if (it != blocks.end() && it->first != recId.block)
+		slot = 0;
+
+	for (; it != blocks.end(); ++it, slot = 0)
+	{
+		std::vector<uint64_t> &words = it->second;
+		for (int word = slot / 64; word < (int)words.size(); ++word)
+		{
+			uint64_t bits = words[word];
+			if (word == slot / 64)
+				bits &= ~(uint64_t)0 << (slot % 64);
+			if (bits != 0)
+				return RecId{it->first, word * 64 + __builtin_ctzll(bits)};
+		}
+	}
+	return RecId{-1, -1};
+}
@@ -0,0 +1,40 @@
+#ifndef NITCBASE_RECIDBITMAP_H
+#define NITCBASE_RECIDBITMAP_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "../define/id.h"
+
+/*
+ * Set of RecIds of a relation, kept as a bitmap of slots for each record block
+ * that holds one of them; blocks without a RecId take no space. The RecIds
+ * are visited in ascending block (then slot) order, so the records of an
+ * index scan can be fetched with a single read of each of their blocks
+ * instead of in key order. Two bitmaps are combined with intersect() (AND)
+ * and unite() (OR).
+ */
+class RecIdBitmap {
+ public:
+  RecIdBitmap();
+
+  void add(RecId recId);
+  bool contains(RecId recId);
+  void intersect(RecIdBitmap &other);
+  void unite(RecIdBitmap &other);
+  void clear();
+
+  int size();  // number of RecIds
+  int getNumBlocks();
+
+  // the first RecId after `recId` in block order ({-1, -1} before the first
+  // one); {-1, -1} once there is none left
+  RecId next(RecId recId);
+
+ private:
+  std::map<int, std::vector<uint64_t>> blocks;  // bit `slot` of block's words
+  int count;
+};
+
+#endif  // NITCBASE_RECIDBITMAP_H
@@ -15,12 +15,13 @@ BlockBuffer::BlockBuffer(char blockType)
 	// allocate a block on the disk and a buffer in memory to hold the new block of
 	// given type using getFreeBlock function and get the return error codes if any.
 	int type = blockType == 'R' ? REC : blockType == 'I' ? IND_INTERNAL :
-					blockType == 'L' ? IND_LEAF : UNUSED_BLK; 
+					blockType == 'L' ? IND_LEAF : blockType == 'D' ? HASH_DIR :
+					blockType == 'H' ? HASH_BUCKET : blockType == 'P' ? IND_POSTING : UNUSED_BLK; 
 	
 	int ret=getFreeBlock(type);
 	if (ret<0 || ret>=DISK_SIZE)
 	{
-		this->blockNum = blockNum;
+		this->blockNum = ret;
 		return;
 	}
 	
@@ -50,6 +51,11 @@ IndInternal::IndInternal(int blockNum) : IndBuffer(blockNum){}
 IndLeaf::IndLeaf() : IndBuffer('L'){}
 IndLeaf::IndLeaf(int blockNum) : IndBuffer(blockNum){}
 
+// 'I' or 'L' allocates an internal or a leaf index block, 'P' a posting list block of a B+ tree,
+// 'D' or 'H' a hash directory or bucket block
+IndNode::IndNode(char blockType) : BlockBuffer(blockType){}
+IndNode::IndNode(int blockNum) : BlockBuffer(blockNum){}
+
 
 // load the block header into the argument pointer
 int BlockBuffer::getHeader(struct HeadInfo *head)
@@ -62,6 +68,8 @@ int BlockBuffer::getHeader(struct HeadInfo *head)
 	  // read the block at this.blockNum into the buffer:
 	  
 	  // populate the numEntries, numAttrs and numSlots fields in *head
+	  // (and the block type, which setHeader() writes back)
+	  memcpy(&head->blockType, bufferPtr, 4);
 	  memcpy(&head->numSlots, bufferPtr + 24, 4);
 	  memcpy(&head->numEntries, bufferPtr + 16, 4);
 	  memcpy(&head->numAttrs, bufferPtr + 20, 4);
@@ -104,6 +112,32 @@ int RecBuffer::getRecord(union Attribute *rec, int slotNum)
 	  return SUCCESS;
 }
 
+/* used by scans to read the header, slotmap and records of a block with a
+single buffer access instead of one per getHeader() / getSlotMap() /
+getRecord() call. The pointers are into the buffer of the block, so they must
+not be used after another block has been loaded.
+*/
+int RecBuffer::getBlockContents(struct HeadInfo *head, unsigned char **slotMap, unsigned char **records)
+{
+	unsigned char *bufferPtr;
+	int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+	if (ret != SUCCESS)
+		return ret;
+
+	memcpy(&head->blockType, bufferPtr, 4);
+	memcpy(&head->pblock, bufferPtr + 4, 4);
+	memcpy(&head->lblock, bufferPtr + 8, 4);
+	memcpy(&head->rblock, bufferPtr + 12, 4);
+	memcpy(&head->numEntries, bufferPtr + 16, 4);
+	memcpy(&head->numAttrs, bufferPtr + 20, 4);
+	memcpy(&head->numSlots, bufferPtr + 24, 4);
+
+	*slotMap = bufferPtr + HEADER_SIZE;
+	*records = bufferPtr + HEADER_SIZE + head->numSlots;
+
+	return SUCCESS;
+}
+
 int BlockBuffer::loadBlockAndGetBufferPtr(unsigned char **buffPtr)
 {
 	// check whether the block is already present in the buffer using StaticBuffer.getBufferNum()
@@ -126,6 +160,7 @@ int BlockBuffer::loadBlockAndGetBufferPtr(unsigned char **buffPtr)
 			return E_OUTOFBOUND;
 
 		Disk::readBlock(StaticBuffer::blocks[bufferNum], this->blockNum);
+		StaticBuffer::numDiskReads++;
 	}
 	// store the pointer to this buffer (blocks[bufferNum]) in *buffPtr
 	*buffPtr = StaticBuffer::blocks[bufferNum];
@@ -475,3 +510,31 @@ int IndInternal::setEntry(void *ptr, int indexNum)
 	ret= StaticBuffer::setDirtyBit(this->blockNum);
 	return ret;
 }
+
+int IndNode::getBytes(unsigned char *dest, int offset, int numBytes)
+{
+	if (offset < 0 || numBytes < 0 || HEADER_SIZE + offset + numBytes > BLOCK_SIZE)
+		return E_OUTOFBOUND;
+
+	unsigned char *bufferPtr;
+	int ret=loadBlockAndGetBufferPtr(&bufferPtr);
+	if(ret!=SUCCESS)
+		return ret;
+
+	memcpy(dest, bufferPtr + HEADER_SIZE + offset, numBytes);
+	return SUCCESS;
+}
+
+int IndNode::setBytes(unsigned char *src, int offset, int numBytes)
+{
+	if (offset < 0 || numBytes < 0 || HEADER_SIZE + offset + numBytes > BLOCK_SIZE)
+		return E_OUTOFBOUND;
+
+	unsigned char *bufferPtr;
+	int ret=loadBlockAndGetBufferPtr(&bufferPtr);
+	if(ret!=SUCCESS)
+		return ret;
+
+	memcpy(bufferPtr + HEADER_SIZE + offset, src, numBytes);
+	return StaticBuffer::setDirtyBit(this->blockNum);
+}
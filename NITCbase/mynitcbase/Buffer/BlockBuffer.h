@@ -66,6 +66,9 @@ class RecBuffer : public BlockBuffer {
   int setSlotMap(unsigned char *slotMap);
   int getRecord(union Attribute *rec, int slotNum);
   int setRecord(union Attribute *rec, int slotNum);
+  // loads the block once and points *slotMap and *records into the buffer
+  // (valid until another block is loaded into the buffer)
+  int getBlockContents(struct HeadInfo *head, unsigned char **slotMap, unsigned char **records);
 };
 
 class IndBuffer : public BlockBuffer {
@@ -92,4 +95,15 @@ class IndLeaf : public IndBuffer {
   int setEntry(void *ptr, int indexNum);
 };
 
+/* index block whose entries do not have the fixed Index / InternalEntry
+   layout (the blocks of a composite B+ tree or a hash index). The bytes after the header are
+   read and written as they are; offset 0 is the first byte after the header. */
+class IndNode : public BlockBuffer {
+ public:
+  IndNode(char blockType);
+  IndNode(int blockNum);
+  int getBytes(unsigned char *dest, int offset, int numBytes);
+  int setBytes(unsigned char *src, int offset, int numBytes);
+};
+
 #endif  // NITCBASE_BLOCKBUFFER_H
@@ -6,6 +6,7 @@ unsigned char StaticBuffer::blocks[BUFFER_CAPACITY][BLOCK_SIZE];
 struct BufferMetaInfo StaticBuffer::metainfo[BUFFER_CAPACITY];
 // declare the blockAllocMap array
 unsigned char StaticBuffer::blockAllocMap[DISK_BLOCKS];
+long long StaticBuffer::numDiskReads = 0;
 
 
 StaticBuffer::StaticBuffer()
@@ -164,3 +165,7 @@ int StaticBuffer::getStaticBlockType(int blockNum)
 	return (int)blockAllocMap[blockNum];
 }
 
+long long StaticBuffer::getNumDiskReads()
+{
+	return numDiskReads;
+}
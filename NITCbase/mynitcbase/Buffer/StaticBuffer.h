@@ -19,6 +19,7 @@ class StaticBuffer {
   static unsigned char blocks[BUFFER_CAPACITY][BLOCK_SIZE];
   static struct BufferMetaInfo metainfo[BUFFER_CAPACITY];
   static unsigned char blockAllocMap[DISK_BLOCKS];
+  static long long numDiskReads;  // blocks read from the disk into the buffer (for benchmarks)
 
   // methods
   static int getFreeBuffer(int blockNum);
@@ -28,6 +29,7 @@ class StaticBuffer {
   // methods
   static int getStaticBlockType(int blockNum);
   static int setDirtyBit(int blockNum);
+  static long long getNumDiskReads();
   StaticBuffer();
   ~StaticBuffer();
 };
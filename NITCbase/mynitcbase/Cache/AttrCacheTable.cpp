@@ -1,64 +1,140 @@
 #include "AttrCacheTable.h"
 #include <cstring>
 
-AttrCacheEntry* AttrCacheTable::attrCache[MAX_OPEN];
+std::vector<AttrCacheRelation *> AttrCacheTable::attrCache;
 
-/* returns the attrOffset-th attribute for the relation corresponding to relId
-NOTE: this function expects the caller to allocate memory for `*attrCatBuf`
-*/
+/* installs the attribute cache entries of the relation at relId (called by
+OpenRelTable when the relation is opened) and builds the hash table over the
+attribute names. The offsets come from the catalog, so every entry must have
+a different offset in [0, number of entries); E_INVALID otherwise. */
+int AttrCacheTable::setRelation(int relId, std::vector<AttrCacheEntry> &entries)
+{
+	std::vector<bool> used(entries.size(), false);
+	for (AttrCacheEntry &entry : entries)
+	{
+		int offset = entry.attrCatEntry.offset;
+		if (offset < 0 || offset >= (int)entries.size() || used[offset])
+			return E_INVALID;
+		used[offset] = true;
+	}
 
-int AttrCacheTable::getAttrCatEntry(int relId, int attrOffset, AttrCatEntry* attrCatBuf)
+	AttrCacheRelation *relation = new AttrCacheRelation;
+
+	// place every entry at its offset
+	relation->entries.resize(entries.size());
+	for (AttrCacheEntry &entry : entries)
+		relation->entries[entry.attrCatEntry.offset] = entry;
+
+	int tableSize = 2;
+	while (tableSize < 2 * (int)entries.size())
+		tableSize *= 2;
+	relation->nameTable.assign(tableSize, -1);
+
+	for (int offset = 0; offset < (int)relation->entries.size(); ++offset)
+	{
+		// linear probing; the table is never more than half full
+		unsigned int slot = hashName(relation->entries[offset].attrCatEntry.attrName) & (tableSize - 1);
+		while (relation->nameTable[slot] != -1)
+			slot = (slot + 1) & (tableSize - 1);
+		relation->nameTable[slot] = offset;
+	}
+
+	attrCache[relId] = relation;
+	return SUCCESS;
+}
+
+void AttrCacheTable::clearRelation(int relId)
+{
+	delete attrCache[relId];
+	attrCache[relId] = nullptr;
+}
+
+// FNV-1a hash of an attribute name
+unsigned int AttrCacheTable::hashName(char attrName[ATTR_SIZE])
 {
-	// check if 0 <= relId < MAX_OPEN and return E_OUTOFBOUND otherwise
-	if(relId<0 || relId >=MAX_OPEN)
+	unsigned int hash = 2166136261u;
+	for (int i = 0; i < ATTR_SIZE && attrName[i] != '\0'; ++i)
+	{
+		hash ^= (unsigned char)attrName[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* sets *entry to the cache entry of the attrOffset-th attribute of the
+relation at relId */
+int AttrCacheTable::getEntry(int relId, int attrOffset, AttrCacheEntry **entry)
+{
+	// check if 0 <= relId < size of the cache and return E_OUTOFBOUND otherwise
+	if(relId<0 || relId >= (int)attrCache.size())
 		return E_OUTOFBOUND;
 
 	// check if attrCache[relId] == nullptr and return E_RELNOTOPEN if true
 	if(attrCache[relId] == nullptr)
 		return E_RELNOTOPEN;
 
-	// traverse the linked list of attribute cache entries
-	for(AttrCacheEntry* entry = attrCache[relId]; entry != nullptr; entry = entry->next)
-	{
-		if (entry->attrCatEntry.offset==attrOffset)
-		{
+	// there is no attribute at this offset
+	if (attrOffset < 0 || attrOffset >= (int)attrCache[relId]->entries.size())
+		return E_ATTRNOTEXIST;
 
-		      // copy entry->attrCatEntry to *attrCatBuf and return SUCCESS;
-		      *attrCatBuf=entry->attrCatEntry;
-		      return SUCCESS;
-		}
-	}
-
-	  // there is no attribute at this offset
-	return E_ATTRNOTEXIST;
+	*entry = &attrCache[relId]->entries[attrOffset];
+	return SUCCESS;
 }
 
-int AttrCacheTable::getAttrCatEntry(int relId, char attrName[ATTR_SIZE], AttrCatEntry* attrCatBuf)
+/* sets *entry to the cache entry of the attribute attrName of the relation
+at relId */
+int AttrCacheTable::getEntry(int relId, char attrName[ATTR_SIZE], AttrCacheEntry **entry)
 {
-	// check if 0 <= relId < MAX_OPEN and return E_OUTOFBOUND otherwise
-	if(relId<0 || relId >=MAX_OPEN)
+	if(relId<0 || relId >= (int)attrCache.size())
 		return E_OUTOFBOUND;
 
-	// check if attrCache[relId] == nullptr and return E_RELNOTOPEN if true
 	if(attrCache[relId] == nullptr)
 		return E_RELNOTOPEN;
 
-	// traverse the linked list of attribute cache entries
-	for(AttrCacheEntry* entry = attrCache[relId]; entry != nullptr; entry = entry->next)
+	AttrCacheRelation *relation = attrCache[relId];
+	int mask = relation->nameTable.size() - 1;
+
+	// probe from the home slot of the name until an empty slot is reached
+	for (unsigned int slot = hashName(attrName) & mask; relation->nameTable[slot] != -1; slot = (slot + 1) & mask)
 	{
-		if (strcmp(entry->attrCatEntry.attrName,attrName)==0)
+		AttrCacheEntry *candidate = &relation->entries[relation->nameTable[slot]];
+		if (strncmp(candidate->attrCatEntry.attrName, attrName, ATTR_SIZE) == 0)
 		{
-
-		      // copy entry->attrCatEntry to *attrCatBuf and return SUCCESS;
-		      *attrCatBuf=entry->attrCatEntry;
-		      return SUCCESS;
+			*entry = candidate;
+			return SUCCESS;
 		}
 	}
 
-	  // there is no attribute at this offset
 	return E_ATTRNOTEXIST;
 }
 
+/* returns the attrOffset-th attribute for the relation corresponding to relId
+NOTE: this function expects the caller to allocate memory for `*attrCatBuf`
+*/
+
+int AttrCacheTable::getAttrCatEntry(int relId, int attrOffset, AttrCatEntry* attrCatBuf)
+{
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrOffset, &entry);
+	if (ret != SUCCESS)
+		return ret;
+
+	// copy entry->attrCatEntry to *attrCatBuf and return SUCCESS;
+	*attrCatBuf=entry->attrCatEntry;
+	return SUCCESS;
+}
+
+int AttrCacheTable::getAttrCatEntry(int relId, char attrName[ATTR_SIZE], AttrCatEntry* attrCatBuf)
+{
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrName, &entry);
+	if (ret != SUCCESS)
+		return ret;
+
+	*attrCatBuf=entry->attrCatEntry;
+	return SUCCESS;
+}
+
 /* Converts a attribute catalog record to AttrCatEntry struct
     We get the record as Attribute[] from the BlockBuffer.getRecord() function.
     This function will convert that to a struct AttrCatEntry type.
@@ -70,7 +146,9 @@ void AttrCacheTable::recordToAttrCatEntry(union Attribute record[ATTRCAT_NO_ATTR
 	// copy the rest of the fields in the record to the attrCacheEntry struct
 	strcpy(attrCatEntry->attrName,record[ATTRCAT_ATTR_NAME_INDEX].sVal);
 	attrCatEntry->attrType=record[ATTRCAT_ATTR_TYPE_INDEX].nVal;
-	attrCatEntry->primaryFlag=record[ATTRCAT_PRIMARY_FLAG_INDEX].nVal;
+	// PrimaryFlag is 1 for the attribute the relation is clustered on (CLUSTER)
+	// and -1 otherwise
+	attrCatEntry->primaryFlag=(record[ATTRCAT_PRIMARY_FLAG_INDEX].nVal==1);
 	attrCatEntry->rootBlock=record[ATTRCAT_ROOT_BLOCK_INDEX].nVal;
 	attrCatEntry->offset=record[ATTRCAT_OFFSET_INDEX].nVal;
 }
@@ -80,7 +158,7 @@ void AttrCacheTable::attrCatEntryToRecord(AttrCatEntry *attrCatEntry, Attribute
 	strcpy(record[ATTRCAT_REL_NAME_INDEX].sVal, attrCatEntry->relName);
 	strcpy(record[ATTRCAT_ATTR_NAME_INDEX].sVal, attrCatEntry->attrName);
 	record[ATTRCAT_ATTR_TYPE_INDEX].nVal = attrCatEntry->attrType;
-	record[ATTRCAT_PRIMARY_FLAG_INDEX].nVal = attrCatEntry->primaryFlag;
+	record[ATTRCAT_PRIMARY_FLAG_INDEX].nVal = attrCatEntry->primaryFlag ? 1 : -1;
 	record[ATTRCAT_ROOT_BLOCK_INDEX].nVal = attrCatEntry->rootBlock;
 	record[ATTRCAT_OFFSET_INDEX].nVal = attrCatEntry->offset;
 
@@ -104,171 +182,92 @@ int AttrCacheTable::resetSearchIndex(int relId, int attrOffset)
 
 int  AttrCacheTable:: setSearchIndex(int relId, char attrName[ATTR_SIZE], IndexId *searchIndex)
 {
-	if(relId<0 || relId>=MAX_OPEN)
-		return E_OUTOFBOUND;
-  
-	if(AttrCacheTable::attrCache[relId]==nullptr)
-		return E_RELNOTOPEN;
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrName, &entry);
+	if (ret != SUCCESS)
+		return ret;
 
-	AttrCacheEntry *curr=AttrCacheTable::attrCache[relId];
-	while(curr)
-	{
-		if(strcmp(curr->attrCatEntry.attrName,attrName)==0)
-		{
-			curr->searchIndex=*searchIndex;
-			return SUCCESS;
-		}
-		curr=curr->next;
-	}
-	return E_ATTRNOTEXIST;
+	entry->searchIndex=*searchIndex;
+	return SUCCESS;
 }
 
 int  AttrCacheTable:: setSearchIndex(int relId, int attrOffset, IndexId *searchIndex)
 {
-	if(relId<0 || relId>=MAX_OPEN)
-		return E_OUTOFBOUND;
-  
-	if(AttrCacheTable::attrCache[relId]==nullptr)
-		return E_RELNOTOPEN;
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrOffset, &entry);
+	if (ret != SUCCESS)
+		return ret;
 
-	AttrCacheEntry *curr=AttrCacheTable::attrCache[relId];
-	while(curr)
-	{
-		if(attrOffset==curr->attrCatEntry.offset)
-		{
-			curr->searchIndex=*searchIndex;
-			return SUCCESS;
-		}
-		curr=curr->next;
-	}
-	return E_ATTRNOTEXIST;
+	entry->searchIndex=*searchIndex;
+	return SUCCESS;
 }
 
 int AttrCacheTable::getSearchIndex(int relId, char attrName[ATTR_SIZE], IndexId *searchIndex)
 {
-
-	if(relId<0 ||relId>=MAX_OPEN)
-	{
-		return E_OUTOFBOUND;
-	}
-
-	if(AttrCacheTable::attrCache[relId] == nullptr)
-	{
-		return E_RELNOTOPEN;
-	}
-
-	
-	for(AttrCacheEntry* temp=AttrCacheTable::attrCache[relId];temp!=nullptr;temp=temp->next)
-	{
-		if (strcmp(attrName,temp->attrCatEntry.attrName)==0)
-		{
-			//copy the searchIndex field of the corresponding Attribute Cache entry
-			//in the Attribute Cache Table to input searchIndex variable.
-			*searchIndex=temp->searchIndex;
-			return SUCCESS;
-		}
-	}
-
-	return E_ATTRNOTEXIST;
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrName, &entry);
+	if (ret != SUCCESS)
+		return ret;
+
+	//copy the searchIndex field of the corresponding Attribute Cache entry
+	//in the Attribute Cache Table to input searchIndex variable.
+	*searchIndex=entry->searchIndex;
+	return SUCCESS;
 }
-	
 
 int AttrCacheTable::getSearchIndex(int relId, int attrOffset, IndexId *searchIndex)
 {
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrOffset, &entry);
+	if (ret != SUCCESS)
+		return ret;
 
-	if(relId<0 ||relId>=MAX_OPEN)
-	{
-		return E_OUTOFBOUND;
-	}
-
-	if(AttrCacheTable::attrCache[relId] == nullptr)
-	{
-		return E_RELNOTOPEN;
-	}
-
-	
-	for(AttrCacheEntry* temp=attrCache[relId];temp!=nullptr;temp=temp->next)
-	{
-		if (attrOffset==temp->attrCatEntry.offset)
-		{
-			//copy the searchIndex field of the corresponding Attribute Cache entry
-			//in the Attribute Cache Table to input searchIndex variable.
-			*searchIndex=temp->searchIndex;
-			return SUCCESS;
-		}
-	}
-
-	return E_ATTRNOTEXIST;
-}	
-
+	*searchIndex=entry->searchIndex;
+	return SUCCESS;
+}
 
 int AttrCacheTable::setAttrCatEntry(int relId, char attrName[ATTR_SIZE], AttrCatEntry *attrCatBuf)
 {
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrName, &entry);
+	if (ret != SUCCESS)
+		return ret;
 
-	if(relId<0 || relId>=MAX_OPEN)
-	{
-		return E_OUTOFBOUND;
-	}
+	// the name table is keyed on the attribute name, so a renamed attribute
+	// is re-hashed by rebuilding the relation's table
+	bool renamed = strncmp(entry->attrCatEntry.attrName, attrCatBuf->attrName, ATTR_SIZE) != 0;
 
-	if(AttrCacheTable::attrCache[relId]==nullptr)
-	{
-		return E_RELNOTOPEN;
-	}
+	// copy the attrCatBuf to the corresponding Attribute Catalog entry in
+	// the Attribute Cache Table.
+	entry->attrCatEntry=*attrCatBuf;
+	entry->dirty=true;
 
-	for(AttrCacheEntry *current=AttrCacheTable::attrCache[relId]; current!=nullptr; current=current->next)
+	if (renamed)
 	{
-		if(strcmp(current->attrCatEntry.attrName,attrName)==0)
-		{
-			// copy the attrCatBuf to the corresponding Attribute Catalog entry in
-			// the Attribute Cache Table.
-			current->attrCatEntry=*attrCatBuf;
-			current->dirty=true;
-			return SUCCESS;
-		}
+		std::vector<AttrCacheEntry> entries = attrCache[relId]->entries;
+		AttrCacheTable::clearRelation(relId);
+		return AttrCacheTable::setRelation(relId, entries);
 	}
-
-	return E_ATTRNOTEXIST;
+	return SUCCESS;
 }
 
 int AttrCacheTable::setAttrCatEntry(int relId, int attrOffset, AttrCatEntry *attrCatBuf)
 {
+	AttrCacheEntry *entry;
+	int ret = AttrCacheTable::getEntry(relId, attrOffset, &entry);
+	if (ret != SUCCESS)
+		return ret;
 
-	if(relId<0 || relId>=MAX_OPEN)
-	{
-		return E_OUTOFBOUND;
-	}
+	bool renamed = strncmp(entry->attrCatEntry.attrName, attrCatBuf->attrName, ATTR_SIZE) != 0;
 
-	if(AttrCacheTable::attrCache[relId]==nullptr)
-	{
-		return E_RELNOTOPEN;
-	}
+	entry->attrCatEntry=*attrCatBuf;
+	entry->dirty=true;
 
-	for(AttrCacheEntry *current=AttrCacheTable::attrCache[relId]; current!=nullptr; current=current->next)
+	if (renamed)
 	{
-		if( current->attrCatEntry.offset==attrOffset)
-		{
-			// copy the attrCatBuf to the corresponding Attribute Catalog entry in
-			// the Attribute Cache Table.
-			current->attrCatEntry=*attrCatBuf;
-			current->dirty=true;
-			return SUCCESS;
-		}
+		std::vector<AttrCacheEntry> entries = attrCache[relId]->entries;
+		AttrCacheTable::clearRelation(relId);
+		return AttrCacheTable::setRelation(relId, entries);
 	}
-
-	return E_ATTRNOTEXIST;
+	return SUCCESS;
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
@@ -1,6 +1,8 @@
 #ifndef NITCBASE_ATTRCACHETABLE_H
 #define NITCBASE_ATTRCACHETABLE_H
 
+#include <vector>
+
 #include "../Buffer/BlockBuffer.h"
 #include "../define/constants.h"
 #include "../define/id.h"
@@ -20,10 +22,18 @@ typedef struct AttrCacheEntry {
   bool dirty;
   RecId recId;
   IndexId searchIndex;
-  struct AttrCacheEntry *next;
 
 } AttrCacheEntry;
 
+/* attribute cache of one open relation: the entries are stored at their
+   attribute offset, and an open addressing hash table (a power of two at
+   least twice the number of attributes) maps attribute names to offsets */
+typedef struct AttrCacheRelation {
+  std::vector<AttrCacheEntry> entries;
+  std::vector<int> nameTable;  // offset of the attribute in each slot, -1 if empty
+
+} AttrCacheRelation;
+
 class AttrCacheTable {
   friend class OpenRelTable;
 
@@ -42,9 +52,15 @@ class AttrCacheTable {
 
  private:
   // field
-  static AttrCacheEntry *attrCache[MAX_OPEN];
+  // one entry per slot of the open relation table (grown by OpenRelTable)
+  static std::vector<AttrCacheRelation *> attrCache;
 
   // methods
+  static int setRelation(int relId, std::vector<AttrCacheEntry> &entries);
+  static void clearRelation(int relId);
+  static int getEntry(int relId, int attrOffset, AttrCacheEntry **entry);
+  static int getEntry(int relId, char attrName[ATTR_SIZE], AttrCacheEntry **entry);
+  static unsigned int hashName(char attrName[ATTR_SIZE]);
   static void recordToAttrCatEntry(union Attribute record[ATTRCAT_NO_ATTRS], AttrCatEntry *attrCatEntry);
   static void attrCatEntryToRecord(AttrCatEntry *attrCatEntry, union Attribute record[ATTRCAT_NO_ATTRS]);
 };
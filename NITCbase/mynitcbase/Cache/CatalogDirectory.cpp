@@ -0,0 +1,152 @@
+#include "CatalogDirectory.h"
+
+#include <cstring>
+
+std::unordered_map<std::string, CatalogDirEntry> CatalogDirectory::directory;
+
+// the directory is keyed by the relation name as stored in the catalog
+static std::string key(char relName[ATTR_SIZE])
+{
+	return std::string(relName, strnlen(relName, ATTR_SIZE));
+}
+
+/* walks the blocks of the Relation Catalog and the Attribute Catalog once and
+records the rec-id of every occupied slot under its relation name */
+void CatalogDirectory::load()
+{
+	directory.clear();
+
+	int block = RELCAT_BLOCK;
+	while (block != -1)
+	{
+		RecBuffer relCatBlock(block);
+		HeadInfo head;
+		relCatBlock.getHeader(&head);
+		unsigned char slotMap[head.numSlots];
+		relCatBlock.getSlotMap(slotMap);
+
+		for (int slot = 0; slot < head.numSlots; ++slot)
+		{
+			if (slotMap[slot] == SLOT_UNOCCUPIED)
+				continue;
+
+			Attribute record[RELCAT_NO_ATTRS];
+			relCatBlock.getRecord(record, slot);
+			addRelation(record[RELCAT_REL_NAME_INDEX].sVal, RecId{block, slot});
+		}
+		block = head.rblock;
+	}
+
+	block = ATTRCAT_BLOCK;
+	while (block != -1)
+	{
+		RecBuffer attrCatBlock(block);
+		HeadInfo head;
+		attrCatBlock.getHeader(&head);
+		unsigned char slotMap[head.numSlots];
+		attrCatBlock.getSlotMap(slotMap);
+
+		for (int slot = 0; slot < head.numSlots; ++slot)
+		{
+			if (slotMap[slot] == SLOT_UNOCCUPIED)
+				continue;
+
+			Attribute record[ATTRCAT_NO_ATTRS];
+			attrCatBlock.getRecord(record, slot);
+			addAttribute(record[ATTRCAT_REL_NAME_INDEX].sVal, (int)record[ATTRCAT_OFFSET_INDEX].nVal,
+			             RecId{block, slot});
+		}
+		block = head.rblock;
+	}
+}
+
+int CatalogDirectory::getRelCatRecId(char relName[ATTR_SIZE], RecId *relCatRecId)
+{
+	auto it = directory.find(key(relName));
+	if (it == directory.end() || it->second.relCatRecId.block == -1)
+		return E_RELNOTEXIST;
+
+	*relCatRecId = it->second.relCatRecId;
+	return SUCCESS;
+}
+
+// returns the Attribute Catalog rec-ids of the relation in offset order
+int CatalogDirectory::getAttrCatRecIds(char relName[ATTR_SIZE], std::vector<RecId> *attrCatRecIds)
+{
+	auto it = directory.find(key(relName));
+	if (it == directory.end() || it->second.relCatRecId.block == -1)
+		return E_RELNOTEXIST;
+
+	*attrCatRecIds = it->second.attrCatRecIds;
+	return SUCCESS;
+}
+
+// returns the Attribute Catalog rec-ids of the composite and hash indexes of the relation
+int CatalogDirectory::getIndexRecIds(char relName[ATTR_SIZE], std::vector<RecId> *indexRecIds)
+{
+	auto it = directory.find(key(relName));
+	if (it == directory.end() || it->second.relCatRecId.block == -1)
+		return E_RELNOTEXIST;
+
+	*indexRecIds = it->second.indexRecIds;
+	return SUCCESS;
+}
+
+void CatalogDirectory::addRelation(char relName[ATTR_SIZE], RecId relCatRecId)
+{
+	directory[key(relName)].relCatRecId = relCatRecId;
+}
+
+void CatalogDirectory::addAttribute(char relName[ATTR_SIZE], int attrOffset, RecId attrCatRecId)
+{
+	/* the Attribute Catalog record of a relation may be seen before its Relation
+	Catalog record (while loading) so the entry is created if needed */
+	auto it = directory.find(key(relName));
+	if (it == directory.end())
+		it = directory.insert({key(relName), CatalogDirEntry{RecId{-1, -1}, {}, {}}}).first;
+
+	// the record of an index is not an attribute of the relation
+	if (attrOffset < 0)
+	{
+		it->second.indexRecIds.push_back(attrCatRecId);
+		return;
+	}
+
+	std::vector<RecId> &attrCatRecIds = it->second.attrCatRecIds;
+	if ((int)attrCatRecIds.size() <= attrOffset)
+		attrCatRecIds.resize(attrOffset + 1, RecId{-1, -1});
+	attrCatRecIds[attrOffset] = attrCatRecId;
+}
+
+void CatalogDirectory::removeIndex(char relName[ATTR_SIZE], RecId indexRecId)
+{
+	auto it = directory.find(key(relName));
+	if (it == directory.end())
+		return;
+
+	std::vector<RecId> &indexRecIds = it->second.indexRecIds;
+	for (int i = 0; i < (int)indexRecIds.size(); ++i)
+	{
+		if (indexRecIds[i].block == indexRecId.block && indexRecIds[i].slot == indexRecId.slot)
+		{
+			indexRecIds.erase(indexRecIds.begin() + i);
+			return;
+		}
+	}
+}
+
+void CatalogDirectory::removeRelation(char relName[ATTR_SIZE])
+{
+	directory.erase(key(relName));
+}
+
+void CatalogDirectory::renameRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE])
+{
+	auto it = directory.find(key(oldName));
+	if (it == directory.end())
+		return;
+
+	CatalogDirEntry entry = it->second;
+	directory.erase(it);
+	directory[key(newName)] = entry;
+}
@@ -0,0 +1,42 @@
+#ifndef NITCBASE_CATALOGDIRECTORY_H
+#define NITCBASE_CATALOGDIRECTORY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Buffer/BlockBuffer.h"
+#include "../define/constants.h"
+#include "../define/id.h"
+
+typedef struct CatalogDirEntry {
+  RecId relCatRecId;
+  std::vector<RecId> attrCatRecIds;  // indexed by attribute offset
+  std::vector<RecId> indexRecIds;    // composite and hash indexes (Offset < 0 in the Attribute Catalog)
+
+} CatalogDirEntry;
+
+/*
+ * In-memory directory of the catalog: maps every relation name to the rec-id
+ * of its Relation Catalog record and the rec-ids of its Attribute Catalog
+ * records. It is loaded once at startup and kept in step with the catalog
+ * by BlockAccess, so that finding a relation does not need a linear search
+ * of RELATIONCAT and ATTRIBUTECAT.
+ */
+class CatalogDirectory {
+ public:
+  static void load();
+  static int getRelCatRecId(char relName[ATTR_SIZE], RecId *relCatRecId);
+  static int getAttrCatRecIds(char relName[ATTR_SIZE], std::vector<RecId> *attrCatRecIds);
+  static int getIndexRecIds(char relName[ATTR_SIZE], std::vector<RecId> *indexRecIds);
+  static void addRelation(char relName[ATTR_SIZE], RecId relCatRecId);
+  static void addAttribute(char relName[ATTR_SIZE], int attrOffset, RecId attrCatRecId);
+  static void removeIndex(char relName[ATTR_SIZE], RecId indexRecId);
+  static void removeRelation(char relName[ATTR_SIZE]);
+  static void renameRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE]);
+
+ private:
+  static std::unordered_map<std::string, CatalogDirEntry> directory;
+};
+
+#endif  // NITCBASE_CATALOGDIRECTORY_H
@@ -4,19 +4,23 @@
 #include<cstdio>
 
 
-OpenRelTableMetaInfo OpenRelTable::tableMetaInfo[MAX_OPEN];
+std::vector<OpenRelTableMetaInfo> OpenRelTable::tableMetaInfo;
+unsigned long OpenRelTable::accessClock = 0;
+bool OpenRelTable::autoOpen = false;
 
 OpenRelTable::OpenRelTable()
 {
 
 	// initialise all values in relCache and attrCache to be nullptr and all entries
-	// in tableMetaInfo to be free
+	// in tableMetaInfo to be free (the table starts with MAX_OPEN entries)
 	
+	RelCacheTable::relCache.assign(MAX_OPEN, nullptr);
+	AttrCacheTable::attrCache.assign(MAX_OPEN, nullptr);
+	OpenRelTable::tableMetaInfo.resize(MAX_OPEN);
 	for (int i = 0; i < MAX_OPEN; ++i)
 	{
-		RelCacheTable::relCache[i]=nullptr;
-		AttrCacheTable::attrCache[i]=nullptr;
 		OpenRelTable::tableMetaInfo[i].free=true;
+		OpenRelTable::tableMetaInfo[i].pinCount=0;
 	}
 	
 	
@@ -31,6 +35,7 @@ OpenRelTable::OpenRelTable()
 	RelCacheTable::recordToRelCatEntry(relCatRecord, &relCacheEntry.relCatEntry);
 	relCacheEntry.recId.block = RELCAT_BLOCK;
 	relCacheEntry.recId.slot = RELCAT_SLOTNUM_FOR_RELCAT;//relCacheEntry has relationship catalog details
+	relCacheEntry.freeBlk = -1;
 
 
 	RelCacheTable::relCache[RELCAT_RELID] = (struct RelCacheEntry*)malloc(sizeof(RelCacheEntry));
@@ -43,56 +48,40 @@ OpenRelTable::OpenRelTable()
 
 	struct RelCacheEntry relCacheEntry2;
 	RelCacheTable::recordToRelCatEntry(attrCatRecord, &relCacheEntry2.relCatEntry);
-	relCacheEntry2.recId.block = ATTRCAT_BLOCK;
+	relCacheEntry2.recId.block = RELCAT_BLOCK;
 	relCacheEntry2.recId.slot = RELCAT_SLOTNUM_FOR_ATTRCAT;
+	relCacheEntry2.freeBlk = -1;
 	
 	RelCacheTable::relCache[ATTRCAT_RELID] = (struct RelCacheEntry*)malloc(sizeof(RelCacheEntry));
 	*(RelCacheTable::relCache[ATTRCAT_RELID]) = relCacheEntry2;
 	
 	// load the relation and attribute catalog into the attribute cache (we did this already)
-	AttrCacheEntry *prevEntry=nullptr,*head=nullptr;
-	
 	RecBuffer  attrCatblock(ATTRCAT_BLOCK);
-	for(int i=0;i<RELCAT_NO_ATTRS;++i)
+	std::vector<AttrCacheEntry> relCatAttrs, attrCatAttrs;
+	for(int i=0;i<RELCAT_NO_ATTRS+ATTRCAT_NO_ATTRS;++i)
 	{
 		attrCatblock.getRecord(attrCatRecord,i);
 		
-		AttrCacheEntry *attrCacheEntry=(AttrCacheEntry*)malloc(sizeof(AttrCacheEntry));
-		attrCacheEntry->recId.block=ATTRCAT_BLOCK;
-		attrCacheEntry->recId.slot=i;
-		attrCacheEntry->next=nullptr;
-		AttrCacheTable::recordToAttrCatEntry(attrCatRecord,&attrCacheEntry->attrCatEntry);
+		AttrCacheEntry attrCacheEntry;
+		attrCacheEntry.recId.block=ATTRCAT_BLOCK;
+		attrCacheEntry.recId.slot=i;
+		attrCacheEntry.dirty=false;
+		attrCacheEntry.searchIndex=IndexId{-1, -1, -1, -1};
+		AttrCacheTable::recordToAttrCatEntry(attrCatRecord,&attrCacheEntry.attrCatEntry);
 		
-		if(prevEntry!=nullptr)
-			prevEntry->next=attrCacheEntry;
+		// the first RELCAT_NO_ATTRS records describe the relation catalog
+		if(i<RELCAT_NO_ATTRS)
+			relCatAttrs.push_back(attrCacheEntry);
 		else
-			head=attrCacheEntry;
-			
-		prevEntry=attrCacheEntry;
+			attrCatAttrs.push_back(attrCacheEntry);
 	}
-	AttrCacheTable::attrCache[RELCAT_RELID]=head;
-	
-	prevEntry=nullptr;
-	head=nullptr;
-	
-	for(int i=RELCAT_NO_ATTRS;i<RELCAT_NO_ATTRS+ATTRCAT_NO_ATTRS;++i)
+	if (AttrCacheTable::setRelation(RELCAT_RELID, relCatAttrs) != SUCCESS ||
+	    AttrCacheTable::setRelation(ATTRCAT_RELID, attrCatAttrs) != SUCCESS)
 	{
-		attrCatblock.getRecord(attrCatRecord,i);
-		
-		AttrCacheEntry *attrCacheEntry=(AttrCacheEntry*)malloc(sizeof(AttrCacheEntry));
-		attrCacheEntry->recId.block=ATTRCAT_BLOCK;
-		attrCacheEntry->recId.slot=i;
-		attrCacheEntry->next=nullptr;
-		AttrCacheTable::recordToAttrCatEntry(attrCatRecord,&attrCacheEntry->attrCatEntry);		
-		
-		if(prevEntry!=nullptr)
-			prevEntry->next=attrCacheEntry;
-		else
-			head=attrCacheEntry;
-			
-		prevEntry=attrCacheEntry;
+		// nothing can be opened without the catalogs
+		printf("Error: the catalogs on the disk are corrupt; format the disk with fdisk\n");
+		std::exit(EXIT_FAILURE);
 	}
-	AttrCacheTable::attrCache[ATTRCAT_RELID]=head;
 	
 	/************ Setting up tableMetaInfo entries ************/
 	OpenRelTable::tableMetaInfo[RELCAT_RELID].free=false;
@@ -100,6 +89,9 @@ OpenRelTable::OpenRelTable()
 	
 	OpenRelTable::tableMetaInfo[ATTRCAT_RELID].free=false;
 	strcpy(OpenRelTable::tableMetaInfo[ATTRCAT_RELID].relName,ATTRCAT_RELNAME);
+
+	// index the rec-ids of every relation in the catalog by relation name
+	CatalogDirectory::load();
 }
 
 
@@ -107,7 +99,7 @@ OpenRelTable::~OpenRelTable()
 {
 
 	// close all open relations (from rel-id = 2 onwards)
-	for (int i = 2; i < MAX_OPEN; ++i)
+	for (int i = 2; i < (int)tableMetaInfo.size(); ++i)
 	{
 		if (!tableMetaInfo[i].free)
 		{
@@ -148,41 +140,81 @@ OpenRelTable::~OpenRelTable()
 	
 	for (int i = 0; i < 2; ++i)
 	{
-		AttrCacheEntry *current = AttrCacheTable::attrCache[i];
-		while (current)
+		for (AttrCacheEntry &entry : AttrCacheTable::attrCache[i]->entries)
 		{
-			AttrCacheEntry *toDelete = current;
-			if(toDelete->dirty)
+			if(entry.dirty)
 			{
-				AttrCatEntry attrcatentry=toDelete->attrCatEntry;
 				Attribute record[ATTRCAT_NO_ATTRS];
-				AttrCacheTable::attrCatEntryToRecord(&attrcatentry,record);
-				RecBuffer attrCatBlock(toDelete->recId.block);
-				attrCatBlock.setRecord(record, toDelete->recId.slot);
+				AttrCacheTable::attrCatEntryToRecord(&entry.attrCatEntry,record);
+				RecBuffer attrCatBlock(entry.recId.block);
+				attrCatBlock.setRecord(record, entry.recId.slot);
 			}
-			current = current->next;
-			free(toDelete);
 		}
-		AttrCacheTable::attrCache[i] = nullptr;
+		AttrCacheTable::clearRelation(i);
 	}
 
 }
 
 
+// returns true if the cached catalog entries of the relation differ from the disk
+bool OpenRelTable::isDirty(int relId)
+{
+	if (RelCacheTable::relCache[relId]->dirty)
+		return true;
+
+	for (AttrCacheEntry &entry : AttrCacheTable::attrCache[relId]->entries)
+	{
+		if (entry.dirty)
+			return true;
+	}
+	return false;
+}
+
 int OpenRelTable::getFreeOpenRelTableEntry()
 {
 
 	/* traverse through the tableMetaInfo array,
 	find a free entry in the Open Relation Table.*/
-	for (int i=0;i<MAX_OPEN;++i)
+	for (int i=0;i<(int)tableMetaInfo.size();++i)
 	{
 		if (tableMetaInfo[i].free==true)
 			return i;
 	}
-	
-	return E_CACHEFULL;
 
-	// if found return the relation id, else return E_CACHEFULL.
+	/* the table is full: evict the least recently used relation that is not
+	pinned by a running query, preferring relations whose catalog entries
+	are clean (closeRel() writes back the dirty ones) */
+	int victim = -1;
+	bool victimDirty = true;
+	for (int i = 2; i < (int)tableMetaInfo.size(); ++i)
+	{
+		if (tableMetaInfo[i].pinCount > 0)
+			continue;
+
+		bool dirty = isDirty(i);
+		if (victim == -1 || (victimDirty && !dirty) ||
+		    (victimDirty == dirty && tableMetaInfo[i].lastAccess < tableMetaInfo[victim].lastAccess))
+		{
+			victim = i;
+			victimDirty = dirty;
+		}
+	}
+
+	if (victim != -1)
+	{
+		OpenRelTable::closeRel(victim);
+		return victim;
+	}
+
+	// every open relation is in use: grow the table by one entry
+	OpenRelTableMetaInfo metaInfo;
+	metaInfo.free = true;
+	metaInfo.pinCount = 0;
+	tableMetaInfo.push_back(metaInfo);
+	RelCacheTable::relCache.push_back(nullptr);
+	AttrCacheTable::attrCache.push_back(nullptr);
+
+	return tableMetaInfo.size() - 1;
 }
 
 int OpenRelTable::getRelId(char relName[ATTR_SIZE])
@@ -191,10 +223,13 @@ int OpenRelTable::getRelId(char relName[ATTR_SIZE])
 	/* traverse through the tableMetaInfo array,
 	find the entry in the Open Relation Table corresponding to relName.*/
 	
-	for(int i=0;i<MAX_OPEN;++i)
+	for(int i=0;i<(int)tableMetaInfo.size();++i)
 	{
 		if(strcmp(relName,tableMetaInfo[i].relName)==0 && tableMetaInfo[i].free==false)
+		{
+			tableMetaInfo[i].lastAccess = ++accessClock;
 			return i;
+		}
 	}
 	return E_RELNOTOPEN;
 
@@ -202,12 +237,68 @@ int OpenRelTable::getRelId(char relName[ATTR_SIZE])
 	// have an entry in the Open Relation Table.
 }
 
+/* returns the rel-id of a relation used by a query. In auto-open mode a
+relation that is not open is opened transparently (and closed again when it is
+evicted or when a DDL command needs it closed). */
+int OpenRelTable::getQueryRelId(char relName[ATTR_SIZE])
+{
+	int relId = OpenRelTable::getRelId(relName);
+	if (relId != E_RELNOTOPEN || !autoOpen)
+		return relId;
+
+	relId = OpenRelTable::openRel(relName);
+	if (relId >= 0)
+		tableMetaInfo[relId].autoOpened = true;
+	return relId;
+}
+
+/* closes relName if it is open only because a query brought it in through
+auto-open, so that commands which need the relation closed can proceed */
+int OpenRelTable::releaseAutoOpened(char relName[ATTR_SIZE])
+{
+	int relId = OpenRelTable::getRelId(relName);
+	if (relId < 0 || !tableMetaInfo[relId].autoOpened || tableMetaInfo[relId].pinCount > 0)
+		return SUCCESS;
+
+	return OpenRelTable::closeRel(relId);
+}
+
+// a pinned relation is never evicted; every pinRel() must be matched by an unpinRel()
+int OpenRelTable::pinRel(int relId)
+{
+	if (relId < 0 || relId >= (int)tableMetaInfo.size())
+		return E_OUTOFBOUND;
+	if (tableMetaInfo[relId].free)
+		return E_RELNOTOPEN;
+
+	tableMetaInfo[relId].pinCount++;
+	return SUCCESS;
+}
+
+int OpenRelTable::unpinRel(int relId)
+{
+	if (relId < 0 || relId >= (int)tableMetaInfo.size())
+		return E_OUTOFBOUND;
+	if (tableMetaInfo[relId].free || tableMetaInfo[relId].pinCount == 0)
+		return E_NOTPERMITTED;
+
+	tableMetaInfo[relId].pinCount--;
+	return SUCCESS;
+}
+
+void OpenRelTable::setAutoOpen(bool enable)
+{
+	autoOpen = enable;
+}
+
 int OpenRelTable::openRel(char relName[ATTR_SIZE])
 {
 	int x=OpenRelTable::getRelId(relName);
 	if(x!=E_RELNOTOPEN)
 	{
 		// (checked using OpenRelTable::getRelId())
+		// an explicit open keeps the relation open even in auto-open mode
+		tableMetaInfo[x].autoOpened=false;
 		// return that relation id;
 		return x;
 	}
@@ -226,21 +317,13 @@ int OpenRelTable::openRel(char relName[ATTR_SIZE])
 
 	/****** Setting up Relation Cache entry for the relation ******/
 
-	/* search for the entry with relation name, relName, in the Relation Catalog using
-	BlockAccess::linearSearch().
-	Care should be taken to reset the searchIndex of the relation RELCAT_RELID
-	before calling linearSearch().*/
-	char attrName[ATTR_SIZE];
-	strcpy(attrName,"RelName");
-	Attribute attrVal;
-	strcpy(attrVal.sVal,relName);
-	RelCacheTable::resetSearchIndex(RELCAT_RELID);
-	// relcatRecId stores the rec-id of the relation `relName` in the Relation Catalog.
-	RecId relcatRecId=BlockAccess::linearSearch(RELCAT_RELID, attrName, attrVal, EQ);
-
-	
-
-	if (relcatRecId.block==-1 && relcatRecId.slot==-1)
+	/* get the rec-id of the relation `relName` in the Relation Catalog and of
+	its attributes in the Attribute Catalog from the catalog directory
+	(no linear search of the catalog is needed) */
+	RecId relcatRecId;
+	std::vector<RecId> attrcatRecIds;
+	if (CatalogDirectory::getRelCatRecId(relName, &relcatRecId) != SUCCESS ||
+	    CatalogDirectory::getAttrCatRecIds(relName, &attrcatRecIds) != SUCCESS)
 	{
 		// (the relation is not found in the Relation Catalog.)
 		return E_RELNOTEXIST;
@@ -261,49 +344,41 @@ int OpenRelTable::openRel(char relName[ATTR_SIZE])
 	relcacheEntry->recId.block=relcatRecId.block;
 	relcacheEntry->recId.slot=relcatRecId.slot;
 	relcacheEntry->dirty=false;
+	relcacheEntry->freeBlk=-1;
 	
-	//RelCacheTable::relCache[relId] = (struct RelCacheEntry*)malloc(sizeof(RelCacheEntry));
 	RelCacheTable::relCache[relId] = relcacheEntry;
+	RelCacheTable::resetSearchIndex(relId);
 	
 
 	/****** Setting up Attribute Cache entry for the relation ******/
 
-	// let listHead be used to hold the head of the linked list of attrCache entries.
-	AttrCacheEntry* listHead=nullptr;
-	RecId attrcatRecId;
-	RelCacheTable::resetSearchIndex(ATTRCAT_RELID);
-	/*iterate over all the entries in the Attribute Catalog corresponding to each
-	attribute of the relation relName by multiple calls of BlockAccess::linearSearch()
-	care should be taken to reset the searchIndex of the relation, ATTRCAT_RELID,
-	corresponding to Attribute Catalog before the first call to linearSearch().*/
-	while((attrcatRecId=BlockAccess::linearSearch(ATTRCAT_RELID,attrName,attrVal,EQ)).block!=-1)
+	/* read the Attribute Catalog record at each rec-id (in offset order) and
+	create an Attribute Cache entry on it using RecBuffer::getRecord() and
+	AttrCacheTable::recordToAttrCatEntry() */
+	std::vector<AttrCacheEntry> attrcacheEntries;
+	for (RecId attrcatRecId : attrcatRecIds)
 	{
-	
-		/* let attrcatRecId store a valid record id an entry of the relation, relName,
-		in the Attribute Catalog.*/
-		
-
-		/* read the record entry corresponding to attrcatRecId and create an
-		Attribute Cache entry on it using RecBuffer::getRecord() and
-		AttrCacheTable::recordToAttrCatEntry().
-		update the recId field of this Attribute Cache entry to attrcatRecId.
-		add the Attribute Cache entry to the linked list of listHead .*/
-		// NOTE: make sure to allocate memory for the AttrCacheEntry using malloc()
-		
 		Attribute Record[NO_OF_ATTRS_RELCAT_ATTRCAT];
-		AttrCacheEntry* attrcacheEntry=(AttrCacheEntry*)malloc(sizeof(AttrCacheEntry));
+		AttrCacheEntry attrcacheEntry;
 		
 		RecBuffer recbuffer(attrcatRecId.block);
 		recbuffer.getRecord(Record, attrcatRecId.slot);
-		AttrCacheTable::recordToAttrCatEntry(Record,&(attrcacheEntry->attrCatEntry));
-		attrcacheEntry->recId.block=attrcatRecId.block;
-		attrcacheEntry->recId.slot=attrcatRecId.slot;
-		attrcacheEntry->dirty=false;
-		attrcacheEntry->next=listHead;
-		listHead=attrcacheEntry;
+		AttrCacheTable::recordToAttrCatEntry(Record,&(attrcacheEntry.attrCatEntry));
+		attrcacheEntry.recId.block=attrcatRecId.block;
+		attrcacheEntry.recId.slot=attrcatRecId.slot;
+		attrcacheEntry.dirty=false;
+		attrcacheEntry.searchIndex=IndexId{-1, -1, -1, -1};
+		attrcacheEntries.push_back(attrcacheEntry);
+	}
+	// set the relIdth entry of the AttrCacheTable (the entries are stored by
+	// offset and hashed by name)
+	int ret = AttrCacheTable::setRelation(relId, attrcacheEntries);
+	if (ret != SUCCESS)
+	{
+		free(RelCacheTable::relCache[relId]);
+		RelCacheTable::relCache[relId] = nullptr;
+		return ret;
 	}
-	AttrCacheTable::attrCache[relId]=listHead;
-	// set the relIdth entry of the AttrCacheTable to listHead.
 
 	/****** Setting up metadata in the Open Relation Table for the relation******/
 	// update the relIdth entry of the tableMetaInfo with free as false and
@@ -311,6 +386,9 @@ int OpenRelTable::openRel(char relName[ATTR_SIZE])
 	
 	OpenRelTable::tableMetaInfo[relId].free=false;
 	strcpy(OpenRelTable::tableMetaInfo[relId].relName,relName);
+	OpenRelTable::tableMetaInfo[relId].pinCount=0;
+	OpenRelTable::tableMetaInfo[relId].lastAccess=++accessClock;
+	OpenRelTable::tableMetaInfo[relId].autoOpened=false;
 	return relId;
 }
 
@@ -322,7 +400,7 @@ int OpenRelTable::closeRel(int relId)
 		return E_NOTPERMITTED;
 	}
 
-	if (relId < 0 || relId >= MAX_OPEN)
+	if (relId < 0 || relId >= (int)tableMetaInfo.size())
 	{
 		return E_OUTOFBOUND;
 	}
@@ -333,23 +411,17 @@ int OpenRelTable::closeRel(int relId)
 	}
 
 	
-	AttrCacheEntry* current = AttrCacheTable::attrCache[relId];
-	while (current != nullptr)
+	for (AttrCacheEntry &current : AttrCacheTable::attrCache[relId]->entries)
 	{
-		if(current->dirty)
+		if(current.dirty)
 		{
-			//AttrCatEntry attrCatBuf;
-			//AttrCacheTable::getAttrCatEntry(relId, current->attrCatEntry.attrName, &attrCatBuf);
 			Attribute record[ATTRCAT_NO_ATTRS];
-			AttrCacheTable::attrCatEntryToRecord(&current->attrCatEntry, record);
+			AttrCacheTable::attrCatEntryToRecord(&current.attrCatEntry, record);
 			
-			RecBuffer buff(current->recId.block);
-			buff.setRecord(record,current->recId.slot);
+			RecBuffer buff(current.recId.block);
+			buff.setRecord(record,current.recId.slot);
 			
 		}
-		AttrCacheEntry* temp = current;
-		current = current->next;
-		free(temp);
 	}
 	
 	if (RelCacheTable::relCache[relId]->dirty==true)
@@ -368,7 +440,7 @@ int OpenRelTable::closeRel(int relId)
 	tableMetaInfo[relId].free = true;
 	tableMetaInfo[relId].relName[0]='\0';
 	RelCacheTable::relCache[relId] = nullptr;
-	AttrCacheTable::attrCache[relId] = nullptr;
+	AttrCacheTable::clearRelation(relId);
 	
 
 	return SUCCESS;
@@ -1,15 +1,21 @@
 #ifndef NITCBASE_OPENRELTABLE_H
 #define NITCBASE_OPENRELTABLE_H
 
+#include <vector>
+
 #include "../BlockAccess/BlockAccess.h"
 #include "../Buffer/BlockBuffer.h"
 #include "../define/constants.h"
 #include "AttrCacheTable.h"
+#include "CatalogDirectory.h"
 #include "RelCacheTable.h"
 
 typedef struct OpenRelTableMetaInfo {
   bool free;
   char relName[ATTR_SIZE];
+  int pinCount;              // number of operators of running queries using the relation
+  unsigned long lastAccess;  // value of the access clock when the relation was last used
+  bool autoOpened;           // opened implicitly by a query in auto-open mode
 
 } OpenRelTableMetaInfo;
 
@@ -19,15 +25,23 @@ class OpenRelTable {
   OpenRelTable();
   ~OpenRelTable();
   static int getRelId(char relName[ATTR_SIZE]);
+  static int getQueryRelId(char relName[ATTR_SIZE]);
   static int openRel(char relName[ATTR_SIZE]);
   static int closeRel(int relId);
+  static int releaseAutoOpened(char relName[ATTR_SIZE]);
+  static int pinRel(int relId);
+  static int unpinRel(int relId);
+  static void setAutoOpen(bool enable);
 
  private:
   // field
-  static OpenRelTableMetaInfo tableMetaInfo[MAX_OPEN];
+  static std::vector<OpenRelTableMetaInfo> tableMetaInfo;
+  static unsigned long accessClock;
+  static bool autoOpen;
 
   // method
   static int getFreeOpenRelTableEntry();
+  static bool isDirty(int relId);
 };
 
 #endif  // NITCBASE_OPENRELTABLE_H
@@ -1,7 +1,7 @@
 #include "RelCacheTable.h"
 #include <cstring>
 
-RelCacheEntry* RelCacheTable::relCache[MAX_OPEN];
+std::vector<RelCacheEntry *> RelCacheTable::relCache;
 
 /*
 Get the relation catalog entry for the relation with rel-id `relId` from the cache
@@ -10,7 +10,7 @@ NOTE: this function expects the caller to allocate memory for `*relCatBuf`
 
 int RelCacheTable::getRelCatEntry(int relId, RelCatEntry* relCatBuf)
 {
-	if (relId < 0 || relId >= MAX_OPEN)
+	if (relId < 0 || relId >= (int)relCache.size())
 		return E_OUTOFBOUND;
 
 	// if there's no entry at the rel-id
@@ -46,8 +46,8 @@ NOTE: this function expects the caller to allocate memory for `*searchIndex`
 */
 int RelCacheTable::getSearchIndex(int relId, RecId* searchIndex)
 {
-	// check if 0 <= relId < MAX_OPEN and return E_OUTOFBOUND otherwise
-	if (relId<0 || relId>=MAX_OPEN)
+	// check if 0 <= relId < size of the cache and return E_OUTOFBOUND otherwise
+	if (relId<0 || relId >= (int)relCache.size())
 		return E_OUTOFBOUND;
 
 	// check if relCache[relId] == nullptr and return E_RELNOTOPEN if true
@@ -64,8 +64,8 @@ int RelCacheTable::getSearchIndex(int relId, RecId* searchIndex)
 int RelCacheTable::setSearchIndex(int relId, RecId* searchIndex)
 {
 
-	// check if 0 <= relId < MAX_OPEN and return E_OUTOFBOUND otherwise
-	if (relId<0 || relId>=MAX_OPEN)
+	// check if 0 <= relId < size of the cache and return E_OUTOFBOUND otherwise
+	if (relId<0 || relId >= (int)relCache.size())
 		return E_OUTOFBOUND;
 
 	// check if relCache[relId] == nullptr and return E_RELNOTOPEN if true
@@ -85,10 +85,36 @@ int RelCacheTable::resetSearchIndex(int relId)
 	 return setSearchIndex(relId,&temp);
 }
 
+/* the block from which BlockAccess::insert() looks for a free slot. Blocks
+before it are known to be full; any operation that frees a slot resets it
+to -1 (the first block of the relation). */
+int RelCacheTable::getFreeBlock(int relId, int *blockNum)
+{
+	if (relId<0 || relId >= (int)relCache.size())
+		return E_OUTOFBOUND;
+
+	if (relCache[relId] == nullptr)
+		return E_RELNOTOPEN;
+
+	*blockNum = relCache[relId]->freeBlk;
+	return SUCCESS;
+}
+
+int RelCacheTable::setFreeBlock(int relId, int blockNum)
+{
+	if (relId<0 || relId >= (int)relCache.size())
+		return E_OUTOFBOUND;
+
+	if (relCache[relId] == nullptr)
+		return E_RELNOTOPEN;
+
+	relCache[relId]->freeBlk = blockNum;
+	return SUCCESS;
+}
 
 int RelCacheTable::setRelCatEntry(int relId, RelCatEntry *relCatBuf)
 {
-	if(relId<0 || relId>=MAX_OPEN) 
+	if(relId<0 || relId >= (int)relCache.size()) 
 	{
 		return E_OUTOFBOUND;
 	}
@@ -1,6 +1,8 @@
 #ifndef NITCBASE_RELCACHETABLE_H
 #define NITCBASE_RELCACHETABLE_H
 
+#include <vector>
+
 #include "../Buffer/BlockBuffer.h"
 #include "../define/constants.h"
 #include "../define/id.h"
@@ -20,6 +22,8 @@ typedef struct RelCacheEntry {
   bool dirty;
   RecId recId;
   RecId searchIndex;
+  // no record block before freeBlk has a free slot (-1: start from firstBlk)
+  int freeBlk;
 
 } RelCacheEntry;
 
@@ -33,10 +37,13 @@ class RelCacheTable {
   static int getSearchIndex(int relId, RecId *searchIndex);
   static int setSearchIndex(int relId, RecId *searchIndex);
   static int resetSearchIndex(int relId);
+  static int getFreeBlock(int relId, int *blockNum);
+  static int setFreeBlock(int relId, int blockNum);
 
  private:
   // field
-  static RelCacheEntry *relCache[MAX_OPEN];
+  // one entry per slot of the open relation table (grown by OpenRelTable)
+  static std::vector<RelCacheEntry *> relCache;
 
   // methods
   static void recordToRelCatEntry(union Attribute record[RELCAT_NO_ATTRS], RelCatEntry *relCatEntry);
@@ -0,0 +1,218 @@
+#include "ZoneMap.h"
+
+#include <cstring>
+
+#include "AttrCacheTable.h"
+#include "RelCacheTable.h"
+
+std::unordered_map<std::string, ZoneMap> ZoneMap::zoneMaps;
+
+static std::string key(char relName[ATTR_SIZE])
+{
+	return std::string(relName, strnlen(relName, ATTR_SIZE));
+}
+
+/* builds the zone map of the open relation at relId from a scan of its record
+blocks, replacing any existing one */
+int ZoneMap::create(int relId)
+{
+	RelCatEntry relCatEntry;
+	int ret = RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	ZoneMap zoneMap;
+	for (int offset = 0; offset < relCatEntry.numAttrs; ++offset)
+	{
+		AttrCatEntry attrCatEntry;
+		AttrCacheTable::getAttrCatEntry(relId, offset, &attrCatEntry);
+		zoneMap.attrTypes.push_back(attrCatEntry.attrType);
+	}
+
+	int prevBlock = -1;
+	int block = relCatEntry.firstBlk;
+	while (block != -1)
+	{
+		RecBuffer recBuffer(block);
+		HeadInfo head;
+		unsigned char *slotMap, *records;
+		recBuffer.getBlockContents(&head, &slotMap, &records);
+
+		zoneMap.addBlock(prevBlock, block);
+		for (int slot = 0; slot < head.numSlots; ++slot)
+		{
+			if (slotMap[slot] == SLOT_UNOCCUPIED)
+				continue;
+
+			Attribute record[head.numAttrs];
+			memcpy(record, records + slot * head.numAttrs * ATTR_SIZE, head.numAttrs * ATTR_SIZE);
+			zoneMap.addRecord(block, record);
+		}
+
+		prevBlock = block;
+		block = head.rblock;
+	}
+
+	zoneMaps[key(relCatEntry.relName)] = zoneMap;
+	return SUCCESS;
+}
+
+int ZoneMap::drop(char relName[ATTR_SIZE])
+{
+	// (a zone map is reported like a missing index)
+	if (zoneMaps.erase(key(relName)) == 0)
+		return E_NOINDEX;
+	return SUCCESS;
+}
+
+// returns the zone map of relName, or nullptr if it has none
+ZoneMap *ZoneMap::get(char relName[ATTR_SIZE])
+{
+	auto it = zoneMaps.find(key(relName));
+	if (it == zoneMaps.end())
+		return nullptr;
+	return &it->second;
+}
+
+void ZoneMap::removeRelation(char relName[ATTR_SIZE])
+{
+	zoneMaps.erase(key(relName));
+}
+
+void ZoneMap::renameRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE])
+{
+	auto it = zoneMaps.find(key(oldName));
+	if (it == zoneMaps.end())
+		return;
+
+	ZoneMap zoneMap = it->second;
+	zoneMaps.erase(it);
+	zoneMaps[key(newName)] = zoneMap;
+}
+
+/* a new (empty) record block was linked after prevBlock (-1 if it is the
+first block of the relation) */
+void ZoneMap::addBlock(int prevBlock, int block)
+{
+	BlockZone zone;
+	zone.nextBlock = -1;
+	zone.numRecords = 0;
+	zone.min.resize(attrTypes.size());
+	zone.max.resize(attrTypes.size());
+	zones[block] = zone;
+
+	auto prev = zones.find(prevBlock);
+	if (prev != zones.end())
+		prev->second.nextBlock = block;
+}
+
+// widens the ranges of block to include record
+void ZoneMap::addRecord(int block, union Attribute *record)
+{
+	auto it = zones.find(block);
+	if (it == zones.end())
+		return;
+
+	BlockZone &zone = it->second;
+	for (int i = 0; i < (int)attrTypes.size(); ++i)
+	{
+		Attribute value = record[i];
+		if (attrTypes[i] == STRING)
+		{
+			// keep only the prefix of the string
+			value.sVal[ZONEMAP_PREFIX_LEN] = '\0';
+		}
+
+		if (zone.numRecords == 0 || compareAttrs(value, zone.min[i], attrTypes[i]) < 0)
+			zone.min[i] = value;
+		if (zone.numRecords == 0 || compareAttrs(value, zone.max[i], attrTypes[i]) > 0)
+			zone.max[i] = value;
+	}
+	zone.numRecords++;
+}
+
+/* returns false only if no record of block can satisfy `attr op attrVal`
+(blocks that are not in the zone map may contain anything) */
+bool ZoneMap::mayContain(int block, int attrOffset, union Attribute attrVal, int op)
+{
+	auto it = zones.find(block);
+	if (it == zones.end())
+		return true;
+
+	BlockZone &zone = it->second;
+	if (zone.numRecords == 0)
+		return false;
+
+	int cmpMin, cmpMax;
+	if (attrTypes[attrOffset] == STRING)
+	{
+		/* a value that compares below (above) attrVal has a prefix that
+		compares at most (at least) equal to the prefix of attrVal, so the
+		prefixes can only rule a block out when they differ */
+		cmpMin = strncmp(zone.min[attrOffset].sVal, attrVal.sVal, ZONEMAP_PREFIX_LEN);
+		cmpMax = strncmp(zone.max[attrOffset].sVal, attrVal.sVal, ZONEMAP_PREFIX_LEN);
+		if (op == NE)
+			return true;
+		if (op == LT || op == LE)
+			return cmpMin <= 0;
+		if (op == GT || op == GE)
+			return cmpMax >= 0;
+		return cmpMin <= 0 && cmpMax >= 0;
+	}
+
+	cmpMin = compareAttrs(zone.min[attrOffset], attrVal, NUMBER);
+	cmpMax = compareAttrs(zone.max[attrOffset], attrVal, NUMBER);
+	switch (op)
+	{
+	case EQ:
+		return cmpMin <= 0 && cmpMax >= 0;
+	case LT:
+		return cmpMin < 0;
+	case LE:
+		return cmpMin <= 0;
+	case GT:
+		return cmpMax > 0;
+	case GE:
+		return cmpMax >= 0;
+	default:
+		// NE fails only if every value in the block equals attrVal
+		return !(cmpMin == 0 && cmpMax == 0);
+	}
+}
+
+/* the block after block in the relation; for a block that is not in the zone
+map, the rblock of its header (-1 if it cannot be read) */
+int ZoneMap::getNextBlock(int block)
+{
+	auto it = zones.find(block);
+	if (it != zones.end())
+		return it->second.nextBlock;
+
+	if (block < 0 || block >= DISK_BLOCKS)
+		return -1;
+	RecBuffer recBuffer(block);
+	HeadInfo head;
+	if (recBuffer.getHeader(&head) != SUCCESS)
+		return -1;
+	return head.rblock;
+}
+
+/* the range of attrOffset over all the blocks of the relation (E_NOTFOUND if
+no block holds a record); for STRING attributes only the prefixes are known */
+int ZoneMap::getRange(int attrOffset, union Attribute *min, union Attribute *max)
+{
+	bool found = false;
+	for (auto &it : zones)
+	{
+		BlockZone &zone = it.second;
+		if (zone.numRecords == 0)
+			continue;
+
+		if (!found || compareAttrs(zone.min[attrOffset], *min, attrTypes[attrOffset]) < 0)
+			*min = zone.min[attrOffset];
+		if (!found || compareAttrs(zone.max[attrOffset], *max, attrTypes[attrOffset]) > 0)
+			*max = zone.max[attrOffset];
+		found = true;
+	}
+	return found ? SUCCESS : E_NOTFOUND;
+}
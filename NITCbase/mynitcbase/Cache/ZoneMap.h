@@ -0,0 +1,53 @@
+#ifndef NITCBASE_ZONEMAP_H
+#define NITCBASE_ZONEMAP_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Buffer/BlockBuffer.h"
+#include "../define/constants.h"
+
+typedef struct BlockZone {
+  int nextBlock;  // rblock of the block, so that a skipped block is not loaded
+  int numRecords;  // records that contributed to the range (0: no range yet)
+  std::vector<Attribute> min;  // STRING values are cut to ZONEMAP_PREFIX_LEN characters
+  std::vector<Attribute> max;
+
+} BlockZone;
+
+/*
+ * Zone map of a relation: the range of values of every attribute over the
+ * records of each record block. A search can skip every block whose range
+ * cannot satisfy its condition. For STRING attributes only a prefix range is
+ * kept. Zone maps are optional (CREATE ZONEMAP ON rel) and widened by
+ * BlockAccess on every insert and update.
+ *
+ * A zone map lives in memory only, keyed by relation name, until the end of
+ * the session. It is not written to the disk, so it is lost on restart and
+ * has to be created again. DELETE and UPDATE never narrow a range: the ranges
+ * may become wider than necessary, but they stay correct. VACUUM and CLUSTER
+ * rebuild the zone map of the relation.
+ */
+class ZoneMap {
+ public:
+  static int create(int relId);
+  static int drop(char relName[ATTR_SIZE]);
+  static ZoneMap *get(char relName[ATTR_SIZE]);
+  static void removeRelation(char relName[ATTR_SIZE]);
+  static void renameRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE]);
+
+  void addBlock(int prevBlock, int block);
+  void addRecord(int block, union Attribute *record);
+  bool mayContain(int block, int attrOffset, union Attribute attrVal, int op);
+  int getNextBlock(int block);
+  int getRange(int attrOffset, union Attribute *min, union Attribute *max);
+
+ private:
+  std::vector<int> attrTypes;
+  std::unordered_map<int, BlockZone> zones;
+
+  static std::unordered_map<std::string, ZoneMap> zoneMaps;
+};
+
+#endif  // NITCBASE_ZONEMAP_H
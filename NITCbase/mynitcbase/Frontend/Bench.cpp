@@ -0,0 +1,1122 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/* FUNCTION SORTBENCH relname attrname [DESC]
+sorts an open relation on an attribute with the external merge sort, checks
+that the output is ordered and reports the runs, merge passes and time taken */
+int Bench::sort_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], bool desc) {
+  Operator *scan;
+  int ret = Algebra::buildScan(relname, &scan);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  char keys[1][ATTR_SIZE];
+  strcpy(keys[0], attrname);
+  SortOp sort(scan, 1, keys, desc, false);
+
+  auto start = std::chrono::steady_clock::now();
+  ret = sort.open();
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  int numAttrs = sort.getNumAttrs();
+  int offset = sort.getAttrOffset(attrname);
+  int type = sort.getAttrType(offset);
+  Attribute record[numAttrs];
+  Attribute prev;
+  int numRecords = 0;
+  bool ordered = true;
+  while (sort.next(record) == SUCCESS) {
+    if (numRecords > 0) {
+      int cmpVal = compareAttrs(prev, record[offset], type);
+      ordered = ordered && (desc ? cmpVal >= 0 : cmpVal <= 0);
+    }
+    prev = record[offset];
+    numRecords++;
+  }
+  sort.close();
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << "Sorted " << numRecords << " records in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms ("
+            << sort.getNumRuns() << " runs, " << sort.getNumPasses() << " merge passes), output "
+            << (ordered ? "is" : "is NOT") << " ordered" << std::endl;
+
+  return ordered ? SUCCESS : FAILURE;
+}
+
+// returns the operator named opname (one of EQ, NE, LT, LE, GT, GE) or -1
+static int op_from_name(char opname[ATTR_SIZE]) {
+  const char *opNames[] = {"EQ", "NE", "LT", "LE", "GT", "GE"};
+  const int ops[] = {EQ, NE, LT, LE, GT, GE};
+  for (int i = 0; i < 6; ++i) {
+    if (strcmp(opname, opNames[i]) == 0) {
+      return ops[i];
+    }
+  }
+  return -1;
+}
+
+/* times a linear search of the whole relation for `attr op value` (op is one
+   of EQ, NE, LT, LE, GT, GE) and reports the cost per record visited */
+int Bench::scan_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], char opname[ATTR_SIZE],
+                          char value[ATTR_SIZE]) {
+  int op = op_from_name(opname);
+  if (op == -1) {
+    return E_INVALID;
+  }
+
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  AttrCatEntry attrCatEntry;
+  int ret = AttrCacheTable::getAttrCatEntry(relId, attrname, &attrCatEntry);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  Attribute attrVal;
+  if (attrCatEntry.attrType == NUMBER) {
+    attrVal.nVal = atof(value);
+  } else {
+    strcpy(attrVal.sVal, value);
+  }
+
+  RelCatEntry relCatEntry;
+  RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+
+  RelCacheTable::resetSearchIndex(relId);
+  int numMatches = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (BlockAccess::linearSearch(relId, attrname, attrVal, op).block != -1) {
+    numMatches++;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  std::cout << "Scanned " << relCatEntry.numRecs << " records (" << numMatches << " matches) in "
+            << ns / 1000000 << " ms, " << (relCatEntry.numRecs > 0 ? ns / relCatEntry.numRecs : 0)
+            << " ns per record" << std::endl;
+
+  return SUCCESS;
+}
+
+// drains an operator tree and returns the values of its first attribute (sorted)
+static int drain_first_attr(Operator *root, std::vector<std::string> &values, long long *ns) {
+  auto start = std::chrono::steady_clock::now();
+  int ret = root->open();
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  int type = root->getAttrType(0);
+  Attribute record[root->getNumAttrs()];
+  while ((ret = root->next(record)) == SUCCESS) {
+    values.push_back(type == NUMBER ? std::to_string(record[0].nVal) : std::string(record[0].sVal));
+  }
+  root->close();
+  auto end = std::chrono::steady_clock::now();
+  *ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+  std::sort(values.begin(), values.end());
+  return ret == E_NOTFOUND ? SUCCESS : ret;
+}
+
+/* FUNCTION INDEXONLYBENCH relname attrname op value
+   runs `SELECT attr FROM rel WHERE attr op value` once through the B+ tree and
+   the record blocks, and once from the leaves of the index alone, checks
+   that both return the same values and reports the time of each */
+int Bench::index_only_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], char opname[ATTR_SIZE],
+                                char value[ATTR_SIZE]) {
+  int op = op_from_name(opname);
+  if (op == -1) {
+    return E_INVALID;
+  }
+
+  char attrs[1][ATTR_SIZE];
+  strcpy(attrs[0], attrname);
+
+  Predicate where = comparison(attrname, op, value);
+  Operator *select;
+  int ret = Algebra::buildSelect(relname, &where, &select);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  select = new ProjectOp(select, 1, attrs);
+
+  Operator *indexOnly;
+  ret = Algebra::buildIndexOnlyScan(relname, &where, 1, attrs, &indexOnly);
+  if (ret != SUCCESS) {
+    delete select;
+    return ret;
+  }
+
+  std::vector<std::string> selected, indexed;
+  long long selectNs, indexNs;
+  ret = drain_first_attr(select, selected, &selectNs);
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(indexOnly, indexed, &indexNs);
+  }
+  delete select;
+  delete indexOnly;
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  bool same = selected == indexed;
+  std::cout << selected.size() << " values: index + records " << selectNs / 1000 << " us, index only "
+            << indexNs / 1000 << " us (" << (indexNs > 0 ? (double)selectNs / indexNs : 0) << "x), results "
+            << (same ? "match" : "DIFFER") << std::endl;
+
+  return same ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION RANGEBENCH relname attrname low high
+   selects the records with low <= attr < high from the B+ tree of attr, once
+   with a search for attr >= low whose results are filtered on attr < high,
+   once with a single range scan fetching the records in key order, and once
+   with the range scan fetching them in block order through a bitmap. Checks
+   that all three return the same records and reports the time and disk reads
+   of each */
+int Bench::range_scan_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], char low[ATTR_SIZE],
+                                char high[ATTR_SIZE]) {
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  AttrCatEntry attrCatEntry;
+  int ret = AttrCacheTable::getAttrCatEntry(relId, attrname, &attrCatEntry);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  if (attrCatEntry.rootBlock == -1) {
+    return E_NOINDEX;
+  }
+
+  Attribute lowVal, highVal;
+  if (attrCatEntry.attrType == NUMBER) {
+    lowVal.nVal = atof(low);
+    highVal.nVal = atof(high);
+  } else {
+    strcpy(lowVal.sVal, low);
+    strcpy(highVal.sVal, high);
+  }
+
+  Predicate below = comparison(attrname, LT, high);
+  Operator *filtered = new FilterOp(new SelectScanOp(relId, attrname, GE, lowVal), &below);
+  Operator *range = new IndexScanOp(relId, attrname, GE, lowVal, LT, highVal);
+  IndexScanOp *bitmap = new IndexScanOp(relId, attrname, GE, lowVal, LT, highVal);
+  bitmap->setBitmapFetch(true);
+
+  std::vector<std::string> rangeValues, filteredValues, bitmapValues;
+  long long rangeNs, filteredNs, bitmapNs;
+  long long readsBefore = StaticBuffer::getNumDiskReads();
+  ret = drain_first_attr(range, rangeValues, &rangeNs);
+  long long readsRange = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(filtered, filteredValues, &filteredNs);
+  }
+  long long readsFiltered = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(bitmap, bitmapValues, &bitmapNs);
+  }
+  long long readsBitmap = StaticBuffer::getNumDiskReads();
+  delete filtered;
+  delete range;
+  delete bitmap;
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  bool same = rangeValues == filteredValues && rangeValues == bitmapValues;
+  std::cout << rangeValues.size() << " records: search + filter " << filteredNs / 1000 << " us, "
+            << readsFiltered - readsRange << " disk reads; range scan " << rangeNs / 1000 << " us, "
+            << readsRange - readsBefore << " disk reads (" << (rangeNs > 0 ? (double)filteredNs / rangeNs : 0)
+            << "x); bitmap fetch " << bitmapNs / 1000 << " us, " << readsBitmap - readsFiltered
+            << " disk reads, results " << (same ? "match" : "DIFFER") << std::endl;
+
+  return same ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION ANDBENCH relname attr1 op1 value1 attr2 op2 value2
+   selects the records with attr1 op1 value1 AND attr2 op2 value2, once from
+   the index of attr1 with the second comparison as a filter, and once with
+   the plan chosen for the whole condition (which may intersect the RecIds of
+   both indexes). Checks that both return the same records and reports the
+   time and disk reads of each */
+int Bench::and_benchmark(char relname[ATTR_SIZE], char argv[][ATTR_SIZE]) {
+  int op1 = op_from_name(argv[1]), op2 = op_from_name(argv[4]);
+  if (op1 == -1 || op2 == -1) {
+    return E_INVALID;
+  }
+
+  Predicate where;
+  where.type = PRED_AND;
+  where.children.push_back(comparison(argv[0], op1, argv[2]));
+  where.children.push_back(comparison(argv[3], op2, argv[5]));
+
+  Operator *single;
+  int ret = Algebra::buildSelect(relname, &where.children[0], &single);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  single = new FilterOp(single, &where.children[1]);
+
+  Operator *planned;
+  ret = Algebra::buildSelect(relname, &where, &planned);
+  if (ret != SUCCESS) {
+    delete single;
+    return ret;
+  }
+
+  std::vector<std::string> plannedValues, singleValues;
+  long long plannedNs, singleNs;
+  long long readsBefore = StaticBuffer::getNumDiskReads();
+  ret = drain_first_attr(single, singleValues, &singleNs);
+  long long readsMiddle = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(planned, plannedValues, &plannedNs);
+  }
+  long long readsAfter = StaticBuffer::getNumDiskReads();
+  delete single;
+  delete planned;
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  bool same = plannedValues == singleValues;
+  std::cout << plannedValues.size() << " records: one index + filter " << singleNs / 1000 << " us, "
+            << readsMiddle - readsBefore << " disk reads; planned " << plannedNs / 1000 << " us, "
+            << readsAfter - readsMiddle << " disk reads, results " << (same ? "match" : "DIFFER") << std::endl;
+
+  return same ? SUCCESS : FAILURE;
+}
+
+/* checks the invariants of the B+ tree of relname.attrname */
+int Bench::bplus_check(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  int numEntries, numBlocks, numPostingBlocks;
+  int ret = BPlusTree::bPlusCheck(relId, attrname, &numEntries, &numBlocks, &numPostingBlocks);
+  if (ret == SUCCESS) {
+    std::cout << "B+ tree on " << relname << "." << attrname << " is consistent (" << numEntries
+              << " entries in " << numBlocks << " blocks, " << numPostingBlocks << " of them posting lists)"
+              << std::endl;
+  }
+  return ret;
+}
+
+// finds the composite index of relname whose key starts with attrNames (in that order)
+static int find_composite_index(char relname[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE], int *relId,
+                                CompositeIndexInfo *index) {
+  *relId = OpenRelTable::getQueryRelId(relname);
+  if (*relId < 0) {
+    return *relId;
+  }
+
+  int keyOffsets[numAttrs];
+  for (int i = 0; i < numAttrs; ++i) {
+    AttrCatEntry attrCatEntry;
+    if (AttrCacheTable::getAttrCatEntry(*relId, attrNames[i], &attrCatEntry) != SUCCESS) {
+      return E_ATTRNOTEXIST;
+    }
+    keyOffsets[i] = attrCatEntry.offset;
+  }
+
+  std::vector<CompositeIndexInfo> indexes;
+  CompositeIndex::getIndexes(*relId, &indexes);
+  for (CompositeIndexInfo &candidate : indexes) {
+    if (candidate.numKeys >= numAttrs && memcmp(candidate.keyOffsets, keyOffsets, numAttrs * sizeof(int)) == 0) {
+      *index = candidate;
+      return SUCCESS;
+    }
+  }
+  return E_NOINDEX;
+}
+
+/* FUNCTION CINDEXCHECK relname attr1 attr2 ...
+   checks the invariants of the composite index on relname.(attr1, attr2, ...) */
+int Bench::composite_index_check(char relname[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE]) {
+  int relId;
+  CompositeIndexInfo index;
+  int ret = find_composite_index(relname, numAttrs, attrNames, &relId, &index);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  if (index.numKeys != numAttrs) {
+    return E_NOINDEX;
+  }
+
+  int numEntries, numBlocks, height;
+  ret = CompositeIndex::check(relId, &index, &numEntries, &numBlocks, &height);
+  if (ret == SUCCESS) {
+    std::cout << "Composite index is consistent (" << numEntries << " entries in " << numBlocks
+              << " blocks, height " << height << ", "
+              << CompositeIndex::leafCapacity(index.numKeys, index.compressed) << " entries per leaf, "
+              << CompositeIndex::internalCapacity(index.numKeys, index.compressed) << " keys per internal block)"
+              << std::endl;
+  }
+  return ret;
+}
+
+/* FUNCTION CINDEXSEARCH relname op attr1 value1 [attr2 value2 ...]
+   counts the records whose (attr1, attr2, ...) compare with (value1, value2,
+   ...) as op says, once through a composite index whose key starts with those
+   attributes and once with a scan of the relation, and checks that both
+   find the same records */
+int Bench::composite_index_search(char relname[ATTR_SIZE], char opname[ATTR_SIZE], int numAttrs,
+                                  char args[][ATTR_SIZE]) {
+  int op = op_from_name(opname);
+  if (op == -1 || numAttrs < 1) {
+    return E_INVALID;
+  }
+
+  char attrNames[numAttrs][ATTR_SIZE];
+  for (int i = 0; i < numAttrs; ++i) {
+    strcpy(attrNames[i], args[2 * i]);
+  }
+
+  int relId;
+  CompositeIndexInfo index;
+  int ret = find_composite_index(relname, numAttrs, attrNames, &relId, &index);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  Attribute searchKey[numAttrs];
+  for (int i = 0; i < numAttrs; ++i) {
+    if (index.keyTypes[i] == NUMBER) {
+      searchKey[i].nVal = atof(args[2 * i + 1]);
+    } else {
+      strcpy(searchKey[i].sVal, args[2 * i + 1]);
+    }
+  }
+
+  std::vector<std::pair<int, int>> indexed, scanned;
+  auto start = std::chrono::steady_clock::now();
+  IndexId cursor = {-1, -1, -1, -1};
+  RecId recId;
+  while (CompositeIndex::search(&index, numAttrs, searchKey, op, &cursor, &recId) == SUCCESS) {
+    indexed.push_back({recId.block, recId.slot});
+  }
+  auto mid = std::chrono::steady_clock::now();
+
+  RelCatEntry relCatEntry;
+  RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+  Attribute record[relCatEntry.numAttrs];
+  for (int block = relCatEntry.firstBlk; block != -1;) {
+    RecBuffer recBuffer(block);
+    HeadInfo head;
+    recBuffer.getHeader(&head);
+    unsigned char slotMap[head.numSlots];
+    recBuffer.getSlotMap(slotMap);
+    for (int slot = 0; slot < head.numSlots; ++slot) {
+      if (slotMap[slot] == SLOT_UNOCCUPIED) {
+        continue;
+      }
+      recBuffer.getRecord(record, slot);
+      int cmpVal = 0;
+      for (int i = 0; i < numAttrs && cmpVal == 0; ++i) {
+        cmpVal = compareAttrs(record[index.keyOffsets[i]], searchKey[i], index.keyTypes[i]);
+      }
+      if (satisfiesOp(cmpVal, op)) {
+        scanned.push_back({block, slot});
+      }
+    }
+    block = head.rblock;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  std::sort(indexed.begin(), indexed.end());
+  std::sort(scanned.begin(), scanned.end());
+  bool same = indexed == scanned;
+  std::cout << indexed.size() << " records: composite index "
+            << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << " us, scan "
+            << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count() << " us, results "
+            << (same ? "match" : "DIFFER") << std::endl;
+
+  return same ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION HASHCHECK relname attrname
+   checks the invariants of the hash index on relname.attrname */
+int Bench::hash_index_check(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  AttrCatEntry attrCatEntry;
+  if (AttrCacheTable::getAttrCatEntry(relId, attrname, &attrCatEntry) != SUCCESS) {
+    return E_ATTRNOTEXIST;
+  }
+  HashIndexInfo index;
+  int ret = HashIndex::find(relId, attrCatEntry.offset, &index);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  int numEntries, numBuckets, numBlocks;
+  ret = HashIndex::check(relId, &index, &numEntries, &numBuckets, &numBlocks);
+  if (ret == SUCCESS) {
+    std::cout << "Hash index on " << relname << "." << attrname << " is consistent (" << numEntries
+              << " entries in " << numBuckets << " buckets of " << numBlocks << " blocks, "
+              << HashIndex::bucketCapacity() << " entries per block)" << std::endl;
+  }
+  return ret;
+}
+
+// number of blocks read from the root to a leaf of the B+ tree rooted at rootBlock
+static int bplus_height(int rootBlock) {
+  int height = 1;
+  int block = rootBlock;
+  while (StaticBuffer::getStaticBlockType(block) == IND_INTERNAL) {
+    IndInternal internal(block);
+    InternalEntry entry;
+    internal.getEntry(&entry, 0);
+    block = entry.lChild;
+    height++;
+  }
+  return height;
+}
+
+/* FUNCTION EQBENCH relname attrname
+   looks up every distinct value of relname.attrname (in a random order)
+   through its B+ tree and reports the time and the disk reads per lookup,
+   along with the size of the tree */
+int Bench::eq_scan_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  AttrCatEntry attrCatEntry;
+  if (AttrCacheTable::getAttrCatEntry(relId, attrname, &attrCatEntry) != SUCCESS) {
+    return E_ATTRNOTEXIST;
+  }
+  int numEntries, numBlocks, numPostingBlocks;
+  int ret = BPlusTree::bPlusCheck(relId, attrname, &numEntries, &numBlocks, &numPostingBlocks);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  // the distinct values, shuffled
+  std::vector<Attribute> keys;
+  RelCatEntry relCatEntry;
+  RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+  RelCacheTable::resetSearchIndex(relId);
+  Attribute record[relCatEntry.numAttrs];
+  while (BlockAccess::project(relId, record) == SUCCESS) {
+    keys.push_back(record[attrCatEntry.offset]);
+  }
+  int type = attrCatEntry.attrType;
+  std::sort(keys.begin(), keys.end(),
+            [type](const Attribute &a, const Attribute &b) { return compareAttrs(a, b, type) < 0; });
+  keys.erase(std::unique(keys.begin(), keys.end(),
+                         [type](const Attribute &a, const Attribute &b) { return compareAttrs(a, b, type) == 0; }),
+             keys.end());
+  srand(1);
+  for (int i = (int)keys.size() - 1; i > 0; --i) {
+    std::swap(keys[i], keys[rand() % (i + 1)]);
+  }
+
+  long long numMatches = 0;
+  long long readsBefore = StaticBuffer::getNumDiskReads();
+  auto start = std::chrono::steady_clock::now();
+  for (Attribute &key : keys) {
+    AttrCacheTable::resetSearchIndex(relId, attrname);
+    while (BPlusTree::bPlusSearch(relId, attrname, key, EQ).block != -1) {
+      numMatches++;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  long long readsAfter = StaticBuffer::getNumDiskReads();
+
+  long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  double numLookups = keys.size() > 0 ? keys.size() : 1;
+  std::cout << keys.size() << " keys, " << numMatches << " records: " << ns / 1000 << " us, "
+            << (readsAfter - readsBefore) / numLookups << " disk reads per lookup; B+ tree of " << numBlocks
+            << " blocks (" << numPostingBlocks << " posting), height " << bplus_height(attrCatEntry.rootBlock)
+            << std::endl;
+
+  return numMatches == numEntries ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION HASHJOINBENCH relname1 attrname1 relname2 attrname2
+   probes relname2.attrname2 (which needs both a B+ tree and a hash index) with
+   the attrname1 value of every record of relname1, as the index join does,
+   once through each index, checks that both find the same number of matches
+   and reports the time of each */
+int Bench::hash_join_benchmark(char relname1[ATTR_SIZE], char attrname1[ATTR_SIZE], char relname2[ATTR_SIZE],
+                               char attrname2[ATTR_SIZE]) {
+  int relId1 = OpenRelTable::getQueryRelId(relname1);
+  if (relId1 < 0) {
+    return relId1;
+  }
+  OpenRelTable::pinRel(relId1);
+  int relId2 = OpenRelTable::getQueryRelId(relname2);
+  OpenRelTable::unpinRel(relId1);
+  if (relId2 < 0) {
+    return relId2;
+  }
+
+  AttrCatEntry attrCatEntry1, attrCatEntry2;
+  if (AttrCacheTable::getAttrCatEntry(relId1, attrname1, &attrCatEntry1) != SUCCESS ||
+      AttrCacheTable::getAttrCatEntry(relId2, attrname2, &attrCatEntry2) != SUCCESS) {
+    return E_ATTRNOTEXIST;
+  }
+  if (attrCatEntry1.attrType != attrCatEntry2.attrType) {
+    return E_ATTRTYPEMISMATCH;
+  }
+  HashIndexInfo index;
+  if (attrCatEntry2.rootBlock == -1 || HashIndex::find(relId2, attrCatEntry2.offset, &index) != SUCCESS) {
+    return E_NOINDEX;
+  }
+
+  // the join keys of the outer relation
+  std::vector<Attribute> keys;
+  RelCatEntry relCatEntry1;
+  RelCacheTable::getRelCatEntry(relId1, &relCatEntry1);
+  RelCacheTable::resetSearchIndex(relId1);
+  Attribute record[relCatEntry1.numAttrs];
+  while (BlockAccess::project(relId1, record) == SUCCESS) {
+    keys.push_back(record[attrCatEntry1.offset]);
+  }
+
+  long long bplusMatches = 0, hashMatches = 0;
+  long long readsBefore = StaticBuffer::getNumDiskReads();
+  auto start = std::chrono::steady_clock::now();
+  for (Attribute &key : keys) {
+    AttrCacheTable::resetSearchIndex(relId2, attrname2);
+    while (BPlusTree::bPlusSearch(relId2, attrname2, key, EQ).block != -1) {
+      bplusMatches++;
+    }
+  }
+  auto middle = std::chrono::steady_clock::now();
+  long long readsMiddle = StaticBuffer::getNumDiskReads();
+  for (Attribute &key : keys) {
+    IndexId cursor = {-1, -1, -1, -1};
+    RecId recId;
+    while (HashIndex::search(&index, key, &cursor, &recId) == SUCCESS) {
+      hashMatches++;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  long long readsAfter = StaticBuffer::getNumDiskReads();
+
+  int numEntries, numBuckets, numBlocks;
+  int ret = HashIndex::check(relId2, &index, &numEntries, &numBuckets, &numBlocks);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  long long bplusNs = std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start).count();
+  long long hashNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle).count();
+  double numProbes = keys.size() > 0 ? keys.size() : 1;
+  std::cout << keys.size() << " probes: B+ tree " << bplusNs / 1000 << " us, "
+            << (readsMiddle - readsBefore) / numProbes << " disk reads per probe (" << bplus_height(attrCatEntry2.rootBlock)
+            << " blocks to a leaf); hash index " << hashNs / 1000 << " us, " << (readsAfter - readsMiddle) / numProbes
+            << " disk reads per probe (1 + " << (numBuckets > 0 ? (double)numBlocks / numBuckets : 0)
+            << " blocks per bucket); " << (hashNs > 0 ? (double)bplusNs / hashNs : 0) << "x, " << bplusMatches
+            << " / " << hashMatches << " matches" << std::endl;
+
+  return bplusMatches == hashMatches ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION SEMIJOINBENCH relname1 attrname1 relname2 attrname2
+   finds the records of relname1 that have a match in relname2, once with a
+   join projected back to the attributes of relname1 and made distinct, and
+   once with a semi-join. Checks that both return the same records (relname1
+   should not hold duplicate records) and reports the time and disk reads of
+   each, and the number of records without a match (anti-join) */
+int Bench::semi_join_benchmark(char relname1[ATTR_SIZE], char attrname1[ATTR_SIZE], char relname2[ATTR_SIZE],
+                               char attrname2[ATTR_SIZE]) {
+  int relId1 = OpenRelTable::getQueryRelId(relname1);
+  if (relId1 < 0) {
+    return relId1;
+  }
+  RelCatEntry relCatEntry1;
+  RelCacheTable::getRelCatEntry(relId1, &relCatEntry1);
+  char attrs[relCatEntry1.numAttrs][ATTR_SIZE];
+  for (int i = 0; i < relCatEntry1.numAttrs; ++i) {
+    AttrCatEntry attrCatEntry;
+    AttrCacheTable::getAttrCatEntry(relId1, i, &attrCatEntry);
+    strcpy(attrs[i], attrCatEntry.attrName);
+  }
+
+  Operator *join;
+  int ret = Algebra::buildJoin(relname1, relname2, attrname1, attrname2, &join);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  join = new SortOp(new ProjectOp(join, relCatEntry1.numAttrs, attrs), 0, attrs, false, true);
+
+  Operator *semi, *anti;
+  ret = Algebra::buildSemiJoin(relname1, relname2, attrname1, attrname2, false, &semi);
+  if (ret == SUCCESS) {
+    ret = Algebra::buildSemiJoin(relname1, relname2, attrname1, attrname2, true, &anti);
+    if (ret != SUCCESS) {
+      delete semi;
+    }
+  }
+  if (ret != SUCCESS) {
+    delete join;
+    return ret;
+  }
+
+  std::vector<std::string> joinValues, semiValues, antiValues;
+  long long joinNs, semiNs, antiNs;
+  long long readsBefore = StaticBuffer::getNumDiskReads();
+  ret = drain_first_attr(join, joinValues, &joinNs);
+  long long readsJoin = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(semi, semiValues, &semiNs);
+  }
+  long long readsSemi = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(anti, antiValues, &antiNs);
+  }
+  bool usesIndex = ((SemiJoinOp *)semi)->usesIndex();
+  delete join;
+  delete semi;
+  delete anti;
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  bool same = joinValues == semiValues;
+  std::cout << semiValues.size() << " records: join + project + distinct " << joinNs / 1000 << " us, "
+            << readsJoin - readsBefore << " disk reads; semi-join (" << (usesIndex ? "index" : "hash set") << ") "
+            << semiNs / 1000 << " us, " << readsSemi - readsJoin << " disk reads ("
+            << (semiNs > 0 ? (double)joinNs / semiNs : 0) << "x), results " << (same ? "match" : "DIFFER")
+            << "; " << antiValues.size() << " records without a match" << std::endl;
+
+  return same ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION BNLJBENCH relname1 attrname1 relname2 attrname2 [budgetBlocks]
+   joins relname1 and relname2 without an index, once a record of relname1 at
+   a time, once with a block nested-loop join holding budgetBlocks blocks of
+   relname1 (the join memory budget by default) per pass over relname2, and once
+   with a sort-merge join. Checks that all three return the same records and
+   reports the passes over relname2, the time and the disk reads of each */
+int Bench::block_nested_loop_benchmark(char relname1[ATTR_SIZE], char attrname1[ATTR_SIZE],
+                                       char relname2[ATTR_SIZE], char attrname2[ATTR_SIZE], int budgetBlocks) {
+  int relId1 = OpenRelTable::getQueryRelId(relname1);
+  if (relId1 < 0) {
+    return relId1;
+  }
+  OpenRelTable::pinRel(relId1);
+  int relId2 = OpenRelTable::getQueryRelId(relname2);
+  OpenRelTable::unpinRel(relId1);
+  if (relId2 < 0) {
+    return relId2;
+  }
+
+  int budget = budgetBlocks > 0 ? budgetBlocks * BLOCK_SIZE : Algebra::getJoinMemoryBudget();
+  BlockNestedLoopJoinOp *tuple = new BlockNestedLoopJoinOp(new ScanOp(relId1), new ScanOp(relId2), attrname1,
+                                                           attrname2, 0);
+  BlockNestedLoopJoinOp *block = new BlockNestedLoopJoinOp(new ScanOp(relId1), new ScanOp(relId2), attrname1,
+                                                           attrname2, budget);
+  MergeJoinOp *merge = new MergeJoinOp(new ScanOp(relId1), new ScanOp(relId2), attrname1, attrname2);
+
+  std::vector<std::string> tupleValues, blockValues, mergeValues;
+  long long tupleNs, blockNs, mergeNs;
+  long long readsBefore = StaticBuffer::getNumDiskReads();
+  int ret = drain_first_attr(tuple, tupleValues, &tupleNs);
+  long long readsTuple = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(block, blockValues, &blockNs);
+  }
+  long long readsBlock = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(merge, mergeValues, &mergeNs);
+  }
+  long long readsMerge = StaticBuffer::getNumDiskReads();
+  int tuplePasses = tuple->getNumInnerPasses();
+  int blockPasses = block->getNumInnerPasses();
+  delete tuple;
+  delete block;
+  delete merge;
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  bool same = tupleValues == blockValues && blockValues == mergeValues;
+  std::cout << blockValues.size() << " records: record at a time " << tuplePasses << " passes, " << tupleNs / 1000
+            << " us, " << readsTuple - readsBefore << " disk reads; block nested-loop (" << budget / BLOCK_SIZE
+            << " blocks) " << blockPasses << " passes, " << blockNs / 1000 << " us, " << readsBlock - readsTuple
+            << " disk reads (" << (blockNs > 0 ? (double)tupleNs / blockNs : 0) << "x); sort-merge " << mergeNs / 1000
+            << " us, " << readsMerge - readsBlock << " disk reads; results " << (same ? "match" : "DIFFER")
+            << std::endl;
+
+  return same ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION MULTIJOINBENCH relname1 attr1 relname2 attr2 attr2b relname3 attr3
+   runs the three-way join relname1.attr1 = relname2.attr2, relname2.attr2b =
+   relname3.attr3 three times: as two binary joins with the first one stored
+   in a scratch relation (dropped afterwards), pipelined in the order written,
+   and pipelined in the order chosen by the planner. Checks that all three
+   return the same records and reports the chosen plan and the time and disk
+   reads of each */
+int Bench::multi_join_benchmark(char relname1[ATTR_SIZE], char attr1[ATTR_SIZE], char relname2[ATTR_SIZE],
+                                char attr2[ATTR_SIZE], char attr2b[ATTR_SIZE], char relname3[ATTR_SIZE],
+                                char attr3[ATTR_SIZE]) {
+  char relNames[3][ATTR_SIZE], leftRels[2][ATTR_SIZE], leftAttrs[2][ATTR_SIZE], rightAttrs[2][ATTR_SIZE];
+  strcpy(relNames[0], relname1);
+  strcpy(relNames[1], relname2);
+  strcpy(relNames[2], relname3);
+  strcpy(leftRels[0], relname1);
+  strcpy(leftAttrs[0], attr1);
+  strcpy(rightAttrs[0], attr2);
+  strcpy(leftRels[1], relname2);
+  strcpy(leftAttrs[1], attr2b);
+  strcpy(rightAttrs[1], attr3);
+
+  Operator *written, *planned;
+  std::string plan;
+  int ret = Algebra::buildMultiJoin(3, relNames, leftRels, leftAttrs, rightAttrs, false, &written);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  ret = Algebra::buildMultiJoin(3, relNames, leftRels, leftAttrs, rightAttrs, true, &planned, &plan);
+  if (ret != SUCCESS) {
+    delete written;
+    return ret;
+  }
+
+  // the first join is stored in a scratch relation and joined with relname3
+  char scratch[ATTR_SIZE] = "multijoinbench";
+  std::vector<std::string> storedValues, writtenValues, plannedValues;
+  long long storedNs, writtenNs, plannedNs;
+  long long readsBefore = StaticBuffer::getNumDiskReads();
+  auto start = std::chrono::steady_clock::now();
+  ret = Algebra::join(relname1, relname2, scratch, attr1, attr2);
+  if (ret == SUCCESS) {
+    Operator *second = nullptr;
+    int relId = OpenRelTable::openRel(scratch);
+    ret = relId < 0 ? relId : Algebra::buildJoin(scratch, relname3, attr2b, attr3, &second);
+    if (ret == SUCCESS) {
+      ret = drain_first_attr(second, storedValues, &storedNs);
+      delete second;
+    }
+    if (relId >= 0) {
+      OpenRelTable::closeRel(relId);
+    }
+    Schema::deleteRel(scratch);
+  }
+  auto end = std::chrono::steady_clock::now();
+  storedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  long long readsStored = StaticBuffer::getNumDiskReads();
+
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(written, writtenValues, &writtenNs);
+  }
+  long long readsWritten = StaticBuffer::getNumDiskReads();
+  if (ret == SUCCESS) {
+    ret = drain_first_attr(planned, plannedValues, &plannedNs);
+  }
+  long long readsPlanned = StaticBuffer::getNumDiskReads();
+  delete written;
+  delete planned;
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  bool same = storedValues == writtenValues && writtenValues == plannedValues;
+  std::cout << plannedValues.size() << " records: stored first join " << storedNs / 1000 << " us, "
+            << readsStored - readsBefore << " disk reads; pipelined as written " << writtenNs / 1000 << " us, "
+            << readsWritten - readsStored << " disk reads; planned (" << plan << ") " << plannedNs / 1000
+            << " us, " << readsPlanned - readsWritten << " disk reads ("
+            << (plannedNs > 0 ? (double)storedNs / plannedNs : 0) << "x); results " << (same ? "match" : "DIFFER")
+            << std::endl;
+
+  return same ? SUCCESS : FAILURE;
+}
+
+/* FUNCTION PREFIXCHECK relname attrname
+   checks the invariants of the compressed index on relname.attrname and, if
+   the attribute also has a B+ tree, compares the number of blocks and the
+   height of the two trees */
+int Bench::compressed_index_check(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  AttrCatEntry attrCatEntry;
+  if (AttrCacheTable::getAttrCatEntry(relId, attrname, &attrCatEntry) != SUCCESS) {
+    return E_ATTRNOTEXIST;
+  }
+  CompositeIndexInfo index;
+  int ret = CompositeIndex::find(relId, 1, &attrCatEntry.offset, &index);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  int numEntries, numBlocks, height;
+  ret = CompositeIndex::check(relId, &index, &numEntries, &numBlocks, &height);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  std::cout << "Compressed index on " << relname << "." << attrname << " is consistent (" << numEntries
+            << " entries in " << numBlocks << " blocks, height " << height << ")" << std::endl;
+
+  if (attrCatEntry.rootBlock != -1) {
+    int bplusEntries, bplusBlocks, numPostingBlocks;
+    ret = BPlusTree::bPlusCheck(relId, attrname, &bplusEntries, &bplusBlocks, &numPostingBlocks);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    std::cout << "B+ tree: " << bplusEntries << " entries in " << bplusBlocks << " blocks, height "
+              << bplus_height(attrCatEntry.rootBlock) << "; the compressed index has "
+              << (double)bplusBlocks / numBlocks << "x fewer blocks" << std::endl;
+  }
+  return SUCCESS;
+}
+
+/* verifies that the indexed records of a relation are exactly `keys`: the
+   B+ tree is checked, and its entries must refer to distinct records */
+static int bplus_stress_verify(int relId, char attrname[ATTR_SIZE], std::vector<double> &keys) {
+  int numEntries, numBlocks, numPostingBlocks;
+  int ret = BPlusTree::bPlusCheck(relId, attrname, &numEntries, &numBlocks, &numPostingBlocks);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  // every key is >= 0, so NE -1 visits every leaf entry
+  Attribute none;
+  none.nVal = -1;
+  std::vector<RecId> recIds;
+  BlockAccess::findRecIds(relId, attrname, none, NE, &recIds);
+  std::sort(recIds.begin(), recIds.end(), [](const RecId &a, const RecId &b) {
+    return a.block != b.block ? a.block < b.block : a.slot < b.slot;
+  });
+  bool distinct = std::adjacent_find(recIds.begin(), recIds.end(), [](const RecId &a, const RecId &b) {
+    return a.block == b.block && a.slot == b.slot;
+  }) == recIds.end();
+  if (!distinct || (int)recIds.size() != numEntries || numEntries != (int)keys.size()) {
+    return E_INDEXCORRUPT;
+  }
+
+  // the records hold the expected keys
+  std::vector<double> found;
+  Attribute record[1];
+  for (RecId recId : recIds) {
+    RecBuffer recBuffer(recId.block);
+    recBuffer.getRecord(record, recId.slot);
+    found.push_back(record[0].nVal);
+  }
+  std::vector<double> expected(keys);
+  std::sort(found.begin(), found.end());
+  std::sort(expected.begin(), expected.end());
+  return found == expected ? SUCCESS : E_INDEXCORRUPT;
+}
+
+/* randomized test of B+ tree insertion and deletion. A scratch relation with
+   an indexed NUM attribute receives numOps inserts and deletes of keys with
+   many duplicates (numKeys distinct keys, numOps / 16 if it is 0): mostly
+   inserts in the first 60% of the operations (the tree grows and splits) and
+   mostly deletes afterwards (nodes borrow, merge and the root shrinks). Few
+   keys make posting lists grow and shrink. The tree is verified every
+   BPLUS_STRESS_CHECK_INTERVAL operations and at the end; the relation is
+   dropped afterwards. */
+int Bench::bplus_stress(int numOps, unsigned int seed, int numKeys) {
+  char relname[ATTR_SIZE] = "bplusstress";
+  char attrs[1][ATTR_SIZE] = {"key"};
+  int types[1] = {NUMBER};
+  int ret = Schema::createRel(relname, 1, attrs, types);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  int relId = OpenRelTable::openRel(relname);
+  if (relId < 0) {
+    Schema::deleteRel(relname);
+    return relId;
+  }
+  OpenRelTable::pinRel(relId);
+  BPlusTree::bPlusCreate(relId, attrs[0]);
+
+  srand(seed);
+  int keyRange = numKeys > 0 ? numKeys : std::max(1, numOps / 16);
+  std::vector<double> keys;
+  int numInserts = 0, numDeletes = 0, numChecks = 0;
+
+  for (int op = 0; op < numOps && ret == SUCCESS; ++op) {
+    bool growing = op < numOps * 6 / 10;
+    bool insert = keys.empty() || (rand() % 10 < 7) == growing;
+
+    Attribute record[1];
+    if (insert) {
+      record[0].nVal = rand() % keyRange;
+      ret = BlockAccess::insert(relId, record);
+      keys.push_back(record[0].nVal);
+      numInserts++;
+    } else {
+      // delete one of the records holding a random live key
+      int pos = rand() % keys.size();
+      std::vector<RecId> recIds;
+      record[0].nVal = keys[pos];
+      BlockAccess::findRecIds(relId, attrs[0], record[0], EQ, &recIds);
+      if (recIds.empty()) {
+        ret = E_INDEXCORRUPT;
+        break;
+      }
+      ret = BlockAccess::deleteRecord(relId, recIds[rand() % recIds.size()]);
+      keys[pos] = keys.back();
+      keys.pop_back();
+      numDeletes++;
+    }
+
+    if (ret == SUCCESS && (op + 1) % BPLUS_STRESS_CHECK_INTERVAL == 0) {
+      ret = bplus_stress_verify(relId, attrs[0], keys);
+      numChecks++;
+    }
+  }
+  if (ret == SUCCESS) {
+    ret = bplus_stress_verify(relId, attrs[0], keys);
+    numChecks++;
+  }
+
+  if (ret == SUCCESS) {
+    std::cout << numInserts << " inserts and " << numDeletes << " deletes (" << keyRange
+              << " distinct keys): " << numChecks << " checks passed, " << keys.size()
+              << " records left" << std::endl;
+  }
+
+  OpenRelTable::unpinRel(relId);
+  OpenRelTable::closeRel(relId);
+  Schema::deleteRel(relname);
+  return ret;
+}
+
+// how FUNCTION GENERATE fills an attribute
+enum GenerateKinds {
+  GENERATE_SEQ,
+  GENERATE_PERM,
+  GENERATE_RANDOM
+};
+
+/* parses a column spec of FUNCTION GENERATE: SEQ, PERM or a bound, after a
+   prefix (only allowed for a STRING attribute) */
+static int parse_generate_spec(char spec[ATTR_SIZE], int attrType, std::string &prefix, int *kind, int *bound) {
+  std::string text = spec;
+  size_t end = text.size();
+  if (end >= 3 && text.compare(end - 3, 3, "SEQ") == 0) {
+    *kind = GENERATE_SEQ;
+    end -= 3;
+  } else if (end >= 4 && text.compare(end - 4, 4, "PERM") == 0) {
+    *kind = GENERATE_PERM;
+    end -= 4;
+  } else {
+    while (end > 0 && isdigit((unsigned char)text[end - 1])) {
+      end--;
+    }
+    if (end == text.size() || atoi(text.c_str() + end) <= 0) {
+      return E_INVALID;
+    }
+    *kind = GENERATE_RANDOM;
+    *bound = atoi(text.c_str() + end);
+  }
+
+  prefix = text.substr(0, end);
+  if (!prefix.empty() && attrType != STRING) {
+    return E_ATTRTYPEMISMATCH;
+  }
+  return SUCCESS;
+}
+
+/* FUNCTION GENERATE relname numRecords seed spec...
+   inserts numRecords records into the open relation relname, one spec per
+   attribute: SEQ (0, 1, 2, ...), PERM (0 .. numRecords - 1 in a random order)
+   or a number k (random values in [0, k)). The value of a STRING attribute is
+   written after the prefix of its spec, e.g. sSEQ gives s0, s1, ... and w5
+   gives one of w0 .. w4. The records only depend on the seed, so benchmarks
+   and batch tests build their relations without input files. */
+int Bench::generate_records(char relname[ATTR_SIZE], int numRecords, unsigned int seed, int numSpecs,
+                            char specs[][ATTR_SIZE]) {
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  RelCatEntry relCatEntry;
+  RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+  if (numSpecs != relCatEntry.numAttrs || numRecords < 0) {
+    return E_NATTRMISMATCH;
+  }
+
+  int numAttrs = relCatEntry.numAttrs;
+  std::vector<std::string> prefixes(numAttrs);
+  std::vector<int> types(numAttrs), kinds(numAttrs), bounds(numAttrs, 0);
+  for (int i = 0; i < numAttrs; ++i) {
+    AttrCatEntry attrCatEntry;
+    AttrCacheTable::getAttrCatEntry(relId, i, &attrCatEntry);
+    types[i] = attrCatEntry.attrType;
+    int ret = parse_generate_spec(specs[i], types[i], prefixes[i], &kinds[i], &bounds[i]);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+
+  // mt19937 and the modulo keep the records the same on every platform
+  std::mt19937 rng(seed);
+  std::vector<int> perm(numRecords);
+  for (int i = 0; i < numRecords; ++i) {
+    perm[i] = i;
+  }
+  for (int i = numRecords - 1; i > 0; --i) {
+    std::swap(perm[i], perm[rng() % (i + 1)]);
+  }
+
+  OpenRelTable::pinRel(relId);
+  int ret = SUCCESS;
+  for (int recNum = 0; recNum < numRecords && ret == SUCCESS; ++recNum) {
+    Attribute record[numAttrs];
+    for (int i = 0; i < numAttrs; ++i) {
+      int value = recNum;
+      if (kinds[i] == GENERATE_PERM) {
+        value = perm[recNum];
+      } else if (kinds[i] == GENERATE_RANDOM) {
+        value = rng() % bounds[i];
+      }
+
+      if (types[i] == NUMBER) {
+        record[i].nVal = value;
+      } else {
+        snprintf(record[i].sVal, ATTR_SIZE, "%s%d", prefixes[i].c_str(), value);
+      }
+    }
+    ret = BlockAccess::insert(relId, record);
+  }
+  OpenRelTable::unpinRel(relId);
+  return ret;
+}
+
+/* FUNCTION DISKREADS
+   prints the number of blocks read from the disk since the previous FUNCTION
+   DISKREADS (or since the start). The count only depends on the commands run,
+   so batch tests use it to check that a query reads as few blocks as it should */
+int Bench::disk_reads() {
+  static long long lastReads = 0;
+  long long reads = StaticBuffer::getNumDiskReads();
+  std::cout << reads - lastReads << " disk reads" << std::endl;
+  lastReads = reads;
+  return SUCCESS;
+}
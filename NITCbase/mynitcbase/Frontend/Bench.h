@@ -0,0 +1,78 @@
+#ifndef FRONTEND_BENCH_H
+#define FRONTEND_BENCH_H
+
+#include "../Algebra/Algebra.h"
+#include "../Schema/Schema.h"
+#include "../define/constants.h"
+
+/* benchmarks, index checks and test data generators run through FUNCTION
+(see Frontend::custom_function). Each one prints what it measured or found and
+returns SUCCESS, or an error code if the check failed. */
+class Bench {
+ public:
+  // FUNCTION SORTBENCH rel attr [DESC]
+  static int sort_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], bool desc);
+
+  // FUNCTION SCANBENCH rel attr op value
+  static int scan_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], char opname[ATTR_SIZE],
+                            char value[ATTR_SIZE]);
+
+  // FUNCTION INDEXONLYBENCH rel attr op value
+  static int index_only_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], char opname[ATTR_SIZE],
+                                  char value[ATTR_SIZE]);
+
+  // FUNCTION RANGEBENCH rel attr low high
+  static int range_scan_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], char low[ATTR_SIZE],
+                                  char high[ATTR_SIZE]);
+
+  // FUNCTION ANDBENCH rel a1 op1 v1 a2 op2 v2
+  static int and_benchmark(char relname[ATTR_SIZE], char argv[][ATTR_SIZE]);
+
+  // FUNCTION BPLUSCHECK rel attr
+  static int bplus_check(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  // FUNCTION CINDEXCHECK rel a b [...]
+  static int composite_index_check(char relname[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE]);
+
+  // FUNCTION CINDEXSEARCH rel op a v [b v ...]
+  static int composite_index_search(char relname[ATTR_SIZE], char opname[ATTR_SIZE], int numAttrs,
+                                    char args[][ATTR_SIZE]);
+
+  // FUNCTION HASHCHECK rel attr
+  static int hash_index_check(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  // FUNCTION EQBENCH rel attr
+  static int eq_scan_benchmark(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  // FUNCTION HASHJOINBENCH r1 a1 r2 a2
+  static int hash_join_benchmark(char relname1[ATTR_SIZE], char attrname1[ATTR_SIZE], char relname2[ATTR_SIZE],
+                                 char attrname2[ATTR_SIZE]);
+
+  // FUNCTION SEMIJOINBENCH r a s b
+  static int semi_join_benchmark(char relname1[ATTR_SIZE], char attrname1[ATTR_SIZE], char relname2[ATTR_SIZE],
+                                 char attrname2[ATTR_SIZE]);
+
+  // FUNCTION BNLJBENCH r1 a1 r2 a2 [budgetBlocks]
+  static int block_nested_loop_benchmark(char relname1[ATTR_SIZE], char attrname1[ATTR_SIZE], char relname2[ATTR_SIZE],
+                                         char attrname2[ATTR_SIZE], int budgetBlocks);
+
+  // FUNCTION MULTIJOINBENCH r1 a1 r2 a2 b2 r3 b3
+  static int multi_join_benchmark(char relname1[ATTR_SIZE], char attr1[ATTR_SIZE], char relname2[ATTR_SIZE],
+                                  char attr2[ATTR_SIZE], char attr2b[ATTR_SIZE], char relname3[ATTR_SIZE],
+                                  char attr3[ATTR_SIZE]);
+
+  // FUNCTION PREFIXCHECK rel attr
+  static int compressed_index_check(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  // FUNCTION BPLUSSTRESS n [seed [numKeys]]
+  static int bplus_stress(int numOps, unsigned int seed, int numKeys);
+
+  // FUNCTION GENERATE rel numRecords seed spec...
+  static int generate_records(char relname[ATTR_SIZE], int numRecords, unsigned int seed, int numSpecs,
+                              char specs[][ATTR_SIZE]);
+
+  // FUNCTION DISKREADS
+  static int disk_reads();
+};
+
+#endif  // FRONTEND_BENCH_H
@@ -1,5 +1,9 @@
 #include "Frontend.h"
+#include "Bench.h"
 
+#include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 
@@ -20,6 +24,53 @@ int Frontend::close_table(char relname[ATTR_SIZE]) {
   return Schema::closeRel(relname);
 }
 
+int Frontend::set_auto_open(bool enable) {
+  OpenRelTable::setAutoOpen(enable);
+  return SUCCESS;
+}
+
+int Frontend::set_join_memory(int num_blocks) {
+  if (num_blocks < 1 || num_blocks > INT_MAX / BLOCK_SIZE) {
+    return E_INVALID;
+  }
+  Algebra::setJoinMemoryBudget(num_blocks * BLOCK_SIZE);
+  return SUCCESS;
+}
+
+/* time of a full scan of an open relation in nanoseconds */
+static long long time_full_scan(int relId) {
+  RelCatEntry relCatEntry;
+  RelCacheTable::getRelCatEntry(relId, &relCatEntry);
+  Attribute record[relCatEntry.numAttrs];
+
+  RelCacheTable::resetSearchIndex(relId);
+  auto start = std::chrono::steady_clock::now();
+  while (BlockAccess::project(relId, record) == SUCCESS) {
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+int Frontend::vacuum_table(char relname[ATTR_SIZE], int *blocks_before, int *blocks_after,
+                           long long *scan_ns_before, long long *scan_ns_after) {
+  int relId = OpenRelTable::getQueryRelId(relname);
+  if (relId < 0) {
+    return relId;
+  }
+
+  *scan_ns_before = time_full_scan(relId);
+  int ret = Schema::vacuumRel(relname, blocks_before, blocks_after);
+  if (ret != SUCCESS && ret != E_INDEX_BLOCKS_RELEASED) {
+    return ret;
+  }
+  *scan_ns_after = time_full_scan(relId);
+  return ret;
+}
+
+int Frontend::cluster_table(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+  return Algebra::cluster(relname, attrname);
+}
+
 int Frontend::alter_table_rename(char relname_from[ATTR_SIZE], char relname_to[ATTR_SIZE]) {
   return Schema::renameRel(relname_from, relname_to);
 }
@@ -37,10 +88,51 @@ int Frontend::drop_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
 	return Schema::dropIndex(relname, attrname);
 }
 
+int Frontend::create_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]) {
+	return Schema::createIndex(relname, attr_count, attr_list);
+}
+
+int Frontend::drop_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]) {
+	return Schema::dropIndex(relname, attr_count, attr_list);
+}
+
+int Frontend::create_compressed_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+	return Schema::createCompressedIndex(relname, attrname);
+}
+
+int Frontend::drop_compressed_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+	return Schema::dropCompressedIndex(relname, attrname);
+}
+
+int Frontend::create_hash_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+	return Schema::createHashIndex(relname, attrname);
+}
+
+int Frontend::drop_hash_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
+	return Schema::dropHashIndex(relname, attrname);
+}
+
+int Frontend::create_zonemap(char relname[ATTR_SIZE]) {
+	return Schema::createZoneMap(relname);
+}
+
+int Frontend::drop_zonemap(char relname[ATTR_SIZE]) {
+	return Schema::dropZoneMap(relname);
+}
+
 int Frontend::insert_into_table_values(char relname[ATTR_SIZE], int attr_count, char attr_values[][ATTR_SIZE]) {
   return Algebra::insert(relname, attr_count, attr_values);
 }
 
+int Frontend::delete_from_table(char relname[ATTR_SIZE], Predicate *where, int *count) {
+  return Algebra::deleteFrom(relname, where, count);
+}
+
+int Frontend::update_table(char relname[ATTR_SIZE], int set_count, char set_attrs[][ATTR_SIZE],
+                           char set_values[][ATTR_SIZE], Predicate *where, int *count) {
+  return Algebra::update(relname, set_count, set_attrs, set_values, where, count);
+}
+
 int Frontend::select_from_table(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE]) {
 
    return Algebra::project(relname_source, relname_target);
@@ -55,53 +147,18 @@ int Frontend::select_attrlist_from_table(char relname_source[ATTR_SIZE], char re
 
 int Frontend::select_from_table_where(char relname_source[ATTR_SIZE],
                                       char relname_target[ATTR_SIZE],
-                                      char attribute[ATTR_SIZE],
-                                      int op, char value[ATTR_SIZE]) {
+                                      Predicate *where) {
 
-    return Algebra::select(relname_source, relname_target, attribute, op, value);
+    return Algebra::select(relname_source, relname_target, where);
 }
 
 int Frontend::select_attrlist_from_table_where(
     char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
-    int attr_count, char attr_list[][ATTR_SIZE],
-    char attribute[ATTR_SIZE], int op, char value[ATTR_SIZE]) {
-
-    char temp[5];
-    strcpy(temp,"temp");
-    // Call select() method of the Algebra Layer with correct arguments to
-    // create a temporary target relation with name ".temp" (use constant TEMP)
-    int ret=Algebra::select(relname_source,temp , attribute, op, value);
-
-    // TEMP will contain all the attributes of the source relation as it is the
-    // result of a select operation
-
-    // Return Error values, if not successful
-    if(ret!=SUCCESS)
-    	return ret;
-
-    // Open the TEMP relation using OpenRelTable::openRel()
-    // if open fails, delete TEMP relation using Schema::deleteRel() and
-    // return the error code
-    
-    int tempId=OpenRelTable::openRel(temp);
-    if(tempId<0 || tempId>=MAX_OPEN)
-    {
-    	Schema::deleteRel(temp);
-    	return tempId;
-    }
-
-    // On the TEMP relation, call project() method of the Algebra Layer with
-    // correct arguments to create the actual target relation. The final
-    // target relation contains only those attributes mentioned in attr_list
-    ret=Algebra::project(temp, relname_target, attr_count, attr_list);
-
-    // close the TEMP relation using OpenRelTable::closeRel()
-    OpenRelTable::closeRel(tempId);
-    // delete the TEMP relation using Schema::deleteRel()
-    Schema::deleteRel(temp);
+    int attr_count, char attr_list[][ATTR_SIZE], Predicate *where) {
 
-    // return any error codes from project() or SUCCESS otherwise
-    return ret;
+    // select and project run as a single pipeline; only the projected records
+    // that satisfy the condition are written to the target relation
+    return Algebra::select(relname_source, relname_target, attr_count, attr_list, where);
 }
 
 int Frontend::select_from_join_where(char relname_source_one[ATTR_SIZE], char relname_source_two[ATTR_SIZE],
@@ -115,31 +172,168 @@ int Frontend::select_attrlist_from_join_where(char relname_source_one[ATTR_SIZE]
                                               char relname_target[ATTR_SIZE],
                                               char join_attr_one[ATTR_SIZE], char join_attr_two[ATTR_SIZE],
                                               int attr_count, char attr_list[][ATTR_SIZE]) {
-  // Algebra::join + project
-  char tempRelName[ATTR_SIZE] = TEMP;
-  int ret = Algebra::join(relname_source_one, relname_source_two, tempRelName, join_attr_one, join_attr_two);
+  // Algebra::join + project, pipelined without a TEMP relation
+  return Algebra::join(relname_source_one, relname_source_two, relname_target, join_attr_one, join_attr_two,
+                       attr_count, attr_list);
+}
+
+/* puts the projection, DISTINCT, ORDER BY and LIMIT on top of a select or
+join tree. DISTINCT applies to the projected records, so the sort goes above
+the projection; otherwise the records are sorted before they are projected
+and a sort under a LIMIT only keeps the records that can be returned. */
+static Operator *addProjectOrderLimit(Operator *root, bool distinct, int attr_count, char attr_list[][ATTR_SIZE],
+                                      char order_attribute[ATTR_SIZE], bool order_desc, int limit, int offset) {
+  int numKeys = (order_attribute != nullptr) ? 1 : 0;
+  char keys[1][ATTR_SIZE];
+  if (numKeys > 0) {
+    strcpy(keys[0], order_attribute);
+  }
+
+  if (!distinct && numKeys > 0) {
+    SortOp *sort = new SortOp(root, numKeys, keys, order_desc, false);
+    if (limit >= 0) {
+      sort->setLimit(limit + offset);
+    }
+    root = sort;
+  }
+  if (attr_count > 0) {
+    root = new ProjectOp(root, attr_count, attr_list);
+  }
+  if (distinct) {
+    root = new SortOp(root, numKeys, keys, order_desc, true);
+  }
+  if (limit >= 0 || offset > 0) {
+    root = new LimitOp(root, limit >= 0 ? limit : INT_MAX, offset);
+  }
+  return root;
+}
+
+int Frontend::select_from_table_to(char relname_source[ATTR_SIZE], bool distinct,
+                                   int attr_count, char attr_list[][ATTR_SIZE], Predicate *where,
+                                   char order_attribute[ATTR_SIZE], bool order_desc,
+                                   int limit, int offset, char file_name[]) {
+  // build the select (or scan) + project pipeline and stream its result
+  Operator *root;
+  int ret;
+  bool projectFirst = where != nullptr && attr_count > 0;
+  if (projectFirst && order_attribute != nullptr) {
+    // the records can only be projected before ORDER BY if they keep its attribute
+    bool kept = false;
+    for (int i = 0; i < attr_count; ++i) {
+      kept = kept || strcmp(attr_list[i], order_attribute) == 0;
+    }
+    projectFirst = kept;
+  }
+  if (projectFirst) {
+    // lets the planner answer the query from an index alone when it covers the projection
+    ret = Algebra::buildSelect(relname_source, where, attr_count, attr_list, &root);
+    attr_count = 0;
+  } else if (where != nullptr) {
+    ret = Algebra::buildSelect(relname_source, where, &root);
+  } else {
+    ret = Algebra::buildScan(relname_source, &root);
+  }
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  root = addProjectOrderLimit(root, distinct, attr_count, attr_list, order_attribute, order_desc, limit, offset);
+
+  ret = Algebra::output(root, file_name);
+  delete root;
 
-  /*
-    TEMP contains all the attributes of the source relations except the join attribute of the 
-    second source relation
-  */
+  return ret;
+}
 
-  if(ret != SUCCESS){
+int Frontend::select_from_join_to(char relname_source_one[ATTR_SIZE], char relname_source_two[ATTR_SIZE],
+                                  char join_attr_one[ATTR_SIZE], char join_attr_two[ATTR_SIZE], bool distinct,
+                                  int attr_count, char attr_list[][ATTR_SIZE],
+                                  char order_attribute[ATTR_SIZE], bool order_desc,
+                                  int limit, int offset, char file_name[]) {
+  Operator *root;
+  int ret = Algebra::buildJoin(relname_source_one, relname_source_two, join_attr_one, join_attr_two, &root);
+  if (ret != SUCCESS) {
     return ret;
   }
 
-  // Open TEMP, if fails delete it
-  int tempRelId = OpenRelTable::openRel(tempRelName);
-  if(tempRelId < 0){
-    Schema::deleteRel(tempRelName);
-    return tempRelId;
+  root = addProjectOrderLimit(root, distinct, attr_count, attr_list, order_attribute, order_desc, limit, offset);
+
+  ret = Algebra::output(root, file_name);
+  delete root;
+
+  return ret;
+}
+
+int Frontend::select_from_semi_join_where(char relname_source[ATTR_SIZE], char relname_inner[ATTR_SIZE],
+                                          char relname_target[ATTR_SIZE], char attr[ATTR_SIZE],
+                                          char inner_attr[ATTR_SIZE], bool anti,
+                                          int attr_count, char attr_list[][ATTR_SIZE]) {
+  return Algebra::semiJoin(relname_source, relname_inner, relname_target, attr, inner_attr, anti, attr_count,
+                           attr_list);
+}
+
+int Frontend::select_from_semi_join_to(char relname_source[ATTR_SIZE], char relname_inner[ATTR_SIZE],
+                                       char attr[ATTR_SIZE], char inner_attr[ATTR_SIZE], bool anti, bool distinct,
+                                       int attr_count, char attr_list[][ATTR_SIZE],
+                                       char order_attribute[ATTR_SIZE], bool order_desc,
+                                       int limit, int offset, char file_name[]) {
+  Operator *root;
+  int ret = Algebra::buildSemiJoin(relname_source, relname_inner, attr, inner_attr, anti, &root);
+  if (ret != SUCCESS) {
+    return ret;
   }
 
-  // call project() [2nd function]
-  ret = Algebra::project(tempRelName, relname_target, attr_count, attr_list);
+  root = addProjectOrderLimit(root, distinct, attr_count, attr_list, order_attribute, order_desc, limit, offset);
 
-  OpenRelTable::closeRel(tempRelId);
-  Schema::deleteRel(tempRelName);
+  ret = Algebra::output(root, file_name);
+  delete root;
+
+  return ret;
+}
+
+int Frontend::select_from_multi_join(int rel_count, char rel_names[][ATTR_SIZE], char left_rels[][ATTR_SIZE],
+                                     char left_attrs[][ATTR_SIZE], char right_attrs[][ATTR_SIZE],
+                                     char relname_target[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]) {
+  return Algebra::multiJoin(rel_count, rel_names, left_rels, left_attrs, right_attrs, relname_target, attr_count,
+                            attr_list);
+}
+
+int Frontend::select_from_multi_join_to(int rel_count, char rel_names[][ATTR_SIZE], char left_rels[][ATTR_SIZE],
+                                        char left_attrs[][ATTR_SIZE], char right_attrs[][ATTR_SIZE], bool distinct,
+                                        int attr_count, char attr_list[][ATTR_SIZE],
+                                        char order_attribute[ATTR_SIZE], bool order_desc,
+                                        int limit, int offset, char file_name[]) {
+  Operator *root;
+  int ret = Algebra::buildMultiJoin(rel_count, rel_names, left_rels, left_attrs, right_attrs, true, &root);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  root = addProjectOrderLimit(root, distinct, attr_count, attr_list, order_attribute, order_desc, limit, offset);
+
+  ret = Algebra::output(root, file_name);
+  delete root;
+
+  return ret;
+}
+
+int Frontend::select_aggregate(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
+                               int item_count, int item_funcs[], char item_attrs[][ATTR_SIZE],
+                               int group_count, char group_attrs[][ATTR_SIZE],
+                               Predicate *where, char file_name[]) {
+  Operator *root;
+  int ret = Algebra::buildAggregate(relname_source, where, group_count, group_attrs,
+                                    item_count, item_funcs, item_attrs, &root);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  if (relname_target != nullptr) {
+    ret = Algebra::materialize(root, relname_target);
+  } else {
+    ret = Algebra::output(root, file_name);
+  }
+  delete root;
 
   return ret;
 }
@@ -148,7 +342,76 @@ int Frontend::custom_function(int argc, char argv[][ATTR_SIZE]) {
   // argc gives the size of the argv array
   // argv stores every token delimited by space and comma
 
-  // implement whatever you desire
+  if ((argc == 3 || argc == 4) && strcmp(argv[0], "SORTBENCH") == 0) {
+    return Bench::sort_benchmark(argv[1], argv[2], argc == 4 && strcmp(argv[3], "DESC") == 0);
+  }
+
+  if (argc == 5 && strcmp(argv[0], "SCANBENCH") == 0) {
+    return Bench::scan_benchmark(argv[1], argv[2], argv[3], argv[4]);
+  }
+
+  if (argc == 5 && strcmp(argv[0], "INDEXONLYBENCH") == 0) {
+    return Bench::index_only_benchmark(argv[1], argv[2], argv[3], argv[4]);
+  }
+
+  if (argc == 5 && strcmp(argv[0], "RANGEBENCH") == 0) {
+    return Bench::range_scan_benchmark(argv[1], argv[2], argv[3], argv[4]);
+  }
+
+  if (argc == 8 && strcmp(argv[0], "ANDBENCH") == 0) {
+    return Bench::and_benchmark(argv[1], argv + 2);
+  }
+
+  if (argc == 3 && strcmp(argv[0], "BPLUSCHECK") == 0) {
+    return Bench::bplus_check(argv[1], argv[2]);
+  }
+
+  if (argc == 3 && strcmp(argv[0], "EQBENCH") == 0) {
+    return Bench::eq_scan_benchmark(argv[1], argv[2]);
+  }
+
+  if (argc >= 4 && strcmp(argv[0], "CINDEXCHECK") == 0) {
+    return Bench::composite_index_check(argv[1], argc - 2, argv + 2);
+  }
+
+  if (argc >= 5 && argc % 2 == 1 && strcmp(argv[0], "CINDEXSEARCH") == 0) {
+    return Bench::composite_index_search(argv[1], argv[2], (argc - 3) / 2, argv + 3);
+  }
+
+  if (argc == 3 && strcmp(argv[0], "PREFIXCHECK") == 0) {
+    return Bench::compressed_index_check(argv[1], argv[2]);
+  }
+
+  if (argc == 3 && strcmp(argv[0], "HASHCHECK") == 0) {
+    return Bench::hash_index_check(argv[1], argv[2]);
+  }
+
+  if (argc == 5 && strcmp(argv[0], "HASHJOINBENCH") == 0) {
+    return Bench::hash_join_benchmark(argv[1], argv[2], argv[3], argv[4]);
+  }
+
+  if (argc == 5 && strcmp(argv[0], "SEMIJOINBENCH") == 0) {
+    return Bench::semi_join_benchmark(argv[1], argv[2], argv[3], argv[4]);
+  }
+
+  if ((argc == 5 || argc == 6) && strcmp(argv[0], "BNLJBENCH") == 0) {
+    return Bench::block_nested_loop_benchmark(argv[1], argv[2], argv[3], argv[4], argc == 6 ? atoi(argv[5]) : 0);
+  }
+
+  if (argc == 8 && strcmp(argv[0], "MULTIJOINBENCH") == 0) {
+    return Bench::multi_join_benchmark(argv[1], argv[2], argv[3], argv[4], argv[5], argv[6], argv[7]);
+  }
+
+  if (argc >= 5 && strcmp(argv[0], "GENERATE") == 0) {
+    return Bench::generate_records(argv[1], atoi(argv[2]), atoi(argv[3]), argc - 4, argv + 4);
+  }
+  if (argc == 1 && strcmp(argv[0], "DISKREADS") == 0) {
+    return Bench::disk_reads();
+  }
+
+  if (argc >= 2 && argc <= 4 && strcmp(argv[0], "BPLUSSTRESS") == 0) {
+    return Bench::bplus_stress(atoi(argv[1]), argc >= 3 ? atoi(argv[2]) : 1, argc == 4 ? atoi(argv[3]) : 0);
+  }
 
   return SUCCESS;
 }
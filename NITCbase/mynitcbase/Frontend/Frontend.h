@@ -16,10 +16,40 @@ class Frontend {
 
   static int close_table(char relname[ATTR_SIZE]);
 
+  static int set_auto_open(bool enable);
+
+  // blocks of records a join holds in memory per pass over its other input
+  static int set_join_memory(int num_blocks);
+
   static int create_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
 
   static int drop_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
 
+  // composite index on attr_count attributes (CREATE INDEX ON rel.(a, b))
+  static int create_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]);
+
+  static int drop_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]);
+
+  // B+ tree on a string attribute with prefix-compressed blocks (CREATE COMPRESSED INDEX ON rel.attr)
+  static int create_compressed_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  static int drop_compressed_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  // hash index used by equality searches (CREATE HASH INDEX ON rel.attr)
+  static int create_hash_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  static int drop_hash_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
+  static int create_zonemap(char relname[ATTR_SIZE]);
+
+  static int drop_zonemap(char relname[ATTR_SIZE]);
+
+  // the number of record blocks and the time of a full scan before and after the compaction are returned
+  static int vacuum_table(char relname[ATTR_SIZE], int *blocks_before, int *blocks_after,
+                          long long *scan_ns_before, long long *scan_ns_after);
+
+  static int cluster_table(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
+
   static int alter_table_rename(char relname_from[ATTR_SIZE], char relname_to[ATTR_SIZE]);
 
   static int alter_table_rename_column(char relname[ATTR_SIZE], char attrname_from[16], char attrname_to[16]);
@@ -27,17 +57,22 @@ class Frontend {
   // DML
   static int insert_into_table_values(char relname[ATTR_SIZE], int attr_count, char attr_values[][ATTR_SIZE]);
 
+  // where = nullptr deletes / updates every record; the number of records is returned in *count
+  static int delete_from_table(char relname[ATTR_SIZE], Predicate *where, int *count);
+
+  static int update_table(char relname[ATTR_SIZE], int set_count, char set_attrs[][ATTR_SIZE],
+                          char set_values[][ATTR_SIZE], Predicate *where, int *count);
+
   static int select_from_table(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE]);
 
   static int select_attrlist_from_table(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
                                         int attr_count, char attr_list[][ATTR_SIZE]);
 
   static int select_from_table_where(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
-                                     char attribute[ATTR_SIZE], int op, char value[ATTR_SIZE]);
+                                     Predicate *where);
 
   static int select_attrlist_from_table_where(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
-                                              int attr_count, char attr_list[][ATTR_SIZE],
-                                              char attribute[ATTR_SIZE], int op, char value[ATTR_SIZE]);
+                                              int attr_count, char attr_list[][ATTR_SIZE], Predicate *where);
 
   static int select_from_join_where(char relname_source_one[ATTR_SIZE], char relname_source_two[ATTR_SIZE],
                                     char relname_target[ATTR_SIZE],
@@ -48,6 +83,52 @@ class Frontend {
                                              char join_attr_one[ATTR_SIZE], char join_attr_two[ATTR_SIZE],
                                              int attr_count, char attr_list[][ATTR_SIZE]);
 
+  // attr_count = 0 selects all the attributes, where = nullptr selects all the records,
+  // order_attribute = nullptr keeps the order of the records, limit = -1 returns every record
+  // (after skipping offset of them) and file_name = nullptr prints the result on the console
+  static int select_from_table_to(char relname_source[ATTR_SIZE], bool distinct,
+                                  int attr_count, char attr_list[][ATTR_SIZE], Predicate *where,
+                                  char order_attribute[ATTR_SIZE], bool order_desc,
+                                  int limit, int offset, char file_name[]);
+
+  static int select_from_join_to(char relname_source_one[ATTR_SIZE], char relname_source_two[ATTR_SIZE],
+                                 char join_attr_one[ATTR_SIZE], char join_attr_two[ATTR_SIZE], bool distinct,
+                                 int attr_count, char attr_list[][ATTR_SIZE],
+                                 char order_attribute[ATTR_SIZE], bool order_desc,
+                                 int limit, int offset, char file_name[]);
+
+  // the records of relname_source whose attr has (anti: has no) match in inner_relname.inner_attr
+  // (WHERE attr [NOT] IN (SELECT inner_attr FROM inner_relname), or [NOT] EXISTS); attr_count = 0 selects all
+  static int select_from_semi_join_where(char relname_source[ATTR_SIZE], char relname_inner[ATTR_SIZE],
+                                         char relname_target[ATTR_SIZE], char attr[ATTR_SIZE],
+                                         char inner_attr[ATTR_SIZE], bool anti,
+                                         int attr_count, char attr_list[][ATTR_SIZE]);
+
+  static int select_from_semi_join_to(char relname_source[ATTR_SIZE], char relname_inner[ATTR_SIZE],
+                                      char attr[ATTR_SIZE], char inner_attr[ATTR_SIZE], bool anti, bool distinct,
+                                      int attr_count, char attr_list[][ATTR_SIZE],
+                                      char order_attribute[ATTR_SIZE], bool order_desc,
+                                      int limit, int offset, char file_name[]);
+
+  // FROM rel_names[0] JOIN rel_names[1] ON ... JOIN ...: rel_names[k + 1] is joined on
+  // left_rels[k].left_attrs[k] = rel_names[k + 1].right_attrs[k]; attr_count = 0 selects all
+  static int select_from_multi_join(int rel_count, char rel_names[][ATTR_SIZE], char left_rels[][ATTR_SIZE],
+                                    char left_attrs[][ATTR_SIZE], char right_attrs[][ATTR_SIZE],
+                                    char relname_target[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]);
+
+  static int select_from_multi_join_to(int rel_count, char rel_names[][ATTR_SIZE], char left_rels[][ATTR_SIZE],
+                                       char left_attrs[][ATTR_SIZE], char right_attrs[][ATTR_SIZE], bool distinct,
+                                       int attr_count, char attr_list[][ATTR_SIZE],
+                                       char order_attribute[ATTR_SIZE], bool order_desc,
+                                       int limit, int offset, char file_name[]);
+
+  /* item_funcs[i] is an AGG_* function over item_attrs[i] ("*" for COUNT) or -1 for a group attribute;
+     relname_target = nullptr writes the result to file_name (or the console) instead of a relation */
+  static int select_aggregate(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
+                              int item_count, int item_funcs[], char item_attrs[][ATTR_SIZE],
+                              int group_count, char group_attrs[][ATTR_SIZE],
+                              Predicate *where, char file_name[]);
+
   static int custom_function(int argc, char argv[][ATTR_SIZE]);
 };
 
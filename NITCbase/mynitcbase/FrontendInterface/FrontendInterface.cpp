@@ -1,4 +1,5 @@
 // clang-format off
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <string>
@@ -31,6 +32,97 @@ vector<string> RegexHandler::extractTokens(string input) {
   return tokens;
 }
 
+static bool isComparisonOp(const string &token) {
+  return token == "=" || token == "<" || token == "<=" || token == ">" || token == ">=" || token == "!=";
+}
+
+static bool isKeyword(const string &token, const char *keyword) {
+  string upper = token;
+  transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+  return upper == keyword;
+}
+
+static bool parseOr(vector<string> &tokens, size_t &pos, Predicate *node);
+
+// a parenthesised condition, or a single `attr op value` comparison
+static bool parsePrimary(vector<string> &tokens, size_t &pos, Predicate *node) {
+  if (pos < tokens.size() && tokens[pos] == "(") {
+    pos++;
+    if (!parseOr(tokens, pos, node) || pos >= tokens.size() || tokens[pos] != ")") {
+      return false;
+    }
+    pos++;
+    return true;
+  }
+
+  if (pos + 2 >= tokens.size() || !isComparisonOp(tokens[pos + 1])) {
+    return false;
+  }
+
+  char attribute[ATTR_SIZE];
+  char value[ATTR_SIZE];
+  attrToTruncatedArray(tokens[pos], attribute);
+  attrToTruncatedArray(tokens[pos + 2], value);
+  *node = comparison(attribute, getOperator(tokens[pos + 1]), value);
+  pos += 3;
+  return true;
+}
+
+// terms joined by `keyword`; nested nodes of the same type are flattened and
+// a single term is returned as it is
+static bool parseTerms(vector<string> &tokens, size_t &pos, Predicate *node, int type, const char *keyword,
+                       bool (*parseTerm)(vector<string> &, size_t &, Predicate *)) {
+  vector<Predicate> children;
+  while (true) {
+    Predicate term;
+    if (!parseTerm(tokens, pos, &term)) {
+      return false;
+    }
+    if (term.type == type) {
+      children.insert(children.end(), term.children.begin(), term.children.end());
+    } else {
+      children.push_back(term);
+    }
+
+    if (pos >= tokens.size() || !isKeyword(tokens[pos], keyword)) {
+      break;
+    }
+    pos++;
+  }
+
+  if (children.size() == 1) {
+    *node = children[0];
+  } else {
+    node->type = type;
+    node->children = children;
+  }
+  return true;
+}
+
+static bool parseAnd(vector<string> &tokens, size_t &pos, Predicate *node) {
+  return parseTerms(tokens, pos, node, PRED_AND, "AND", parsePrimary);
+}
+
+static bool parseOr(vector<string> &tokens, size_t &pos, Predicate *node) {
+  return parseTerms(tokens, pos, node, PRED_OR, "OR", parseAnd);
+}
+
+int RegexHandler::parseCondition(string text, Predicate *where) {
+  regex tokenRegex("\\(|\\)|<=|>=|!=|<|>|=|[#A-Za-z0-9_.-]+");
+  vector<string> tokens;
+  for (sregex_iterator it(text.begin(), text.end(), tokenRegex), end; it != end; ++it) {
+    tokens.push_back(it->str());
+  }
+
+  // unbalanced parentheses and an AND / OR without a comparison after it are both rejected here
+  size_t pos = 0;
+  if (!parseOr(tokens, pos, where) || pos != tokens.size()) {
+    return E_SYNTAX;
+  }
+
+  return SUCCESS;
+}
+
 // handler functions
 int RegexHandler::helpHandler() {
   printHelp();
@@ -99,6 +191,26 @@ int RegexHandler::closeHandler() {
   return ret;
 }
 
+int RegexHandler::autoOpenHandler() {
+  bool enable = toupper(m[1].str()[1]) == 'N';
+
+  int ret = Frontend::set_auto_open(enable);
+  if (ret == SUCCESS) {
+    cout << "Auto-open " << (enable ? "enabled" : "disabled") << "\n";
+  }
+  return ret;
+}
+
+int RegexHandler::joinMemoryHandler() {
+  int numBlocks = stoi(m[1].str());
+
+  int ret = Frontend::set_join_memory(numBlocks);
+  if (ret == SUCCESS) {
+    cout << "Join memory set to " << numBlocks << " blocks\n";
+  }
+  return ret;
+}
+
 int RegexHandler::createTableHandler() {
   char relName[ATTR_SIZE];
   attrToTruncatedArray(m[1], relName);
@@ -168,6 +280,154 @@ int RegexHandler::dropIndexHandler() {
   return ret;
 }
 
+int RegexHandler::createCompositeIndexHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  vector<string> words = extractTokens(m[2]);
+  int attrCount = words.size();
+  char attrNames[attrCount][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(words[i], attrNames[i]);
+  }
+
+  int ret = Frontend::create_index(relName, attrCount, attrNames);
+  if (ret == SUCCESS) {
+    cout << "Index created successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::dropCompositeIndexHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  vector<string> words = extractTokens(m[2]);
+  int attrCount = words.size();
+  char attrNames[attrCount][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(words[i], attrNames[i]);
+  }
+
+  int ret = Frontend::drop_index(relName, attrCount, attrNames);
+  if (ret == SUCCESS) {
+    cout << "Index deleted successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::createCompressedIndexHandler() {
+  char relName[ATTR_SIZE], attrName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+  attrToTruncatedArray(m[2], attrName);
+
+  int ret = Frontend::create_compressed_index(relName, attrName);
+  if (ret == SUCCESS) {
+    cout << "Compressed index created successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::dropCompressedIndexHandler() {
+  char relName[ATTR_SIZE], attrName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+  attrToTruncatedArray(m[2], attrName);
+
+  int ret = Frontend::drop_compressed_index(relName, attrName);
+  if (ret == SUCCESS) {
+    cout << "Compressed index deleted successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::createHashIndexHandler() {
+  char relName[ATTR_SIZE], attrName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+  attrToTruncatedArray(m[2], attrName);
+
+  int ret = Frontend::create_hash_index(relName, attrName);
+  if (ret == SUCCESS) {
+    cout << "Hash index created successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::dropHashIndexHandler() {
+  char relName[ATTR_SIZE], attrName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+  attrToTruncatedArray(m[2], attrName);
+
+  int ret = Frontend::drop_hash_index(relName, attrName);
+  if (ret == SUCCESS) {
+    cout << "Hash index deleted successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::createZoneMapHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  int ret = Frontend::create_zonemap(relName);
+  if (ret == SUCCESS) {
+    cout << "Zone map created successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::dropZoneMapHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  int ret = Frontend::drop_zonemap(relName);
+  if (ret == SUCCESS) {
+    cout << "Zone map deleted successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::vacuumHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  int blocksBefore, blocksAfter;
+  long long scanBefore, scanAfter;
+  int ret = Frontend::vacuum_table(relName, &blocksBefore, &blocksAfter, &scanBefore, &scanAfter);
+  if (ret == SUCCESS || ret == E_INDEX_BLOCKS_RELEASED) {
+    cout << "Vacuumed " << relName << ": " << blocksBefore << " -> " << blocksAfter << " record blocks ("
+         << blocksBefore - blocksAfter << " reclaimed), full scan " << scanBefore / 1000 << " us -> "
+         << scanAfter / 1000 << " us";
+    if (scanAfter > 0) {
+      cout << " (" << (double)scanBefore / scanAfter << "x)";
+    }
+    cout << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::clusterHandler() {
+  char relName[ATTR_SIZE];
+  char attrName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+  attrToTruncatedArray(m[2], attrName);
+
+  int ret = Frontend::cluster_table(relName, attrName);
+  if (ret == SUCCESS) {
+    cout << "Clustered successfully" << endl;
+  }
+
+  return ret;
+}
+
 int RegexHandler::renameTableHandler() {
   char oldRelName[ATTR_SIZE];
   char newRelName[ATTR_SIZE];
@@ -256,7 +516,7 @@ int RegexHandler::insertFromFileHandler() {
 
     if (columnCount == -1) {
       columnCount = row.size();
-    } else if (columnCount != row.size()) {
+    } else if (columnCount != (int)row.size()) {
       errorMsg += "Mismatch in number of attributes\n";
       retVal = FAILURE;
       break;
@@ -294,6 +554,57 @@ int RegexHandler::insertFromFileHandler() {
   return retVal;
 }
 
+int RegexHandler::deleteHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  // without a WHERE clause every record is deleted
+  Predicate where;
+  if (m[2].matched && parseCondition(m[2], &where) != SUCCESS) {
+    return E_SYNTAX;
+  }
+
+  int count = 0;
+  int ret = Frontend::delete_from_table(relName, m[2].matched ? &where : nullptr, &count);
+  if (ret == SUCCESS) {
+    cout << count << " rows deleted" << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::updateHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  // split the SET list into attribute = value pairs
+  string setList = m[2];
+  regex setItem("([#A-Za-z0-9_-]+)\\s*=\\s*([0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)");
+  vector<smatch> items(sregex_iterator(setList.begin(), setList.end(), setItem), sregex_iterator());
+
+  int setCount = items.size();
+  char setAttrs[setCount][ATTR_SIZE];
+  char setValues[setCount][ATTR_SIZE];
+  for (int i = 0; i < setCount; i++) {
+    attrToTruncatedArray(items[i][1], setAttrs[i]);
+    attrToTruncatedArray(items[i][2], setValues[i]);
+  }
+
+  Predicate where;
+  if (m[3].matched && parseCondition(m[3], &where) != SUCCESS) {
+    return E_SYNTAX;
+  }
+
+  int count = 0;
+  int ret = Frontend::update_table(relName, setCount, setAttrs, setValues, m[3].matched ? &where : nullptr,
+                                   &count);
+  if (ret == SUCCESS) {
+    cout << count << " rows updated" << endl;
+  }
+
+  return ret;
+}
+
 int RegexHandler::selectFromHandler() {
   char sourceRelName[ATTR_SIZE];
   char targetRelName[ATTR_SIZE];
@@ -311,15 +622,15 @@ int RegexHandler::selectFromHandler() {
 int RegexHandler::selectFromWhereHandler() {
   char sourceRelName[ATTR_SIZE];
   char targetRelName[ATTR_SIZE];
-  char attribute[ATTR_SIZE];
-  char valueStr[ATTR_SIZE];
   attrToTruncatedArray(m[1], sourceRelName);
   attrToTruncatedArray(m[2], targetRelName);
-  attrToTruncatedArray(m[3], attribute);
-  int op = getOperator(m[4]);
-  attrToTruncatedArray(m[5], valueStr);
 
-  int ret = Frontend::select_from_table_where(sourceRelName, targetRelName, attribute, op, valueStr);
+  Predicate where;
+  if (parseCondition(m[3], &where) != SUCCESS) {
+    return E_SYNTAX;
+  }
+
+  int ret = Frontend::select_from_table_where(sourceRelName, targetRelName, &where);
   if (ret == SUCCESS) {
     cout << "Selected successfully into " << targetRelName << endl;
   }
@@ -352,14 +663,14 @@ int RegexHandler::selectAttrFromHandler() {
 int RegexHandler::selectAttrFromWhereHandler() {
   char sourceRelName[ATTR_SIZE];
   char targetRelName[ATTR_SIZE];
-  char attribute[ATTR_SIZE];
-  char value[ATTR_SIZE];
 
   attrToTruncatedArray(m[2], sourceRelName);
   attrToTruncatedArray(m[3], targetRelName);
-  attrToTruncatedArray(m[4], attribute);
-  int op = getOperator(m[5]);
-  attrToTruncatedArray(m[6], value);
+
+  Predicate where;
+  if (parseCondition(m[4], &where) != SUCCESS) {
+    return E_SYNTAX;
+  }
 
   vector<string> attrTokens = extractTokens(m[1]);
 
@@ -370,7 +681,7 @@ int RegexHandler::selectAttrFromWhereHandler() {
   }
 
   int ret = Frontend::select_attrlist_from_table_where(sourceRelName, targetRelName, attrCount, attrNames,
-                                                       attribute, op, value);
+                                                       &where);
   if (ret == SUCCESS) {
     cout << "Selected successfully into " << targetRelName << endl;
   }
@@ -452,11 +763,422 @@ int RegexHandler::selectAttrFromJoinHandler() {
   return ret;
 }
 
+int RegexHandler::selectToHandler() {
+  char sourceRelName[ATTR_SIZE];
+  char orderAttribute[ATTR_SIZE];
+  attrToTruncatedArray(m[3], sourceRelName);
+
+  // `*` selects all the attributes (attrCount = 0)
+  vector<string> attrTokens;
+  if (m[2] != "*") {
+    attrTokens = extractTokens(m[2]);
+  }
+  int attrCount = attrTokens.size();
+  char attrNames[attrCount + 1][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attrNames[i]);
+  }
+
+  // the WHERE clause is optional
+  Predicate where;
+  if (m[4].matched && parseCondition(m[4], &where) != SUCCESS) {
+    return E_SYNTAX;
+  }
+
+  // so is the ORDER BY clause (ascending unless DESC is given)
+  if (m[5].matched) {
+    attrToTruncatedArray(m[5], orderAttribute);
+  }
+  bool orderDesc = m[6].matched && toupper(m[6].str()[0]) == 'D';
+
+  // LIMIT n [OFFSET k]; a limit of -1 returns every record
+  int limit = m[7].matched ? stoi(m[7]) : -1;
+  int offset = m[8].matched ? stoi(m[8]) : 0;
+
+  // without a TO clause, the records are printed on the console
+  string fileName = m[9];
+  char fileNameArray[fileName.size() + 1];
+  strcpy(fileNameArray, fileName.c_str());
+
+  int ret = Frontend::select_from_table_to(sourceRelName, m[1].matched, attrCount, attrNames,
+                                           m[4].matched ? &where : nullptr,
+                                           m[5].matched ? orderAttribute : nullptr, orderDesc,
+                                           limit, offset, m[9].matched ? fileNameArray : nullptr);
+  if (ret == SUCCESS && m[9].matched) {
+    cout << "Selected successfully to " << OUTPUT_FILES_PATH << fileName << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::selectJoinToHandler() {
+  char sourceRelOneName[ATTR_SIZE];
+  char sourceRelTwoName[ATTR_SIZE];
+  char joinAttributeOne[ATTR_SIZE];
+  char joinAttributeTwo[ATTR_SIZE];
+  char orderAttribute[ATTR_SIZE];
+
+  attrToTruncatedArray(m[3], sourceRelOneName);
+  attrToTruncatedArray(m[4], sourceRelTwoName);
+
+  if (m[3] == m[5] && m[4] == m[7]) {
+    attrToTruncatedArray(m[6], joinAttributeOne);
+    attrToTruncatedArray(m[8], joinAttributeTwo);
+  } else if (m[3] == m[7] && m[4] == m[5]) {
+    attrToTruncatedArray(m[8], joinAttributeOne);
+    attrToTruncatedArray(m[6], joinAttributeTwo);
+  } else {
+    cout << "Syntax Error: Relation names do not match" << endl;
+    return FAILURE;
+  }
+
+  vector<string> attrTokens;
+  if (m[2] != "*") {
+    attrTokens = extractTokens(m[2]);
+  }
+  int attrCount = attrTokens.size();
+  char attrNames[attrCount + 1][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attrNames[i]);
+  }
+
+  if (m[9].matched) {
+    attrToTruncatedArray(m[9], orderAttribute);
+  }
+  bool orderDesc = m[10].matched && toupper(m[10].str()[0]) == 'D';
+
+  int limit = m[11].matched ? stoi(m[11]) : -1;
+  int offset = m[12].matched ? stoi(m[12]) : 0;
+
+  string fileName = m[13];
+  char fileNameArray[fileName.size() + 1];
+  strcpy(fileNameArray, fileName.c_str());
+
+  int ret = Frontend::select_from_join_to(sourceRelOneName, sourceRelTwoName, joinAttributeOne, joinAttributeTwo,
+                                          m[1].matched, attrCount, attrNames,
+                                          m[9].matched ? orderAttribute : nullptr, orderDesc,
+                                          limit, offset, m[13].matched ? fileNameArray : nullptr);
+  if (ret == SUCCESS && m[13].matched) {
+    cout << "Selected successfully to " << OUTPUT_FILES_PATH << fileName << endl;
+  }
+
+  return ret;
+}
+
+/* splits the JOIN ... ON clauses following FROM firstRel: the k-th clause joins
+relNames[k + 1] on leftRels[k].leftAttrs[k] = relNames[k + 1].rightAttrs[k] */
+static int parseJoinClauses(string firstRel, string clauses, vector<string> &relNames, vector<string> &leftRels,
+                            vector<string> &leftAttrs, vector<string> &rightAttrs) {
+  relNames.push_back(firstRel);
+  regex clauseRegex(JOIN_ON_CLAUSE, regex_constants::icase);
+  for (sregex_iterator it(clauses.begin(), clauses.end(), clauseRegex), end; it != end; ++it) {
+    smatch clause = *it;
+    string rel = clause[1];
+    bool firstIsBefore = find(relNames.begin(), relNames.end(), clause[2].str()) != relNames.end();
+    bool secondIsBefore = find(relNames.begin(), relNames.end(), clause[4].str()) != relNames.end();
+
+    if (clause[4] == rel && firstIsBefore) {
+      leftRels.push_back(clause[2]);
+      leftAttrs.push_back(clause[3]);
+      rightAttrs.push_back(clause[5]);
+    } else if (clause[2] == rel && secondIsBefore) {
+      leftRels.push_back(clause[4]);
+      leftAttrs.push_back(clause[5]);
+      rightAttrs.push_back(clause[3]);
+    } else {
+      cout << "Syntax Error: Relation names do not match" << endl;
+      return FAILURE;
+    }
+    relNames.push_back(rel);
+  }
+  return SUCCESS;
+}
+
+int RegexHandler::selectMultiJoinHandler() {
+  char targetRelName[ATTR_SIZE];
+  attrToTruncatedArray(m[9], targetRelName);
+
+  vector<string> relTokens, leftRelTokens, leftAttrTokens, rightAttrTokens;
+  if (parseJoinClauses(m[2], m[3], relTokens, leftRelTokens, leftAttrTokens, rightAttrTokens) != SUCCESS) {
+    return FAILURE;
+  }
+  int relCount = relTokens.size();
+  char relNames[relCount][ATTR_SIZE];
+  char leftRels[relCount - 1][ATTR_SIZE];
+  char leftAttrs[relCount - 1][ATTR_SIZE];
+  char rightAttrs[relCount - 1][ATTR_SIZE];
+  for (int i = 0; i < relCount; i++) {
+    attrToTruncatedArray(relTokens[i], relNames[i]);
+  }
+  for (int i = 0; i < relCount - 1; i++) {
+    attrToTruncatedArray(leftRelTokens[i], leftRels[i]);
+    attrToTruncatedArray(leftAttrTokens[i], leftAttrs[i]);
+    attrToTruncatedArray(rightAttrTokens[i], rightAttrs[i]);
+  }
+
+  vector<string> attrTokens;
+  if (m[1] != "*") {
+    attrTokens = extractTokens(m[1]);
+  }
+  int attrCount = attrTokens.size();
+  char attrNames[attrCount + 1][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attrNames[i]);
+  }
+
+  int ret = Frontend::select_from_multi_join(relCount, relNames, leftRels, leftAttrs, rightAttrs, targetRelName,
+                                             attrCount, attrNames);
+  if (ret == SUCCESS) {
+    cout << "Selected successfully into " << targetRelName << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::selectMultiJoinToHandler() {
+  char orderAttribute[ATTR_SIZE];
+
+  vector<string> relTokens, leftRelTokens, leftAttrTokens, rightAttrTokens;
+  if (parseJoinClauses(m[3], m[4], relTokens, leftRelTokens, leftAttrTokens, rightAttrTokens) != SUCCESS) {
+    return FAILURE;
+  }
+  int relCount = relTokens.size();
+  char relNames[relCount][ATTR_SIZE];
+  char leftRels[relCount - 1][ATTR_SIZE];
+  char leftAttrs[relCount - 1][ATTR_SIZE];
+  char rightAttrs[relCount - 1][ATTR_SIZE];
+  for (int i = 0; i < relCount; i++) {
+    attrToTruncatedArray(relTokens[i], relNames[i]);
+  }
+  for (int i = 0; i < relCount - 1; i++) {
+    attrToTruncatedArray(leftRelTokens[i], leftRels[i]);
+    attrToTruncatedArray(leftAttrTokens[i], leftAttrs[i]);
+    attrToTruncatedArray(rightAttrTokens[i], rightAttrs[i]);
+  }
+
+  vector<string> attrTokens;
+  if (m[2] != "*") {
+    attrTokens = extractTokens(m[2]);
+  }
+  int attrCount = attrTokens.size();
+  char attrNames[attrCount + 1][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attrNames[i]);
+  }
+
+  if (m[10].matched) {
+    attrToTruncatedArray(m[10], orderAttribute);
+  }
+  bool orderDesc = m[11].matched && toupper(m[11].str()[0]) == 'D';
+
+  int limit = m[12].matched ? stoi(m[12]) : -1;
+  int offset = m[13].matched ? stoi(m[13]) : 0;
+
+  string fileName = m[14];
+  char fileNameArray[fileName.size() + 1];
+  strcpy(fileNameArray, fileName.c_str());
+
+  int ret = Frontend::select_from_multi_join_to(relCount, relNames, leftRels, leftAttrs, rightAttrs,
+                                                m[1].matched, attrCount, attrNames,
+                                                m[10].matched ? orderAttribute : nullptr, orderDesc,
+                                                limit, offset, m[14].matched ? fileNameArray : nullptr);
+  if (ret == SUCCESS && m[14].matched) {
+    cout << "Selected successfully to " << OUTPUT_FILES_PATH << fileName << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::selectAggregateHandler() {
+  char sourceRelName[ATTR_SIZE];
+  char targetRelName[ATTR_SIZE];
+  attrToTruncatedArray(m[8], sourceRelName);
+
+  // the result goes either into a relation or to a file (or the console)
+  if (m[9].matched && m[12].matched) {
+    cout << "Syntax Error: INTO and TO cannot be used together" << endl;
+    return FAILURE;
+  }
+  if (m[9].matched) {
+    attrToTruncatedArray(m[9], targetRelName);
+  }
+
+  // each item of the select list is an aggregate FUNC(attr) or a group attribute
+  string itemList = m[1];
+  regex itemRegex(AGGREGATE_ITEM, regex_constants::icase);
+  vector<int> itemFuncs;
+  vector<string> itemTokens;
+  for (sregex_iterator it(itemList.begin(), itemList.end(), itemRegex), end; it != end; ++it) {
+    smatch item = *it;
+    if (!item[1].matched) {
+      itemFuncs.push_back(-1);
+      itemTokens.push_back(item[3]);
+      continue;
+    }
+
+    string func = item[1];
+    transform(func.begin(), func.end(), func.begin(), ::toupper);
+    if (func == "COUNT") {
+      itemFuncs.push_back(AGG_COUNT);
+    } else if (func == "SUM") {
+      itemFuncs.push_back(AGG_SUM);
+    } else if (func == "AVG") {
+      itemFuncs.push_back(AGG_AVG);
+    } else if (func == "MIN") {
+      itemFuncs.push_back(AGG_MIN);
+    } else {
+      itemFuncs.push_back(AGG_MAX);
+    }
+    itemTokens.push_back(item[2]);
+  }
+  int itemCount = itemTokens.size();
+  char itemAttrs[itemCount][ATTR_SIZE];
+  for (int i = 0; i < itemCount; i++) {
+    attrToTruncatedArray(itemTokens[i], itemAttrs[i]);
+  }
+
+  Predicate where;
+  if (m[10].matched && parseCondition(m[10], &where) != SUCCESS) {
+    return E_SYNTAX;
+  }
+
+  vector<string> groupTokens;
+  if (m[11].matched) {
+    groupTokens = extractTokens(m[11]);
+  }
+  int groupCount = groupTokens.size();
+  char groupAttrs[groupCount + 1][ATTR_SIZE];
+  for (int i = 0; i < groupCount; i++) {
+    attrToTruncatedArray(groupTokens[i], groupAttrs[i]);
+  }
+
+  string fileName = m[12];
+  char fileNameArray[fileName.size() + 1];
+  strcpy(fileNameArray, fileName.c_str());
+
+  int ret = Frontend::select_aggregate(sourceRelName, m[9].matched ? targetRelName : nullptr,
+                                       itemCount, itemFuncs.data(), itemAttrs, groupCount, groupAttrs,
+                                       m[10].matched ? &where : nullptr,
+                                       m[12].matched ? fileNameArray : nullptr);
+  if (ret == SUCCESS && m[9].matched) {
+    cout << "Selected successfully into " << targetRelName << endl;
+  } else if (ret == SUCCESS && m[12].matched) {
+    cout << "Selected successfully to " << OUTPUT_FILES_PATH << fileName << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::subqueryJoin(int first, string srcRel, char attr[ATTR_SIZE], char innerRel[ATTR_SIZE],
+                               char innerAttr[ATTR_SIZE], bool *anti) {
+  // attr [NOT] IN (SELECT innerAttr FROM innerRel)
+  if (m[first].matched) {
+    attrToTruncatedArray(m[first], attr);
+    attrToTruncatedArray(m[first + 2], innerAttr);
+    attrToTruncatedArray(m[first + 3], innerRel);
+    *anti = m[first + 1].matched;
+    return SUCCESS;
+  }
+
+  // [NOT] EXISTS (SELECT * FROM innerRel WHERE rel.attr = rel.attr), one side on each relation
+  string innerName = m[first + 5];
+  attrToTruncatedArray(innerName, innerRel);
+  *anti = m[first + 4].matched;
+  if (m[first + 6] == srcRel && m[first + 8] == innerName) {
+    attrToTruncatedArray(m[first + 7], attr);
+    attrToTruncatedArray(m[first + 9], innerAttr);
+  } else if (m[first + 6] == innerName && m[first + 8] == srcRel) {
+    attrToTruncatedArray(m[first + 9], attr);
+    attrToTruncatedArray(m[first + 7], innerAttr);
+  } else {
+    cout << "Syntax Error: Relation names do not match" << endl;
+    return FAILURE;
+  }
+  return SUCCESS;
+}
+
+int RegexHandler::selectSemiJoinHandler() {
+  char sourceRelName[ATTR_SIZE];
+  char innerRelName[ATTR_SIZE];
+  char targetRelName[ATTR_SIZE];
+  char attribute[ATTR_SIZE];
+  char innerAttribute[ATTR_SIZE];
+  bool anti;
+  attrToTruncatedArray(m[2], sourceRelName);
+  attrToTruncatedArray(m[3], targetRelName);
+  if (subqueryJoin(4, m[2], attribute, innerRelName, innerAttribute, &anti) != SUCCESS) {
+    return FAILURE;
+  }
+
+  vector<string> attrTokens;
+  if (m[1] != "*") {
+    attrTokens = extractTokens(m[1]);
+  }
+  int attrCount = attrTokens.size();
+  char attrNames[attrCount + 1][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attrNames[i]);
+  }
+
+  int ret = Frontend::select_from_semi_join_where(sourceRelName, innerRelName, targetRelName, attribute,
+                                                  innerAttribute, anti, attrCount, attrNames);
+  if (ret == SUCCESS) {
+    cout << "Selected successfully into " << targetRelName << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::selectSemiJoinToHandler() {
+  char sourceRelName[ATTR_SIZE];
+  char innerRelName[ATTR_SIZE];
+  char attribute[ATTR_SIZE];
+  char innerAttribute[ATTR_SIZE];
+  char orderAttribute[ATTR_SIZE];
+  bool anti;
+  attrToTruncatedArray(m[3], sourceRelName);
+  if (subqueryJoin(4, m[3], attribute, innerRelName, innerAttribute, &anti) != SUCCESS) {
+    return FAILURE;
+  }
+
+  vector<string> attrTokens;
+  if (m[2] != "*") {
+    attrTokens = extractTokens(m[2]);
+  }
+  int attrCount = attrTokens.size();
+  char attrNames[attrCount + 1][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attrNames[i]);
+  }
+
+  if (m[14].matched) {
+    attrToTruncatedArray(m[14], orderAttribute);
+  }
+  bool orderDesc = m[15].matched && toupper(m[15].str()[0]) == 'D';
+
+  int limit = m[16].matched ? stoi(m[16]) : -1;
+  int offset = m[17].matched ? stoi(m[17]) : 0;
+
+  string fileName = m[18];
+  char fileNameArray[fileName.size() + 1];
+  strcpy(fileNameArray, fileName.c_str());
+
+  int ret = Frontend::select_from_semi_join_to(sourceRelName, innerRelName, attribute, innerAttribute, anti,
+                                               m[1].matched, attrCount, attrNames,
+                                               m[14].matched ? orderAttribute : nullptr, orderDesc,
+                                               limit, offset, m[18].matched ? fileNameArray : nullptr);
+  if (ret == SUCCESS && m[18].matched) {
+    cout << "Selected successfully to " << OUTPUT_FILES_PATH << fileName << endl;
+  }
+
+  return ret;
+}
+
 int RegexHandler::customFunctionHandler() {
   vector<string> tokens = extractTokens(m[1]);
 
   char tokensAsArray[tokens.size()][ATTR_SIZE];
-  for (int i = 0; i < tokens.size(); ++i) {
+  for (int i = 0; i < (int)tokens.size(); ++i) {
     attrToTruncatedArray(tokens[i], tokensAsArray[i]);
   }
 
@@ -468,8 +1190,7 @@ int RegexHandler::handle(const string command) {
   for (auto iter = handlers.begin(); iter != handlers.end(); ++iter) {
     regex testCommand = iter->first;
     handlerFunction handler = iter->second;
-    if (regex_match(command, testCommand)) {
-      regex_search(command, m, testCommand);
+    if (regex_match(command, m, testCommand)) {
       int status = (this->*handler)();
       if (status == SUCCESS || status == EXIT) {
         return status;
@@ -581,6 +1302,10 @@ void printErrorMsg(int error) {
     cout << "Error: This operation is not permitted" << endl;
   else if (error == E_INDEX_BLOCKS_RELEASED)
     cout << "Warning: Operation succeeded, but some indexes had to be dropped" << endl;
+  else if (error == E_INDEXCORRUPT)
+    cout << "Error: Index is inconsistent" << endl;
+  else if (error == E_SYNTAX)
+    cout << "Syntax Error" << endl;
 }
 
 void printHelp() {
@@ -588,18 +1313,40 @@ void printHelp() {
   printf("DROP TABLE tablename;\n\t-delete the relation\n  \n");
   printf("OPEN TABLE tablename;\n\t-open the relation \n\n");
   printf("CLOSE TABLE tablename;\n\t-close the relation \n \n");
+  printf("SET AUTOOPEN ON|OFF;\n\t-open relations used by queries automatically (least recently used ones are closed when the table is full)\n\n");
+  printf("SET JOIN MEMORY blocks;\n\t-set the memory a join without an index holds per pass over its other input (%d blocks by default)\n\n", JOIN_MEMORY_BUDGET / BLOCK_SIZE);
   printf("CREATE INDEX ON tablename.attributename;\n\t-create an index on a given attribute. \n\n");
   printf("DROP INDEX ON tablename.attributename; \n\t-delete the index. \n\n");
+  printf("CREATE INDEX ON tablename.(attr1, attr2, ...);\n\t-create an index on up to %d attributes, ordered on attr1 first. \n\n", MAX_COMPOSITE_KEYS);
+  printf("DROP INDEX ON tablename.(attr1, attr2, ...); \n\t-delete the index on the attributes. \n\n");
+  printf("CREATE COMPRESSED INDEX ON tablename.attributename;\n\t-create a B+ tree on a string attribute whose blocks store the common prefix of their keys once. \n\n");
+  printf("DROP COMPRESSED INDEX ON tablename.attributename; \n\t-delete the compressed index. \n\n");
+  printf("CREATE HASH INDEX ON tablename.attributename;\n\t-create a hash index on a given attribute, used by equality searches and joins. \n\n");
+  printf("DROP HASH INDEX ON tablename.attributename; \n\t-delete the hash index. \n\n");
+  printf("CREATE ZONEMAP ON tablename;\n\t-keep the range of every attribute per block so that searches can skip blocks. \n\n");
+  printf("DROP ZONEMAP ON tablename;\n\t-delete the zone map. \n\n");
+  printf("VACUUM tablename;\n\t-move the records into as few blocks as possible, release the empty blocks and rebuild the indexes. \n\n");
+  printf("CLUSTER tablename ON attrname;\n\t-rewrite the records of the relation in the order of the attribute so that range scans read consecutive blocks. \n\n");
   printf("ALTER TABLE RENAME tablename TO new_tablename;\n\t-rename an existing relation to a given new name. \n\n");
   printf("ALTER TABLE RENAME tablename COLUMN column_name TO new_column_name;\n\t-rename an attribute of an existing relation.\n\n");
   printf("INSERT INTO tablename VALUES ( value1,value2,value3,... );\n\t-insert a single record into the given relation. \n\n");
   printf("INSERT INTO tablename VALUES FROM filepath; \n\t-insert multiple records from a csv file \n\n");
+  printf("DELETE FROM tablename [WHERE condition]; \n\t-delete the records satisfying the condition (all the records without WHERE) \n\n");
+  printf("UPDATE tablename SET attrname = value[, attrname = value ...] [WHERE condition]; \n\t-change the given attributes of the records satisfying the condition \n\n");
   printf("SELECT * FROM source_relation INTO target_relation; \n\t-creates a relation with the same attributes and records as of source relation\n\n");
   printf("SELECT Attribute1,Attribute2,....FROM source_relation INTO target_relation; \n\t-creates a relation with attributes specified and all records\n\n");
-  printf("SELECT * FROM source_relation INTO target_relation WHERE attrname OP value; \n\t-retrieve records based on a condition and insert them into a target relation\n\n");
+  printf("SELECT * FROM source_relation INTO target_relation WHERE condition; \n\t-retrieve records based on a condition and insert them into a target relation\n\n");
   printf("SELECT Attribute1,Attribute2,....FROM source_relation INTO target_relation;\n\t-creates a relation with the attributes specified and inserts those records which satisfy the given condition.\n\n");
   printf("SELECT * FROM source_relation1 JOIN source_relation2 INTO target_relation WHERE source_relation1.attribute1 = source_relation2.attribute2; \n\t-creates a new relation with by equi-join of both the source relations\n\n");
   printf("SELECT Attribute1,Attribute2,.. FROM source_relation1 JOIN source_relation2 INTO target_relation WHERE source_relation1.attribute1 = source_relation2.attribute2; \n\t-creates a new relation by equi-join of both the source relations with the attributes specified \n\n");
+  printf("SELECT [DISTINCT] * FROM source_relation [WHERE condition] [ORDER BY attrname [ASC|DESC]] [LIMIT n [OFFSET k]] [TO filename.csv]; \n\t-print the records satisfying the condition on the console or write them to a csv file in Output_Files without creating a relation\n\n");
+  printf("SELECT [DISTINCT] Attribute1,Attribute2,.. FROM source_relation [WHERE condition] [ORDER BY attrname [ASC|DESC]] [LIMIT n [OFFSET k]] [TO filename.csv]; \n\t-print the specified attributes of the records on the console or write them to a csv file\n\n");
+  printf("SELECT [DISTINCT] Attribute1,Attribute2,.. FROM source_relation1 JOIN source_relation2 WHERE source_relation1.attribute1 = source_relation2.attribute2 [ORDER BY attrname [ASC|DESC]] [LIMIT n [OFFSET k]] [TO filename.csv]; \n\t-print the equi-join of both the source relations on the console or write it to a csv file\n\n");
+  printf("SELECT [DISTINCT] Attribute1,Attribute2,..|* FROM source_relation1 JOIN source_relation2 ON source_relation1.attribute1 = source_relation2.attribute2 [JOIN source_relation3 ON ...]... [INTO target_relation] [ORDER BY attrname [ASC|DESC]] [LIMIT n [OFFSET k]] [TO filename.csv]; \n\t-equi-join of two or more relations, joined in the order of least estimated cost without intermediate relations. INTO takes no DISTINCT, ORDER BY, LIMIT or TO\n\n");
+  printf("SELECT Attribute1,..,FUNC(Attribute),.. FROM source_relation [INTO target_relation] [WHERE condition] [GROUP BY Attribute1,..] [TO filename.csv]; \n\t-compute COUNT, SUM, AVG, MIN or MAX (COUNT(*) counts records) over each group of records\n\n");
+  printf("SELECT [DISTINCT] Attribute1,Attribute2,..|* FROM source_relation1 [INTO target_relation] WHERE attrname [NOT] IN (SELECT attrname2 FROM source_relation2) [ORDER BY attrname [ASC|DESC]] [LIMIT n [OFFSET k]] [TO filename.csv]; \n\t-semi-join (anti-join with NOT): the records of source_relation1 with (without) a match in source_relation2, each once. INTO takes no DISTINCT, ORDER BY, LIMIT or TO\n\n");
+  printf("SELECT ... FROM source_relation1 ... WHERE [NOT] EXISTS (SELECT * FROM source_relation2 WHERE source_relation2.attribute2 = source_relation1.attribute1) ...; \n\t-the same as attribute1 [NOT] IN (SELECT attribute2 FROM source_relation2)\n\n");
+  printf("condition: attrname OP value, or conditions joined by AND / OR and grouped with parentheses \n\t-e.g. WHERE (Batch = J OR Batch = K) AND Marks >= 50; AND binds tighter than OR\n\n");
   printf("echo <any message> \n\t  -echo back the given string. \n\n");
   printf("run <filename> \n\t  -run commands from an input file in sequence. \n\n");
   printf("exit \n\t-Exit the interface\n");
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+#include "../Algebra/Operator.h"
+
 /* External File System Commands */
 #define HELP_CMD "\\s*HELP\\s*;?"
 #define EXIT_CMD "\\s*EXIT\\s*;?"
@@ -16,20 +18,55 @@
 #define DROP_TABLE_CMD "\\s*DROP\\s+TABLE\\s+([A-Za-z0-9_-]+)\\s*;?"
 #define OPEN_TABLE_CMD "\\s*OPEN\\s+TABLE\\s+([A-Za-z0-9_-]+)\\s*;?"
 #define CLOSE_TABLE_CMD "\\s*CLOSE\\s+TABLE\\s+([A-Za-z0-9_-]+)\\s*;?"
+#define SET_AUTOOPEN_CMD "\\s*SET\\s+AUTOOPEN\\s+(ON|OFF)\\s*;?"
+#define SET_JOIN_MEMORY_CMD "\\s*SET\\s+JOIN\\s+MEMORY\\s+([0-9]{1,9})\\s*;?"
 #define CREATE_INDEX_CMD "\\s*CREATE\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
 #define DROP_INDEX_CMD "\\s*DROP\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
+#define CREATE_COMPOSITE_INDEX_CMD "\\s*CREATE\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*\\(\\s*((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s*\\)\\s*;?"
+#define DROP_COMPOSITE_INDEX_CMD "\\s*DROP\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*\\(\\s*((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s*\\)\\s*;?"
+#define CREATE_COMPRESSED_INDEX_CMD "\\s*CREATE\\s+COMPRESSED\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
+#define DROP_COMPRESSED_INDEX_CMD "\\s*DROP\\s+COMPRESSED\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
+#define CREATE_HASH_INDEX_CMD "\\s*CREATE\\s+HASH\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
+#define DROP_HASH_INDEX_CMD "\\s*DROP\\s+HASH\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
+#define CREATE_ZONEMAP_CMD "\\s*CREATE\\s+ZONEMAP\\s+ON\\s+([A-Za-z0-9_-]+)\\s*;?"
+#define DROP_ZONEMAP_CMD "\\s*DROP\\s+ZONEMAP\\s+ON\\s+([A-Za-z0-9_-]+)\\s*;?"
+#define VACUUM_CMD "\\s*VACUUM\\s+([A-Za-z0-9_-]+)\\s*;?"
+#define CLUSTER_CMD "\\s*CLUSTER\\s+([A-Za-z0-9_-]+)\\s+ON\\s+([#A-Za-z0-9_-]+)\\s*;?"
 #define RENAME_TABLE_CMD "\\s*ALTER\\s+TABLE\\s+RENAME\\s+([a-zA-Z0-9_-]+)\\s+TO\\s+([a-zA-Z0-9_-]+)\\s*;?"
 #define RENAME_COLUMN_CMD "\\s*ALTER\\s+TABLE\\s+RENAME\\s+([a-zA-Z0-9_-]+)\\s+COLUMN\\s+([#a-zA-Z0-9_-]+)\\s+TO\\s+([#a-zA-Z0-9_-]+)\\s*;?"
 
 /* DML Commands */
 #define SELECT_FROM_CMD "\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s*;?"
 #define SELECT_ATTR_FROM_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s*;?"
-#define SELECT_FROM_WHERE_CMD "\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+)\\s*(<|<=|>|>=|=|!=)\\s*([A-Za-z0-9_-]+|([0-9]+(\\.)[0-9]+))\\s*;?"
-#define SELECT_ATTR_FROM_WHERE_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+)\\s*(<|<=|>|>=|=|!=)\\s*([A-Za-z0-9_-]+|([0-9]+(\\.)[0-9]+))\\s*;?"
+/* a condition is a comparison or comparisons joined by AND / OR, grouped with parentheses.
+The pattern only delimits it: parseCondition checks that the parentheses balance and that
+every AND / OR is followed by a comparison, so that both mistakes fail the same way. */
+#define COMPARISON "(?:\\(\\s*)*[#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)(?:\\s*\\))*"
+#define CONDITION "(" COMPARISON "(?:\\s+(?:AND|OR)\\b(?:\\s+" COMPARISON ")?)*)"
+#define SELECT_FROM_WHERE_CMD "\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+" CONDITION "\\s*;?"
+#define SELECT_ATTR_FROM_WHERE_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+" CONDITION "\\s*;?"
 #define SELECT_FROM_JOIN_CMD "\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*;?"
 #define SELECT_ATTR_FROM_JOIN_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*;?"
+#define ORDER_BY_CLAUSE "(?:\\s+ORDER\\s+BY\\s+([#A-Za-z0-9_-]+)(?:\\s+(ASC|DESC))?)?"
+#define LIMIT_CLAUSE "(?:\\s+LIMIT\\s+([0-9]+)(?:\\s+OFFSET\\s+([0-9]+))?)?"
+#define SELECT_TO_CMD "\\s*SELECT\\s+(DISTINCT\\s+)?(\\*|(?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)(?:\\s+WHERE\\s+" CONDITION ")?" ORDER_BY_CLAUSE LIMIT_CLAUSE "(?:\\s+TO\\s+'?([A-Za-z0-9_-]+\\.csv)'?)?\\s*;?"
+#define SELECT_JOIN_TO_CMD "\\s*SELECT\\s+(DISTINCT\\s+)?(\\*|(?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)" ORDER_BY_CLAUSE LIMIT_CLAUSE "(?:\\s+TO\\s+'?([A-Za-z0-9_-]+\\.csv)'?)?\\s*;?"
+// JOIN rel ON rel.attr = rel.attr, one side on the relation joined and the other on a relation before it
+#define JOIN_ON_CLAUSE "\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)"
+#define SELECT_MULTI_JOIN_CMD "\\s*SELECT\\s+(\\*|(?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)((?:" JOIN_ON_CLAUSE ")+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s*;?"
+#define SELECT_MULTI_JOIN_TO_CMD "\\s*SELECT\\s+(DISTINCT\\s+)?(\\*|(?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)((?:" JOIN_ON_CLAUSE ")+)" ORDER_BY_CLAUSE LIMIT_CLAUSE "(?:\\s+TO\\s+'?([A-Za-z0-9_-]+\\.csv)'?)?\\s*;?"
+// attr [NOT] IN (SELECT attr FROM rel), or [NOT] EXISTS (SELECT * FROM rel WHERE rel.attr = rel.attr)
+#define SUBQUERY_CONDITION "(?:([#A-Za-z0-9_-]+)\\s+(NOT\\s+)?IN\\s*\\(\\s*SELECT\\s+([#A-Za-z0-9_-]+)\\s+FROM\\s+([A-Za-z0-9_-]+)\\s*\\)|(NOT\\s+)?EXISTS\\s*\\(\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\))"
+#define SELECT_SEMI_JOIN_CMD "\\s*SELECT\\s+(\\*|(?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+" SUBQUERY_CONDITION "\\s*;?"
+#define SELECT_SEMI_JOIN_TO_CMD "\\s*SELECT\\s+(DISTINCT\\s+)?(\\*|(?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+" SUBQUERY_CONDITION ORDER_BY_CLAUSE LIMIT_CLAUSE "(?:\\s+TO\\s+'?([A-Za-z0-9_-]+\\.csv)'?)?\\s*;?"
+#define AGGREGATE_ITEM "(?:(COUNT|SUM|AVG|MIN|MAX)\\s*\\(\\s*(\\*|[#A-Za-z0-9_-]+)\\s*\\)|([#A-Za-z0-9_-]+))"
+#define SELECT_AGGREGATE_CMD "\\s*SELECT\\s+((?:" AGGREGATE_ITEM "\\s*,\\s*)*" AGGREGATE_ITEM ")\\s+FROM\\s+([A-Za-z0-9_-]+)(?:\\s+INTO\\s+([A-Za-z0-9_-]+))?(?:\\s+WHERE\\s+" CONDITION ")?(?:\\s+GROUP\\s+BY\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+)))?(?:\\s+TO\\s+'?([A-Za-z0-9_-]+\\.csv)'?)?\\s*;?"
 #define INSERT_SINGLE_CMD "\\s*INSERT\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+VALUES\\s*\\(\\s*((?:(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)\\s*,\\s*)*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+))\\s*\\)\\s*;?"
 #define INSERT_MULTIPLE_CMD "\\s*INSERT\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+VALUES\\s+FROM\\s+([a-zA-Z0-9_-]+\\.csv)\\s*;?"
+#define WHERE_CLAUSE "(?:\\s+WHERE\\s+" CONDITION ")?"
+#define SET_ITEM "[#A-Za-z0-9_-]+\\s*=\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)"
+#define DELETE_CMD "\\s*DELETE\\s+FROM\\s+([A-Za-z0-9_-]+)" WHERE_CLAUSE "\\s*;?"
+#define UPDATE_CMD "\\s*UPDATE\\s+([A-Za-z0-9_-]+)\\s+SET\\s+((?:" SET_ITEM "\\s*,\\s*)*" SET_ITEM ")" WHERE_CLAUSE "\\s*;?"
 #define CUSTOM_CMD "\\s*FUNCTION\\s+([A-Za-z,#0-9\\s()_-]+)\\s*;?"
 
 #define REGEX(c) std::regex(c, std::regex_constants::icase)
@@ -46,26 +83,54 @@ class RegexHandler {
       {REGEX(RUN_CMD), &RegexHandler::runHandler},
       {REGEX(OPEN_TABLE_CMD), &RegexHandler::openHandler},
       {REGEX(CLOSE_TABLE_CMD), &RegexHandler::closeHandler},
+      {REGEX(SET_AUTOOPEN_CMD), &RegexHandler::autoOpenHandler},
+      {REGEX(SET_JOIN_MEMORY_CMD), &RegexHandler::joinMemoryHandler},
       {REGEX(CREATE_TABLE_CMD), &RegexHandler::createTableHandler},
       {REGEX(DROP_TABLE_CMD), &RegexHandler::dropTableHandler},
       {REGEX(CREATE_INDEX_CMD), &RegexHandler::createIndexHandler},
       {REGEX(DROP_INDEX_CMD), &RegexHandler::dropIndexHandler},
+      {REGEX(CREATE_COMPOSITE_INDEX_CMD), &RegexHandler::createCompositeIndexHandler},
+      {REGEX(DROP_COMPOSITE_INDEX_CMD), &RegexHandler::dropCompositeIndexHandler},
+      {REGEX(CREATE_COMPRESSED_INDEX_CMD), &RegexHandler::createCompressedIndexHandler},
+      {REGEX(DROP_COMPRESSED_INDEX_CMD), &RegexHandler::dropCompressedIndexHandler},
+      {REGEX(CREATE_HASH_INDEX_CMD), &RegexHandler::createHashIndexHandler},
+      {REGEX(DROP_HASH_INDEX_CMD), &RegexHandler::dropHashIndexHandler},
+      {REGEX(CREATE_ZONEMAP_CMD), &RegexHandler::createZoneMapHandler},
+      {REGEX(DROP_ZONEMAP_CMD), &RegexHandler::dropZoneMapHandler},
+      {REGEX(VACUUM_CMD), &RegexHandler::vacuumHandler},
+      {REGEX(CLUSTER_CMD), &RegexHandler::clusterHandler},
       {REGEX(RENAME_TABLE_CMD), &RegexHandler::renameTableHandler},
       {REGEX(RENAME_COLUMN_CMD), &RegexHandler::renameColumnHandler},
       {REGEX(INSERT_SINGLE_CMD), &RegexHandler::insertSingleHandler},
       {REGEX(INSERT_MULTIPLE_CMD), &RegexHandler::insertFromFileHandler},
+      {REGEX(DELETE_CMD), &RegexHandler::deleteHandler},
+      {REGEX(UPDATE_CMD), &RegexHandler::updateHandler},
       {REGEX(SELECT_FROM_CMD), &RegexHandler::selectFromHandler},
       {REGEX(SELECT_FROM_WHERE_CMD), &RegexHandler::selectFromWhereHandler},
       {REGEX(SELECT_ATTR_FROM_CMD), &RegexHandler::selectAttrFromHandler},
       {REGEX(SELECT_ATTR_FROM_WHERE_CMD), &RegexHandler::selectAttrFromWhereHandler},
       {REGEX(SELECT_FROM_JOIN_CMD), &RegexHandler::selectFromJoinHandler},
       {REGEX(SELECT_ATTR_FROM_JOIN_CMD), &RegexHandler::selectAttrFromJoinHandler},
+      {REGEX(SELECT_TO_CMD), &RegexHandler::selectToHandler},
+      {REGEX(SELECT_JOIN_TO_CMD), &RegexHandler::selectJoinToHandler},
+      {REGEX(SELECT_MULTI_JOIN_CMD), &RegexHandler::selectMultiJoinHandler},
+      {REGEX(SELECT_MULTI_JOIN_TO_CMD), &RegexHandler::selectMultiJoinToHandler},
+      {REGEX(SELECT_AGGREGATE_CMD), &RegexHandler::selectAggregateHandler},
+      {REGEX(SELECT_SEMI_JOIN_CMD), &RegexHandler::selectSemiJoinHandler},
+      {REGEX(SELECT_SEMI_JOIN_TO_CMD), &RegexHandler::selectSemiJoinToHandler},
       {REGEX(CUSTOM_CMD), &RegexHandler::customFunctionHandler},
   };
 
   // extract tokens delimited by whitespace and comma
   std::vector<std::string> extractTokens(std::string input);
 
+  // parse a WHERE condition into a predicate tree (AND binds tighter than OR); E_SYNTAX if it is malformed
+  int parseCondition(std::string text, Predicate *where);
+
+  // the join of a SUBQUERY_CONDITION whose groups start at m[first], with srcRel as the outer relation
+  int subqueryJoin(int first, std::string srcRel, char attr[ATTR_SIZE], char innerRel[ATTR_SIZE],
+                   char innerAttr[ATTR_SIZE], bool *anti);
+
   // handler functions
   std::smatch m;  // to store matches while parsing the regex
   int helpHandler();
@@ -74,20 +139,41 @@ class RegexHandler {
   int runHandler();
   int openHandler();
   int closeHandler();
+  int autoOpenHandler();
+  int joinMemoryHandler();
   int createTableHandler();
   int dropTableHandler();
   int createIndexHandler();
   int dropIndexHandler();
+  int createCompositeIndexHandler();
+  int dropCompositeIndexHandler();
+  int createCompressedIndexHandler();
+  int dropCompressedIndexHandler();
+  int createHashIndexHandler();
+  int dropHashIndexHandler();
+  int createZoneMapHandler();
+  int dropZoneMapHandler();
+  int vacuumHandler();
+  int clusterHandler();
   int renameTableHandler();
   int renameColumnHandler();
   int insertSingleHandler();
   int insertFromFileHandler();
+  int deleteHandler();
+  int updateHandler();
   int selectFromHandler();
   int selectFromWhereHandler();
   int selectAttrFromHandler();
   int selectAttrFromWhereHandler();
   int selectFromJoinHandler();
   int selectAttrFromJoinHandler();
+  int selectToHandler();
+  int selectJoinToHandler();
+  int selectMultiJoinHandler();
+  int selectMultiJoinToHandler();
+  int selectAggregateHandler();
+  int selectSemiJoinHandler();
+  int selectSemiJoinToHandler();
   int customFunctionHandler();
 
  public:
@@ -1,6 +1,7 @@
 #include "Schema.h"
 
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 
 int Schema::openRel(char relName[ATTR_SIZE])
@@ -8,7 +9,7 @@ int Schema::openRel(char relName[ATTR_SIZE])
 	int ret = OpenRelTable::openRel(relName);
 
 	// the OpenRelTable::openRel() function returns the rel-id if successful
-	// a valid rel-id will be within the range 0 <= relId < MAX_OPEN and any
+	// a valid rel-id will be a slot of the open relation table and any
 	// error codes will be negative
 	if(ret >= 0)
 	{
@@ -51,6 +52,8 @@ int Schema::renameRel(char oldRelName[ATTR_SIZE], char newRelName[ATTR_SIZE])
 	// if the relation is open
 	//    (check if OpenRelTable::getRelId() returns E_RELNOTOPEN)
 	//    return E_RELOPEN
+	// (a relation that was only opened implicitly by a query is closed first)
+	OpenRelTable::releaseAutoOpened(oldRelName);
 	if (OpenRelTable::getRelId(oldRelName)!=E_RELNOTOPEN)
 		return E_RELOPEN;
 	
@@ -70,6 +73,7 @@ int Schema::renameAttr(char *relName, char *oldAttrName, char *newAttrName)
 	// if the relation is open
 	//    (check if OpenRelTable::getRelId() returns E_RELNOTOPEN)
 	//    return E_RELOPEN
+	OpenRelTable::releaseAutoOpened(relName);
 	if (OpenRelTable::getRelId(relName)!=E_RELNOTOPEN)
 		return E_RELOPEN;
 	// Call BlockAccess::renameAttribute with appropriate arguments.
@@ -85,8 +89,9 @@ int Schema::deleteRel(char *relName)
 
 	// get the rel-id using appropriate method of OpenRelTable class by
 	// passing relation name as argument
+	OpenRelTable::releaseAutoOpened(relName);
 	int ret=OpenRelTable::getRelId(relName);
-	if (ret>=0 && ret<MAX_OPEN)
+	if (ret>=0)
 		return E_RELOPEN;
 
 	// Call BlockAccess::deleteRelation() with appropriate argument.
@@ -97,17 +102,9 @@ int Schema::deleteRel(char *relName)
 
 int Schema::createRel(char relName[],int nAttrs, char attrs[][ATTR_SIZE],int attrtype[])
 {
-	Attribute relNameAsAttribute;
-	strcpy(relNameAsAttribute.sVal,relName);
-
+	// if a relation with the same name is in the catalog directory, return E_RELEXIST
 	RecId targetRelId;
-
-	RelCacheTable::resetSearchIndex(RELCAT_RELID);
-	char RelName[8];
-	strcpy(RelName,"RelName");
-	targetRelId=BlockAccess::linearSearch(RELCAT_RELID,RelName, relNameAsAttribute, EQ);
-
-	if (targetRelId.block!=-1 || targetRelId.slot!=-1)
+	if (CatalogDirectory::getRelCatRecId(relName, &targetRelId) == SUCCESS)
 		return E_RELEXIST;
 
 	// compare every pair of attributes of attrNames[] array
@@ -177,10 +174,10 @@ int Schema::createIndex(char relName[ATTR_SIZE],char attrName[ATTR_SIZE])
         	return E_NOTPERMITTED;
 
 	// get the relation's rel-id using OpenRelTable::getRelId() method
-	int relId=OpenRelTable::getRelId(relName);
+	int relId=OpenRelTable::getQueryRelId(relName);
 
-	if(relId==E_RELNOTOPEN)
-		return E_RELNOTOPEN;
+	if(relId<0)
+		return relId;
 		
 	return BPlusTree::bPlusCreate(relId, attrName);
 }
@@ -194,9 +191,9 @@ int Schema::dropIndex(char *relName, char *attrName)
 	// get the rel-id using OpenRelTable::getRelId()
 
 	// if relation is not open in open relation table, return E_RELNOTOPEN
-	int relId=OpenRelTable::getRelId(relName);
-	if(relId==E_RELNOTOPEN)
-		return E_RELNOTOPEN;
+	int relId=OpenRelTable::getQueryRelId(relName);
+	if(relId<0)
+		return relId;
 
 	// get the attribute catalog entry corresponding to the attribute
 	// using AttrCacheTable::getAttrCatEntry()
@@ -223,3 +220,259 @@ int Schema::dropIndex(char *relName, char *attrName)
 	return SUCCESS;
 }
 
+/* gets the offsets of the key attributes of a composite index on attrNames
+(in that order) and the relation's rel-id */
+static int compositeKeys(char relName[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE], int *relId, int keyOffsets[])
+{
+	if(strcmp(relName, RELCAT_RELNAME)==0 || strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
+
+	if(numAttrs < 2 || numAttrs > MAX_COMPOSITE_KEYS)
+		return E_INVALID;
+
+	*relId=OpenRelTable::getQueryRelId(relName);
+	if(*relId<0)
+		return *relId;
+
+	for(int i=0; i<numAttrs; ++i)
+	{
+		AttrCatEntry attrCatBuf;
+		if(AttrCacheTable::getAttrCatEntry(*relId, attrNames[i], &attrCatBuf)!=SUCCESS)
+			return E_ATTRNOTEXIST;
+		keyOffsets[i]=attrCatBuf.offset;
+
+		for(int j=0; j<i; ++j)
+		{
+			if(keyOffsets[j]==keyOffsets[i])
+				return E_DUPLICATEATTR;
+		}
+	}
+	return SUCCESS;
+}
+
+int Schema::createIndex(char relName[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE])
+{
+	// an index on a single attribute is an ordinary B+ tree
+	if(numAttrs==1)
+		return Schema::createIndex(relName, attrNames[0]);
+
+	int relId;
+	int keyOffsets[MAX_COMPOSITE_KEYS];
+	int ret=compositeKeys(relName, numAttrs, attrNames, &relId, keyOffsets);
+	if(ret!=SUCCESS)
+		return ret;
+
+	// (an index on the same attributes already exists)
+	CompositeIndexInfo index;
+	if(CompositeIndex::find(relId, numAttrs, keyOffsets, &index)==SUCCESS)
+		return SUCCESS;
+
+	/* the index is recorded in the attribute catalog with Offset -1 and the
+	offsets of its key attributes as the attribute name */
+	Attribute attrCatRecord[ATTRCAT_NO_ATTRS];
+	strcpy(attrCatRecord[ATTRCAT_REL_NAME_INDEX].sVal,relName);
+	CompositeIndex::keyName(numAttrs, keyOffsets, attrCatRecord[ATTRCAT_ATTR_NAME_INDEX].sVal);
+	attrCatRecord[ATTRCAT_ATTR_TYPE_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_PRIMARY_FLAG_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_ROOT_BLOCK_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_OFFSET_INDEX].nVal=COMPOSITE_INDEX_OFFSET;
+	ret=BlockAccess::insert(ATTRCAT_RELID, attrCatRecord);
+	if(ret!=SUCCESS)
+		return ret;
+
+	// insert the entries of the records already in the relation
+	CompositeIndex::find(relId, numAttrs, keyOffsets, &index);
+	ret=CompositeIndex::build(relId, &index);
+	if(ret!=SUCCESS)
+	{
+		BlockAccess::dropCompositeIndex(relId, &index);
+		return ret;
+	}
+	return SUCCESS;
+}
+
+int Schema::dropIndex(char relName[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE])
+{
+	if(numAttrs==1)
+		return Schema::dropIndex(relName, attrNames[0]);
+
+	int relId;
+	int keyOffsets[MAX_COMPOSITE_KEYS];
+	int ret=compositeKeys(relName, numAttrs, attrNames, &relId, keyOffsets);
+	if(ret!=SUCCESS)
+		return ret;
+
+	CompositeIndexInfo index;
+	if(CompositeIndex::find(relId, numAttrs, keyOffsets, &index)!=SUCCESS)
+		return E_NOINDEX;
+
+	return BlockAccess::dropCompositeIndex(relId, &index);
+}
+
+/* gets the rel-id of relName and the compressed index on attrName; returns
+E_NOINDEX (with index->keyOffsets[0] set) if the attribute has none */
+static int compressedIndexOf(char relName[ATTR_SIZE], char attrName[ATTR_SIZE], int *relId, CompositeIndexInfo *index)
+{
+	if(strcmp(relName, RELCAT_RELNAME)==0 || strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
+
+	*relId=OpenRelTable::getQueryRelId(relName);
+	if(*relId<0)
+		return *relId;
+
+	AttrCatEntry attrCatBuf;
+	if(AttrCacheTable::getAttrCatEntry(*relId, attrName, &attrCatBuf)!=SUCCESS)
+		return E_ATTRNOTEXIST;
+	// (only string keys have a prefix to share)
+	if(attrCatBuf.attrType!=STRING)
+		return E_ATTRTYPEMISMATCH;
+
+	// (a compressed index is the only kind of composite index with one key)
+	index->keyOffsets[0]=attrCatBuf.offset;
+	return CompositeIndex::find(*relId, 1, index->keyOffsets, index);
+}
+
+int Schema::createCompressedIndex(char relName[ATTR_SIZE], char attrName[ATTR_SIZE])
+{
+	int relId;
+	CompositeIndexInfo index;
+	int ret=compressedIndexOf(relName, attrName, &relId, &index);
+	// (the attribute already has a compressed index)
+	if(ret==SUCCESS)
+		return SUCCESS;
+	if(ret!=E_NOINDEX)
+		return ret;
+
+	/* the index is recorded in the attribute catalog with Offset -3 and the
+	offset of the attribute as the attribute name */
+	int keyOffset=index.keyOffsets[0];
+	Attribute attrCatRecord[ATTRCAT_NO_ATTRS];
+	strcpy(attrCatRecord[ATTRCAT_REL_NAME_INDEX].sVal,relName);
+	CompositeIndex::keyName(1, &keyOffset, attrCatRecord[ATTRCAT_ATTR_NAME_INDEX].sVal);
+	attrCatRecord[ATTRCAT_ATTR_TYPE_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_PRIMARY_FLAG_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_ROOT_BLOCK_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_OFFSET_INDEX].nVal=COMPRESSED_INDEX_OFFSET;
+	ret=BlockAccess::insert(ATTRCAT_RELID, attrCatRecord);
+	if(ret!=SUCCESS)
+		return ret;
+
+	// insert the entries of the records already in the relation
+	CompositeIndex::find(relId, 1, &keyOffset, &index);
+	ret=CompositeIndex::build(relId, &index);
+	if(ret!=SUCCESS)
+	{
+		BlockAccess::dropCompositeIndex(relId, &index);
+		return ret;
+	}
+	return SUCCESS;
+}
+
+int Schema::dropCompressedIndex(char relName[ATTR_SIZE], char attrName[ATTR_SIZE])
+{
+	int relId;
+	CompositeIndexInfo index;
+	int ret=compressedIndexOf(relName, attrName, &relId, &index);
+	if(ret!=SUCCESS)
+		return ret;
+
+	return BlockAccess::dropCompositeIndex(relId, &index);
+}
+
+/* gets the rel-id of relName and the hash index on attrName; returns
+E_NOINDEX (with index->attrOffset set) if the attribute has none */
+static int hashIndexOf(char relName[ATTR_SIZE], char attrName[ATTR_SIZE], int *relId, HashIndexInfo *index)
+{
+	if(strcmp(relName, RELCAT_RELNAME)==0 || strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
+
+	*relId=OpenRelTable::getQueryRelId(relName);
+	if(*relId<0)
+		return *relId;
+
+	AttrCatEntry attrCatBuf;
+	if(AttrCacheTable::getAttrCatEntry(*relId, attrName, &attrCatBuf)!=SUCCESS)
+		return E_ATTRNOTEXIST;
+
+	index->attrOffset=attrCatBuf.offset;
+	return HashIndex::find(*relId, attrCatBuf.offset, index);
+}
+
+int Schema::createHashIndex(char relName[ATTR_SIZE], char attrName[ATTR_SIZE])
+{
+	int relId;
+	HashIndexInfo index;
+	int ret=hashIndexOf(relName, attrName, &relId, &index);
+	// (the attribute already has a hash index)
+	if(ret==SUCCESS)
+		return SUCCESS;
+	if(ret!=E_NOINDEX)
+		return ret;
+
+	/* the index is recorded in the attribute catalog with Offset -2 and the
+	offset of the attribute as the attribute name */
+	Attribute attrCatRecord[ATTRCAT_NO_ATTRS];
+	strcpy(attrCatRecord[ATTRCAT_REL_NAME_INDEX].sVal,relName);
+	snprintf(attrCatRecord[ATTRCAT_ATTR_NAME_INDEX].sVal, ATTR_SIZE, "%d", index.attrOffset);
+	attrCatRecord[ATTRCAT_ATTR_TYPE_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_PRIMARY_FLAG_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_ROOT_BLOCK_INDEX].nVal=-1;
+	attrCatRecord[ATTRCAT_OFFSET_INDEX].nVal=HASH_INDEX_OFFSET;
+	ret=BlockAccess::insert(ATTRCAT_RELID, attrCatRecord);
+	if(ret!=SUCCESS)
+		return ret;
+
+	// insert the entries of the records already in the relation
+	HashIndex::find(relId, index.attrOffset, &index);
+	ret=HashIndex::build(relId, &index);
+	if(ret!=SUCCESS)
+	{
+		BlockAccess::dropHashIndex(relId, &index);
+		return ret;
+	}
+	return SUCCESS;
+}
+
+int Schema::dropHashIndex(char relName[ATTR_SIZE], char attrName[ATTR_SIZE])
+{
+	int relId;
+	HashIndexInfo index;
+	int ret=hashIndexOf(relName, attrName, &relId, &index);
+	if(ret!=SUCCESS)
+		return ret;
+
+	return BlockAccess::dropHashIndex(relId, &index);
+}
+
+int Schema::createZoneMap(char relName[ATTR_SIZE])
+{
+	if(strcmp(relName, RELCAT_RELNAME)==0 || strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
+
+	// the zone map is built from the records of the open relation
+	int relId=OpenRelTable::getQueryRelId(relName);
+	if(relId<0)
+		return relId;
+
+	return ZoneMap::create(relId);
+}
+
+int Schema::dropZoneMap(char relName[ATTR_SIZE])
+{
+	if(strcmp(relName, RELCAT_RELNAME)==0 || strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
+
+	return ZoneMap::drop(relName);
+}
+
+int Schema::vacuumRel(char relName[ATTR_SIZE], int *numBlocksBefore, int *numBlocksAfter)
+{
+	if(strcmp(relName, RELCAT_RELNAME)==0 || strcmp(relName,ATTRCAT_RELNAME)==0)
+		return E_NOTPERMITTED;
+
+	int relId=OpenRelTable::getQueryRelId(relName);
+	if(relId<0)
+		return relId;
+
+	return BlockAccess::compact(relId, numBlocksBefore, numBlocksAfter);
+}
@@ -60,12 +60,29 @@ enum ConditionalOperators {
   NE   // !=
 };
 
+enum PredicateTypes {
+  PRED_COMPARE,  // attr op value
+  PRED_AND,      // every child holds
+  PRED_OR        // some child holds
+};
+
+enum AggregateFunctions {
+  AGG_COUNT,  // COUNT
+  AGG_SUM,    // SUM
+  AGG_AVG,    // AVG
+  AGG_MIN,    // MIN
+  AGG_MAX     // MAX
+};
+
 enum BlockType {
   REC,           // record block
   IND_INTERNAL,  // internal index block
   IND_LEAF,      // leaf index block
   UNUSED_BLK,    // unused block
-  BMAP           // block allocation map
+  BMAP,          // block allocation map
+  HASH_DIR,      // directory block of a hash index
+  HASH_BUCKET,   // bucket block of a hash index
+  IND_POSTING    // posting list block of a B+ tree
 };
 
 enum OpenRelationEntryStatus {
@@ -119,6 +136,8 @@ enum ReturnTypes {
   E_NOTFOUND,               // Search for requested record unsuccessful
   E_BLOCKNOTINBUFFER,       // Block not found in buffer
   E_INDEX_BLOCKS_RELEASED,  // Due to insufficient disk space, index blocks have been released from the disk
+  E_INDEXCORRUPT,           // B+ tree invariant violated
+  E_SYNTAX,                 // Command does not follow the grammar
 };
 
 #define TEMP ".temp"  // Used for internal purposes
@@ -128,6 +147,31 @@ enum ReturnTypes {
 #define MIDDLE_INDEX_INTERNAL 50  // Index of the middle element in an Internal Node of a B+ tree
 #define MAX_KEYS_LEAF 63          // Maximum number of keys allowed in a Leaf Node of a B+ tree
 #define MIDDLE_INDEX_LEAF 31      // Index of the middle element in a Leaf Node of a B+ tree
+#define MIN_KEYS_INTERNAL 50      // Minimum number of keys in an Internal Node (other than the root) of a B+ tree
+#define MIN_KEYS_LEAF 31          // Minimum number of keys in a Leaf Node (other than the root) of a B+ tree
+#define POSTING_THRESHOLD 64      // Records of one key at which their B+ tree leaf entries become a posting list
+#define POSTING_LIST_SLOT -2      // Slot of a B+ tree leaf entry whose block is the first block of a posting list
+#define NO_BOUND -1               // Open end of the range of a BPlusCursor
+#define BPLUS_STRESS_CHECK_INTERVAL 500  // Operations between two checks of the tree in FUNCTION BPLUSSTRESS
+#define MAX_COMPOSITE_KEYS 4      // Maximum number of attributes in the key of a composite B+ tree
+#define COMPOSITE_INDEX_OFFSET -1   // Offset of the Attribute Catalog record of a composite index
+#define HASH_INDEX_OFFSET -2        // Offset of the Attribute Catalog record of a hash index
+#define COMPRESSED_INDEX_OFFSET -3  // Offset of the Attribute Catalog record of a compressed string index
+
+// Global variables for hash indexes
+#define HASH_INITIAL_BUCKETS 4  // Number of buckets of a hash index before its first split
+#define HASH_SPLIT_LOAD 75      // Percentage of the bucket capacity filled before a bucket is split
+
+// Global variables for zone maps in the Cache Layer
+#define ZONEMAP_PREFIX_LEN 4  // Number of leading characters of a STRING kept in a zone map range
+
+// Global variables for query execution in the Algebra Layer
+#define AGGREGATE_MEMORY_BUDGET (BUFFER_CAPACITY * BLOCK_SIZE)  // Bytes of group state an aggregation may hold in memory before spilling
+#define AGGREGATE_SPILL_PARTITIONS 8                             // Number of temporary partitions an aggregation spills its overflow into
+#define SORT_MEMORY_BUDGET (BUFFER_CAPACITY * BLOCK_SIZE)       // Bytes of records a sort holds in memory to form one run
+#define SORT_MERGE_FANIN 16                                      // Maximum number of runs merged together in one pass of a sort
+#define JOIN_MEMORY_BUDGET (BUFFER_CAPACITY * BLOCK_SIZE)       // Default bytes of records a join holds per pass over its other input (SET JOIN MEMORY)
+#define JOIN_LOOP_COMPARE_RATIO 32                               // Key comparisons of a block nested-loop join estimated to cost as much as one comparison of a sort
 
 // Name strings for Relation Catalog and Attribute Catalog (as it is stored in the Relation catalog)
 #define RELCAT_RELNAME "RELATIONCAT"
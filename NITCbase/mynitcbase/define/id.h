@@ -10,10 +10,14 @@ struct RecId {
   int slot;
 };
 
-/* An index is identified by its block number and index number */
+/* An index is identified by its block number and index number. For a B+ tree
+leaf entry with a posting list, postingBlock and postingIndex locate a record
+of the list. Every field is -1 unless it is set. */
 struct IndexId {
-  int block;
-  int index;
+  int block = -1;
+  int index = -1;
+  int postingBlock = -1;
+  int postingIndex = -1;
 };
 
 #endif  // NITCBASE_ID_H
\ No newline at end of file